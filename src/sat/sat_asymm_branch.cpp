@@ -162,6 +162,7 @@ namespace sat {
         TRACE("asymm_branch", tout << c << "\nnew_size: " << new_sz << "\n";
               for (unsigned i = 0; i < c.size(); i++) tout << static_cast<int>(s.value(c[i])) << " "; tout << "\n";);
         // cleanup reduced clause
+        if (s.m_config.m_drat) s.m_drat.save(c);
         unsigned j = 0;
         for (i = 0; i < new_sz; i++) {
             literal l = c[i];
@@ -179,6 +180,10 @@ namespace sat {
         }
         new_sz = j;
         m_elim_literals += sz - new_sz;
+        if (s.m_config.m_drat) {
+            if (new_sz > 0) c.shrink(new_sz);
+            s.m_drat.update(c);
+        }
         switch(new_sz) {
         case 0:
             s.set_conflict(justification());
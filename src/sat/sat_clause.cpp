@@ -32,6 +32,7 @@ namespace sat {
         m_used(false),
         m_frozen(false),
         m_reinit_stack(false),
+        m_relocated(false),
         m_inact_rounds(0) {
         memcpy(m_lits, lits, sizeof(literal) * sz);
         mark_strengthened();
@@ -122,98 +123,132 @@ namespace sat {
     }
 
     clause_allocator::clause_allocator():
-        m_allocator("clause-allocator") {
-#if defined(_AMD64_)
-        m_num_segments = 0;
-#endif
+        m_used(0),
+        m_live(0),
+        m_num_compactions(0) {
     }
 
-    clause * clause_allocator::get_clause(clause_offset cls_off) const {
-#if defined(_AMD64_)
-#if defined (Z3DEBUG)
-        clause const* result;
-        if (((cls_off & c_alignment_mask) == c_last_segment)) {
-            unsigned id = cls_off >> c_cls_alignment;
-            bool check = m_last_seg_id2cls.find(id, result);
-            SASSERT(check);
-            return const_cast<clause*>(result);
+    clause_allocator::~clause_allocator() {
+        free_chunks(m_chunks);
+        free_chunks(m_old_chunks);
+    }
+
+    void clause_allocator::free_chunks(svector<chunk> & chunks) {
+        for (unsigned i = 0; i < chunks.size(); ++i) {
+            dealloc_svect(chunks[i].m_data);
         }
-#endif
-        return reinterpret_cast<clause *>(m_segments[cls_off & c_alignment_mask] + (static_cast<size_t>(cls_off) & ~c_alignment_mask));
-#else
-        return reinterpret_cast<clause *>(cls_off);
-#endif
+        chunks.reset();
     }
 
-#if defined(_AMD64_)
-    unsigned clause_allocator::get_segment(clause const* cls) {
-        size_t ptr = reinterpret_cast<size_t>(cls);
-
-        SASSERT((ptr & c_alignment_mask) == 0);
-        ptr &= 0xFFFFFFFF00000000ull; // Keep only high part
-        unsigned i = 0;
-        for (i = 0; i < m_num_segments; ++i)
-            if (m_segments[i] == ptr)
-                return i;
-        i = m_num_segments;
-        SASSERT(i <= c_last_segment);
-#if defined(Z3DEBUG)
-        if (i == c_last_segment) {
-            if (!m_last_seg_id2cls.contains(cls->id()))
-                m_last_seg_id2cls.insert(cls->id(), cls);
+    void clause_allocator::add_chunk(size_t sz) {
+        if (m_chunks.size() >= (1u << (32 - c_pos_bits))) {
+            throw default_exception("clause arena out of range");
         }
-        else {
-            ++m_num_segments;
-            m_segments[i] = ptr;
+        // chunks grow geometrically, clauses that do not fit get a chunk of their own.
+        size_t capacity = m_chunks.empty() ? c_min_chunk_size : std::min(2 * m_chunks.back().m_capacity, c_max_chunk_size);
+        if (capacity < sz) {
+            capacity = sz;
         }
-#else
-        if (i == c_last_segment) {
-            throw default_exception("segment out of range");
+        chunk c;
+        c.m_data     = alloc_svect(char, capacity);
+        c.m_capacity = capacity;
+        c.m_top      = 0;
+        m_chunks.push_back(c);
+        m_by_address.push_back(m_chunks.size() - 1);
+        unsigned i = m_by_address.size() - 1;
+        for (; i > 0 && m_chunks[m_by_address[i - 1]].m_data > c.m_data; --i) {
+            std::swap(m_by_address[i - 1], m_by_address[i]);
         }
-        m_segments[i] = ptr;
-        ++m_num_segments;
-#endif
+    }
 
-        return i;
+    char * clause_allocator::allocate(size_t sz) {
+        sz = (sz + (1 << c_align_bits) - 1) & ~static_cast<size_t>((1 << c_align_bits) - 1);
+        if (m_chunks.empty() || m_chunks.back().m_top + sz > m_chunks.back().m_capacity) {
+            add_chunk(sz);
+        }
+        chunk & c = m_chunks.back();
+        char * result = c.m_data + c.m_top;
+        c.m_top += sz;
+        m_used  += sz;
+        m_live  += sz;
+        return result;
     }
-#endif
 
     clause_offset clause_allocator::get_offset(clause const * cls) const {
-#if defined(_AMD64_)
-        unsigned segment = const_cast<clause_allocator*>(this)->get_segment(cls);
-#if defined(Z3DEBUG)
-        SASSERT(segment <= c_last_segment);
-        if (segment == c_last_segment) {
-            SASSERT(m_last_seg_id2cls.contains(cls->id()));
-            return (cls->id() << c_cls_alignment) | c_last_segment;
+        char const * ptr = reinterpret_cast<char const *>(cls);
+        // find the last chunk that starts at or before ptr.
+        unsigned lo = 0, hi = m_by_address.size();
+        while (hi - lo > 1) {
+            unsigned mid = (lo + hi) / 2;
+            if (m_chunks[m_by_address[mid]].m_data <= ptr)
+                lo = mid;
+            else
+                hi = mid;
         }
-#endif
-        return static_cast<unsigned>(reinterpret_cast<size_t>(cls)) + segment;
-#else
-        return reinterpret_cast<size_t>(cls);
-#endif
+        unsigned idx = m_by_address[lo];
+        SASSERT(m_chunks[idx].m_data <= ptr && ptr < m_chunks[idx].m_data + m_chunks[idx].m_top);
+        size_t pos = static_cast<size_t>(ptr - m_chunks[idx].m_data) >> c_align_bits;
+        SASSERT(pos < (1u << c_pos_bits));
+        return (idx << c_pos_bits) | static_cast<unsigned>(pos);
     }
 
     clause * clause_allocator::mk_clause(unsigned num_lits, literal const * lits, bool learned) {
         size_t size = clause::get_obj_size(num_lits);
-        void * mem = m_allocator.allocate(size);
+        void * mem = allocate(size);
         clause * cls = new (mem) clause(m_id_gen.mk(), num_lits, lits, learned);
         TRACE("sat", tout << "alloc: " << cls->id() << " " << *cls << " " << (learned?"l":"a") << "\n";);
         SASSERT(!learned || cls->is_learned());
+        SASSERT(get_clause(get_offset(cls)) == cls);
         return cls;
     }
 
     void clause_allocator::del_clause(clause * cls) {
         TRACE("sat", tout << "delete: " << cls->id() << " " << *cls << "\n";);
         m_id_gen.recycle(cls->id());
-#if defined(_AMD64_)
-#if defined(Z3DEBUG)
-        m_last_seg_id2cls.remove(cls->id());
-#endif
-#endif
         size_t size = clause::get_obj_size(cls->m_capacity);
+        size = (size + (1 << c_align_bits) - 1) & ~static_cast<size_t>((1 << c_align_bits) - 1);
         cls->~clause();
-        m_allocator.deallocate(size, cls);
+        SASSERT(m_live >= size);
+        m_live -= size;
+    }
+
+    void clause_allocator::begin_compaction() {
+        SASSERT(m_old_chunks.empty());
+        m_old_chunks.swap(m_chunks);
+        m_by_address.reset();
+        m_used = 0;
+        m_live = 0;
+    }
+
+    clause * clause_allocator::relocate(clause * cls) {
+        if (cls->m_relocated) {
+            return get_clause(cls->m_capacity);
+        }
+        // the copy does not keep the capacity of clauses that were shrunk.
+        size_t size = clause::get_obj_size(cls->m_size);
+        char * mem = allocate(size);
+        memcpy(mem, reinterpret_cast<char const *>(cls), size);
+        clause * result = reinterpret_cast<clause *>(mem);
+        result->m_capacity = result->m_size;
+        cls->m_relocated = true;
+        cls->m_capacity  = get_offset(result);
+        return result;
+    }
+
+    clause_offset clause_allocator::relocate(clause_offset cls_off) {
+        return get_offset(relocate(get_clause(m_old_chunks, cls_off)));
+    }
+
+    void clause_allocator::end_compaction() {
+        free_chunks(m_old_chunks);
+        m_num_compactions++;
+    }
+
+    void clause_allocator::collect_statistics(statistics & st) const {
+        st.update("clause arena mb", static_cast<double>(m_used) / (1024.0 * 1024.0));
+        st.update("clause arena live mb", static_cast<double>(m_live) / (1024.0 * 1024.0));
+        st.update("clause arena fragmentation", fragmentation());
+        st.update("clause arena compactions", m_num_compactions);
     }
 
     std::ostream & operator<<(std::ostream & out, clause const & c) {
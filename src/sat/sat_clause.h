@@ -20,8 +20,8 @@ Revision History:
 #define SAT_CLAUSE_H_
 
 #include "sat/sat_types.h"
-#include "util/small_object_allocator.h"
 #include "util/id_gen.h"
+#include "util/statistics.h"
 #include "util/map.h"
 
 #ifdef _MSC_VER
@@ -46,6 +46,7 @@ namespace sat {
         unsigned           m_used:1;
         unsigned           m_frozen:1;
         unsigned           m_reinit_stack:1;
+        unsigned           m_relocated:1;  // the clause was copied during compaction, m_capacity is the new offset
         unsigned           m_inact_rounds:8;
         unsigned           m_glue:8;
         unsigned           m_psm:8;  // transient field used during gc
@@ -73,6 +74,8 @@ namespace sat {
         bool check_approx() const; // for debugging
         literal * begin() { return m_lits; }
         literal * end() { return m_lits + m_size; }
+        literal const * begin() const { return m_lits; }
+        literal const * end() const { return m_lits + m_size; }
         bool contains(literal l) const;
         bool contains(bool_var v) const;
         bool satisfied_by(model const & m) const;
@@ -124,28 +127,61 @@ namespace sat {
     };
 
     /**
-       \brief Simple clause allocator that allows uint (32bit integers) to be used to reference clauses (even in 64bit machines).
+       \brief Arena for clauses. Clauses are allocated contiguously in large chunks
+       and referenced by 32-bit offsets (even in 64bit machines): the index of the chunk
+       and the position of the clause in the chunk, in units of 8 bytes.
+       
+       Memory of deleted clauses is not reused. It is reclaimed by a compaction
+       that copies the surviving clauses to fresh chunks, see solver::defrag_clauses.
     */
     class clause_allocator {
-        small_object_allocator m_allocator;
+        struct chunk {
+            char *   m_data;
+            size_t   m_capacity;
+            size_t   m_top;
+        };
+        static const unsigned  c_align_bits     = 3;
+        static const unsigned  c_pos_bits       = 19;     // chunks of up to 4MB are addressable
+        static const size_t    c_min_chunk_size = 1 << 16;
+        static const size_t    c_max_chunk_size = static_cast<size_t>(1) << (c_pos_bits + c_align_bits);
         id_gen                 m_id_gen;
-#if defined(_AMD64_)
-        unsigned get_segment(clause const* cls);
-        static const unsigned  c_cls_alignment = 3;
-        static const unsigned  c_last_segment  = (1ull << c_cls_alignment) - 1ull;
-        static const size_t    c_alignment_mask = (1ull << c_cls_alignment) - 1ull;
-        unsigned               m_num_segments;
-        size_t                 m_segments[c_last_segment];
-#if defined(Z3DEBUG)
-        u_map<clause const*>   m_last_seg_id2cls;
-#endif
-#endif
+        svector<chunk>         m_chunks;
+        svector<chunk>         m_old_chunks;   // chunks of the clauses being relocated
+        unsigned_vector        m_by_address;   // chunk indices sorted by address of the chunk
+        size_t                 m_used;         // bytes allocated in chunks
+        size_t                 m_live;         // bytes of clauses that were not deleted
+        unsigned               m_num_compactions;
+
+        char * allocate(size_t sz);
+        void add_chunk(size_t sz);
+        static clause * get_clause(svector<chunk> const & chunks, clause_offset cls_off) {
+            return reinterpret_cast<clause *>(chunks[cls_off >> c_pos_bits].m_data + (static_cast<size_t>(cls_off & ((1u << c_pos_bits) - 1)) << c_align_bits));
+        }
+        static void free_chunks(svector<chunk> & chunks);
     public:
         clause_allocator();
-        clause *      get_clause(clause_offset cls_off) const;
+        ~clause_allocator();
+        clause *      get_clause(clause_offset cls_off) const { return get_clause(m_chunks, cls_off); }
         clause_offset get_offset(clause const * ptr) const;
         clause *      mk_clause(unsigned num_lits, literal const * lits, bool learned);
         void          del_clause(clause * cls);
+
+        /**
+           \brief fraction of the allocated memory that is used by deleted clauses.
+        */
+        double fragmentation() const { return m_used == 0 ? 0.0 : static_cast<double>(m_used - m_live) / static_cast<double>(m_used); }
+
+        /**
+           \brief Compaction: after begin_compaction every reference to a clause must be
+           replaced by the result of relocate. A clause that is relocated several times is
+           copied only once. Clauses that are not relocated are freed by end_compaction.
+        */
+        void          begin_compaction();
+        clause *      relocate(clause * cls);
+        clause_offset relocate(clause_offset cls_off);
+        void          end_compaction();
+
+        void collect_statistics(statistics & st) const;
     };
 
     /**
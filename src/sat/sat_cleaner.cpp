@@ -41,6 +41,7 @@ namespace sat {
         unsigned l_idx = 0;
         for (; it != end; ++it, ++l_idx) {
             if (s.value(to_literal(l_idx)) != l_undef) {
+                if (s.m_config.m_drat) drat_del_assigned_bins(~to_literal(l_idx), *it);
                 it->finalize();
                 SASSERT(it->empty());
                 continue;
@@ -58,6 +59,10 @@ namespace sat {
                         *it_prev = *it2;
                         ++it_prev;
                     }
+                    else if (s.m_config.m_drat) {
+                        // the other half sits in the watch list of an assigned literal.
+                        s.m_drat.del(~to_literal(l_idx), it2->get_literal());
+                    }
                     TRACE("cleanup_bug", tout << "keeping: " << ~to_literal(l_idx) << " " << it2->get_literal() << "\n";);
                     break;
                 case watched::TERNARY:
@@ -77,6 +82,22 @@ namespace sat {
         }
     }
 
+    /**
+       \brief Log the deletion of the binary clauses (l1 or l2) watched by ~l1
+       whose both halves are dropped with the watch lists of assigned literals.
+    */
+    void cleaner::drat_del_assigned_bins(literal l1, watch_list const & wlist) {
+        watch_list::const_iterator it  = wlist.begin();
+        watch_list::const_iterator end = wlist.end();
+        for (; it != end; ++it) {
+            if (!it->is_binary_clause())
+                continue;
+            literal l2 = it->get_literal();
+            if (s.value(l2) != l_undef && l1.index() < l2.index())
+                s.m_drat.del(l1, l2);
+        }
+    }
+
     void cleaner::cleanup_clauses(clause_vector & cs) {
         clause_vector::iterator it  = cs.begin();
         clause_vector::iterator it2 = it;
@@ -90,6 +111,7 @@ namespace sat {
             unsigned i = 0, j = 0;
             bool sat = false;
             m_cleanup_counter += sz;
+            if (s.m_config.m_drat) s.m_drat.save(c);
             for (; i < sz; i++) {
                 switch (s.value(c[i])) {
                 case l_true:
@@ -105,6 +127,10 @@ namespace sat {
                 }
             }
         end_loop:
+            if (s.m_config.m_drat) {
+                if (!sat) c.shrink(j);
+                s.m_drat.update(c);
+            }
             CTRACE("sat_cleaner_frozen", c.frozen(),
                    tout << "sat: " << sat << ", new_size: " << j << "\n";
                    tout << mk_lits_pp(j, c.begin()) << "\n";);
@@ -20,6 +20,7 @@ Revision History:
 #define SAT_CLEANER_H_
 
 #include "sat/sat_types.h"
+#include "sat/sat_watched.h"
 #include "util/statistics.h"
 
 namespace sat {
@@ -36,6 +37,7 @@ namespace sat {
         unsigned m_elim_literals;
 
         void cleanup_watches();
+        void drat_del_assigned_bins(literal l1, watch_list const & wlist);
         void cleanup_clauses(clause_vector & cs);
     public:
         cleaner(solver & s);
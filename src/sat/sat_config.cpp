@@ -79,6 +79,24 @@ namespace sat {
         
         m_max_conflicts   = p.max_conflicts();
         m_num_parallel    = p.parallel_threads();
+        m_par_max_size    = p.parallel_share_max_size();
+        m_par_max_glue    = p.parallel_share_max_glue();
+        m_lookahead_cube       = p.lookahead_cube();
+        m_lookahead_depth      = p.lookahead_cube_depth();
+        m_lookahead_candidates = p.lookahead_candidates();
+        m_lookahead_double     = p.lookahead_double();
+        m_local_search           = p.local_search();
+        m_local_search_rephase   = p.local_search_rephase();
+        m_local_search_max_flips = p.local_search_max_flips();
+        m_local_search_cb        = p.local_search_cb();
+        m_xor_solver      = p.xor_solver();
+        m_xor_max_size    = p.xor_solver_max_size();
+        m_xor_gauss_max   = p.xor_solver_gauss_max();
+
+        m_drat_file       = p.drat_file();
+        m_drat_check      = p.drat_check();
+        m_drat            = m_drat_file != symbol("") || m_drat_check;
+        m_drat_binary     = p.drat_binary();
         
         // These parameters are not exposed
         m_simplify_mult1  = _p.get_uint("simplify_mult1", 300);
@@ -110,6 +128,7 @@ namespace sat {
             m_gc_initial      = p.gc_initial();
             m_gc_increment    = p.gc_increment();
         }
+        m_gc_defrag       = p.gc_defrag();
         m_minimize_lemmas = p.minimize_lemmas();
         m_core_minimize   = p.core_minimize();
         m_core_minimize_partial   = p.core_minimize_partial();
@@ -58,6 +58,24 @@ namespace sat {
         unsigned           m_burst_search;
         unsigned           m_max_conflicts;
         unsigned           m_num_parallel;
+        unsigned           m_par_max_size;
+        unsigned           m_par_max_glue;
+        bool               m_lookahead_cube;
+        unsigned           m_lookahead_depth;
+        unsigned           m_lookahead_candidates;
+        bool               m_lookahead_double;
+        bool               m_local_search;
+        unsigned           m_local_search_rephase;
+        unsigned           m_local_search_max_flips;
+        double             m_local_search_cb;
+        bool               m_xor_solver;
+        unsigned           m_xor_max_size;
+        unsigned           m_xor_gauss_max;
+
+        bool               m_drat;
+        symbol             m_drat_file;
+        bool               m_drat_binary;
+        bool               m_drat_check;
 
         unsigned           m_simplify_mult1;
         double             m_simplify_mult2;
@@ -68,6 +86,7 @@ namespace sat {
         unsigned           m_gc_increment;
         unsigned           m_gc_small_lbd;
         unsigned           m_gc_k;
+        bool               m_gc_defrag;
 
         bool               m_minimize_lemmas;
         bool               m_dyn_sub_res;
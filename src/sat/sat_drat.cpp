@@ -0,0 +1,206 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.cpp
+
+Abstract:
+
+    Produce DRAT proofs.
+
+Author:
+
+    agent (agent@local) 2026-10-15
+
+Revision History:
+
+--*/
+#include "sat/sat_solver.h"
+#include "sat/sat_drat.h"
+
+
+namespace sat {
+
+    static const unsigned drat_buffer_size = 1 << 16;
+
+    drat::drat(solver& s):
+        s(s),
+        m_out(0),
+        m_checker(0),
+        m_check_result(l_undef),
+        m_binary(false) {
+    }
+
+    drat::~drat() {
+        if (m_out) {
+            flush();
+            dealloc(m_out);
+        }
+        dealloc(m_checker);
+    }
+
+    void drat::updt_config() {
+        m_binary = s.get_config().m_drat_binary;
+        symbol const& file = s.get_config().m_drat_file;
+        if (!m_out && file != symbol::null && file != symbol("")) {
+            m_out = alloc(std::ofstream, file.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!m_out->good()) {
+                dealloc(m_out);
+                m_out = 0;
+                throw solver_exception("could not open DRAT file");
+            }
+        }
+        if (!m_checker && s.get_config().m_drat_check) {
+            m_checker = alloc(drat_checker);
+        }
+    }
+
+    void drat::flush() {
+        if (!m_buffer.empty()) {
+            m_out->write(m_buffer.c_ptr(), m_buffer.size());
+            m_buffer.reset();
+        }
+        m_out->flush();
+    }
+
+    void drat::dump(unsigned n, literal const* lits, status st) {
+        if (m_checker) {
+            if (st == deleted) {
+                m_checker->del(n, lits);
+            }
+            else {
+                m_checker->add_lemma(n, lits);
+            }
+        }
+        if (!m_out) return;
+        if (m_binary) {
+            write_binary(n, lits, st);
+        }
+        else {
+            write_text(n, lits, st);
+        }
+        if (m_buffer.size() >= drat_buffer_size) {
+            m_out->write(m_buffer.c_ptr(), m_buffer.size());
+            m_buffer.reset();
+        }
+    }
+
+    void drat::write_text(unsigned n, literal const* lits, status st) {
+        char digits[16];
+        if (st == deleted) {
+            m_buffer.push_back('d');
+            m_buffer.push_back(' ');
+        }
+        for (unsigned i = 0; i < n; ++i) {
+            literal l = lits[i];
+            if (l.sign()) m_buffer.push_back('-');
+            unsigned v = l.var() + 1;
+            unsigned k = 0;
+            do {
+                digits[k++] = '0' + (v % 10);
+                v /= 10;
+            }
+            while (v > 0);
+            while (k > 0) {
+                m_buffer.push_back(digits[--k]);
+            }
+            m_buffer.push_back(' ');
+        }
+        m_buffer.push_back('0');
+        m_buffer.push_back('\n');
+    }
+
+    void drat::write_binary(unsigned n, literal const* lits, status st) {
+        m_buffer.push_back(st == deleted ? 'd' : 'a');
+        for (unsigned i = 0; i < n; ++i) {
+            literal l = lits[i];
+            unsigned u = 2 * (l.var() + 1) + (l.sign() ? 1 : 0);
+            while (u > 127) {
+                m_buffer.push_back(static_cast<char>(128 | (u & 127)));
+                u >>= 7;
+            }
+            m_buffer.push_back(static_cast<char>(u));
+        }
+        m_buffer.push_back(0);
+    }
+
+    void drat::add_input(unsigned n, literal const* lits) {
+        if (m_checker) {
+            m_checker->add_input(n, lits);
+        }
+    }
+
+    void drat::add() {
+        dump(0, 0, asserted);
+    }
+
+    void drat::add(literal l) {
+        dump(1, &l, asserted);
+    }
+
+    void drat::add(literal l1, literal l2) {
+        literal ls[2] = { l1, l2 };
+        dump(2, ls, asserted);
+    }
+
+    void drat::add(clause const& c) {
+        dump(c.size(), c.begin(), asserted);
+    }
+
+    void drat::add(unsigned n, literal const* lits) {
+        dump(n, lits, asserted);
+    }
+
+    void drat::del(literal l1, literal l2) {
+        literal ls[2] = { l1, l2 };
+        dump(2, ls, deleted);
+    }
+
+    void drat::del(clause const& c) {
+        del(c.size(), c.begin());
+    }
+
+    void drat::del(unsigned n, literal const* lits) {
+        // deletions of units and of the empty clause are ignored by checkers.
+        if (n > 1) {
+            dump(n, lits, deleted);
+        }
+    }
+
+    void drat::save(clause const& c) {
+        if (!enabled()) return;
+        m_saved.reset();
+        m_saved.append(c.size(), c.begin());
+    }
+
+    void drat::update(clause const& c) {
+        if (!enabled()) return;
+        if (c.size() == m_saved.size() && std::equal(m_saved.begin(), m_saved.end(), c.begin())) {
+            return;
+        }
+        add(c);
+        del(m_saved.size(), m_saved.c_ptr());
+    }
+
+    lbool drat::check() {
+        if (!m_checker) {
+            return l_undef;
+        }
+        stopwatch sw;
+        sw.start();
+        lbool r = m_checker->check(s.rlimit());
+        sw.stop();
+        m_check_result = r;
+        IF_VERBOSE(1, verbose_stream() << "(sat.drat-check :result " << r 
+                   << " :time " << std::fixed << std::setprecision(2) << sw.get_seconds() << ")\n";);
+        return r;
+    }
+
+    void drat::collect_statistics(statistics& st) const {
+        if (m_checker) {
+            m_checker->collect_statistics(st);
+        }
+    }
+
+};
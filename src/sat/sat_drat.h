@@ -0,0 +1,100 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.h
+
+Abstract:
+
+    Produce DRAT proofs.
+
+    The solver records clause additions (learned lemmas, resolvents,
+    clauses simplified in place, units derived at the base level) and
+    clause deletions. Clauses are written either in the textual DRAT
+    format or in the binary DRAT format, where a step is 'a' (addition)
+    or 'd' (deletion) followed by the literals, each encoded as
+    2*(var+1) + sign in 7-bit variable-byte encoding, and terminated by 0.
+    Both formats write solver variable v as v+1, so that variable 0
+    does not collide with the clause terminator.
+
+    Output is collected in a buffer that is flushed in large blocks.
+
+    When sat.drat.check is set, the input clauses and the proof are
+    also passed to an in-process checker, see sat_drat_checker.h, so
+    that unsat answers can be validated without writing the proof.
+
+Author:
+
+    agent (agent@local) 2026-10-15
+
+Revision History:
+
+--*/
+#ifndef SAT_DRAT_H_
+#define SAT_DRAT_H_
+
+#include <fstream>
+#include "sat/sat_types.h"
+#include "sat/sat_drat_checker.h"
+
+namespace sat {
+
+    class drat {
+        enum status { asserted, deleted };
+        solver&        s;
+        std::ofstream* m_out;
+        drat_checker*  m_checker;
+        lbool          m_check_result;
+        bool           m_binary;
+        svector<char>  m_buffer;
+        literal_vector m_saved;     // literals of a clause before it is simplified in place
+
+        void dump(unsigned n, literal const* lits, status st);
+        void write_text(unsigned n, literal const* lits, status st);
+        void write_binary(unsigned n, literal const* lits, status st);
+        void flush();
+    public:
+        drat(solver& s);
+        ~drat();
+
+        void updt_config();
+        bool enabled() const { return m_out != 0 || m_checker != 0; }
+
+        /**
+           \brief record an input clause. Input clauses are not part of the proof.
+         */
+        void add_input(unsigned n, literal const* lits);
+
+        void add();
+        void add(literal l);
+        void add(literal l1, literal l2);
+        void add(clause const& c);
+        void add(unsigned n, literal const* lits);
+        void del(literal l1, literal l2);
+        void del(clause const& c);
+        void del(unsigned n, literal const* lits);
+
+        /**
+           \brief save the literals of c before c is simplified in place.
+         */
+        void save(clause const& c);
+
+        /**
+           \brief c was simplified in place: add its current literals 
+           and delete the literals that were saved.
+         */
+        void update(clause const& c);
+
+        /**
+           \brief check the proof recorded so far, see drat_checker::check.
+         */
+        lbool check();
+        lbool check_result() const { return m_check_result; }
+
+        void collect_statistics(statistics& st) const;
+    };
+
+};
+
+#endif
@@ -0,0 +1,472 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_drat_checker.cpp
+
+Abstract:
+
+    In-process checker for DRAT proofs.
+
+Author:
+
+    agent (agent@local) 2026-10-15
+
+Revision History:
+
+--*/
+#include <algorithm>
+#include "sat/sat_drat_checker.h"
+
+namespace sat {
+
+    const unsigned drat_checker::null_id;
+
+    drat_checker::drat_checker():
+        m_qhead(0),
+        m_qhead_core(0),
+        m_base_size(0),
+        m_base_conflict(null_id),
+        m_conflict(null_id) {
+    }
+
+    void drat_checker::ensure_var(bool_var v) {
+        if (v < m_reason.size()) return;
+        unsigned num_vars = std::max(v + 1, 2 * m_reason.size());
+        m_reason.resize(num_vars, null_id);
+        m_seen.resize(num_vars, false);
+        m_value.resize(2 * num_vars, l_undef);
+        m_mark.resize(2 * num_vars, false);
+        m_watches.resize(2 * num_vars);
+    }
+
+    unsigned drat_checker::hash(unsigned n, literal const* lits) const {
+        // independent of the order of the literals.
+        unsigned h = n;
+        for (unsigned i = 0; i < n; ++i) {
+            h += lits[i].index() * 2654435761u;
+        }
+        return h;
+    }
+
+    /**
+       \brief copy the literals to m_tmp, sorted and without duplicates.
+       Returns false if the clause is a tautology.
+     */
+    bool drat_checker::normalize(unsigned n, literal const* lits) {
+        m_tmp.reset();
+        m_tmp.append(n, lits);
+        std::sort(m_tmp.begin(), m_tmp.end());
+        unsigned j = 0;
+        for (unsigned i = 0; i < m_tmp.size(); ++i) {
+            literal l = m_tmp[i];
+            ensure_var(l.var());
+            if (j > 0 && m_tmp[j - 1] == l) continue;
+            // complementary literals are adjacent after sorting.
+            if (j > 0 && m_tmp[j - 1] == ~l) return false;
+            m_tmp[j++] = l;
+        }
+        m_tmp.shrink(j);
+        return true;
+    }
+
+    /**
+       \brief find the most recent active clause with the literals in m_tmp.
+     */
+    unsigned drat_checker::find(unsigned n, literal const* lits) {
+        u_map<unsigned_vector>::entry* e = m_table.find_core(hash(n, lits));
+        if (!e) return null_id;
+        unsigned_vector& ids = e->get_data().m_value;
+        for (unsigned i = 0; i < n; ++i) m_mark[lits[i].index()] = true;
+        unsigned result = null_id;
+        for (unsigned i = ids.size(); result == null_id && i-- > 0; ) {
+            unsigned id = ids[i];
+            if (!m_active[id] || m_size[id] != n) continue;
+            literal const* c = m_lits.c_ptr() + m_start[id];
+            bool eq = true;
+            for (unsigned k = 0; eq && k < n; ++k) eq = m_mark[c[k].index()] != 0;
+            if (eq) result = id;
+        }
+        for (unsigned i = 0; i < n; ++i) m_mark[lits[i].index()] = false;
+        return result;
+    }
+
+    unsigned drat_checker::mk_clause(unsigned n, literal const* lits, bool input) {
+        unsigned id = m_start.size();
+        m_start.push_back(m_lits.size());
+        m_size.push_back(m_tmp.size());
+        m_lits.append(m_tmp);
+        m_pivot.push_back(n > 0 ? lits[0] : null_literal);
+        m_input.push_back(input);
+        m_core.push_back(false);
+        m_active.push_back(true);
+        m_steps.push_back(2 * id);
+        m_table.insert_if_not_there2(hash(m_tmp.size(), m_tmp.c_ptr()), unsigned_vector())->get_data().m_value.push_back(id);
+        if (m_tmp.size() == 1) {
+            m_units.push_back(id);
+        }
+        else if (m_tmp.size() >= 2) {
+            m_watches[m_tmp[0].index()].push_back(id);
+            m_watches[m_tmp[1].index()].push_back(id);
+        }
+        return id;
+    }
+
+    void drat_checker::add_input(unsigned n, literal const* lits) {
+        if (!normalize(n, lits)) return;
+        ++m_stats.m_num_inputs;
+        mk_clause(n, lits, true);
+    }
+
+    void drat_checker::add_lemma(unsigned n, literal const* lits) {
+        // tautologies are trivially implied and never needed.
+        if (!normalize(n, lits)) return;
+        ++m_stats.m_num_lemmas;
+        mk_clause(n, lits, false);
+    }
+
+    void drat_checker::del(unsigned n, literal const* lits) {
+        if (!normalize(n, lits) || m_tmp.size() <= 1) return;
+        unsigned id = find(m_tmp.size(), m_tmp.c_ptr());
+        if (id == null_id) {
+            ++m_stats.m_num_missing;
+            return;
+        }
+        ++m_stats.m_num_deleted;
+        m_active[id] = false;
+        m_steps.push_back(2 * id + 1);
+    }
+
+    void drat_checker::assign(literal l, unsigned reason) {
+        SASSERT(value(l) == l_undef);
+        m_value[l.index()] = l_true;
+        m_value[(~l).index()] = l_false;
+        m_reason[l.var()] = reason;
+        m_trail.push_back(l);
+    }
+
+    void drat_checker::undo(unsigned old_sz) {
+        for (unsigned i = old_sz; i < m_trail.size(); ++i) {
+            literal l = m_trail[i];
+            m_value[l.index()] = l_undef;
+            m_value[(~l).index()] = l_undef;
+            m_reason[l.var()] = null_id;
+        }
+        m_trail.shrink(old_sz);
+        m_qhead = std::min(m_qhead, old_sz);
+        m_qhead_core = std::min(m_qhead_core, old_sz);
+        m_conflict = null_id;
+    }
+
+    /**
+       \brief visit the clauses watching l, which was assigned to false.
+       Watches of clauses whose first two literals no longer contain l are stale
+       and get dropped. Propagated literals are always moved to the first position.
+     */
+    bool drat_checker::visit(literal l, propagation_mode mode) {
+        unsigned_vector& ws = m_watches[l.index()];
+        unsigned sz = ws.size();
+        unsigned i = 0, j = 0;
+        for (; i < sz; ++i) {
+            unsigned id = ws[i];
+            literal* c = lits(id);
+            if (c[0] != l && c[1] != l) {
+                continue;
+            }
+            if (!m_active[id] ||
+                (mode == core_clauses && !m_core[id]) ||
+                (mode == non_core_clauses && m_core[id])) {
+                ws[j++] = id;
+                continue;
+            }
+            if (c[0] == l) {
+                std::swap(c[0], c[1]);
+            }
+            if (value(c[0]) == l_true) {
+                ws[j++] = id;
+                continue;
+            }
+            unsigned n = m_size[id];
+            bool found = false;
+            for (unsigned k = 2; !found && k < n; ++k) {
+                if (value(c[k]) != l_false) {
+                    std::swap(c[1], c[k]);
+                    m_watches[c[1].index()].push_back(id);
+                    found = true;
+                }
+            }
+            if (found) {
+                continue;
+            }
+            ws[j++] = id;
+            if (value(c[0]) == l_false) {
+                m_conflict = id;
+                for (++i; i < sz; ++i) {
+                    ws[j++] = ws[i];
+                }
+                break;
+            }
+            assign(c[0], id);
+        }
+        ws.shrink(j);
+        return m_conflict != null_id;
+    }
+
+    /**
+       \brief propagate the trail. In core-first mode the marked clauses
+       are propagated to a fix-point before a single literal is propagated
+       using the remaining clauses.
+     */
+    bool drat_checker::propagate(bool core_first) {
+        if (!core_first) {
+            while (m_qhead < m_trail.size()) {
+                if (visit(~m_trail[m_qhead++], all_clauses)) return true;
+            }
+            m_qhead_core = m_qhead;
+            return false;
+        }
+        while (true) {
+            while (m_qhead_core < m_trail.size()) {
+                if (visit(~m_trail[m_qhead_core++], core_clauses)) return true;
+            }
+            if (m_qhead == m_trail.size()) {
+                return false;
+            }
+            if (visit(~m_trail[m_qhead++], non_core_clauses)) return true;
+        }
+    }
+
+    /**
+       \brief mark the clauses that participate in the conflict, or in the
+       implication of l when no conflict clause is given.
+     */
+    void drat_checker::analyze(unsigned conflict, literal l) {
+        if (conflict != null_id) {
+            m_core[conflict] = true;
+            literal const* c = lits(conflict);
+            for (unsigned i = 0; i < m_size[conflict]; ++i) {
+                m_seen[c[i].var()] = true;
+            }
+        }
+        else {
+            m_seen[l.var()] = true;
+        }
+        for (unsigned i = m_trail.size(); i-- > 0; ) {
+            bool_var v = m_trail[i].var();
+            if (!m_seen[v]) continue;
+            m_seen[v] = false;
+            unsigned r = m_reason[v];
+            if (r == null_id) continue;
+            m_core[r] = true;
+            literal const* c = lits(r);
+            for (unsigned k = 1; k < m_size[r]; ++k) {
+                m_seen[c[k].var()] = true;
+            }
+        }
+    }
+
+    void drat_checker::rebuild_base() {
+        ++m_stats.m_num_rebuilds;
+        undo(0);
+        m_qhead = m_qhead_core = 0;
+        m_base_conflict = null_id;
+        for (unsigned i = 0; i < m_units.size() && m_base_conflict == null_id; ++i) {
+            unsigned id = m_units[i];
+            if (!m_active[id]) continue;
+            literal l = lits(id)[0];
+            switch (value(l)) {
+            case l_true: break;
+            case l_false: m_base_conflict = id; break;
+            case l_undef: assign(l, id); break;
+            }
+        }
+        if (m_base_conflict == null_id && propagate(false)) {
+            m_base_conflict = m_conflict;
+        }
+        m_conflict = null_id;
+        m_base_size = m_trail.size();
+    }
+
+    /**
+       \brief a deleted clause becomes active again. Its watches are moved to
+       literals that are not false in the base assignment, and the base
+       assignment is extended.
+     */
+    void drat_checker::activate(unsigned id) {
+        m_active[id] = true;
+        if (m_base_conflict != null_id) return;
+        unsigned n = m_size[id];
+        literal* c = lits(id);
+        literal w0 = c[0], w1 = c[1];
+        for (unsigned i = 0; i < 2; ++i) {
+            for (unsigned k = i; k < n; ++k) {
+                if (value(c[k]) != l_false) {
+                    std::swap(c[i], c[k]);
+                    break;
+                }
+            }
+        }
+        for (unsigned i = 0; i < 2; ++i) {
+            if (c[i] != w0 && c[i] != w1) {
+                m_watches[c[i].index()].push_back(id);
+            }
+        }
+        if (value(c[0]) == l_false) {
+            m_base_conflict = id;
+        }
+        else if (value(c[1]) == l_false && value(c[0]) == l_undef) {
+            assign(c[0], id);
+            if (propagate(false)) {
+                m_base_conflict = m_conflict;
+                m_conflict = null_id;
+            }
+            m_base_size = m_trail.size();
+        }
+    }
+
+    /**
+       \brief a clause is removed. The base assignment is rebuilt if
+       it depends on the clause.
+     */
+    void drat_checker::deactivate(unsigned id) {
+        m_active[id] = false;
+        if (m_size[id] == 0) return;
+        literal l = lits(id)[0];
+        if (m_base_conflict == id || (value(l) == l_true && m_reason[l.var()] == id)) {
+            rebuild_base();
+        }
+    }
+
+    bool drat_checker::is_rup(unsigned n, literal const* c) {
+        if (m_base_conflict != null_id) {
+            analyze(m_base_conflict, null_literal);
+            return true;
+        }
+        SASSERT(m_trail.size() == m_base_size);
+        bool result = false;
+        for (unsigned i = 0; !result && i < n; ++i) {
+            switch (value(c[i])) {
+            case l_true:
+                analyze(null_id, c[i]);
+                result = true;
+                break;
+            case l_false:
+                break;
+            case l_undef:
+                assign(~c[i], null_id);
+                break;
+            }
+        }
+        if (!result) {
+            m_qhead = m_qhead_core = m_base_size;
+            if (propagate(true)) {
+                analyze(m_conflict, null_literal);
+                result = true;
+            }
+        }
+        undo(m_base_size);
+        m_qhead = m_qhead_core = m_base_size;
+        return result;
+    }
+
+    /**
+       \brief check that the resolvents on the pivot with every active
+       clause that contains the negated pivot have the RUP property.
+     */
+    bool drat_checker::is_rat(unsigned id) {
+        literal p = m_pivot[id];
+        if (p == null_literal) return false;
+        ++m_stats.m_num_rat;
+        literal_vector c(m_size[id], lits(id));
+        literal_vector resolvent;
+        for (unsigned i = 0; i < c.size(); ++i) m_mark[c[i].index()] = true;
+        bool ok = true;
+        for (unsigned d = 0; ok && d < m_start.size(); ++d) {
+            if (!m_active[d]) continue;
+            literal const* lits_d = lits(d);
+            unsigned n = m_size[d];
+            bool has_pivot = false;
+            for (unsigned k = 0; !has_pivot && k < n; ++k) has_pivot = lits_d[k] == ~p;
+            if (!has_pivot) continue;
+            resolvent.reset();
+            resolvent.append(c);
+            bool is_taut = false;
+            for (unsigned k = 0; !is_taut && k < n; ++k) {
+                literal l = lits_d[k];
+                if (l == ~p) continue;
+                is_taut = m_mark[(~l).index()] != 0;
+                resolvent.push_back(l);
+            }
+            if (is_taut) continue;
+            ok = is_rup(resolvent.size(), resolvent.c_ptr());
+            if (ok) m_core[d] = true;
+        }
+        for (unsigned i = 0; i < c.size(); ++i) m_mark[c[i].index()] = false;
+        return ok;
+    }
+
+    lbool drat_checker::check(reslimit& lim) {
+        unsigned last = m_steps.size();
+        for (unsigned i = 0; i < m_steps.size(); ++i) {
+            if ((m_steps[i] & 1) == 0 && m_size[m_steps[i] / 2] == 0) {
+                last = i;
+                break;
+            }
+        }
+        if (last == m_steps.size()) {
+            return l_undef;
+        }
+        if (m_input[m_steps[last] / 2]) {
+            return l_true;
+        }
+
+        // replay additions and deletions up to the empty clause.
+        for (unsigned id = 0; id < m_active.size(); ++id) {
+            m_active[id] = false;
+            m_core[id] = false;
+        }
+        for (unsigned i = 0; i < last; ++i) {
+            m_active[m_steps[i] / 2] = (m_steps[i] & 1) == 0;
+        }
+        m_stats.m_num_checked = 0;
+        m_stats.m_num_rat = 0;
+        rebuild_base();
+        if (!is_rup(0, 0)) {
+            return l_false;
+        }
+        for (unsigned i = last; i-- > 0; ) {
+            if (!lim.inc()) {
+                return l_undef;
+            }
+            unsigned step = m_steps[i];
+            unsigned id = step / 2;
+            if (step & 1) {
+                activate(id);
+                continue;
+            }
+            deactivate(id);
+            if (m_input[id] || !m_core[id]) {
+                continue;
+            }
+            ++m_stats.m_num_checked;
+            if (!is_rup(m_size[id], lits(id)) && !is_rat(id)) {
+                IF_VERBOSE(0, verbose_stream() << "(sat.drat-check \"failed to verify lemma\"";
+                           for (unsigned k = 0; k < m_size[id]; ++k) verbose_stream() << " " << lits(id)[k];
+                           verbose_stream() << ")\n";);
+                return l_false;
+            }
+        }
+        return l_true;
+    }
+
+    void drat_checker::collect_statistics(statistics& st) const {
+        st.update("drat inputs", m_stats.m_num_inputs);
+        st.update("drat lemmas", m_stats.m_num_lemmas);
+        st.update("drat deleted", m_stats.m_num_deleted);
+        st.update("drat missing deletes", m_stats.m_num_missing);
+        st.update("drat checked lemmas", m_stats.m_num_checked);
+        st.update("drat rat lemmas", m_stats.m_num_rat);
+    }
+
+};
@@ -0,0 +1,126 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_drat_checker.h
+
+Abstract:
+
+    In-process checker for DRAT proofs.
+
+    The checker receives the input clauses and the proof steps
+    (lemma additions and clause deletions) as they are produced by
+    the solver. Checking proceeds backwards from the first empty
+    clause: only lemmas that are used to derive a conflict are marked
+    and verified. A lemma is verified if it has the RUP property
+    (reverse unit propagation on its negation leads to a conflict)
+    or, failing that, if it has the RAT property on its first literal.
+    Propagation uses two watched literals and is core-first: clauses
+    that are already marked are propagated to a fix-point before any
+    other clause is used, which keeps the marked core small.
+
+    Units implied by the active clauses are kept on a base trail that
+    is only rebuilt when a clause it depends on is removed.
+
+Author:
+
+    agent (agent@local) 2026-10-15
+
+Revision History:
+
+--*/
+#ifndef SAT_DRAT_CHECKER_H_
+#define SAT_DRAT_CHECKER_H_
+
+#include "sat/sat_types.h"
+#include "util/map.h"
+#include "util/rlimit.h"
+#include "util/statistics.h"
+
+namespace sat {
+
+    class drat_checker {
+        struct stats {
+            unsigned m_num_inputs;
+            unsigned m_num_lemmas;
+            unsigned m_num_deleted;
+            unsigned m_num_missing;     // deletions of clauses that were never added
+            unsigned m_num_checked;     // lemmas in the core that were verified
+            unsigned m_num_rat;         // lemmas that required a RAT check
+            unsigned m_num_rebuilds;    // rebuilds of the base trail
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        enum propagation_mode { all_clauses, core_clauses, non_core_clauses };
+
+        static const unsigned null_id = UINT_MAX;
+
+        stats                   m_stats;
+        // clause database: literals of clause id are m_lits[m_start[id] .. m_start[id] + m_size[id])
+        literal_vector          m_lits;
+        unsigned_vector         m_start;
+        unsigned_vector         m_size;
+        literal_vector          m_pivot;    // first literal of the clause as it was added
+        svector<char>           m_input;
+        svector<char>           m_core;
+        svector<char>           m_active;
+        unsigned_vector         m_steps;    // 2*id for additions, 2*id+1 for deletions
+        u_map<unsigned_vector>  m_table;    // hash of clause literals -> clause ids
+        unsigned_vector         m_units;
+        vector<unsigned_vector> m_watches;
+
+        // assignment
+        svector<lbool>          m_value;
+        unsigned_vector         m_reason;
+        literal_vector          m_trail;
+        unsigned                m_qhead;
+        unsigned                m_qhead_core;
+        unsigned                m_base_size;
+        unsigned                m_base_conflict;
+        unsigned                m_conflict;
+        svector<char>           m_seen;
+        svector<char>           m_mark;     // literal marks used for clause comparison
+        literal_vector          m_tmp;
+
+        literal* lits(unsigned id) { return m_lits.c_ptr() + m_start[id]; }
+        lbool value(literal l) const { return m_value[l.index()]; }
+        void ensure_var(bool_var v);
+        unsigned hash(unsigned n, literal const* lits) const;
+        bool normalize(unsigned n, literal const* lits);
+        unsigned find(unsigned n, literal const* lits);
+        unsigned mk_clause(unsigned n, literal const* lits, bool input);
+
+        void assign(literal l, unsigned reason);
+        void undo(unsigned old_sz);
+        bool visit(literal l, propagation_mode mode);
+        bool propagate(bool core_first);
+        void analyze(unsigned conflict, literal l);
+        void rebuild_base();
+        void activate(unsigned id);
+        void deactivate(unsigned id);
+        bool is_rup(unsigned n, literal const* lits);
+        bool is_rat(unsigned id);
+
+    public:
+        drat_checker();
+
+        void add_input(unsigned n, literal const* lits);
+        void add_lemma(unsigned n, literal const* lits);
+        void del(unsigned n, literal const* lits);
+
+        /**
+           \brief check the proof up to the first empty clause.
+           Returns l_true if the proof is a valid refutation, l_false if
+           some lemma could not be verified, and l_undef if no empty clause
+           was derived or the check was canceled.
+         */
+        lbool check(reslimit& lim);
+
+        void collect_statistics(statistics& st) const;
+    };
+
+};
+
+#endif
@@ -47,6 +47,7 @@ namespace sat {
                 if (it2->is_binary_clause()) {
                     literal l2 = it2->get_literal();
                     literal r2 = norm(roots, l2);
+                    if (m_solver.m_config.m_drat) drat_bin(l1, l2, r1, r2);
                     if (r1 == r2) {
                         m_solver.assign(r1, justification());
                         if (m_solver.inconsistent())
@@ -72,6 +73,20 @@ namespace sat {
         }
     }
 
+    /**
+       \brief Log the rewrite of the binary clause (l1 or l2) into (r1 or r2).
+       Each clause is visited once per half, so only the half with l1 < l2 is logged.
+       The deletion is delayed because the equivalences are still needed to justify
+       the rewritten non-binary clauses.
+    */
+    void elim_eqs::drat_bin(literal l1, literal l2, literal r1, literal r2) {
+        if (l1.index() > l2.index() || (l1 == r1 && l2 == r2))
+            return;
+        if (r1 != r2 && r1 != ~r2)
+            m_solver.m_drat.add(r1, r2);
+        m_drat_del.push_back(literal_pair(l1, l2));
+    }
+
     void elim_eqs::cleanup_clauses(literal_vector const & roots, clause_vector & cs) {
         clause_vector::iterator it  = cs.begin();
         clause_vector::iterator it2 = it;
@@ -95,6 +110,7 @@ namespace sat {
             }
             if (!c.frozen())
                 m_solver.detach_clause(c);
+            if (m_solver.m_config.m_drat) m_solver.m_drat.save(c);
             // apply substitution
             for (i = 0; i < sz; i++) {
                 SASSERT(!m_solver.was_eliminated(c[i].var()));
@@ -122,6 +138,7 @@ namespace sat {
             }
             if (i < sz) {
                 // clause is a tautology or was simplified
+                if (m_solver.m_config.m_drat) m_solver.m_drat.update(c);
                 m_solver.del_clause(c);
                 continue; 
             }
@@ -140,6 +157,7 @@ namespace sat {
                 c.shrink(j);
             else
                 c.update_approx();
+            if (m_solver.m_config.m_drat) m_solver.m_drat.update(c);
             SASSERT(c.size() == j);
             DEBUG_CODE({
                 for (unsigned i = 0; i < c.size(); i++) {
@@ -212,11 +230,14 @@ namespace sat {
     }
 
     void elim_eqs::operator()(literal_vector const & roots, bool_var_vector const & to_elim) {
+        m_drat_del.reset();
         cleanup_bin_watches(roots);
         TRACE("elim_eqs", tout << "after bin cleanup\n"; m_solver.display(tout););
         cleanup_clauses(roots, m_solver.m_clauses);
-        if (m_solver.inconsistent()) return;
-        cleanup_clauses(roots, m_solver.m_learned);
+        if (!m_solver.inconsistent()) 
+            cleanup_clauses(roots, m_solver.m_learned);
+        for (unsigned i = 0; i < m_drat_del.size(); ++i) 
+            m_solver.m_drat.del(m_drat_del[i].first, m_drat_del[i].second);
         if (m_solver.inconsistent()) return;
         save_elim(roots, to_elim);
         m_solver.propagate(false);
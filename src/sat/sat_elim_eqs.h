@@ -26,10 +26,12 @@ namespace sat {
     
     class elim_eqs {
         solver & m_solver;
+        svector<literal_pair> m_drat_del; // binary clauses whose deletion is logged once all clauses are rewritten
         void save_elim(literal_vector const & roots, bool_var_vector const & to_elim);
         void cleanup_clauses(literal_vector const & roots, clause_vector & cs);
         void cleanup_bin_watches(literal_vector const & roots);
         bool check_clauses(literal_vector const & roots) const;
+        void drat_bin(literal l1, literal l2, literal r1, literal r2);
     public:
         elim_eqs(solver & s);
         void operator()(literal_vector const & roots, bool_var_vector const & to_elim);
@@ -0,0 +1,273 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_local_search.cpp
+
+Abstract:
+
+    Stochastic local search in the style of ProbSAT.
+
+Author:
+
+    agent (agent@local) 2026-10-15
+
+Revision History:
+
+--*/
+#include <cmath>
+#include "sat/sat_local_search.h"
+#include "sat/sat_solver.h"
+
+namespace sat {
+
+    local_search::local_search(reslimit& lim, unsigned random_seed, unsigned max_flips, double cb):
+        m_limit(lim),
+        m_rand(random_seed),
+        m_inconsistent(false),
+        m_best_unsat(UINT_MAX) {
+        m_config.m_max_flips = max_flips;
+        m_config.m_cb        = cb;
+        m_config.m_eps       = 0.9;
+        for (unsigned i = 0; i < c_max_break; ++i) {
+            m_prob_break[i] = pow(m_config.m_eps + i, -m_config.m_cb);
+        }
+        m_begin.push_back(0);
+    }
+
+    void local_search::import(solver const& s, unsigned num_assumptions, literal const* assumptions) {
+        unsigned num_vars = s.num_vars();
+        m_inconsistent = false;
+        m_lits.reset();
+        m_begin.reset();
+        m_begin.push_back(0);
+        m_occs.reset();
+        m_occs.resize(2 * num_vars);
+        m_fixed.reset();
+        m_value.reset();
+        for (bool_var v = 0; v < num_vars; ++v) {
+            m_fixed.push_back(s.value(v));
+            m_value.push_back(s.m_phase[v] == POS_PHASE);
+        }
+        for (unsigned i = 0; i < num_assumptions; ++i) {
+            literal l = assumptions[i];
+            lbool val = l.sign() ? l_false : l_true;
+            if (m_fixed[l.var()] == ~val) {
+                m_inconsistent = true;
+            }
+            m_fixed[l.var()] = val;
+        }
+        for (bool_var v = 0; v < num_vars; ++v) {
+            if (m_fixed[v] != l_undef) {
+                m_value[v] = m_fixed[v] == l_true;
+            }
+        }
+
+        // binary clauses are stored in the watch lists of both their literals.
+        for (unsigned l_idx = 0; l_idx < 2 * num_vars; ++l_idx) {
+            literal l = ~to_literal(l_idx);
+            watch_list const& wlist = s.m_watches[l_idx];
+            watch_list::const_iterator it = wlist.begin(), end = wlist.end();
+            for (; it != end; ++it) {
+                if (it->is_binary_clause() && !it->is_learned() && l.index() < it->get_literal().index()) {
+                    literal lits[2] = { l, it->get_literal() };
+                    add_clause(2, lits);
+                }
+            }
+        }
+        clause_vector::const_iterator it = s.m_clauses.begin(), end = s.m_clauses.end();
+        for (; it != end; ++it) {
+            clause const& c = *(*it);
+            add_clause(c.size(), c.begin());
+        }
+
+        m_best.reset();
+        m_best.append(m_value);
+        m_best_unsat = UINT_MAX;
+        m_num_true.reset();
+        m_num_true.resize(num_clauses(), 0);
+        m_true_xor.reset();
+        m_true_xor.resize(num_clauses(), 0);
+        m_unsat_idx.reset();
+        m_unsat_idx.resize(num_clauses(), UINT_MAX);
+        m_break.reset();
+        m_break.resize(num_vars, 0);
+        m_unsat.reset();
+    }
+
+    /**
+       \brief add the clause simplified with respect to the fixed variables.
+     */
+    void local_search::add_clause(unsigned n, literal const* lits) {
+        unsigned sz = m_lits.size();
+        for (unsigned i = 0; i < n; ++i) {
+            literal l = lits[i];
+            lbool val = m_fixed[l.var()];
+            if (val == l_undef) {
+                m_lits.push_back(l);
+            }
+            else if ((val == l_true) != l.sign()) {
+                m_lits.shrink(sz);
+                return;
+            }
+        }
+        if (m_lits.size() == sz) {
+            m_inconsistent = true;
+            return;
+        }
+        unsigned idx = num_clauses();
+        for (unsigned i = sz; i < m_lits.size(); ++i) {
+            m_occs[m_lits[i].index()].push_back(idx);
+        }
+        m_begin.push_back(m_lits.size());
+    }
+
+    void local_search::set_unsat(unsigned c) {
+        m_unsat_idx[c] = m_unsat.size();
+        m_unsat.push_back(c);
+    }
+
+    void local_search::set_sat(unsigned c) {
+        unsigned idx = m_unsat_idx[c];
+        unsigned last = m_unsat.back();
+        m_unsat[idx] = last;
+        m_unsat_idx[last] = idx;
+        m_unsat.pop_back();
+        m_unsat_idx[c] = UINT_MAX;
+    }
+
+    void local_search::init_try() {
+        ++m_stats.m_tries;
+        m_unsat.reset();
+        m_break.fill(0);
+        for (unsigned c = 0; c < num_clauses(); ++c) {
+            unsigned num_true = 0, true_xor = 0;
+            for (unsigned i = m_begin[c]; i < m_begin[c + 1]; ++i) {
+                if (is_true(m_lits[i])) {
+                    ++num_true;
+                    true_xor ^= m_lits[i].var();
+                }
+            }
+            m_num_true[c] = num_true;
+            m_true_xor[c] = true_xor;
+            m_unsat_idx[c] = UINT_MAX;
+            if (num_true == 0) {
+                set_unsat(c);
+            }
+            else if (num_true == 1) {
+                m_break[true_xor]++;
+            }
+        }
+    }
+
+    void local_search::flip(bool_var v) {
+        ++m_stats.m_flips;
+        literal old_true(v, !m_value[v]);
+        m_value[v] = !m_value[v];
+        unsigned_vector const& falsified = m_occs[old_true.index()];
+        for (unsigned i = 0; i < falsified.size(); ++i) {
+            unsigned c = falsified[i];
+            unsigned num_true = --m_num_true[c];
+            m_true_xor[c] ^= v;
+            if (num_true == 0) {
+                set_unsat(c);
+                m_break[v]--;
+            }
+            else if (num_true == 1) {
+                m_break[m_true_xor[c]]++;
+            }
+        }
+        unsigned_vector const& satisfied = m_occs[(~old_true).index()];
+        for (unsigned i = 0; i < satisfied.size(); ++i) {
+            unsigned c = satisfied[i];
+            unsigned num_true = m_num_true[c]++;
+            if (num_true == 0) {
+                set_sat(c);
+                m_break[v]++;
+            }
+            else if (num_true == 1) {
+                m_break[m_true_xor[c]]--;
+            }
+            m_true_xor[c] ^= v;
+        }
+    }
+
+    bool_var local_search::pick_var(unsigned c) {
+        unsigned sz = m_begin[c + 1] - m_begin[c];
+        literal const* lits = m_lits.c_ptr() + m_begin[c];
+        if (sz == 1) {
+            return lits[0].var();
+        }
+        m_probs.reset();
+        double sum = 0;
+        for (unsigned i = 0; i < sz; ++i) {
+            unsigned b = m_break[lits[i].var()];
+            double p = b < c_max_break ? m_prob_break[b] : m_prob_break[c_max_break - 1];
+            sum += p;
+            m_probs.push_back(sum);
+        }
+        double r = sum * (m_rand() / static_cast<double>(0x8000));
+        for (unsigned i = 0; i + 1 < sz; ++i) {
+            if (r < m_probs[i]) {
+                return lits[i].var();
+            }
+        }
+        return lits[sz - 1].var();
+    }
+
+    void local_search::save_best() {
+        if (m_unsat.size() < m_best_unsat) {
+            m_best_unsat = m_unsat.size();
+            m_best.reset();
+            m_best.append(m_value);
+        }
+        if (m_unsat.size() < m_stats.m_min_unsat) {
+            m_stats.m_min_unsat = m_unsat.size();
+        }
+    }
+
+    lbool local_search::check(unsigned max_tries) {
+        if (m_inconsistent) {
+            return l_undef;
+        }
+        for (unsigned t = 0; max_tries == 0 || t < max_tries; ++t) {
+            if (t > 0) {
+                m_value.reset();
+                m_value.append(m_best);
+            }
+            init_try();
+            save_best();
+            unsigned best_in_try = m_unsat.size();
+            for (unsigned f = 0; !m_unsat.empty() && f < m_config.m_max_flips; ++f) {
+                if ((f & 0x3FF) == 0 && !m_limit.inc()) {
+                    return l_undef;
+                }
+                unsigned c = m_unsat[m_rand(m_unsat.size())];
+                flip(pick_var(c));
+                if (m_unsat.size() < best_in_try) {
+                    best_in_try = m_unsat.size();
+                    save_best();
+                }
+            }
+            IF_VERBOSE(2, verbose_stream() << "(sat-local-search :try " << m_stats.m_tries
+                       << " :unsat " << best_in_try << " :flips " << m_stats.m_flips << ")\n";);
+            if (m_unsat.empty()) {
+                m_model.reset();
+                for (bool_var v = 0; v < m_value.size(); ++v) {
+                    m_model.push_back(m_value[v] ? l_true : l_false);
+                }
+                return l_true;
+            }
+        }
+        return l_undef;
+    }
+
+    void local_search::collect_statistics(statistics& st) const {
+        st.update("local search flips", m_stats.m_flips);
+        st.update("local search tries", m_stats.m_tries);
+        if (m_stats.m_min_unsat != UINT_MAX) {
+            st.update("local search min unsat", m_stats.m_min_unsat);
+        }
+    }
+};
@@ -0,0 +1,127 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_local_search.h
+
+Abstract:
+
+    Stochastic local search in the style of ProbSAT.
+
+    The engine works on a copy of the irredundant clauses of a SAT
+    solver, simplified with respect to the base level assignment
+    (and assumptions). It maintains a complete assignment together
+    with, for every clause, the number of true literals and the xor of
+    the true variables, so that the only true variable of a clause
+    (its critical variable) is available in constant time. The break
+    count of a variable is the number of clauses in which it is
+    critical. A step picks a random falsified clause and flips one of
+    its variables with probability proportional to (eps + break)^-cb.
+
+    The best assignment seen so far is kept; the CDCL solver copies
+    it into its phase cache (rephasing), and the parallel solver uses
+    the engine as a portfolio member that can only answer sat.
+
+Author:
+
+    agent (agent@local) 2026-10-15
+
+Revision History:
+
+--*/
+#ifndef SAT_LOCAL_SEARCH_H_
+#define SAT_LOCAL_SEARCH_H_
+
+#include "sat/sat_types.h"
+#include "util/rlimit.h"
+#include "util/util.h"
+#include "util/statistics.h"
+
+namespace sat {
+
+    class solver;
+
+    class local_search {
+
+        struct config {
+            unsigned m_max_flips;       // flips per try
+            double   m_cb;              // break exponent
+            double   m_eps;
+        };
+
+        struct stats {
+            unsigned m_flips;
+            unsigned m_tries;
+            unsigned m_min_unsat;       // fewest falsified clauses seen
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); m_min_unsat = UINT_MAX; }
+        };
+
+        static const unsigned c_max_break = 64;
+
+        reslimit&               m_limit;
+        random_gen              m_rand;
+        config                  m_config;
+        stats                   m_stats;
+        bool                    m_inconsistent;  // some clause is false under the base assignment
+
+        // clauses: literals of clause i are m_lits[m_begin[i] .. m_begin[i+1])
+        literal_vector          m_lits;
+        unsigned_vector         m_begin;
+        vector<unsigned_vector> m_occs;          // clauses in which a literal occurs
+
+        svector<lbool>          m_fixed;         // base level value of variables, l_undef if free
+        svector<bool>           m_value;         // current value of variables
+        svector<bool>           m_best;          // value of variables in the best assignment
+        unsigned                m_best_unsat;
+        unsigned_vector         m_num_true;      // number of true literals of a clause
+        unsigned_vector         m_true_xor;      // xor of the true variables of a clause
+        unsigned_vector         m_break;         // number of clauses in which a variable is critical
+        unsigned_vector         m_unsat;         // falsified clauses
+        unsigned_vector         m_unsat_idx;     // position of a clause in m_unsat
+        double                  m_prob_break[c_max_break];
+        svector<double>         m_probs;
+        model                   m_model;
+
+        unsigned num_clauses() const { return m_begin.size() - 1; }
+        bool is_true(literal l) const { return m_value[l.var()] != l.sign(); }
+        void add_clause(unsigned n, literal const* lits);
+        void set_unsat(unsigned c);
+        void set_sat(unsigned c);
+        void init_try();
+        void flip(bool_var v);
+        bool_var pick_var(unsigned c);
+        void save_best();
+
+    public:
+        local_search(reslimit& lim, unsigned random_seed, unsigned max_flips, double cb);
+
+        /**
+           \brief copy the irredundant clauses of s. Clauses are simplified
+           with respect to the assignment of s and the given assumptions.
+           The initial assignment is taken from the phase cache of s.
+         */
+        void import(solver const& s, unsigned num_assumptions, literal const* assumptions);
+
+        /**
+           \brief run up to max_tries tries of local search (0 for no bound).
+           Returns l_true if a satisfying assignment was found, and l_undef
+           otherwise. Tries after the first one restart from the best assignment.
+         */
+        lbool check(unsigned max_tries);
+
+        model const& get_model() const { return m_model; }
+
+        /**
+           \brief value of v in the best assignment found.
+         */
+        bool best_phase(bool_var v) const { return m_best[v]; }
+
+        unsigned best_unsat() const { return m_best_unsat; }
+
+        void collect_statistics(statistics& st) const;
+    };
+};
+
+#endif
@@ -0,0 +1,360 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_lookahead.cpp
+
+Abstract:
+
+    Lookahead based cuber for cube-and-conquer.
+
+Author:
+
+    agent (agent@local) 2026-10-15
+
+Revision History:
+
+--*/
+#include "sat/sat_lookahead.h"
+#include "sat/sat_solver.h"
+
+namespace sat {
+
+    struct lookahead_rating_lt {
+        svector<double> const& m_rating;
+        lookahead_rating_lt(svector<double> const& r): m_rating(r) {}
+        bool operator()(bool_var v1, bool_var v2) const {
+            return m_rating[v1] > m_rating[v2];
+        }
+    };
+
+    lookahead::lookahead(solver& s):
+        s(s),
+        m_qhead(0),
+        m_inconsistent(false),
+        m_reduce(0) {
+        m_config.m_max_depth      = s.m_config.m_lookahead_depth;
+        m_config.m_max_candidates = s.m_config.m_lookahead_candidates;
+        m_config.m_double         = s.m_config.m_lookahead_double;
+        m_config.m_dl_trigger     = 5.0;
+        double w = 1.0;
+        for (unsigned i = 0; i < 16; ++i) {
+            // clauses reduced to size i+2
+            m_weights[i] = w;
+            w /= 5.0;
+        }
+    }
+
+    void lookahead::init() {
+        unsigned num_lits = 2 * s.num_vars();
+        m_binary.reset();
+        m_clauses.reset();
+        m_occs.reset();
+        m_binary.resize(num_lits);
+        m_occs.resize(num_lits);
+        m_value.reset();
+        m_value.resize(num_lits, l_undef);
+        m_lit_reduce.reset();
+        m_lit_reduce.resize(num_lits, 0.0);
+        m_rating.reset();
+        m_rating.resize(s.num_vars(), 0.0);
+        m_trail.reset();
+        m_trail_lim.reset();
+        m_qhead = 0;
+        m_inconsistent = false;
+        m_free_vars.reset();
+
+        for (bool_var v = 0; v < s.num_vars(); ++v) {
+            if (s.value(v) == l_undef && !s.was_eliminated(v) && s.m_decision[v]) {
+                m_free_vars.push_back(v);
+            }
+        }
+
+        // binary clauses, the watch list of l contains the literals implied by l.
+        for (unsigned l_idx = 0; l_idx < num_lits; ++l_idx) {
+            literal l = to_literal(l_idx);
+            if (s.value(l) != l_undef) continue;
+            watch_list const& wlist = s.m_watches[l_idx];
+            watch_list::const_iterator it = wlist.begin(), end = wlist.end();
+            for (; it != end; ++it) {
+                if (it->is_binary_clause() && s.value(it->get_literal()) == l_undef) {
+                    m_binary[l_idx].push_back(it->get_literal());
+                }
+            }
+        }
+
+        // other clauses, simplified with respect to the base level assignment.
+        literal_vector lits;
+        clause_vector::const_iterator it = s.m_clauses.begin(), end = s.m_clauses.end();
+        for (; it != end; ++it) {
+            clause const& c = *(*it);
+            lits.reset();
+            bool is_sat = false;
+            for (unsigned i = 0; !is_sat && i < c.size(); ++i) {
+                switch (s.value(c[i])) {
+                case l_true:  is_sat = true; break;
+                case l_false: break;
+                case l_undef: lits.push_back(c[i]); break;
+                }
+            }
+            if (is_sat) {
+                continue;
+            }
+            SASSERT(lits.size() >= 2);
+            if (lits.size() == 2) {
+                m_binary[(~lits[0]).index()].push_back(lits[1]);
+                m_binary[(~lits[1]).index()].push_back(lits[0]);
+                continue;
+            }
+            unsigned idx = m_clauses.size();
+            m_clauses.push_back(lits);
+            for (unsigned i = 0; i < lits.size(); ++i) {
+                m_occs[lits[i].index()].push_back(idx);
+            }
+        }
+    }
+
+    void lookahead::checkpoint() {
+        s.checkpoint();
+    }
+
+    void lookahead::assign(literal l) {
+        switch (value(l)) {
+        case l_true:
+            break;
+        case l_false:
+            m_inconsistent = true;
+            break;
+        case l_undef:
+            m_value[l.index()] = l_true;
+            m_value[(~l).index()] = l_false;
+            m_trail.push_back(l);
+            break;
+        }
+    }
+
+    void lookahead::propagate() {
+        while (!m_inconsistent && m_qhead < m_trail.size()) {
+            literal l = m_trail[m_qhead++];
+            ++m_stats.m_propagations;
+            literal_vector const& bins = m_binary[l.index()];
+            for (unsigned i = 0; !m_inconsistent && i < bins.size(); ++i) {
+                assign(bins[i]);
+            }
+            unsigned_vector const& occs = m_occs[(~l).index()];
+            for (unsigned i = 0; !m_inconsistent && i < occs.size(); ++i) {
+                literal_vector const& c = m_clauses[occs[i]];
+                unsigned num_undef = 0;
+                literal unit = null_literal;
+                bool is_sat = false;
+                for (unsigned j = 0; !is_sat && j < c.size(); ++j) {
+                    switch (value(c[j])) {
+                    case l_true:  is_sat = true; break;
+                    case l_false: break;
+                    case l_undef: ++num_undef; unit = c[j]; break;
+                    }
+                }
+                if (is_sat) {
+                    continue;
+                }
+                switch (num_undef) {
+                case 0:
+                    m_inconsistent = true;
+                    break;
+                case 1:
+                    assign(unit);
+                    break;
+                default:
+                    if (num_undef - 2 < 16) {
+                        m_reduce += m_weights[num_undef - 2];
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    void lookahead::push() {
+        SASSERT(!m_inconsistent);
+        m_trail_lim.push_back(m_trail.size());
+    }
+
+    void lookahead::pop() {
+        unsigned old_sz = m_trail_lim.back();
+        m_trail_lim.pop_back();
+        for (unsigned i = old_sz; i < m_trail.size(); ++i) {
+            literal l = m_trail[i];
+            m_value[l.index()] = l_undef;
+            m_value[(~l).index()] = l_undef;
+        }
+        m_trail.shrink(old_sz);
+        m_qhead = old_sz;
+        m_inconsistent = false;
+    }
+
+    /**
+       \brief preselect the free variables with the most occurrences
+       in binary clauses and (weighted) in longer clauses.
+     */
+    void lookahead::init_candidates() {
+        m_candidates.reset();
+        for (unsigned i = 0; i < m_free_vars.size(); ++i) {
+            bool_var v = m_free_vars[i];
+            if (value(literal(v, false)) != l_undef) continue;
+            double h[2];
+            for (unsigned j = 0; j < 2; ++j) {
+                literal l(v, j == 1);
+                h[j] = 1 + m_binary[(~l).index()].size() + 0.2 * m_occs[l.index()].size();
+            }
+            m_rating[v] = h[0] * h[1];
+            m_candidates.push_back(v);
+        }
+        lookahead_rating_lt lt(m_rating);
+        std::sort(m_candidates.begin(), m_candidates.end(), lt);
+        if (m_candidates.size() > m_config.m_max_candidates) {
+            m_candidates.shrink(m_config.m_max_candidates);
+        }
+    }
+
+    /**
+       \brief assign l, measure the reduction and check for conflicts.
+       Returns false if l is a failed literal.
+     */
+    bool lookahead::try_literal(literal l, double& reduce) {
+        ++m_stats.m_lookaheads;
+        push();
+        m_reduce = 0;
+        assign(l);
+        propagate();
+        bool ok = !m_inconsistent;
+        reduce = m_reduce;
+        if (ok && m_config.m_double && reduce >= m_config.m_dl_trigger) {
+            ok = double_lookahead();
+        }
+        pop();
+        return ok;
+    }
+
+    /**
+       \brief lookahead on the candidates under the current assignment.
+       Returns false if some candidate fails in both phases.
+     */
+    bool lookahead::double_lookahead() {
+        ++m_stats.m_double_lookaheads;
+        bool found = false;
+        for (unsigned i = 0; !m_inconsistent && i < m_candidates.size(); ++i) {
+            for (unsigned j = 0; !m_inconsistent && j < 2; ++j) {
+                literal l(m_candidates[i], j == 1);
+                if (value(l) != l_undef) continue;
+                push();
+                assign(l);
+                propagate();
+                bool failed = m_inconsistent;
+                pop();
+                if (failed) {
+                    found = true;
+                    assign(~l);
+                    propagate();
+                }
+            }
+        }
+        if (!found) {
+            // unproductive double lookaheads become rarer.
+            m_config.m_dl_trigger *= 1.25;
+        }
+        return !m_inconsistent;
+    }
+
+    /**
+       \brief lookahead on the candidate literals, asserting failed literals.
+       Returns false if the current node is unsatisfiable.
+     */
+    bool lookahead::lookahead_round() {
+        init_candidates();
+        bool progress = true;
+        while (progress && !m_inconsistent) {
+            checkpoint();
+            progress = false;
+            for (unsigned i = 0; !m_inconsistent && i < m_candidates.size(); ++i) {
+                for (unsigned j = 0; !m_inconsistent && j < 2; ++j) {
+                    literal l(m_candidates[i], j == 1);
+                    if (value(l) != l_undef) continue;
+                    double reduce = 0;
+                    if (try_literal(l, reduce)) {
+                        m_lit_reduce[l.index()] = reduce;
+                    }
+                    else {
+                        ++m_stats.m_failed_literals;
+                        progress = true;
+                        assign(~l);
+                        propagate();
+                    }
+                }
+            }
+        }
+        return !m_inconsistent;
+    }
+
+    literal lookahead::select_literal() {
+        literal result = null_literal;
+        double best = -1;
+        for (unsigned i = 0; i < m_candidates.size(); ++i) {
+            bool_var v = m_candidates[i];
+            literal l(v, false);
+            if (value(l) != l_undef) continue;
+            double pos = m_lit_reduce[l.index()], neg = m_lit_reduce[(~l).index()];
+            double score = 1024 * pos * neg + pos + neg;
+            if (score > best) {
+                best = score;
+                result = pos >= neg ? l : ~l;
+            }
+        }
+        return result;
+    }
+
+    void lookahead::cube(literal_vector& path, vector<literal_vector>& cubes) {
+        if (!lookahead_round()) {
+            return;
+        }
+        literal l = path.size() < m_config.m_max_depth ? select_literal() : null_literal;
+        if (l == null_literal) {
+            ++m_stats.m_cubes;
+            cubes.push_back(path);
+            return;
+        }
+        for (unsigned i = 0; i < 2; ++i, l.neg()) {
+            push();
+            assign(l);
+            propagate();
+            if (!m_inconsistent) {
+                path.push_back(l);
+                cube(path, cubes);
+                path.pop_back();
+            }
+            pop();
+        }
+    }
+
+    lbool lookahead::operator()(vector<literal_vector>& cubes) {
+        SASSERT(s.scope_lvl() == 0);
+        if (s.inconsistent()) {
+            return l_false;
+        }
+        init();
+        literal_vector path;
+        cube(path, cubes);
+        IF_VERBOSE(1, verbose_stream() << "(sat-lookahead :cubes " << m_stats.m_cubes
+                   << " :failed-literals " << m_stats.m_failed_literals
+                   << " :double-lookaheads " << m_stats.m_double_lookaheads << ")\n";);
+        return cubes.empty() ? l_false : l_undef;
+    }
+
+    void lookahead::collect_statistics(statistics& st) const {
+        st.update("lookahead propagations", m_stats.m_propagations);
+        st.update("lookahead lookaheads", m_stats.m_lookaheads);
+        st.update("lookahead double lookaheads", m_stats.m_double_lookaheads);
+        st.update("lookahead failed literals", m_stats.m_failed_literals);
+        st.update("lookahead cubes", m_stats.m_cubes);
+    }
+};
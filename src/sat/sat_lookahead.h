@@ -0,0 +1,105 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_lookahead.h
+
+Abstract:
+
+    Lookahead based cuber for cube-and-conquer.
+
+    The cuber works on a copy of the clauses of a SAT solver that is
+    at base level. At every node of its search tree it performs a
+    lookahead on a set of preselected candidate variables, asserting
+    failed literals (optionally detected using double lookahead), and
+    branches on the variable whose two phases reduce the remaining
+    clauses the most. The reduction of a literal is the weighted number
+    of clauses that get shortened, but not satisfied, by assigning it.
+    Leaves of the search tree are returned as cubes.
+
+Author:
+
+    agent (agent@local) 2026-10-15
+
+Revision History:
+
+--*/
+#ifndef SAT_LOOKAHEAD_H_
+#define SAT_LOOKAHEAD_H_
+
+#include "sat/sat_types.h"
+#include "util/statistics.h"
+
+namespace sat {
+
+    class solver;
+
+    class lookahead {
+
+        struct config {
+            unsigned m_max_depth;       // maximal number of decisions in a cube
+            unsigned m_max_candidates;  // number of variables considered for lookahead
+            bool     m_double;          // enable double lookahead
+            double   m_dl_trigger;      // minimal reduction for which double lookahead is attempted
+        };
+
+        struct stats {
+            unsigned m_propagations;
+            unsigned m_lookaheads;
+            unsigned m_double_lookaheads;
+            unsigned m_failed_literals;
+            unsigned m_cubes;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        solver &                 s;
+        config                   m_config;
+        stats                    m_stats;
+        vector<literal_vector>   m_binary;       // literals implied by a literal via binary clauses
+        vector<literal_vector>   m_clauses;      // clauses of size at least three
+        vector<unsigned_vector>  m_occs;         // clauses in which a literal occurs
+        svector<lbool>           m_value;        // value of literals
+        svector<double>          m_rating;       // preselection rating of literals
+        svector<double>          m_lit_reduce;   // reduction measured in the last lookahead on a literal
+        double                   m_weights[16];  // weight of a reduced clause by its remaining size
+        literal_vector           m_trail;
+        unsigned_vector          m_trail_lim;
+        unsigned                 m_qhead;
+        bool                     m_inconsistent;
+        double                   m_reduce;       // reduction accumulated by propagate
+        bool_var_vector          m_candidates;
+        bool_var_vector          m_free_vars;
+
+        lbool value(literal l) const { return m_value[l.index()]; }
+        void init();
+        void assign(literal l);
+        void propagate();
+        void push();
+        void pop();
+        void checkpoint();
+
+        void init_candidates();
+        bool lookahead_round();
+        bool try_literal(literal l, double& reduce);
+        bool double_lookahead();
+        literal select_literal();
+        void cube(literal_vector& path, vector<literal_vector>& cubes);
+
+    public:
+        lookahead(solver& s);
+
+        /**
+           \brief split the clauses of s into cubes.
+           Returns l_false if the clauses are unsatisfiable,
+           and l_undef otherwise. The disjunction of the cubes is implied
+           by the clauses of s.
+         */
+        lbool operator()(vector<literal_vector>& cubes);
+
+        void collect_statistics(statistics& st) const;
+    };
+};
+
+#endif
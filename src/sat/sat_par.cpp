@@ -21,25 +21,86 @@ Revision History:
 
 namespace sat {
 
-    par::par() {}
-
-    void par::exchange(literal_vector const& in, unsigned& limit, literal_vector& out) {
-        #pragma omp critical (par_solver)
-        {
-            if (limit < m_units.size()) {
-                // this might repeat some literals.
-                out.append(m_units.size() - limit, m_units.c_ptr() + limit);
+    par::ring::ring(unsigned log_capacity):
+        m_data(1ull << log_capacity),
+        m_mask((1ull << log_capacity) - 1),
+        m_reserved(0),
+        m_tail(0) {
+        for (unsigned i = 0; i < m_data.size(); ++i) {
+            m_data[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void par::ring::push(unsigned sz, literal const* lits) {
+        SASSERT(sz <= max_vector_size());
+        uint64 pos = m_tail.load(std::memory_order_relaxed);
+        // announce the words about to be overwritten before touching them.
+        m_reserved.store(pos + sz + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_data[pos & m_mask].store(sz, std::memory_order_relaxed);
+        for (unsigned i = 0; i < sz; ++i) {
+            m_data[(pos + 1 + i) & m_mask].store(lits[i].index(), std::memory_order_relaxed);
+        }
+        m_tail.store(pos + sz + 1, std::memory_order_release);
+    }
+
+    void par::ring::read(uint64& head, literal_vector& lits, unsigned_vector& sizes) const {
+        uint64 capacity = m_mask + 1;
+        uint64 tail = m_tail.load(std::memory_order_acquire);
+        if (tail <= head) {
+            return;
+        }
+        if (tail - head > capacity) {
+            // the reader was lapped: the vectors starting at head are gone.
+            head = tail;
+            return;
+        }
+        unsigned old_lits = lits.size(), old_sizes = sizes.size();
+        uint64 pos = head;
+        while (pos < tail) {
+            unsigned sz = m_data[pos & m_mask].load(std::memory_order_relaxed);
+            if (pos + sz + 1 > tail) {
+                break;
             }
-            for (unsigned i = 0; i < in.size(); ++i) {
-                literal lit = in[i];
-                if (!m_unit_set.contains(lit.index())) {
-                    m_unit_set.insert(lit.index());
-                    m_units.push_back(lit);
-                }
+            for (unsigned i = 0; i < sz; ++i) {
+                lits.push_back(to_literal(m_data[(pos + 1 + i) & m_mask].load(std::memory_order_relaxed)));
+            }
+            sizes.push_back(sz);
+            pos += sz + 1;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64 reserved = m_reserved.load(std::memory_order_relaxed);
+        if (reserved - head > capacity || pos != tail) {
+            // the writer entered the epoch following head while we were copying.
+            lits.shrink(old_lits);
+            sizes.shrink(old_sizes);
+            head = reserved;
+            return;
+        }
+        head = tail;
+    }
+
+    par::par(unsigned num_threads) {
+        for (unsigned i = 0; i < num_threads; ++i) {
+            m_rings.push_back(alloc(ring, 18));
+            m_heads.push_back(svector<uint64>(num_threads, 0ull));
+        }
+    }
+
+    void par::share_clause(unsigned owner, unsigned sz, literal const* lits) {
+        ring& r = *m_rings[owner];
+        if (sz <= r.max_vector_size()) {
+            r.push(sz, lits);
+        }
+    }
+
+    void par::get_clauses(unsigned owner, literal_vector& lits, unsigned_vector& sizes) {
+        svector<uint64>& heads = m_heads[owner];
+        for (unsigned j = 0; j < m_rings.size(); ++j) {
+            if (j != owner) {
+                m_rings[j]->read(heads[j], lits, sizes);
             }
-            limit = m_units.size();
         }
     }
     
 };
-
@@ -9,6 +9,13 @@ Abstract:
 
     Utilities for parallel SAT solving.
 
+    Units and learned clauses are exchanged through one ring buffer 
+    per producing thread. A ring has a single writer and is read by 
+    all other threads without locks. Positions in a ring are absolute
+    64-bit word counts, so the epoch of a position (position / capacity)
+    tells readers whether the words they copied were overwritten in
+    the mean time.
+
 Author:
 
     Nikolaj Bjorner (nbjorner) 2017-1-29.
@@ -19,19 +26,52 @@ Revision History:
 #ifndef SAT_PAR_H_
 #define SAT_PAR_H_
 
+#include <atomic>
+#include <vector>
 #include "sat/sat_types.h"
-#include "util/hashtable.h"
-#include "util/map.h"
+#include "util/scoped_ptr_vector.h"
 
 namespace sat {
 
     class par {
-        typedef hashtable<unsigned, u_hash, u_eq> index_set;
-        literal_vector m_units;
-        index_set      m_unit_set;
+
+        /**
+           \brief single-writer, multi-reader ring of literal vectors.
+           Each vector is stored as its size followed by the literal indices.
+        */
+        class ring {
+            std::vector<std::atomic<unsigned> > m_data;
+            uint64                m_mask;
+            std::atomic<uint64>   m_reserved;  // words claimed by the writer.
+            std::atomic<uint64>   m_tail;      // words published to readers.
+        public:
+            ring(unsigned log_capacity);
+            unsigned max_vector_size() const { return static_cast<unsigned>(m_mask >> 2); }
+            void push(unsigned sz, literal const* lits);
+            void read(uint64& head, literal_vector& lits, unsigned_vector& sizes) const;
+        };
+
+        scoped_ptr_vector<ring>  m_rings;   // ring written by thread i.
+        vector<svector<uint64> > m_heads;   // m_heads[i][j]: position of thread i in ring j.
+
     public:
-        par();
-        void exchange(literal_vector const& in, unsigned& limit, literal_vector& out);
+        par(unsigned num_threads);
+
+        unsigned num_threads() const { return m_rings.size(); }
+
+        /**
+           \brief publish a unit or learned clause of the given owner to the other threads.
+           Only the owner thread may call this method.
+         */
+        void share_clause(unsigned owner, unsigned sz, literal const* lits);
+
+        /**
+           \brief retrieve the clauses (and units) exported by other threads since the 
+           last call by the given owner. The literals of the clauses are appended to lits, 
+           their sizes to sizes. Clauses that were overwritten before they could be read 
+           are dropped.
+         */
+        void get_clauses(unsigned owner, literal_vector& lits, unsigned_vector& sizes);
     };
 
 };
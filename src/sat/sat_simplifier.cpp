@@ -8,7 +8,8 @@ Module Name:
 Abstract:
 
     SAT simplification procedures that use a "full" occurrence list:
-    Subsumption, Blocked Clause Removal, Variable Elimination, ...
+    Subsumption, Blocked Clause Removal, Variable Elimination,
+    Bounded Variable Addition, ...
 
 
 Author:
@@ -188,6 +189,9 @@ namespace sat {
 
         scoped_finalize _scoped_finalize(*this);
 
+        if (!learned)
+            bva();
+
         do {
             if (m_subsumption)
                 subsume();
@@ -554,6 +558,7 @@ namespace sat {
         bool r = false;
         unsigned sz = c.size();
         unsigned j  = 0;
+        if (s.m_config.m_drat) s.m_drat.save(c);
         for (unsigned i = 0; i < sz; i++) {
             literal l = c[i];
             switch (value(l)) {
@@ -577,6 +582,7 @@ namespace sat {
             }
         }
         c.shrink(j);
+        if (s.m_config.m_drat) s.m_drat.update(c);
         return r;
     }
 
@@ -645,7 +651,9 @@ namespace sat {
         m_need_cleanup = true;
         m_num_elim_lits++;
         insert_elim_todo(l.var());
+        if (s.m_config.m_drat) s.m_drat.save(c);
         c.elim(l);
+        if (s.m_config.m_drat) s.m_drat.update(c);
         clause_use_list & occurs = m_use_list.get(l);
         occurs.erase_not_removed(c);
         m_sub_counter -= occurs.size()/2;
@@ -769,6 +777,9 @@ namespace sat {
                     TRACE("subsumption", tout << "eliminating: " << ~to_literal(l_idx)
                           << " " << it2->get_literal() << "\n";);
                     elim++;
+                    literal l1 = ~to_literal(static_cast<unsigned>(it - s.m_watches.begin()));
+                    if (s.m_config.m_drat && l1.index() < last_lit.index())
+                        s.m_drat.del(l1, last_lit);
                 }
                 else {
                     last_lit = it2->get_literal();
@@ -1007,6 +1018,7 @@ namespace sat {
                             new_entry = &(mc.mk(model_converter::BLOCK_LIT, l.var()));
                         TRACE("blocked_clause", tout << "new blocked clause: " << l2 << " " << l << "\n";);
                         s.remove_bin_clause_half(l2, l, it->is_learned());
+                        if (s.s.m_config.m_drat) s.s.m_drat.del(l, l2);
                         s.m_num_blocked_clauses++;
                         m_queue.decreased(~l2);
                         mc.insert(*new_entry, l, l2);
@@ -1214,6 +1226,193 @@ namespace sat {
         return res;
     }
 
+    /**
+       \brief Find a definition of the variable of x as an AND gate of the form
+       x <-> (~l1 & ... & ~lk), given by the clause (x or l1 or ... or lk) and
+       the binary clauses (~x or ~li).
+    */
+    bool simplifier::find_and_gate(literal x) {
+        clause_wrapper_vector const & xs = x.sign() ? m_neg_cls : m_pos_cls;
+        clause_wrapper_vector const & ys = x.sign() ? m_pos_cls : m_neg_cls;
+        svector<char> & xg = x.sign() ? m_neg_gate : m_pos_gate;
+        svector<char> & yg = x.sign() ? m_pos_gate : m_neg_gate;
+        for (unsigned i = 0; i < ys.size(); ++i) {
+            if (ys[i].is_binary()) {
+                SASSERT(ys[i][0] == ~x);
+                mark_visited(ys[i][1]);
+            }
+        }
+        bool found = false;
+        for (unsigned i = 0; !found && i < xs.size(); ++i) {
+            clause_wrapper const & c = xs[i];
+            m_elim_counter -= c.size();
+            found = true;
+            for (unsigned j = 0; found && j < c.size(); ++j) {
+                found = c[j] == x || is_marked(~c[j]);
+            }
+            if (found) {
+                xg[i] = true;
+                for (unsigned j = 0; j < ys.size(); ++j) {
+                    if (ys[j].is_binary() && c.contains(~ys[j][1])) {
+                        yg[j] = true;
+                    }
+                }
+            }
+        }
+        for (unsigned i = 0; i < ys.size(); ++i) {
+            if (ys[i].is_binary()) {
+                unmark_visited(ys[i][1]);
+            }
+        }
+        return found;
+    }
+
+    /**
+       \brief Find a definition of the variable being eliminated as an XOR of
+       at most four other variables, given by all the clauses over the same
+       variables that have the same parity.
+    */
+    bool simplifier::find_xor_gate(bool_var v) {
+        unsigned const max_size = 5;
+        unsigned num_tries = 0;
+        for (unsigned i = 0; i < m_pos_cls.size() && num_tries < 8; ++i) {
+            clause_wrapper const & c = m_pos_cls[i];
+            unsigned sz = c.size();
+            if (sz < 3 || sz > max_size)
+                continue;
+            ++num_tries;
+            bool_var vars[max_size];
+            unsigned parity = 0;
+            for (unsigned j = 0; j < sz; ++j) {
+                vars[j] = c[j].var();
+                parity ^= c[j].sign();
+                mark_visited(literal(vars[j], false));
+            }
+            unsigned num_masks = 0, found = 0;
+            unsigned pos_idx[1 << max_size], neg_idx[1 << max_size];
+            for (unsigned k = 0; k < 2; ++k) {
+                clause_wrapper_vector const & cs = k == 0 ? m_pos_cls : m_neg_cls;
+                for (unsigned j = 0; j < cs.size(); ++j) {
+                    clause_wrapper const & d = cs[j];
+                    if (d.size() != sz)
+                        continue;
+                    m_elim_counter -= sz;
+                    unsigned mask = 0, p = 0;
+                    bool same_vars = true;
+                    for (unsigned l = 0; same_vars && l < sz; ++l) {
+                        same_vars = is_marked(literal(d[l].var(), false));
+                        unsigned pos = 0;
+                        while (pos < sz && vars[pos] != d[l].var()) ++pos;
+                        if (d[l].sign()) {
+                            mask |= 1 << pos;
+                            p ^= 1;
+                        }
+                    }
+                    if (!same_vars || p != parity || (found & (1u << mask)) != 0)
+                        continue;
+                    found |= 1u << mask;
+                    ++num_masks;
+                    (k == 0 ? pos_idx : neg_idx)[mask] = j;
+                }
+            }
+            for (unsigned j = 0; j < sz; ++j) {
+                unmark_visited(literal(vars[j], false));
+            }
+            if (num_masks == (1u << (sz - 1))) {
+                unsigned v_bit = 0;
+                while (vars[v_bit] != v) ++v_bit;
+                for (unsigned mask = 0; mask < (1u << sz); ++mask) {
+                    if ((found & (1u << mask)) == 0)
+                        continue;
+                    if (mask & (1u << v_bit))
+                        m_neg_gate[neg_idx[mask]] = true;
+                    else
+                        m_pos_gate[pos_idx[mask]] = true;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+       \brief Return the index of the ternary clause (l1 or l2 or l3) in cs, or UINT_MAX.
+    */
+    unsigned simplifier::find_ternary(clause_wrapper_vector const & cs, literal l1, literal l2, literal l3) const {
+        for (unsigned i = 0; i < cs.size(); ++i) {
+            clause_wrapper const & c = cs[i];
+            if (c.size() == 3 && c.contains(l1) && c.contains(l2) && c.contains(l3))
+                return i;
+        }
+        return UINT_MAX;
+    }
+
+    /**
+       \brief Find a definition of v as an if-then-else v <-> ite(c, t, e), given by
+       the clauses (~v or ~c or t), (~v or c or e), (v or ~c or ~t), (v or c or ~e).
+    */
+    bool simplifier::find_ite_gate(bool_var v) {
+        literal pos_l(v, false);
+        literal neg_l(v, true);
+        unsigned const max_ternary = 32;
+        unsigned_vector ternary;
+        for (unsigned i = 0; i < m_neg_cls.size() && ternary.size() < max_ternary; ++i) {
+            if (m_neg_cls[i].size() == 3)
+                ternary.push_back(i);
+        }
+        for (unsigned i = 0; i < ternary.size(); ++i) {
+            clause_wrapper const & c1 = m_neg_cls[ternary[i]];
+            for (unsigned j = i + 1; j < ternary.size(); ++j) {
+                clause_wrapper const & c2 = m_neg_cls[ternary[j]];
+                m_elim_counter -= 6;
+                for (unsigned k = 0; k < 3; ++k) {
+                    literal c = c1[k];
+                    if (c == neg_l || !c2.contains(~c))
+                        continue;
+                    literal t = null_literal, e = null_literal;
+                    for (unsigned l = 0; l < 3; ++l) {
+                        if (c1[l] != neg_l && c1[l] != c) t = c1[l];
+                        if (c2[l] != neg_l && c2[l] != ~c) e = c2[l];
+                    }
+                    if (t.var() == e.var() || t.var() == c.var() || e.var() == c.var())
+                        continue;
+                    unsigned i3 = find_ternary(m_pos_cls, pos_l, c, ~t);
+                    if (i3 == UINT_MAX)
+                        continue;
+                    unsigned i4 = find_ternary(m_pos_cls, pos_l, ~c, ~e);
+                    if (i4 == UINT_MAX)
+                        continue;
+                    m_neg_gate[ternary[i]] = true;
+                    m_neg_gate[ternary[j]] = true;
+                    m_pos_gate[i3] = true;
+                    m_pos_gate[i4] = true;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+       \brief Find a gate definition of v among the clauses in m_pos_cls and m_neg_cls.
+       Resolvents between two gate clauses are tautologies, and resolvents between
+       two non-gate clauses are implied by the other resolvents, so only gate clauses
+       need to be resolved with non-gate clauses.
+    */
+    bool simplifier::find_gate(bool_var v) {
+        m_pos_gate.reset();
+        m_pos_gate.resize(m_pos_cls.size(), false);
+        m_neg_gate.reset();
+        m_neg_gate.resize(m_neg_cls.size(), false);
+        if (!m_elim_gates)
+            return false;
+        return
+            find_and_gate(literal(v, false)) ||
+            find_and_gate(literal(v, true)) ||
+            find_xor_gate(v) ||
+            find_ite_gate(v);
+    }
+
     void simplifier::save_clauses(model_converter::entry & mc_entry, clause_wrapper_vector const & cs) {
         model_converter & mc = s.m_mc;
         clause_wrapper_vector::const_iterator it  = cs.begin();
@@ -1275,6 +1474,8 @@ namespace sat {
                 }
                 wlist2.set_end(itprev);
                 m_sub_bin_todo.erase(bin_clause(l, l2, it->is_learned()));
+                // non-learned binary clauses are deleted after their resolvents are added.
+                if (s.m_config.m_drat && it->is_learned()) s.m_drat.del(l, l2);
             }
         }
         TRACE("bin_clause_bug", tout << "collapsing watch_list of: " << l << "\n";);
@@ -1315,7 +1516,9 @@ namespace sat {
 
         TRACE("resolution", tout << v << " num_pos: " << num_pos << " neg_pos: " << num_neg << "\n";);
 
-        if (num_pos >= m_res_occ_cutoff && num_neg >= m_res_occ_cutoff)
+        // variables with many occurrences are only eliminated if they are defined by a gate.
+        bool over_cutoff = num_pos >= m_res_occ_cutoff && num_neg >= m_res_occ_cutoff;
+        if (over_cutoff && !m_elim_gates)
             return false;
 
         unsigned before_lits = num_bin_pos*2 + num_bin_neg*2;
@@ -1339,12 +1542,14 @@ namespace sat {
         TRACE("resolution", tout << v << " num_pos: " << num_pos << " neg_pos: " << num_neg << " before_lits: " << before_lits << "\n";);
 
         if (num_pos >= m_res_occ_cutoff3 && num_neg >= m_res_occ_cutoff3 && before_lits > m_res_lit_cutoff3 && s.m_clauses.size() > m_res_cls_cutoff2)
-            return false;
+            over_cutoff = true;
         if (num_pos >= m_res_occ_cutoff2 && num_neg >= m_res_occ_cutoff2 && before_lits > m_res_lit_cutoff2 &&
             s.m_clauses.size() > m_res_cls_cutoff1 && s.m_clauses.size() <= m_res_cls_cutoff2)
-            return false;
+            over_cutoff = true;
         if (num_pos >= m_res_occ_cutoff1 && num_neg >= m_res_occ_cutoff1 && before_lits > m_res_lit_cutoff1 &&
             s.m_clauses.size() <= m_res_cls_cutoff1)
+            over_cutoff = true;
+        if (over_cutoff && !m_elim_gates)
             return false;
 
         m_pos_cls.reset();
@@ -1352,21 +1557,24 @@ namespace sat {
         collect_clauses(pos_l, m_pos_cls);
         collect_clauses(neg_l, m_neg_cls);
 
+        bool has_gate = find_gate(v);
+        if (over_cutoff && !has_gate)
+            return false;
+        TRACE("resolution", if (has_gate) tout << v << " is defined by a gate\n";);
+
         m_elim_counter -= num_pos * num_neg + before_lits;
 
         TRACE("resolution_detail", tout << "collecting number of after_clauses\n";);
         unsigned before_clauses = num_pos + num_neg;
         unsigned after_clauses  = 0;
-        clause_wrapper_vector::iterator it1  = m_pos_cls.begin();
-        clause_wrapper_vector::iterator end1 = m_pos_cls.end();
-        for (; it1 != end1; ++it1) {
-            clause_wrapper_vector::iterator it2  = m_neg_cls.begin();
-            clause_wrapper_vector::iterator end2 = m_neg_cls.end();
-            for (; it2 != end2; ++it2) {
+        for (unsigned i = 0; i < m_pos_cls.size(); ++i) {
+            for (unsigned j = 0; j < m_neg_cls.size(); ++j) {
+                if (has_gate && m_pos_gate[i] == m_neg_gate[j])
+                    continue;
                 m_new_cls.reset();
-                if (resolve(*it1, *it2, pos_l, m_new_cls)) {
-                    TRACE("resolution_detail", tout << *it1 << "\n" << *it2 << "\n-->\n";
-                          for (unsigned i = 0; i < m_new_cls.size(); i++) tout << m_new_cls[i] << " "; tout << "\n";);
+                if (resolve(m_pos_cls[i], m_neg_cls[j], pos_l, m_new_cls)) {
+                    TRACE("resolution_detail", tout << m_pos_cls[i] << "\n" << m_neg_cls[j] << "\n-->\n";
+                          for (unsigned k = 0; k < m_new_cls.size(); k++) tout << m_new_cls[k] << " "; tout << "\n";);
                     after_clauses++;
                     if (after_clauses > before_clauses) {
                         TRACE("resolution", tout << "too many after clauses: " << after_clauses << "\n";);
@@ -1376,6 +1584,8 @@ namespace sat {
             }
         }
         TRACE("resolution", tout << "found var to eliminate, before: " << before_clauses << " after: " << after_clauses << "\n";);
+        if (has_gate)
+            m_num_elim_gates++;
 
 
         // eliminate variable
@@ -1392,16 +1602,14 @@ namespace sat {
 
         m_elim_counter -= num_pos * num_neg + before_lits;
 
-        it1  = m_pos_cls.begin();
-        end1 = m_pos_cls.end();
-        for (; it1 != end1; ++it1) {
-            clause_wrapper_vector::iterator it2  = m_neg_cls.begin();
-            clause_wrapper_vector::iterator end2 = m_neg_cls.end();
-            for (; it2 != end2; ++it2) {
+        for (unsigned i = 0; i < m_pos_cls.size(); ++i) {
+            for (unsigned j = 0; j < m_neg_cls.size(); ++j) {
+                if (has_gate && m_pos_gate[i] == m_neg_gate[j])
+                    continue;
                 m_new_cls.reset();
-                if (!resolve(*it1, *it2, pos_l, m_new_cls))
+                if (!resolve(m_pos_cls[i], m_neg_cls[j], pos_l, m_new_cls))
                     continue;
-                TRACE("resolution_new_cls", tout << *it1 << "\n" << *it2 << "\n-->\n" << m_new_cls << "\n";);
+                TRACE("resolution_new_cls", tout << m_pos_cls[i] << "\n" << m_neg_cls[j] << "\n-->\n" << m_new_cls << "\n";);
                 if (cleanup_clause(m_new_cls))
                     continue; // clause is already satisfied.
                 switch (m_new_cls.size()) {
@@ -1413,6 +1621,7 @@ namespace sat {
                     break;
                 case 2:
                     s.m_stats.m_mk_bin_clause++;
+                    if (s.m_config.m_drat) s.m_drat.add(m_new_cls[0], m_new_cls[1]);
                     add_non_learned_binary_clause(m_new_cls[0], m_new_cls[1]);
                     back_subsumption1(m_new_cls[0], m_new_cls[1], false);
                     break;
@@ -1422,6 +1631,7 @@ namespace sat {
                     else
                         s.m_stats.m_mk_clause++;
                     clause * new_c = s.m_cls_allocator.mk_clause(m_new_cls.size(), m_new_cls.c_ptr(), false);
+                    if (s.m_config.m_drat) s.m_drat.add(*new_c);
                     s.m_clauses.push_back(new_c);
                     m_use_list.insert(*new_c);
                     if (m_sub_counter > 0)
@@ -1434,10 +1644,25 @@ namespace sat {
                     return true;
             }
         }
+        if (s.m_config.m_drat) {
+            // the non-binary clauses of v are deleted when the simplifier cleans up.
+            drat_del_bin_clauses(m_pos_cls);
+            drat_del_bin_clauses(m_neg_cls);
+        }
 
         return true;
     }
 
+    void simplifier::drat_del_bin_clauses(clause_wrapper_vector const& cs) {
+        clause_wrapper_vector::const_iterator it  = cs.begin();
+        clause_wrapper_vector::const_iterator end = cs.end();
+        for (; it != end; ++it) {
+            if (it->is_binary()) {
+                s.m_drat.del((*it)[0], (*it)[1]);
+            }
+        }
+    }
+
     struct simplifier::elim_var_report {
         simplifier & m_simplifier;
         stopwatch    m_watch;
@@ -1482,6 +1707,254 @@ namespace sat {
         m_new_cls.finalize();
     }
 
+    // -----------------------
+    //
+    // Bounded variable addition
+    //
+    // A set of literals M_lit and a set of clauses M_cls containing a literal l
+    // such that (C \ {l}) or l' is a clause for every C in M_cls and l' in M_lit
+    // (a complete bi-clique) is replaced by the clauses (x or C \ {l}) and
+    // (~x or l') over a fresh variable x. This replaces |M_lit| * |M_cls| clauses
+    // by |M_lit| + |M_cls| clauses. For example, the pairwise encoding of an
+    // at-most-one constraint over n literals is reduced to about 3n clauses.
+    //
+    // -----------------------
+
+    unsigned simplifier::num_occs(literal l) const {
+        return m_use_list.get(l).size() + get_num_non_learned_bin(l);
+    }
+
+    static int bva_reduction(unsigned num_lits, unsigned num_cls) {
+        return static_cast<int>(num_lits * num_cls) - static_cast<int>(num_lits + num_cls);
+    }
+
+    /**
+       \brief greedily grow a bi-clique with l in M_lit and apply it if it reduces the number of clauses.
+    */
+    bool simplifier::try_bva(literal l) {
+        m_bva_cls.reset();
+        collect_clauses(l, m_bva_cls);
+        m_bva_lits.reset();
+        m_bva_lits.push_back(l);
+        unsigned_vector cls, new_cls;
+        for (unsigned i = 0; i < m_bva_cls.size(); ++i)
+            cls.push_back(i);
+        svector<std::pair<literal, unsigned> > matches;
+        while (m_bva_counter > 0) {
+            // find the clauses (C \ {l}) or l2 for C in M_cls
+            matches.reset();
+            for (unsigned k = 0; k < cls.size(); ++k) {
+                clause_wrapper const & c = m_bva_cls[cls[k]];
+                literal lmin = null_literal;
+                unsigned min_occs = UINT_MAX;
+                for (unsigned i = 0; i < c.size(); ++i) {
+                    if (c[i] == l)
+                        continue;
+                    mark_visited(c[i]);
+                    unsigned n = num_occs(c[i]);
+                    if (n < min_occs) {
+                        min_occs = n;
+                        lmin = c[i];
+                    }
+                }
+                m_bva_occs.reset();
+                collect_clauses(lmin, m_bva_occs);
+                for (unsigned j = 0; j < m_bva_occs.size(); ++j) {
+                    clause_wrapper const & d = m_bva_occs[j];
+                    if (d.size() != c.size())
+                        continue;
+                    m_bva_counter -= d.size();
+                    literal l2 = null_literal;
+                    unsigned num_marked = 0;
+                    for (unsigned i = 0; i < d.size(); ++i) {
+                        if (is_marked(d[i]))
+                            ++num_marked;
+                        else
+                            l2 = d[i];
+                    }
+                    if (num_marked + 1 == c.size() && l2 != l && value(l2) == l_undef && !m_bva_lits.contains(l2))
+                        matches.push_back(std::make_pair(l2, k));
+                }
+                for (unsigned i = 0; i < c.size(); ++i) {
+                    if (c[i] != l)
+                        unmark_visited(c[i]);
+                }
+            }
+            // extend M_lit by the literal with most matches
+            literal best = null_literal;
+            unsigned best_count = 0;
+            for (unsigned i = 0; i < matches.size(); ++i) {
+                unsigned n = ++m_bva_count[matches[i].first.index()];
+                if (n > best_count) {
+                    best_count = n;
+                    best = matches[i].first;
+                }
+            }
+            for (unsigned i = 0; i < matches.size(); ++i)
+                m_bva_count[matches[i].first.index()] = 0;
+            if (best == null_literal)
+                break;
+            new_cls.reset();
+            for (unsigned i = 0; i < matches.size(); ++i) {
+                if (matches[i].first == best && (new_cls.empty() || new_cls.back() != cls[matches[i].second]))
+                    new_cls.push_back(cls[matches[i].second]);
+            }
+            if (bva_reduction(m_bva_lits.size() + 1, new_cls.size()) <= bva_reduction(m_bva_lits.size(), cls.size()))
+                break;
+            m_bva_lits.push_back(best);
+            cls.swap(new_cls);
+        }
+        if (m_bva_lits.size() < 2 || bva_reduction(m_bva_lits.size(), cls.size()) <= 0)
+            return false;
+        TRACE("bva", tout << "bva on " << l << " literals: " << m_bva_lits << " clauses: " << cls.size() << "\n";);
+        apply_bva(l, cls);
+        return true;
+    }
+
+    void simplifier::add_clause(literal_vector const & lits) {
+        SASSERT(lits.size() >= 2);
+        if (lits.size() == 2) {
+            s.m_stats.m_mk_bin_clause++;
+            if (s.m_config.m_drat) s.m_drat.add(lits[0], lits[1]);
+            add_non_learned_binary_clause(lits[0], lits[1]);
+            return;
+        }
+        if (lits.size() == 3)
+            s.m_stats.m_mk_ter_clause++;
+        else
+            s.m_stats.m_mk_clause++;
+        clause * new_c = s.m_cls_allocator.mk_clause(lits.size(), lits.c_ptr(), false);
+        if (s.m_config.m_drat) s.m_drat.add(*new_c);
+        s.m_clauses.push_back(new_c);
+        m_use_list.insert(*new_c);
+    }
+
+    /**
+       \brief remove the clause (C \ {l}) or l2.
+    */
+    bool simplifier::remove_matching(clause_wrapper const & c, literal l, literal l2) {
+        if (c.is_binary()) {
+            literal other = c[0] == l ? c[1] : c[0];
+            remove_bin_clause_half(l2, other, false);
+            remove_bin_clause_half(other, l2, false);
+            if (s.m_config.m_drat) s.m_drat.del(l2, other);
+            insert_elim_todo(other.var());
+            insert_elim_todo(l2.var());
+            return true;
+        }
+        clause_use_list & occs = m_use_list.get(l2);
+        clause_use_list::iterator it = occs.mk_iterator();
+        while (!it.at_end()) {
+            clause & d = it.curr();
+            it.next();
+            if (d.size() != c.size())
+                continue;
+            bool match = true;
+            for (unsigned i = 0; match && i < c.size(); ++i) {
+                match = c[i] == l || d.contains(c[i]);
+            }
+            if (match) {
+                remove_clause(d);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void simplifier::apply_bva(literal l, unsigned_vector const & cls) {
+        bool_var x = s.mk_var(false, true);
+        m_visited.resize(2 * s.num_vars(), false);
+        m_bva_count.resize(2 * s.num_vars(), 0);
+        m_use_list.reserve(s.num_vars());
+        literal lx(x, false);
+        // the clauses with x (and then ~x) are added first, so they are RAT on their first literal.
+        literal_vector lits;
+        for (unsigned k = 0; k < cls.size(); ++k) {
+            clause_wrapper const & c = m_bva_cls[cls[k]];
+            lits.reset();
+            lits.push_back(lx);
+            for (unsigned i = 0; i < c.size(); ++i) {
+                if (c[i] != l)
+                    lits.push_back(c[i]);
+            }
+            add_clause(lits);
+        }
+        for (unsigned i = 0; i < m_bva_lits.size(); ++i) {
+            lits.reset();
+            lits.push_back(~lx);
+            lits.push_back(m_bva_lits[i]);
+            add_clause(lits);
+        }
+        // duplicate clauses in M_cls share their matching clauses, so a match may already be gone.
+        for (unsigned k = 0; k < cls.size(); ++k) {
+            for (unsigned i = 0; i < m_bva_lits.size(); ++i) {
+                remove_matching(m_bva_cls[cls[k]], l, m_bva_lits[i]);
+            }
+        }
+        m_need_cleanup = true;
+        m_num_bva_vars++;
+        m_num_bva_reduced += bva_reduction(m_bva_lits.size(), cls.size());
+    }
+
+    struct simplifier::bva_report {
+        simplifier & m_simplifier;
+        stopwatch    m_watch;
+        unsigned     m_num_vars;
+        unsigned     m_num_reduced;
+        bva_report(simplifier & s):
+            m_simplifier(s),
+            m_num_vars(s.m_num_bva_vars),
+            m_num_reduced(s.m_num_bva_reduced) {
+            m_watch.start();
+        }
+
+        ~bva_report() {
+            m_watch.stop();
+            IF_VERBOSE(SAT_VB_LVL,
+                       verbose_stream() << " (sat-bva :new-vars "
+                       << (m_simplifier.m_num_bva_vars - m_num_vars)
+                       << " :clauses-reduced " << (m_simplifier.m_num_bva_reduced - m_num_reduced)
+                       << mem_stat()
+                       << " :time " << std::fixed << std::setprecision(2) << m_watch.get_seconds() << ")\n";);
+        }
+    };
+
+    typedef std::pair<unsigned, literal> occs_and_literal;
+
+    struct occs_and_literal_gt {
+        bool operator()(occs_and_literal const & p1, occs_and_literal const & p2) const { return p1.first > p2.first; }
+    };
+
+    void simplifier::bva() {
+        // fresh variables cannot be shared with other solvers or extensions.
+        if (!m_bva || s.m_par || s.m_ext)
+            return;
+        bva_report rpt(*this);
+        m_bva_counter = m_bva_limit;
+        m_bva_count.reset();
+        m_bva_count.resize(2 * s.num_vars(), 0);
+        svector<occs_and_literal> lits;
+        for (bool_var v = 0; v < s.num_vars(); ++v) {
+            if (value(v) != l_undef || was_eliminated(v))
+                continue;
+            for (unsigned k = 0; k < 2; ++k) {
+                literal l(v, k == 1);
+                unsigned n = num_occs(l);
+                if (n >= 3)
+                    lits.push_back(occs_and_literal(n, l));
+            }
+        }
+        std::stable_sort(lits.begin(), lits.end(), occs_and_literal_gt());
+        for (unsigned i = 0; i < lits.size() && m_bva_counter > 0; ++i) {
+            checkpoint();
+            while (m_bva_counter > 0 && try_bva(lits[i].second))
+                ;
+        }
+        m_bva_cls.finalize();
+        m_bva_occs.finalize();
+        m_bva_count.finalize();
+    }
+
     void simplifier::updt_params(params_ref const & _p) {
         sat_simplifier_params p(_p);
         m_elim_blocked_clauses    = p.elim_blocked_clauses();
@@ -1501,6 +1974,9 @@ namespace sat {
         m_subsumption             = p.subsumption();
         m_subsumption_limit       = p.subsumption_limit();
         m_elim_vars               = p.elim_vars();
+        m_elim_gates              = p.elim_vars_gates();
+        m_bva                     = p.bva();
+        m_bva_limit               = p.bva_limit();
     }
 
     void simplifier::collect_param_descrs(param_descrs & r) {
@@ -1513,6 +1989,9 @@ namespace sat {
         st.update("elim literals", m_num_elim_lits);
         st.update("elim bool vars", m_num_elim_vars);
         st.update("elim blocked clauses", m_num_blocked_clauses);
+        st.update("elim gates", m_num_elim_gates);
+        st.update("bva vars", m_num_bva_vars);
+        st.update("bva clauses reduced", m_num_bva_reduced);
     }
 
     void simplifier::reset_statistics() {
@@ -1521,5 +2000,8 @@ namespace sat {
         m_num_sub_res = 0;
         m_num_elim_lits = 0;
         m_num_elim_vars = 0;
+        m_num_elim_gates = 0;
+        m_num_bva_vars = 0;
+        m_num_bva_reduced = 0;
     }
 };
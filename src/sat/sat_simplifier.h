@@ -8,7 +8,8 @@ Module Name:
 Abstract:
 
     SAT simplification procedures that use a "full" occurrence list:
-    Subsumption, Blocked Clause Removal, Variable Elimination, ...
+    Subsumption, Blocked Clause Removal, Variable Elimination,
+    Bounded Variable Addition, ...
 
 
 Author:
@@ -43,6 +44,7 @@ namespace sat {
         void erase(clause & c, literal l);
         clause_use_list & get(literal l) { return m_use_list[l.index()]; }
         clause_use_list const & get(literal l) const { return m_use_list[l.index()]; }
+        void reserve(unsigned num_vars) { if (m_use_list.size() < 2 * num_vars) m_use_list.resize(2 * num_vars); }
         void finalize() { m_use_list.finalize(); }
     };
 
@@ -63,6 +65,7 @@ namespace sat {
         // counters
         int                    m_sub_counter;
         int                    m_elim_counter;
+        int                    m_bva_counter;
 
         // config
         bool                   m_elim_blocked_clauses;
@@ -83,6 +86,9 @@ namespace sat {
         bool                   m_subsumption;
         unsigned               m_subsumption_limit;
         bool                   m_elim_vars;
+        bool                   m_elim_gates;
+        bool                   m_bva;
+        unsigned               m_bva_limit;
 
         // stats
         unsigned               m_num_blocked_clauses;
@@ -90,6 +96,9 @@ namespace sat {
         unsigned               m_num_elim_vars;
         unsigned               m_num_sub_res;
         unsigned               m_num_elim_lits;
+        unsigned               m_num_elim_gates;
+        unsigned               m_num_bva_vars;
+        unsigned               m_num_bva_reduced;  // net number of clauses removed by BVA
 
         bool                   m_learned_in_use_lists;
         unsigned               m_old_num_elim_vars;
@@ -162,16 +171,40 @@ namespace sat {
         clause_wrapper_vector m_neg_cls;
         literal_vector m_new_cls;
         bool resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r);
+
+        // gate definitions of the variable being eliminated: m_pos_gate[i] (m_neg_gate[i]) is set
+        // if m_pos_cls[i] (m_neg_cls[i]) belongs to the gate.
+        svector<char> m_pos_gate;
+        svector<char> m_neg_gate;
+        bool find_gate(bool_var v);
+        bool find_and_gate(literal x);
+        bool find_xor_gate(bool_var v);
+        bool find_ite_gate(bool_var v);
+        unsigned find_ternary(clause_wrapper_vector const & cs, literal l1, literal l2, literal l3) const;
         void save_clauses(model_converter::entry & mc_entry, clause_wrapper_vector const & cs);
         void add_non_learned_binary_clause(literal l1, literal l2);
         void remove_bin_clauses(literal l);
         void remove_clauses(clause_use_list const & cs, literal l);
         bool try_eliminate(bool_var v);
+        void drat_del_bin_clauses(clause_wrapper_vector const& cs);
         void elim_vars();
 
+        // bounded variable addition
+        clause_wrapper_vector m_bva_cls;
+        clause_wrapper_vector m_bva_occs;
+        literal_vector        m_bva_lits;
+        unsigned_vector       m_bva_count;
+        unsigned num_occs(literal l) const;
+        bool try_bva(literal l);
+        void apply_bva(literal l, unsigned_vector const & cls);
+        void add_clause(literal_vector const & lits);
+        bool remove_matching(clause_wrapper const & c, literal l, literal l2);
+        void bva();
+
         struct blocked_cls_report;
         struct subsumption_report;
         struct elim_var_report;
+        struct bva_report;
 
         class scoped_finalize {
             simplifier& s;
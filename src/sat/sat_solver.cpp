@@ -18,6 +18,7 @@ Revision History:
 --*/
 #include "sat/sat_solver.h"
 #include "sat/sat_integrity_checker.h"
+#include "sat/sat_xor_finder.h"
 #include "util/luby.h"
 #include "util/trace.h"
 #include "util/max_cliques.h"
@@ -37,6 +38,8 @@ namespace sat {
         m_config(p),
         m_ext(ext),
         m_par(0),
+        m_drat(*this),
+        m_drat_input(false),
         m_cleaner(*this),
         m_simplifier(*this, p),
         m_scc(*this, p),
@@ -55,6 +58,7 @@ namespace sat {
         m_conflicts               = 0;
         m_next_simplify           = 0;
         m_num_checkpoints         = 0;
+        m_par_id                  = 0;
     }
 
     solver::~solver() {
@@ -165,13 +169,16 @@ namespace sat {
                 SASSERT(m_eliminated[lits[i].var()] == false);
         });
 
+        flet<bool> _input(m_drat_input, m_config.m_drat);
         if (m_user_scope_literals.empty()) {
+            if (m_config.m_drat) m_drat.add_input(num_lits, lits);
             mk_clause_core(num_lits, lits, false);
         }
         else {
             m_aux_literals.reset();
             m_aux_literals.append(num_lits, lits);
             m_aux_literals.append(m_user_scope_literals);
+            if (m_config.m_drat) m_drat.add_input(m_aux_literals.size(), m_aux_literals.c_ptr());
             mk_clause_core(m_aux_literals.size(), m_aux_literals.c_ptr(), false);
         }
     }
@@ -188,6 +195,7 @@ namespace sat {
 
     void solver::del_clause(clause& c) {
         if (!c.is_learned()) m_stats.m_non_learned_generation++;
+        if (m_config.m_drat) m_drat.del(c);
         m_cls_allocator.del_clause(&c);
         m_stats.m_del_clause++;
     }
@@ -195,11 +203,14 @@ namespace sat {
     clause * solver::mk_clause_core(unsigned num_lits, literal * lits, bool learned) {
         TRACE("sat", tout << "mk_clause: " << mk_lits_pp(num_lits, lits) << (learned?" learned":" aux") << "\n";);
         if (!learned) {
+            unsigned old_sz = num_lits;
             bool keep = simplify_clause(num_lits, lits);
             TRACE("sat_mk_clause", tout << "mk_clause (after simp), keep: " << keep << "\n" << mk_lits_pp(num_lits, lits) << "\n";);
             if (!keep) {
                 return 0; // clause is equivalent to true.
             }
+            if (num_lits != old_sz)
+                m_drat_input = false; // the strengthened clause is a lemma
             ++m_stats.m_non_learned_generation;
         }
 
@@ -221,6 +232,9 @@ namespace sat {
     }
 
     void solver::mk_bin_clause(literal l1, literal l2, bool learned) {
+        if (m_config.m_drat && !m_drat_input) 
+            m_drat.add(l1, l2);
+        m_drat_input = false; // units propagated by the clause are lemmas
         if (propagate_bin_clause(l1, l2)) {
             if (scope_lvl() == 0)
                 return;
@@ -256,6 +270,9 @@ namespace sat {
     clause * solver::mk_ter_clause(literal * lits, bool learned) {
         m_stats.m_mk_ter_clause++;
         clause * r = m_cls_allocator.mk_clause(3, lits, learned);
+        if (m_config.m_drat && !m_drat_input) 
+            m_drat.add(*r);
+        m_drat_input = false;
         bool reinit = attach_ter_clause(*r);
         if (reinit && !learned) push_reinit_stack(*r);
 
@@ -294,6 +311,9 @@ namespace sat {
     clause * solver::mk_nary_clause(unsigned num_lits, literal * lits, bool learned) {
         m_stats.m_mk_clause++;
         clause * r = m_cls_allocator.mk_clause(num_lits, lits, learned);
+        if (m_config.m_drat && !m_drat_input) 
+            m_drat.add(*r);
+        m_drat_input = false;
         SASSERT(!learned || r->is_learned());
         bool reinit = attach_nary_clause(*r);
         if (reinit && !learned) push_reinit_stack(*r);
@@ -464,6 +484,7 @@ namespace sat {
     }
 
     void solver::detach_bin_clause(literal l1, literal l2, bool learned) {
+        if (m_config.m_drat) m_drat.del(l1, l2);
         get_wlist(~l1).erase(watched(l2, learned));
         get_wlist(~l2).erase(watched(l1, learned));
     }
@@ -499,13 +520,18 @@ namespace sat {
         m_inconsistent = true;
         m_conflict = c;
         m_not_l    = not_l;
+        if (m_config.m_drat && scope_lvl() == 0 && !m_drat_input) 
+            m_drat.add();
     }
 
     void solver::assign_core(literal l, justification j) {
         SASSERT(value(l) == l_undef);
         TRACE("sat_assign_core", tout << l << " " << j << " level: " << scope_lvl() << "\n";);
-        if (scope_lvl() == 0)
+        if (scope_lvl() == 0) {
             j = justification(); // erase justification for level 0
+            if (m_config.m_drat && !m_drat_input) 
+                m_drat.add(l);
+        }
         m_assignment[l.index()]    = l_true;
         m_assignment[(~l).index()] = l_false;
         bool_var v = l.var();
@@ -570,8 +596,24 @@ namespace sat {
             m_asymm_branch.dec(wlist.size());
             m_probing.dec(wlist.size());
             watch_list::iterator it  = wlist.begin();
-            watch_list::iterator it2 = it;
             watch_list::iterator end = wlist.end();
+            // binary watches are kept in front of the watch list (see sort_watch_lits and compact_watches).
+            // They are never removed during propagation, so they are visited without copying them.
+            for (; it != end && it->is_binary_clause(); ++it) {
+                l1 = it->get_literal();
+                switch (value(l1)) {
+                case l_false:
+                    set_conflict(justification(not_l), ~l1);
+                    return false;
+                case l_undef:
+                    m_stats.m_bin_propagate++;
+                    assign_core(l1, justification(not_l));
+                    break;
+                case l_true:
+                    break;
+                }
+            }
+            watch_list::iterator it2 = it;
 #define CONFLICT_CLEANUP() {                    \
                 for (; it != end; ++it, ++it2)  \
                     *it2 = *it;                 \
@@ -687,14 +729,16 @@ namespace sat {
                 case watched::EXT_CONSTRAINT:
                     SASSERT(m_ext);
                     m_ext->propagate(l, it->get_ext_constraint_idx(), keep);
-                    if (keep) {
-                        *it2 = *it;
-                        it2++;
-                    }
                     if (m_inconsistent) {
+                        // CONFLICT_CLEANUP copies the current watch
+                        if (!keep) ++it;
                         CONFLICT_CLEANUP();
                         return false;
                     }
+                    if (keep) {
+                        *it2 = *it;
+                        it2++;
+                    }
                     break;
                 default:
                     UNREACHABLE();
@@ -721,10 +765,36 @@ namespace sat {
     //
     // -----------------------
     lbool solver::check(unsigned num_lits, literal const* lits) {
+        lbool r = check_core(num_lits, lits);
+        if (r == l_false && m_config.m_drat_check && num_lits == 0 && m_user_scope_literals.empty()) {
+            check_drat();
+        }
+        return r;
+    }
+
+    /**
+       \brief validate the refutation with the in-process DRAT checker.
+       Justifications produced by an extension are not part of the proof.
+     */
+    void solver::check_drat() {
+        if (m_ext) {
+            IF_VERBOSE(1, verbose_stream() << "(sat.drat-check \"skipped: proofs of extensions are not supported\")\n";);
+            return;
+        }
+        if (m_drat.check() == l_false) {
+            throw solver_exception("DRAT proof check failed");
+        }
+    }
+
+    lbool solver::check_core(unsigned num_lits, literal const* lits) {
         pop_to_base_level();
         IF_VERBOSE(2, verbose_stream() << "(sat.sat-solver)\n";);
         SASSERT(scope_lvl() == 0);
-        if (m_config.m_num_parallel > 1 && !m_par) {
+        // proofs are only produced by sequential search.
+        if (m_config.m_lookahead_cube && num_lits == 0 && !m_par && !m_config.m_drat) {
+            return check_cubes();
+        }
+        if (m_config.m_num_parallel > 1 && !m_par && !m_config.m_drat) {
             return check_par(num_lits, lits);
         }
 #ifdef CLONE_BEFORE_SOLVING
@@ -778,6 +848,10 @@ namespace sat {
                 if (check_inconsistent()) return l_false;
                 gc();
 
+                if (m_config.m_local_search_rephase > 0 && m_restarts % m_config.m_local_search_rephase == 0) {
+                    rephase();
+                }
+
                 if (m_config.m_restart_max <= m_restarts) {
                     IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat \"abort: max-restarts\")\n";);
                     return l_undef;
@@ -801,8 +875,21 @@ namespace sat {
         scoped_limits scoped_rlimit(rlimit());
         vector<reslimit> rlims(num_extra_solvers);
         ptr_vector<sat::solver> solvers(num_extra_solvers);
-        sat::par par;
+        sat::par par(num_threads);
         symbol saved_phase = m_params.get_sym("phase", symbol("caching"));
+        // the last extra thread runs local search, it can only find models.
+        int local_search_id = -1;
+        scoped_ptr<local_search> ls;
+        if (m_config.m_local_search && num_extra_solvers > 0 && !m_ext && m_mc.empty()) {
+            local_search_id = --num_extra_solvers;
+            ls = alloc(local_search, rlims[local_search_id], m_rand(), m_config.m_local_search_max_flips, m_config.m_local_search_cb);
+            literal_vector asms(num_lits, lits);
+            for (unsigned i = 0; i < m_user_scope_literals.size(); ++i) {
+                asms.push_back(~m_user_scope_literals[i]);
+            }
+            ls->import(*this, asms.size(), asms.c_ptr());
+            scoped_rlimit.push_child(&rlims[local_search_id]);
+        }
         for (int i = 0; i < num_extra_solvers; ++i) {
             m_params.set_uint("random_seed", m_rand());
             if (i == 1 + num_threads/2) {
@@ -810,10 +897,10 @@ namespace sat {
             }
             solvers[i] = alloc(sat::solver, m_params, rlims[i], 0);
             solvers[i]->copy(*this);
-            solvers[i]->set_par(&par);
+            solvers[i]->set_par(&par, i);
             scoped_rlimit.push_child(&solvers[i]->rlimit());
         }
-        set_par(&par);
+        set_par(&par, num_extra_solvers);
         m_params.set_sym("phase", saved_phase);
         int finished_id = -1;
         std::string        ex_msg;
@@ -824,7 +911,10 @@ namespace sat {
         for (int i = 0; i < num_threads; ++i) {
             try {
                 lbool r = l_undef;
-                if (i < num_extra_solvers) {
+                if (i == local_search_id) {
+                    r = ls->check(0);
+                }
+                else if (i < num_extra_solvers) {
                     r = solvers[i]->check(num_lits, lits);
                 }
                 else {
@@ -833,21 +923,25 @@ namespace sat {
                 bool first = false;
                 #pragma omp critical (par_solver)
                 {
-                    if (finished_id == -1) {
+                    // local search gives up only when it is canceled.
+                    if (finished_id == -1 && (r != l_undef || i != local_search_id)) {
                         finished_id = i;
                         first = true;
                         result = r;
                     }
                 }
                 if (first) {
-                    if (r == l_true && i < num_extra_solvers) {
+                    if (i == local_search_id) {
+                        rlimit().inc_cancel();
+                    }
+                    else if (r == l_true && i < num_extra_solvers) {
                         set_model(solvers[i]->get_model());
                     }
                     else if (r == l_false && i < num_extra_solvers) {
                         m_core.reset();
                         m_core.append(solvers[i]->get_core());
                     }
-                    for (int j = 0; j < num_extra_solvers; ++j) {
+                    for (int j = 0; j < static_cast<int>(rlims.size()); ++j) {
                         if (i != j) {
                             rlims[j].cancel();
                         }
@@ -867,10 +961,30 @@ namespace sat {
                 }
             }
         }
-        set_par(0);
+        set_par(0, 0);
+        if (finished_id != -1 && finished_id == local_search_id) {
+            rlimit().dec_cancel();
+            set_model(ls->get_model());
+            ls->collect_statistics(m_aux_stats);
+        }
+        stats main_stats = m_stats;
         if (finished_id != -1 && finished_id < num_extra_solvers) {
             m_stats = solvers[finished_id]->m_stats;
         }
+        // report clause exchange summed over all threads.
+        m_stats.m_par_units_in    = main_stats.m_par_units_in;
+        m_stats.m_par_clauses_in  = main_stats.m_par_clauses_in;
+        m_stats.m_par_clauses_out = main_stats.m_par_clauses_out;
+        for (int i = 0; i < num_extra_solvers; ++i) {
+            stats const& st = solvers[i]->m_stats;
+            IF_VERBOSE(1, verbose_stream() << "(sat-par :thread " << i 
+                       << " :units-in " << st.m_par_units_in 
+                       << " :clauses-in " << st.m_par_clauses_in 
+                       << " :clauses-out " << st.m_par_clauses_out << ")\n";);
+            m_stats.m_par_units_in    += st.m_par_units_in;
+            m_stats.m_par_clauses_in  += st.m_par_clauses_in;
+            m_stats.m_par_clauses_out += st.m_par_clauses_out;
+        }
 
         for (int i = 0; i < num_extra_solvers; ++i) {
             dealloc(solvers[i]);
@@ -885,42 +999,231 @@ namespace sat {
 
     }
 
+    /**
+       \brief cube-and-conquer: split the problem into cubes using lookahead and 
+       solve the cubes with m_num_parallel copies of this solver. Idle copies take 
+       the next unsolved cube, and learned clauses are shared between the copies.
+     */
+    lbool solver::check_cubes() {
+        if (inconsistent()) return l_false;
+        propagate(false);
+        if (inconsistent()) return l_false;
+        vector<literal_vector> cubes;
+        {
+            lookahead lh(*this);
+            lbool r = lh(cubes);
+            lh.collect_statistics(m_aux_stats);
+            if (r == l_false) {
+                return l_false;
+            }
+        }
+        // cube literals are assumptions for the workers and may not be eliminated.
+        // They are external only for the copies, the flags of this solver are restored below.
+        bool_var_vector new_external;
+        for (unsigned i = 0; i < cubes.size(); ++i) {
+            for (unsigned j = 0; j < cubes[i].size(); ++j) {
+                bool_var v = cubes[i][j].var();
+                if (!is_external(v)) {
+                    set_external(v);
+                    new_external.push_back(v);
+                }
+            }
+        }
+        int num_threads = static_cast<int>(std::max(1u, m_config.m_num_parallel));
+        scoped_limits scoped_rlimit(rlimit());
+        vector<reslimit> rlims(num_threads);
+        ptr_vector<sat::solver> solvers(num_threads);
+        sat::par par(num_threads);
+        for (int i = 0; i < num_threads; ++i) {
+            m_params.set_uint("random_seed", m_rand());
+            solvers[i] = alloc(sat::solver, m_params, rlims[i], 0);
+            solvers[i]->copy(*this);
+            solvers[i]->set_par(&par, i);
+            scoped_rlimit.push_child(&solvers[i]->rlimit());
+        }
+        for (unsigned i = 0; i < new_external.size(); ++i) {
+            m_external[new_external[i]] = false;
+        }
+        std::atomic<unsigned> next_cube(0);
+        std::atomic<int> finished_id(-1);
+        std::string        ex_msg;
+        par_exception_kind ex_kind = DEFAULT_EX;
+        unsigned error_code = 0;
+        lbool result = l_false;
+        #pragma omp parallel for
+        for (int i = 0; i < num_threads; ++i) {
+            try {
+                lbool r = l_false;
+                while (r == l_false && finished_id == -1) {
+                    unsigned idx = next_cube++;
+                    if (idx >= cubes.size()) break;
+                    literal_vector const& cube = cubes[idx];
+                    r = solvers[i]->check(cube.size(), cube.c_ptr());
+                }
+                bool first = false;
+                if (r != l_false) {
+                    #pragma omp critical (par_solver)
+                    {
+                        if (finished_id == -1) {
+                            finished_id = i;
+                            first = true;
+                            result = r;
+                        }
+                    }
+                }
+                if (first) {
+                    if (r == l_true) {
+                        set_model(solvers[i]->get_model());
+                    }
+                    for (int j = 0; j < num_threads; ++j) {
+                        if (i != j) {
+                            rlims[j].cancel();
+                        }
+                    }
+                }
+            }
+            catch (z3_error & err) {
+                #pragma omp critical (par_solver)
+                {
+                    error_code = err.error_code();
+                    ex_kind = ERROR_EX;
+                    finished_id = -2;
+                }
+                for (int j = 0; j < num_threads; ++j) {
+                    if (i != j) {
+                        rlims[j].cancel();
+                    }
+                }
+            }
+            catch (z3_exception & ex) {
+                #pragma omp critical (par_solver)
+                {
+                    ex_msg = ex.msg();
+                    ex_kind = DEFAULT_EX;
+                    finished_id = -2;
+                }
+                for (int j = 0; j < num_threads; ++j) {
+                    if (i != j) {
+                        rlims[j].cancel();
+                    }
+                }
+            }
+        }
+        for (int i = 0; i < num_threads; ++i) {
+            stats const& st = solvers[i]->m_stats;
+            IF_VERBOSE(1, verbose_stream() << "(sat-cube :thread " << i 
+                       << " :conflicts " << st.m_conflict 
+                       << " :clauses-in " << st.m_par_clauses_in << ")\n";);
+            m_stats.m_conflict        += st.m_conflict;
+            m_stats.m_decision        += st.m_decision;
+            m_stats.m_par_clauses_in  += st.m_par_clauses_in;
+            m_stats.m_par_clauses_out += st.m_par_clauses_out;
+            dealloc(solvers[i]);
+        }
+        if (finished_id == -2) {
+            switch (ex_kind) {
+            case ERROR_EX: throw z3_error(error_code);
+            default: throw default_exception(ex_msg.c_str());
+            }
+        }
+        return result;
+    }
+
     /*
-      \brief import lemmas/units from parallel sat solvers.
+      \brief export new units to and import lemmas/units from parallel sat solvers.
      */
     void solver::exchange_par() {
         if (m_par && scope_lvl() == 0) {
             unsigned sz = init_trail_size();
-            unsigned num_in = 0, num_out = 0;
-            literal_vector in, out;
+            unsigned num_out = 0;
             for (unsigned i = m_par_limit_out; i < sz; ++i) {
                 literal lit = m_trail[i];
                 if (lit.var() < m_par_num_vars) {
                     ++num_out;
-                    out.push_back(lit);
-                }
-            }
-            m_par_limit_out = sz;
-            m_par->exchange(out, m_par_limit_in, in);
-            for (unsigned i = 0; !inconsistent() && i < in.size(); ++i) {
-                literal lit = in[i];
-                SASSERT(lit.var() < m_par_num_vars);
-                if (lvl(lit.var()) != 0 || value(lit) != l_true) {
-                    ++num_in;
-                    assign(lit, justification());
+                    m_par->share_clause(m_par_id, 1, &lit);
                 }
             }
+            unsigned num_units = m_stats.m_par_units_in;
+            unsigned num_clauses = m_stats.m_par_clauses_in;
+            import_par_clauses();
+            // units that were imported need not be exported again.
+            m_par_limit_out = init_trail_size();
+            unsigned num_in = m_stats.m_par_units_in - num_units;
             if (num_in > 0 || num_out > 0) {
                 IF_VERBOSE(1, verbose_stream() << "(sat-sync out: " << num_out << " in: " << num_in << ")\n";);
             }
+            if (num_clauses < m_stats.m_par_clauses_in) {
+                IF_VERBOSE(2, verbose_stream() << "(sat-sync :thread " << m_par_id << " :clauses-in " << (m_stats.m_par_clauses_in - num_clauses) << ")\n";);
+            }
+        }
+    }
+
+    /**
+       \brief export the current lemma to the other parallel solvers 
+       if it is short or has small glue.
+     */
+    void solver::share_lemma(unsigned glue) {
+        if (!m_par || m_lemma.size() <= 1) 
+            return;
+        if (m_lemma.size() > m_config.m_par_max_size || glue > m_config.m_par_max_glue)
+            return;
+        for (unsigned i = 0; i < m_lemma.size(); ++i) {
+            if (m_lemma[i].var() >= m_par_num_vars) 
+                return;
+        }
+        m_par->share_clause(m_par_id, m_lemma.size(), m_lemma.c_ptr());
+        m_stats.m_par_clauses_out++;
+    }
+
+    /**
+       \brief import units and lemmas learned by the other parallel solvers.
+       It is invoked at the base level, i.e., when the solver restarts.
+     */
+    void solver::import_par_clauses() {
+        SASSERT(scope_lvl() == 0);
+        m_par_lits.reset();
+        m_par_sizes.reset();
+        m_par->get_clauses(m_par_id, m_par_lits, m_par_sizes);
+        literal const* lits = m_par_lits.c_ptr();
+        for (unsigned i = 0; !inconsistent() && i < m_par_sizes.size(); ++i) {
+            import_par_clause(m_par_sizes[i], lits);
+            lits += m_par_sizes[i];
+        }
+    }
+
+    void solver::import_par_clause(unsigned sz, literal const* lits) {
+        m_aux_literals.reset();
+        for (unsigned i = 0; i < sz; ++i) {
+            literal lit = lits[i];
+            if (lit.var() >= m_par_num_vars || was_eliminated(lit.var()))
+                return;
+            switch (value(lit)) {
+            case l_true:
+                return;
+            case l_false:
+                break;
+            case l_undef:
+                m_aux_literals.push_back(lit);
+                break;
+            }
+        }
+        if (sz == 1) {
+            m_stats.m_par_units_in++;
+        }
+        else {
+            m_stats.m_par_clauses_in++;
+        }
+        clause* c = mk_clause_core(m_aux_literals.size(), m_aux_literals.c_ptr(), true);
+        if (c) {
+            c->set_glue(std::min(c->size(), m_config.m_par_max_glue));
         }
     }
 
-    void solver::set_par(par* p) {
+    void solver::set_par(par* p, unsigned id) {
         m_par = p;
         m_par_num_vars = num_vars();
-        m_par_limit_in = 0;
         m_par_limit_out = 0;
+        m_par_id = id;
     }
 
     bool_var solver::next_var() {
@@ -1198,6 +1501,9 @@ namespace sat {
         m_cleaner();
         CASSERT("sat_simplify_bug", check_invariant());
 
+        find_xors();
+        if (inconsistent()) return;
+
         m_scc();
         CASSERT("sat_simplify_bug", check_invariant());
 
@@ -1222,6 +1528,8 @@ namespace sat {
         CASSERT("sat_missed_prop", check_missed_propagation());
         CASSERT("sat_simplify_bug", check_invariant());
 
+        gc_defrag();
+
         if (m_ext) {
             m_ext->clauses_modifed();
             m_ext->simplify();
@@ -1365,6 +1673,55 @@ namespace sat {
         CASSERT("sat_restart", check_invariant());
     }
 
+    /**
+       \brief run local search from the current phases and
+       replace the phases of unassigned variables by its best assignment.
+     */
+    void solver::rephase() {
+        if (m_config.m_phase != PS_CACHING || m_ext) {
+            return;
+        }
+        if (!m_local_search) {
+            m_local_search = alloc(local_search, m_rlimit, m_rand(), m_config.m_local_search_max_flips, m_config.m_local_search_cb);
+        }
+        m_local_search->import(*this, 0, 0);
+        m_local_search->check(1);
+        unsigned num_changed = 0;
+        for (bool_var v = 0; v < num_vars(); ++v) {
+            if (value(v) != l_undef || was_eliminated(v)) continue;
+            phase ph = m_local_search->best_phase(v) ? POS_PHASE : NEG_PHASE;
+            if (m_phase[v] != ph) {
+                m_phase[v] = ph;
+                ++num_changed;
+            }
+        }
+        IF_VERBOSE(2, verbose_stream() << "(sat-rephase :unsat " << m_local_search->best_unsat()
+                   << " :changed " << num_changed << ")\n";);
+    }
+
+    /**
+       \brief replace the XOR constraints among the clauses by the XOR extension.
+     */
+    void solver::find_xors() {
+        if (!m_config.m_xor_solver || (m_ext && m_ext != m_xor.get()))
+            return;
+        // the copies made for parallel search, cubing and proof checking only contain clauses.
+        if (m_par || m_config.m_num_parallel > 1 || m_config.m_lookahead_cube || m_config.m_drat)
+            return;
+        vector<bool_var_vector> vars;
+        svector<bool> rhs;
+        xor_finder(*this, m_config.m_xor_max_size)(vars, rhs);
+        if (vars.empty())
+            return;
+        if (!m_xor) {
+            m_xor = alloc(xor_extension, *this, m_config.m_xor_gauss_max);
+            m_ext = m_xor.get();
+        }
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            m_xor->add_xor(vars[i].size(), vars[i].c_ptr(), rhs[i]);
+        }
+    }
+
     // -----------------------
     //
     // GC
@@ -1399,6 +1756,7 @@ namespace sat {
         }
         m_conflicts_since_gc = 0;
         m_gc_threshold += m_config.m_gc_increment;
+        gc_defrag();
         CASSERT("sat_gc_bug", check_invariant());
     }
 
@@ -1494,8 +1852,7 @@ namespace sat {
         for (unsigned i = new_sz; i < sz; i++) {
             clause & c = *(m_learned[i]);
             if (can_delete(c)) {
-                detach_clause(c);
-                del_clause(c);
+                m_gc_removed.push_back(&c);
             }
             else {
                 m_learned[j] = &c;
@@ -1505,9 +1862,125 @@ namespace sat {
         new_sz = j;
         m_stats.m_gc_clause += sz - new_sz;
         m_learned.shrink(new_sz);
+        gc_del_clauses();
         IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat-gc :strategy " << st_name << " :deleted " << (sz - new_sz) << ")\n";);
     }
 
+    /**
+       \brief Delete the clauses collected by gc. Instead of erasing the watches of every
+       clause from two watch lists, the watches of all deleted clauses are removed in
+       a single pass over the watch lists.
+    */
+    void solver::gc_del_clauses() {
+        if (m_gc_removed.empty())
+            return;
+        unsigned sz = m_gc_removed.size();
+        for (unsigned i = 0; i < sz; i++) {
+            clause & c = *(m_gc_removed[i]);
+            if (c.size() == 3)
+                detach_ter_clause(c);
+            else
+                c.set_removed(true);
+        }
+        compact_watches();
+        for (unsigned i = 0; i < sz; i++) {
+            del_clause(*(m_gc_removed[i]));
+        }
+        m_gc_removed.reset();
+    }
+
+    /**
+       \brief Remove the watches of clauses marked as removed, and move the
+       binary watches to the front of every watch list.
+    */
+    void solver::compact_watches() {
+        vector<watch_list>::iterator it  = m_watches.begin();
+        vector<watch_list>::iterator end = m_watches.end();
+        for (; it != end; ++it) {
+            watch_list & wlist = *it;
+            unsigned sz = wlist.size();
+            unsigned j  = 0;
+            unsigned num_bin = 0;
+            for (unsigned i = 0; i < sz; i++) {
+                watched w = wlist[i];
+                if (w.is_clause() && m_cls_allocator.get_clause(w.get_clause_offset())->was_removed())
+                    continue;
+                wlist[j] = w;
+                if (w.is_binary_clause()) {
+                    std::swap(wlist[num_bin], wlist[j]);
+                    num_bin++;
+                }
+                j++;
+            }
+            wlist.shrink(j);
+        }
+    }
+
+    /**
+       \brief The clause arena does not reuse the memory of deleted clauses,
+       so it is compacted whenever more than half of it is garbage.
+    */
+    void solver::gc_defrag() {
+        if (m_cls_allocator.fragmentation() > 0.5) {
+            defrag_clauses();
+        }
+    }
+
+    struct activity_gt {
+        svector<unsigned> const & m_activity;
+        activity_gt(svector<unsigned> const & a):m_activity(a) {}
+        bool operator()(bool_var v1, bool_var v2) const { return m_activity[v1] > m_activity[v2]; }
+    };
+
+    /**
+       \brief Copy the clauses to a fresh clause arena and release the memory of deleted clauses.
+       Clauses are copied in the order in which propagation visits them, so that clauses watched
+       by the same literal are adjacent. With sat.gc.defrag, the clauses watched by active variables
+       come first, otherwise the variables are visited by index.
+    */
+    void solver::defrag_clauses() {
+        TRACE("sat", tout << "defrag\n";);
+        m_cls_allocator.begin_compaction();
+        // the watches of every variable are relocated, the order only decides where the copies go.
+        bool_var_vector vars;
+        for (bool_var v = 0; v < num_vars(); v++) {
+            vars.push_back(v);
+        }
+        if (m_config.m_gc_defrag) {
+            std::stable_sort(vars.begin(), vars.end(), activity_gt(m_activity));
+        }
+        for (unsigned i = 0; i < vars.size(); i++) {
+            for (unsigned sign = 0; sign < 2; sign++) {
+                watch_list & wlist = m_watches[literal(vars[i], sign == 1).index()];
+                watch_list::iterator it  = wlist.begin();
+                watch_list::iterator end = wlist.end();
+                for (; it != end; ++it) {
+                    if (it->is_clause())
+                        it->set_clause_offset(m_cls_allocator.relocate(it->get_clause_offset()));
+                }
+            }
+        }
+        // ternary and frozen clauses are not referenced by watches.
+        for (unsigned i = 0; i < m_clauses.size(); i++) 
+            m_clauses[i] = m_cls_allocator.relocate(m_clauses[i]);
+        for (unsigned i = 0; i < m_learned.size(); i++) 
+            m_learned[i] = m_cls_allocator.relocate(m_learned[i]);
+        for (unsigned i = 0; i < m_trail.size(); i++) {
+            bool_var v = m_trail[i].var();
+            if (m_justification[v].is_clause()) 
+                m_justification[v] = justification(m_cls_allocator.relocate(m_justification[v].get_clause_offset()));
+        }
+        if (m_inconsistent && m_conflict.is_clause())
+            m_conflict = justification(m_cls_allocator.relocate(m_conflict.get_clause_offset()));
+        for (unsigned i = 0; i < m_clauses_to_reinit.size(); i++) {
+            clause_wrapper & cw = m_clauses_to_reinit[i];
+            if (!cw.is_binary()) 
+                cw = clause_wrapper(*m_cls_allocator.relocate(cw.get_clause()));
+        }
+        m_cls_allocator.end_compaction();
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat-defrag)\n";);
+    }
+
     /**
        \brief Use gc based on dynamic psm. Clauses are initially frozen.
     */
@@ -1552,8 +2025,7 @@ namespace sat {
                     else {
                         c.inc_inact_rounds();
                         if (c.inact_rounds() > m_config.m_gc_k) {
-                            detach_clause(c);
-                            del_clause(c);
+                            m_gc_removed.push_back(&c);
                             m_stats.m_gc_clause++;
                             deleted++;
                             continue;
@@ -1599,6 +2071,7 @@ namespace sat {
             ++it2;
         }
         m_learned.set_end(it2);
+        gc_del_clauses();
         IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat-gc :d_tk " << d_tk << " :min-d_tk " << m_min_d_tk <<
                    " :frozen " << frozen << " :activated " << activated << " :deleted " << deleted << ")\n";);
     }
@@ -1610,10 +2083,12 @@ namespace sat {
         // do some cleanup
         unsigned sz = c.size();
         unsigned j  = 0;
+        if (m_config.m_drat) m_drat.save(c);
         for (unsigned i = 0; i < sz; i++) {
             literal l = c[i];
             switch (value(l)) {
             case l_true:
+                if (m_config.m_drat) m_drat.update(c);
                 return false;
             case l_false:
                 break;
@@ -1625,6 +2100,10 @@ namespace sat {
         }
         TRACE("sat", tout << "after cleanup:\n" << mk_lits_pp(j, c.begin()) << "\n";);
         unsigned new_sz = j;
+        if (m_config.m_drat) {
+            c.shrink(new_sz);
+            m_drat.update(c);
+        }
         switch (new_sz) {
         case 0:
             set_conflict(justification());
@@ -1698,6 +2177,7 @@ namespace sat {
         }
 
         if (m_conflict_lvl == 0) {
+            if (m_config.m_drat) m_drat.add();
             return false;
         }
 
@@ -1810,6 +2290,7 @@ namespace sat {
         if (lemma) {
             lemma->set_glue(glue);
         }
+        share_lemma(glue);
         decay_activity();
         updt_phase_counters();
         return true;
@@ -2756,6 +3237,7 @@ namespace sat {
         m_probing.updt_params(p);
         m_scc.updt_params(p);
         m_rand.set_seed(m_config.m_random_seed);
+        m_drat.updt_config();
     }
 
     void solver::collect_param_descrs(param_descrs & d) {
@@ -2768,19 +3250,26 @@ namespace sat {
 
     void solver::collect_statistics(statistics & st) const {
         m_stats.collect_statistics(st);
+        st.copy(m_aux_stats);
         m_cleaner.collect_statistics(st);
         m_simplifier.collect_statistics(st);
         m_scc.collect_statistics(st);
         m_asymm_branch.collect_statistics(st);
         m_probing.collect_statistics(st);
+        m_drat.collect_statistics(st);
+        m_cls_allocator.collect_statistics(st);
+        if (m_local_search) m_local_search->collect_statistics(st);
+        if (m_xor) m_xor->collect_statistics(st);
     }
 
     void solver::reset_statistics() {
         m_stats.reset();
+        m_aux_stats.reset();
         m_cleaner.reset_statistics();
         m_simplifier.reset_statistics();
         m_asymm_branch.reset_statistics();
         m_probing.reset_statistics();
+        if (m_xor) m_xor->reset_statistics();
     }
 
     // -----------------------
@@ -3717,6 +4206,9 @@ namespace sat {
         st.update("minimized lits", m_minimized_lits);
         st.update("dyn subsumption resolution", m_dyn_sub_res);
         st.update("blocked correction sets", m_blocked_corr_sets);
+        st.update("par units in", m_par_units_in);
+        st.update("par clauses in", m_par_clauses_in);
+        st.update("par clauses out", m_par_clauses_out);
     }
 
     void stats::reset() {
@@ -3736,6 +4228,9 @@ namespace sat {
         m_dyn_sub_res = 0;
         m_non_learned_generation = 0;
         m_blocked_corr_sets = 0;
+        m_par_units_in = 0;
+        m_par_clauses_in = 0;
+        m_par_clauses_out = 0;
     }
 
     void mk_stat::display(std::ostream & out) const {
@@ -34,6 +34,10 @@ Revision History:
 #include "sat/sat_probing.h"
 #include "sat/sat_mus.h"
 #include "sat/sat_par.h"
+#include "sat/sat_lookahead.h"
+#include "sat/sat_local_search.h"
+#include "sat/sat_xor_extension.h"
+#include "sat/sat_drat.h"
 #include "util/params.h"
 #include "util/statistics.h"
 #include "util/stopwatch.h"
@@ -62,6 +66,9 @@ namespace sat {
         unsigned m_dyn_sub_res;
         unsigned m_non_learned_generation;
         unsigned m_blocked_corr_sets;
+        unsigned m_par_units_in;
+        unsigned m_par_clauses_in;
+        unsigned m_par_clauses_out;
         stats() { reset(); }
         void reset();
         void collect_statistics(statistics & st) const;
@@ -75,8 +82,11 @@ namespace sat {
         bool                    m_checkpoint_enabled;
         config                  m_config;
         stats                   m_stats;
+        statistics              m_aux_stats;    // statistics of auxiliary engines, e.g., lookahead
         extension *             m_ext;
         par*                    m_par;
+        drat                    m_drat;         // DRAT for generating proofs
+        bool                    m_drat_input;   // clause being added is an input clause, not a lemma
         random_gen              m_rand;
         clause_allocator        m_cls_allocator;
         cleaner                 m_cleaner;
@@ -127,13 +137,17 @@ namespace sat {
         stopwatch               m_stopwatch;
         params_ref              m_params;
         scoped_ptr<solver>      m_clone; // for debugging purposes
+        scoped_ptr<local_search> m_local_search; // for rephasing
+        scoped_ptr<xor_extension> m_xor;         // extension for the XOR constraints found among the clauses
         literal_vector          m_assumptions;      // additional assumptions during check
         literal_set             m_assumption_set;   // set of enabled assumptions
         literal_vector          m_core;             // unsat core
 
-        unsigned                m_par_limit_in;
         unsigned                m_par_limit_out;
         unsigned                m_par_num_vars;
+        unsigned                m_par_id;
+        literal_vector          m_par_lits;
+        unsigned_vector         m_par_sizes;
 
         void del_clauses(clause * const * begin, clause * const * end);
 
@@ -145,7 +159,12 @@ namespace sat {
         friend class asymm_branch;
         friend class probing;
         friend class iff3_finder;
+        friend class xor_finder;
+        friend class xor_extension;
         friend class mus;
+        friend class lookahead;
+        friend class local_search;
+        friend class drat;
         friend struct mk_stat;
     public:
         solver(params_ref const & p, reslimit& l, extension * ext);
@@ -280,7 +299,7 @@ namespace sat {
             m_num_checkpoints = 0;
             if (memory::get_allocation_size() > m_config.m_max_memory) throw solver_exception(Z3_MAX_MEMORY_MSG);
         }
-        void set_par(par* p);
+        void set_par(par* p, unsigned id);
         bool canceled() { return !m_rlimit.inc(); }
         config const& get_config() { return m_config; }
         typedef std::pair<literal, literal> bin_clause;
@@ -317,6 +336,12 @@ namespace sat {
     public:
         lbool check(unsigned num_lits = 0, literal const* lits = 0);
 
+        /**
+           \brief result of the last DRAT check (sat.drat.check),
+           l_undef if the last refutation was not checked.
+         */
+        lbool drat_check_result() const { return m_drat.check_result(); }
+
         model const & get_model() const { return m_model; }
         bool model_is_current() const { return m_model_is_current; }
         literal_vector const& get_core() const { return m_core; }
@@ -331,6 +356,7 @@ namespace sat {
         unsigned m_luby_idx;
         unsigned m_conflicts_since_gc;
         unsigned m_gc_threshold;
+        clause_vector m_gc_removed; // learned clauses deleted by the current gc
         unsigned m_num_checkpoints;
         double   m_min_d_tk;
         unsigned m_next_simplify;
@@ -357,9 +383,17 @@ namespace sat {
         void mk_model();
         bool check_model(model const & m) const;
         void restart();
+        void rephase();
+        void find_xors();
         void sort_watch_lits();
         void exchange_par();
+        void share_lemma(unsigned glue);
+        void import_par_clauses();
+        void import_par_clause(unsigned sz, literal const* lits);
         lbool check_par(unsigned num_lits, literal const* lits);
+        lbool check_cubes();
+        lbool check_core(unsigned num_lits, literal const* lits);
+        void check_drat();
 
         // -----------------------
         //
@@ -375,6 +409,10 @@ namespace sat {
         void save_psm();
         void gc_half(char const * st_name);
         void gc_dyn_psm();
+        void gc_del_clauses();
+        void compact_watches();
+        void gc_defrag();
+        void defrag_clauses();
         bool activate_frozen_clause(clause & c);
         unsigned psm(clause const & c) const;
         bool can_delete(clause const & c) const {
@@ -0,0 +1,412 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_extension.cpp
+
+Abstract:
+
+    XOR constraints  x1 xor ... xor xk = rhs  as a SAT extension.
+
+Author:
+
+    agent (agent@local) 2026-10-16.
+
+Revision History:
+
+--*/
+#include "sat/sat_xor_extension.h"
+#include "sat/sat_solver.h"
+#include "util/union_find.h"
+
+namespace sat {
+
+    xor_extension::xor_extension(solver & _s, unsigned gauss_max):
+        s(_s),
+        m_gauss_max(gauss_max) {
+    }
+
+    literal xor_extension::true_literal(bool_var v) const {
+        SASSERT(s.value(v) != l_undef);
+        return literal(v, s.value(v) == l_false);
+    }
+
+    /**
+       \brief the constraint is visited when v is assigned, with either value.
+    */
+    void xor_extension::watch(unsigned idx, bool_var v) {
+        s.get_wlist(literal(v, false)).push_back(watched(idx));
+        s.get_wlist(literal(v, true)).push_back(watched(idx));
+    }
+
+    static void erase_ext_watch(watch_list & wlist, ext_constraint_idx idx) {
+        // the watches of the constraints are usually at the end of the watch list.
+        for (unsigned i = wlist.size(); i-- > 0; ) {
+            if (wlist[i].is_ext_constraint() && wlist[i].get_ext_constraint_idx() == idx) {
+                std::swap(wlist[i], wlist.back());
+                wlist.pop_back();
+                return;
+            }
+        }
+        UNREACHABLE();
+    }
+
+    static void erase_ext_watches(watch_list & wlist) {
+        unsigned j = 0;
+        for (unsigned i = 0; i < wlist.size(); ++i) {
+            if (!wlist[i].is_ext_constraint())
+                wlist[j++] = wlist[i];
+        }
+        wlist.shrink(j);
+    }
+
+    void xor_extension::detach_rows() {
+        svector<char> done(s.num_vars(), false);
+        for (unsigned i = 0; i < m_rows.size(); ++i) {
+            for (unsigned j = 0; j < 2; ++j) {
+                bool_var v = m_rows[i].m_vars[j];
+                if (done[v])
+                    continue;
+                done[v] = true;
+                erase_ext_watches(s.get_wlist(literal(v, false)));
+                erase_ext_watches(s.get_wlist(literal(v, true)));
+            }
+        }
+        m_rows.reset();
+    }
+
+    /**
+       \brief sort the variables of r, and remove the fixed variables and the pairs of
+       equal variables. Return false if r is inconsistent.
+    */
+    bool xor_extension::normalize(xor_row & r) {
+        bool_var_vector & vs = r.m_vars;
+        std::sort(vs.begin(), vs.end());
+        unsigned j = 0;
+        for (unsigned i = 0; i < vs.size(); ++i) {
+            bool_var v = vs[i];
+            if (i + 1 < vs.size() && vs[i + 1] == v) {
+                ++i;
+                continue;
+            }
+            switch (s.value(v)) {
+            case l_true:
+                r.m_rhs = !r.m_rhs;
+                break;
+            case l_false:
+                break;
+            case l_undef:
+                vs[j++] = v;
+                break;
+            }
+        }
+        vs.shrink(j);
+        return !vs.empty() || !r.m_rhs;
+    }
+
+    void xor_extension::add_row(xor_row & r) {
+        SASSERT(s.scope_lvl() == 0);
+        if (!normalize(r)) {
+            s.set_conflict(justification());
+            return;
+        }
+        switch (r.m_vars.size()) {
+        case 0:
+            return;
+        case 1:
+            s.assign(literal(r.m_vars[0], !r.m_rhs), justification());
+            return;
+        default:
+            break;
+        }
+        unsigned idx = m_rows.size();
+        for (unsigned i = 0; i < r.m_vars.size(); ++i) {
+            // the extension must be notified of the assignments
+            s.set_external(r.m_vars[i]);
+        }
+        m_rows.push_back(r);
+        watch(idx, r.m_vars[0]);
+        watch(idx, r.m_vars[1]);
+    }
+
+    void xor_extension::add_xor(unsigned sz, bool_var const * vars, bool rhs) {
+        if (s.inconsistent())
+            return;
+        xor_row r;
+        r.m_vars.append(sz, vars);
+        r.m_rhs = rhs;
+        add_row(r);
+    }
+
+    void xor_extension::mk_conflict(unsigned idx, bool_var v) {
+        ++m_stats.m_num_conflicts;
+        s.set_conflict(justification::mk_ext_justification(idx), true_literal(v));
+    }
+
+    void xor_extension::propagate(literal l, ext_constraint_idx idx, bool & keep) {
+        xor_row & r = m_rows[idx];
+        bool_var_vector & vs = r.m_vars;
+        if (vs[0] == l.var())
+            std::swap(vs[0], vs[1]);
+        SASSERT(vs[1] == l.var());
+        unsigned sz = vs.size();
+        for (unsigned i = 2; i < sz; ++i) {
+            if (s.value(vs[i]) == l_undef) {
+                std::swap(vs[1], vs[i]);
+                erase_ext_watch(s.get_wlist(~l), idx);
+                watch(idx, vs[1]);
+                keep = false;
+                return;
+            }
+        }
+        keep = true;
+        // all variables but vs[0] are assigned: vs[0] = rhs xor vs[1] xor ... xor vs[sz-1]
+        bool val = r.m_rhs;
+        for (unsigned i = 1; i < sz; ++i) {
+            if (s.value(vs[i]) == l_true)
+                val = !val;
+        }
+        switch (s.value(vs[0])) {
+        case l_undef:
+            ++m_stats.m_num_propagations;
+            s.assign(literal(vs[0], !val), justification::mk_ext_justification(idx));
+            break;
+        case l_true:
+            if (!val) mk_conflict(idx, vs[0]);
+            break;
+        case l_false:
+            if (val) mk_conflict(idx, vs[0]);
+            break;
+        }
+    }
+
+    void xor_extension::get_antecedents(literal l, ext_justification_idx idx, literal_vector & r) {
+        bool_var_vector const & vs = m_rows[idx].m_vars;
+        for (unsigned i = 0; i < vs.size(); ++i) {
+            if (vs[i] != l.var())
+                r.push_back(true_literal(vs[i]));
+        }
+    }
+
+    check_result xor_extension::check() {
+        for (unsigned i = 0; i < m_rows.size(); ++i) {
+            bool_var_vector const & vs = m_rows[i].m_vars;
+            bool val = m_rows[i].m_rhs;
+            for (unsigned j = 0; j < vs.size(); ++j) {
+                switch (s.value(vs[j])) {
+                case l_true:  val = !val; break;
+                case l_false: break;
+                case l_undef: UNREACHABLE(); return CR_GIVEUP;
+                }
+            }
+            if (val) {
+                UNREACHABLE();
+                return CR_GIVEUP;
+            }
+        }
+        return CR_DONE;
+    }
+
+    struct xor_row_lt {
+        template<typename R>
+        bool operator()(R const * r1, R const * r2) const {
+            unsigned sz1 = r1->m_vars.size(), sz2 = r2->m_vars.size();
+            if (sz1 != sz2) return sz1 < sz2;
+            for (unsigned i = 0; i < sz1; ++i) {
+                if (r1->m_vars[i] != r2->m_vars[i]) return r1->m_vars[i] < r2->m_vars[i];
+            }
+            return r1->m_rhs < r2->m_rhs;
+        }
+    };
+
+    static bool same_vars(bool_var_vector const & vs1, bool_var_vector const & vs2) {
+        if (vs1.size() != vs2.size())
+            return false;
+        for (unsigned i = 0; i < vs1.size(); ++i) {
+            if (vs1[i] != vs2[i])
+                return false;
+        }
+        return true;
+    }
+
+    void xor_extension::simplify() {
+        SASSERT(s.scope_lvl() == 0);
+        if (m_rows.empty() || s.inconsistent())
+            return;
+        vector<xor_row> rows(m_rows);
+        detach_rows();
+        unsigned j = 0;
+        for (unsigned i = 0; i < rows.size(); ++i) {
+            if (!normalize(rows[i])) {
+                s.set_conflict(justification());
+                return;
+            }
+            if (!rows[i].m_vars.empty())
+                rows[j++] = rows[i];
+        }
+        rows.shrink(j);
+        gauss_jordan(rows);
+        if (s.inconsistent())
+            return;
+        ptr_vector<xor_row> ps;
+        for (unsigned i = 0; i < rows.size(); ++i) {
+            if (!normalize(rows[i])) {
+                s.set_conflict(justification());
+                return;
+            }
+            ps.push_back(&rows[i]);
+        }
+        std::sort(ps.begin(), ps.end(), xor_row_lt());
+        for (unsigned i = 0; i < ps.size() && !s.inconsistent(); ++i) {
+            if (i > 0 && same_vars(ps[i]->m_vars, ps[i - 1]->m_vars)) {
+                if (ps[i]->m_rhs != ps[i - 1]->m_rhs)
+                    s.set_conflict(justification());
+                continue;
+            }
+            add_row(*ps[i]);
+        }
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << " (sat-xor :xors " << m_rows.size()
+                   << " :gauss-units " << m_stats.m_num_gauss_units << ")\n";);
+    }
+
+    /**
+       \brief apply Gauss-Jordan elimination to every connected component of rows.
+    */
+    void xor_extension::gauss_jordan(vector<xor_row> & rows) {
+        basic_union_find uf;
+        for (unsigned i = 0; i < rows.size(); ++i) {
+            bool_var_vector const & vs = rows[i].m_vars;
+            for (unsigned j = 1; j < vs.size(); ++j)
+                uf.merge(vs[0], vs[j]);
+        }
+        unsigned_vector root2comp(s.num_vars(), UINT_MAX);
+        vector<unsigned_vector> comps;
+        for (unsigned i = 0; i < rows.size(); ++i) {
+            unsigned root = uf.find(rows[i].m_vars[0]);
+            if (root2comp[root] == UINT_MAX) {
+                root2comp[root] = comps.size();
+                comps.push_back(unsigned_vector());
+            }
+            comps[root2comp[root]].push_back(i);
+        }
+        unsigned_vector col(s.num_vars(), UINT_MAX);
+        vector<xor_row> result;
+        for (unsigned i = 0; i < comps.size() && !s.inconsistent(); ++i)
+            gauss_jordan(rows, comps[i], col, result);
+        rows.swap(result);
+    }
+
+    /**
+       \brief reduce the rows with indices in comp to row echelon form. The reduced
+       rows are added to result if they are not larger than the original rows,
+       otherwise the original rows are added together with the short reduced rows.
+    */
+    void xor_extension::gauss_jordan(vector<xor_row> const & rows, unsigned_vector const & comp, unsigned_vector & col, vector<xor_row> & result) {
+        bool_var_vector vars;
+        unsigned orig_size = 0;
+        for (unsigned i = 0; i < comp.size(); ++i) {
+            bool_var_vector const & vs = rows[comp[i]].m_vars;
+            for (unsigned j = 0; j < vs.size(); ++j) {
+                if (col[vs[j]] == UINT_MAX) {
+                    col[vs[j]] = 0;
+                    vars.push_back(vs[j]);
+                }
+            }
+            orig_size += vs.size();
+        }
+        std::sort(vars.begin(), vars.end());
+        for (unsigned i = 0; i < vars.size(); ++i)
+            col[vars[i]] = i;
+        unsigned num_rows = comp.size();
+        unsigned num_cols = vars.size();
+        if (num_rows < 2 || static_cast<uint64>(num_rows) * num_cols > m_gauss_max) {
+            for (unsigned i = 0; i < num_cols; ++i)
+                col[vars[i]] = UINT_MAX;
+            for (unsigned i = 0; i < comp.size(); ++i)
+                result.push_back(rows[comp[i]]);
+            return;
+        }
+        unsigned num_words = (num_cols + 63) / 64;
+        svector<uint64> m(num_rows * num_words, static_cast<uint64>(0));
+        svector<bool> rhs;
+        for (unsigned i = 0; i < num_rows; ++i) {
+            bool_var_vector const & vs = rows[comp[i]].m_vars;
+            for (unsigned j = 0; j < vs.size(); ++j) {
+                unsigned c = col[vs[j]];
+                m[i * num_words + c / 64] ^= 1ull << (c % 64);
+            }
+            rhs.push_back(rows[comp[i]].m_rhs);
+        }
+        for (unsigned i = 0; i < num_cols; ++i)
+            col[vars[i]] = UINT_MAX;
+
+        unsigned pivot = 0;
+        for (unsigned c = 0; c < num_cols && pivot < num_rows; ++c) {
+            if ((c & 0xFF) == 0)
+                s.checkpoint();
+            unsigned w = c / 64;
+            uint64 bit = 1ull << (c % 64);
+            unsigned r = pivot;
+            while (r < num_rows && (m[r * num_words + w] & bit) == 0)
+                ++r;
+            if (r == num_rows)
+                continue;
+            if (r != pivot) {
+                for (unsigned k = w; k < num_words; ++k)
+                    std::swap(m[r * num_words + k], m[pivot * num_words + k]);
+                std::swap(rhs[r], rhs[pivot]);
+            }
+            // the pivot row has no entries before column c.
+            uint64 const * p = m.c_ptr() + pivot * num_words;
+            for (unsigned r2 = 0; r2 < num_rows; ++r2) {
+                uint64 * q = m.c_ptr() + r2 * num_words;
+                if (r2 != pivot && (q[w] & bit) != 0) {
+                    for (unsigned k = w; k < num_words; ++k)
+                        q[k] ^= p[k];
+                    rhs[r2] = rhs[r2] != rhs[pivot];
+                }
+            }
+            ++pivot;
+        }
+        for (unsigned r = pivot; r < num_rows; ++r) {
+            if (rhs[r]) {
+                // 0 = 1
+                s.set_conflict(justification());
+                return;
+            }
+        }
+        vector<xor_row> reduced;
+        unsigned reduced_size = 0;
+        for (unsigned r = 0; r < pivot; ++r) {
+            reduced.push_back(xor_row());
+            xor_row & row = reduced.back();
+            row.m_rhs = rhs[r];
+            for (unsigned c = 0; c < num_cols; ++c) {
+                if ((m[r * num_words + c / 64] & (1ull << (c % 64))) != 0)
+                    row.m_vars.push_back(vars[c]);
+            }
+            reduced_size += row.m_vars.size();
+            if (row.m_vars.size() == 1)
+                ++m_stats.m_num_gauss_units;
+        }
+        if (reduced_size <= orig_size) {
+            result.append(reduced);
+        }
+        else {
+            for (unsigned i = 0; i < comp.size(); ++i)
+                result.push_back(rows[comp[i]]);
+            for (unsigned r = 0; r < reduced.size(); ++r) {
+                if (reduced[r].m_vars.size() <= 2)
+                    result.push_back(reduced[r]);
+            }
+        }
+    }
+
+    void xor_extension::collect_statistics(statistics & st) const {
+        st.update("xor constraints", m_rows.size());
+        st.update("xor propagations", m_stats.m_num_propagations);
+        st.update("xor conflicts", m_stats.m_num_conflicts);
+        st.update("xor gauss units", m_stats.m_num_gauss_units);
+    }
+};
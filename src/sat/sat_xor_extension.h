@@ -0,0 +1,103 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_extension.h
+
+Abstract:
+
+    XOR constraints  x1 xor ... xor xk = rhs  as a SAT extension.
+
+    During search, every constraint watches two of its variables (the
+    first two in its variable vector), on both of their literals. When
+    a watched variable is assigned, another unassigned variable is
+    watched instead. When there is none, the other watched variable is
+    propagated, or a conflict is reported if it is already assigned
+    with the wrong parity. Explanations are produced lazily: the
+    antecedents of a propagation are the current values of the other
+    variables of the constraint.
+
+    At base level (when the solver simplifies), the constraints are
+    simplified with respect to the fixed variables, and Gauss-Jordan
+    elimination is applied to every connected component of the system.
+    This detects inconsistent systems, and implied units and
+    equivalences. The reduced system replaces the component when it is
+    not larger.
+
+Author:
+
+    agent (agent@local) 2026-10-16.
+
+Revision History:
+
+--*/
+#ifndef SAT_XOR_EXTENSION_H_
+#define SAT_XOR_EXTENSION_H_
+
+#include "sat/sat_extension.h"
+#include "sat/sat_justification.h"
+#include "util/statistics.h"
+
+namespace sat {
+
+    class solver;
+
+    class xor_extension : public extension {
+
+        struct stats {
+            unsigned m_num_propagations;
+            unsigned m_num_conflicts;
+            unsigned m_num_gauss_units;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        struct xor_row {
+            bool_var_vector m_vars;  // m_vars[0] and m_vars[1] are watched
+            bool            m_rhs;
+            xor_row(): m_rhs(false) {}
+        };
+
+        solver &        s;
+        unsigned        m_gauss_max;    // maximal number of entries of a matrix
+        vector<xor_row> m_rows;
+        stats           m_stats;
+
+        literal true_literal(bool_var v) const;
+        void watch(unsigned idx, bool_var v);
+        void detach_rows();
+        bool normalize(xor_row & r);
+        void add_row(xor_row & r);
+        void gauss_jordan(vector<xor_row> & rows);
+        void gauss_jordan(vector<xor_row> const & rows, unsigned_vector const & comp, unsigned_vector & col, vector<xor_row> & result);
+        void mk_conflict(unsigned idx, bool_var v);
+
+    public:
+        xor_extension(solver & s, unsigned gauss_max);
+
+        /**
+           \brief add the constraint vars[0] xor ... xor vars[sz-1] = rhs.
+           The solver must be at base level.
+        */
+        void add_xor(unsigned sz, bool_var const * vars, bool rhs);
+
+        unsigned num_xors() const { return m_rows.size(); }
+
+        void collect_statistics(statistics & st) const;
+        void reset_statistics() { m_stats.reset(); }
+
+        virtual void propagate(literal l, ext_constraint_idx idx, bool & keep);
+        virtual void get_antecedents(literal l, ext_justification_idx idx, literal_vector & r);
+        virtual void asserted(literal l) {}
+        virtual check_result check();
+        virtual void push() {}
+        virtual void pop(unsigned n) {}
+        virtual void simplify();
+        virtual void clauses_modifed() {}
+        virtual lbool get_phase(bool_var v) { return l_undef; }
+    };
+
+};
+
+#endif
@@ -0,0 +1,148 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_finder.cpp
+
+Abstract:
+
+    Find XOR constraints  x1 xor ... xor xk = rhs  among the clauses.
+
+Author:
+
+    agent (agent@local) 2026-10-16.
+
+Revision History:
+
+--*/
+#include "sat/sat_xor_finder.h"
+#include "sat/sat_solver.h"
+
+namespace sat {
+
+    struct xor_finder::entry_lt {
+        bool_var_vector const & m_vars;
+        entry_lt(bool_var_vector const & vars): m_vars(vars) {}
+        bool operator()(entry const & e1, entry const & e2) const {
+            unsigned sz1 = e1.m_clause->size();
+            unsigned sz2 = e2.m_clause->size();
+            if (sz1 != sz2) return sz1 < sz2;
+            for (unsigned i = 0; i < sz1; ++i) {
+                bool_var v1 = m_vars[e1.m_begin + i];
+                bool_var v2 = m_vars[e2.m_begin + i];
+                if (v1 != v2) return v1 < v2;
+            }
+            return false;
+        }
+    };
+
+    xor_finder::xor_finder(solver & _s, unsigned max_size):
+        s(_s),
+        m_max_size(std::min(max_size, 8u)),
+        m_xor_vars(0),
+        m_xor_rhs(0) {
+    }
+
+    static unsigned parity(unsigned mask) {
+        unsigned p = 0;
+        for (; mask != 0; mask &= mask - 1) p ^= 1;
+        return p;
+    }
+
+    /**
+       \brief m_entries[begin .. end) are the clauses over the same k variables.
+       They contain an XOR constraint if, for some parity p, they contain the 2^(k-1)
+       sign patterns of parity p. Each of these clauses excludes one assignment of
+       parity p, so together they state  x1 xor ... xor xk = 1 - p.
+    */
+    void xor_finder::extract_xor(unsigned begin, unsigned end) {
+        entry const & e0 = m_entries[begin];
+        unsigned sz = e0.m_clause->size();
+        for (unsigned p = 0; p < 2; ++p) {
+            uint64 seen[4] = { 0, 0, 0, 0 };
+            unsigned num_masks = 0;
+            for (unsigned i = begin; i < end; ++i) {
+                unsigned mask = m_entries[i].m_mask;
+                if (parity(mask) != p)
+                    continue;
+                uint64 bit = 1ull << (mask & 63);
+                if ((seen[mask >> 6] & bit) == 0) {
+                    seen[mask >> 6] |= bit;
+                    ++num_masks;
+                }
+            }
+            if (num_masks < (1u << (sz - 1)))
+                continue;
+            m_xor_vars->push_back(bool_var_vector());
+            m_xor_vars->back().append(sz, m_vars.c_ptr() + e0.m_begin);
+            m_xor_rhs->push_back(p == 0);
+            for (unsigned i = begin; i < end; ++i) {
+                clause & c = *m_entries[i].m_clause;
+                if (parity(m_entries[i].m_mask) == p && !c.was_removed()) {
+                    s.detach_clause(c);
+                    c.set_removed(true);
+                }
+            }
+        }
+    }
+
+    void xor_finder::operator()(vector<bool_var_vector> & vars, svector<bool> & rhs) {
+        SASSERT(s.scope_lvl() == 0);
+        m_xor_vars = &vars;
+        m_xor_rhs  = &rhs;
+        unsigned num_xors = vars.size();
+        m_entries.reset();
+        m_vars.reset();
+        clause_vector::iterator it  = s.m_clauses.begin();
+        clause_vector::iterator end = s.m_clauses.end();
+        for (; it != end; ++it) {
+            clause & c = *(*it);
+            unsigned sz = c.size();
+            if (sz < 3 || sz > m_max_size || c.was_removed() || c.frozen())
+                continue;
+            entry e;
+            e.m_clause = &c;
+            e.m_begin  = m_vars.size();
+            e.m_mask   = 0;
+            for (unsigned i = 0; i < sz; ++i)
+                m_vars.push_back(c[i].var());
+            std::sort(m_vars.begin() + e.m_begin, m_vars.end());
+            for (unsigned i = 0; i < sz; ++i) {
+                unsigned pos = 0;
+                while (m_vars[e.m_begin + pos] != c[i].var()) ++pos;
+                if (c[i].sign())
+                    e.m_mask |= 1u << pos;
+            }
+            m_entries.push_back(e);
+        }
+        std::sort(m_entries.begin(), m_entries.end(), entry_lt(m_vars));
+        entry_lt lt(m_vars);
+        unsigned num_entries = m_entries.size();
+        for (unsigned i = 0, j = 0; i < num_entries; i = j) {
+            for (j = i + 1; j < num_entries && !lt(m_entries[i], m_entries[j]); ++j)
+                ;
+            unsigned sz = m_entries[i].m_clause->size();
+            if (j - i >= (1u << (sz - 1)))
+                extract_xor(i, j);
+        }
+        if (vars.size() > num_xors) {
+            it  = s.m_clauses.begin();
+            clause_vector::iterator it2 = it;
+            for (; it != end; ++it) {
+                clause & c = *(*it);
+                if (c.was_removed()) {
+                    s.del_clause(c);
+                }
+                else {
+                    *it2 = *it;
+                    ++it2;
+                }
+            }
+            s.m_clauses.set_end(it2);
+        }
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << " (sat-xor-finder :xors " << (vars.size() - num_xors) << ")\n";);
+        m_entries.finalize();
+        m_vars.finalize();
+    }
+};
@@ -0,0 +1,69 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_finder.h
+
+Abstract:
+
+    Find XOR constraints  x1 xor ... xor xk = rhs  among the clauses.
+    That is, search for the 2^(k-1) clauses over the variables x1 ... xk
+    whose number of negative literals has the same parity, e.g.,
+      x \/ l1  \/ l2
+      x \/ ~l1 \/ ~l2
+     ~x \/ l1  \/ ~l2
+     ~x \/ ~l1 \/ l2
+    for  x xor l1 xor l2 = 1.
+
+    The basic idea is to sort the clauses by their set of variables,
+    as iff3_finder does for ternary clauses.
+
+    The clauses of a constraint that is found are removed from the
+    solver.
+
+Author:
+
+    agent (agent@local) 2026-10-16.
+
+Revision History:
+
+--*/
+#ifndef SAT_XOR_FINDER_H_
+#define SAT_XOR_FINDER_H_
+
+#include "sat/sat_types.h"
+
+namespace sat {
+
+    class xor_finder {
+        struct entry {
+            clause * m_clause;
+            unsigned m_begin;  // sorted variables of the clause are m_vars[m_begin .. m_begin + size)
+            unsigned m_mask;   // bit i is set if the literal of the i-th variable is negative
+        };
+        struct entry_lt;
+
+        solver &         s;
+        unsigned         m_max_size;
+        svector<entry>   m_entries;
+        bool_var_vector  m_vars;
+        vector<bool_var_vector> * m_xor_vars;
+        svector<bool> *  m_xor_rhs;
+
+        void extract_xor(unsigned begin, unsigned end);
+    public:
+        xor_finder(solver & s, unsigned max_size);
+
+        /**
+           \brief find the XOR constraints of size at most max_size, remove
+           their clauses, and store the constraints in vars and rhs.
+           The variables of constraint i are in vars[i], and the constraint
+           is  vars[i][0] xor ... xor vars[i][k-1] = rhs[i].
+        */
+        void operator()(vector<bool_var_vector> & vars, svector<bool> & rhs);
+    };
+
+};
+
+#endif
@@ -172,6 +172,9 @@ unsigned read_dimacs(char const * file_name) {
         break;
     case l_false: 
         std::cout << "unsat\n"; 
+        if (g_solver->drat_check_result() == l_true) {
+            std::cout << "c DRAT proof verified\n";
+        }
         if (p.get_bool("dimacs.core", false)) {
             display_core(*g_solver, tracking_clauses);
         }
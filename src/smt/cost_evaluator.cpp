@@ -102,3 +102,155 @@ float cost_evaluator::operator()(expr * f, unsigned num_args, float const * args
 
 
 
+
+void compiled_cost_function::compile_core(ast_manager & m, arith_util & a, cost_evaluator & ev, expr * f) {
+#define C(IDX) compile_core(m, a, ev, to_app(f)->get_arg(IDX))
+    if (is_ground(f)) {
+        emit(PUSH_CONST, 0, ev(f, 0, 0));
+        return;
+    }
+    if (is_var(f)) {
+        unsigned idx = to_var(f)->get_idx();
+        if (idx < m_num_args) {
+            emit(PUSH_VAR, m_num_args - idx - 1);
+            return;
+        }
+    }
+    else {
+        app * n = to_app(f);
+        unsigned num_args = n->get_num_args();
+        unsigned jmp;
+        unsigned_vector jmps;
+        if (n->get_family_id() == m.get_basic_family_id()) {
+            switch (n->get_decl_kind()) {
+            case OP_NOT:     C(0); emit(NOT); return;
+            case OP_AND:
+            case OP_OR: {
+                // the arguments are evaluated until one of them decides the result.
+                bool is_and = n->get_decl_kind() == OP_AND;
+                for (unsigned i = 0; i < num_args; i++) {
+                    C(i);
+                    jmps.push_back(m_code.size());
+                    emit(is_and ? JZ : JNZ);
+                }
+                emit(PUSH_CONST, 0, is_and ? 1.0f : 0.0f);
+                jmp = m_code.size();
+                emit(JMP);
+                for (unsigned pc : jmps)
+                    patch(pc);
+                emit(PUSH_CONST, 0, is_and ? 0.0f : 1.0f);
+                patch(jmp);
+                return;
+            }
+            case OP_ITE:
+                C(0);
+                jmps.push_back(m_code.size());
+                emit(JZ);
+                C(1);
+                jmp = m_code.size();
+                emit(JMP);
+                patch(jmps[0]);
+                C(2);
+                patch(jmp);
+                return;
+            case OP_EQ:
+            case OP_IFF:     C(0); C(1); emit(EQ); return;
+            case OP_XOR:     C(0); C(1); emit(XOR); return;
+            case OP_IMPLIES:
+                C(0);
+                jmps.push_back(m_code.size());
+                emit(JZ);
+                C(1);
+                emit(TO_BOOL);
+                jmp = m_code.size();
+                emit(JMP);
+                patch(jmps[0]);
+                emit(PUSH_CONST, 0, 1.0f);
+                patch(jmp);
+                return;
+            default:
+                ;
+            }
+        }
+        else if (n->get_family_id() == a.get_family_id()) {
+            switch (n->get_decl_kind()) {
+            case OP_LE:      C(0); C(1); emit(LE); return;
+            case OP_GE:      C(0); C(1); emit(GE); return;
+            case OP_LT:      C(0); C(1); emit(LT); return;
+            case OP_GT:      C(0); C(1); emit(GT); return;
+            case OP_ADD:     C(0); C(1); emit(ADD); return;
+            case OP_SUB:     C(0); C(1); emit(SUB); return;
+            case OP_UMINUS:  C(0); emit(UMINUS); return;
+            case OP_MUL:     C(0); C(1); emit(MUL); return;
+            case OP_DIV:     C(0); C(1); emit(DIV); return;
+            default:
+                ;
+            }
+        }
+    }
+    warning_msg("cost function evaluation error");
+    emit(PUSH_CONST, 0, 1.0f);
+}
+
+void compiled_cost_function::compile(ast_manager & m, expr * f, unsigned num_args) {
+    arith_util a(m);
+    cost_evaluator ev(m);
+    m_num_args = num_args;
+    m_code.reset();
+    compile_core(m, a, ev, f);
+    m_stack.resize(m_code.size(), 0.0f);
+    m_kind = K_CODE;
+    if (m_code.size() == 1 && m_code[0].m_op == PUSH_CONST) {
+        m_kind  = K_CONST;
+        m_const = m_code[0].m_val;
+    }
+    else if (m_code.size() == 1 && m_code[0].m_op == PUSH_VAR) {
+        m_kind = K_VAR;
+        m_idx1 = m_code[0].m_idx;
+    }
+    else if (m_code.size() == 3 && m_code[0].m_op == PUSH_VAR && m_code[1].m_op == PUSH_VAR && m_code[2].m_op == ADD) {
+        m_kind = K_ADD_VARS;
+        m_idx1 = m_code[0].m_idx;
+        m_idx2 = m_code[1].m_idx;
+    }
+}
+
+float compiled_cost_function::run(float const * args) const {
+    float * sp = m_stack.c_ptr(); // next free slot
+    unsigned pc = 0;
+    unsigned sz = m_code.size();
+    while (pc < sz) {
+        instr const & i = m_code[pc++];
+        switch (i.m_op) {
+        case PUSH_CONST: *sp++ = i.m_val; break;
+        case PUSH_VAR:   *sp++ = args[i.m_idx]; break;
+        case NOT:        sp[-1] = sp[-1] == 0.0f ? 1.0f : 0.0f; break;
+        case TO_BOOL:    sp[-1] = sp[-1] != 0.0f ? 1.0f : 0.0f; break;
+        case EQ:         --sp; sp[-1] = sp[-1] == sp[0] ? 1.0f : 0.0f; break;
+        case XOR:        --sp; sp[-1] = sp[-1] != sp[0] ? 1.0f : 0.0f; break;
+        case LE:         --sp; sp[-1] = sp[-1] <= sp[0] ? 1.0f : 0.0f; break;
+        case GE:         --sp; sp[-1] = sp[-1] >= sp[0] ? 1.0f : 0.0f; break;
+        case LT:         --sp; sp[-1] = sp[-1] <  sp[0] ? 1.0f : 0.0f; break;
+        case GT:         --sp; sp[-1] = sp[-1] >  sp[0] ? 1.0f : 0.0f; break;
+        case ADD:        --sp; sp[-1] = sp[-1] + sp[0]; break;
+        case SUB:        --sp; sp[-1] = sp[-1] - sp[0]; break;
+        case UMINUS:     sp[-1] = - sp[-1]; break;
+        case MUL:        --sp; sp[-1] = sp[-1] * sp[0]; break;
+        case DIV:
+            --sp;
+            if (sp[0] == 0.0f) {
+                warning_msg("cost function division by zero");
+                sp[-1] = 1.0f;
+            }
+            else {
+                sp[-1] = sp[-1] / sp[0];
+            }
+            break;
+        case JMP:        pc = i.m_idx; break;
+        case JZ:         if (*--sp == 0.0f) pc = i.m_idx; break;
+        case JNZ:        if (*--sp != 0.0f) pc = i.m_idx; break;
+        }
+    }
+    SASSERT(sp == m_stack.c_ptr() + 1);
+    return sp[-1];
+}
@@ -21,6 +21,7 @@ Revision History:
 
 #include "ast/ast.h"
 #include "ast/arith_decl_plugin.h"
+#include "util/vector.h"
 
 class cost_evaluator {
     ast_manager &   m_manager;
@@ -39,5 +40,62 @@ public:
     float operator()(expr * f, unsigned num_args, float const * args);
 };
 
+/**
+   \brief Cost function compiled into code for a small stack machine.
+
+   The ground subterms are folded into constants, and the common shapes
+   (a constant, a variable, and the sum of two variables such as the
+   default "(+ weight generation)") are evaluated without the stack.
+   The result is the same as the one of cost_evaluator on the same
+   arguments, but the function is not traversed for every evaluation.
+*/
+class compiled_cost_function {
+    enum kind { K_CONST, K_VAR, K_ADD_VARS, K_CODE };
+    enum opcode {
+        PUSH_CONST, PUSH_VAR,
+        NOT, EQ, XOR, LE, GE, LT, GT, ADD, SUB, UMINUS, MUL, DIV,
+        TO_BOOL,  // replace the top by 1 if it is not 0
+        JMP,      // jump to m_idx
+        JZ,       // pop, and jump to m_idx if the value is 0
+        JNZ       // pop, and jump to m_idx if the value is not 0
+    };
+    struct instr {
+        opcode   m_op;
+        unsigned m_idx;   // index of the variable in the arguments, or jump target
+        float    m_val;
+        instr(opcode op, unsigned idx = 0, float val = 0.0f): m_op(op), m_idx(idx), m_val(val) {}
+    };
+    kind            m_kind;
+    float           m_const;
+    unsigned        m_idx1;
+    unsigned        m_idx2;
+    unsigned        m_num_args;
+    svector<instr>  m_code;
+    mutable svector<float> m_stack;
+
+    void emit(opcode op, unsigned idx = 0, float val = 0.0f) { m_code.push_back(instr(op, idx, val)); }
+    void patch(unsigned pc) { m_code[pc].m_idx = m_code.size(); }
+    void compile_core(ast_manager & m, arith_util & a, cost_evaluator & ev, expr * f);
+    float run(float const * args) const;
+public:
+    compiled_cost_function(): m_kind(K_CONST), m_const(1.0f), m_idx1(0), m_idx2(0), m_num_args(0) {}
+
+    /**
+       \brief Compile f for arguments of size num_args, using the conventions of cost_evaluator.
+    */
+    void compile(ast_manager & m, expr * f, unsigned num_args);
+
+    float operator()(float const * args) const {
+        switch (m_kind) {
+        case K_CONST:    return m_const;
+        case K_VAR:      return args[m_idx1];
+        case K_ADD_VARS: return args[m_idx1] + args[m_idx2];
+        default:         return run(args);
+        }
+    }
+
+    unsigned code_size() const { return m_code.size(); }
+};
+
 #endif /* COST_EVALUATOR_H_ */
 
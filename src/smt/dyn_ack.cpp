@@ -127,6 +127,8 @@ namespace smt {
 
 
     void dyn_ack_manager::init_search_eh() {
+        m_sketch.reset(m_params.m_dack_sketch_width, m_params.m_dack_sketch_depth);
+        m_triple.m_sketch.reset(m_params.m_dack_eq ? m_params.m_dack_sketch_width : 0, m_params.m_dack_sketch_depth);
         m_app_pair2num_occs.reset();
         reset_app_pairs();
         m_to_instantiate.reset();
@@ -151,6 +153,7 @@ namespace smt {
         app_pair p(n1, n2);
         if (m_instantiated.contains(p))
             return;
+        m_stats.m_num_events++;
         unsigned num_occs = 0;
         if (m_app_pair2num_occs.find(n1, n2, num_occs)) {
             TRACE("dyn_ack", tout << "used_cg_eh:\n" << mk_pp(n1, m_manager) << "\n" << mk_pp(n2, m_manager) << "\nnum_occs: " << num_occs << "\n";);
@@ -158,6 +161,13 @@ namespace smt {
         }
         else {
             num_occs = 1;
+            if (!m_sketch.empty()) {
+                unsigned id1 = n1->get_id(), id2 = n2->get_id();
+                if (m_sketch.inc(hash_u_u(id1, id2), hash_u_u(id2, id1)) < m_params.m_dack_threshold)
+                    return;
+                num_occs = m_params.m_dack_threshold;
+            }
+            m_stats.m_num_candidates++;
             m_manager.inc_ref(n1);
             m_manager.inc_ref(n2);
             m_app_pairs.push_back(p);
@@ -186,6 +196,7 @@ namespace smt {
         app_triple tr(n1, n2, r);
         if (m_triple.m_instantiated.contains(tr))
             return;
+        m_stats.m_num_events++;
         unsigned num_occs = 0;
         if (m_triple.m_app2num_occs.find(n1, n2, r, num_occs)) {
             TRACE("dyn_ack", tout << mk_pp(n1, m_manager) << "\n" << mk_pp(n2, m_manager) 
@@ -194,6 +205,13 @@ namespace smt {
         }
         else {
             num_occs = 1;
+            if (!m_triple.m_sketch.empty()) {
+                unsigned id1 = n1->get_id(), id2 = n2->get_id(), id3 = r->get_id();
+                if (m_triple.m_sketch.inc(mk_mix(id1, id2, id3), mk_mix(id3, id2, id1)) < m_params.m_dack_threshold)
+                    return;
+                num_occs = m_params.m_dack_threshold;
+            }
+            m_stats.m_num_candidates++;
             m_manager.inc_ref(n1);
             m_manager.inc_ref(n2);
             m_manager.inc_ref(r);
@@ -237,6 +255,7 @@ namespace smt {
     void dyn_ack_manager::gc() {
         TRACE("dyn_ack", tout << "dyn_ack GC\n";);
         unsigned num_deleted = 0;
+        m_sketch.decay(m_params.m_dack_gc_inv_decay);
         m_to_instantiate.reset();
         m_qhead = 0;
         svector<app_pair>::iterator it  = m_app_pairs.begin();
@@ -321,6 +340,8 @@ namespace smt {
         m_num_propagations_since_last_gc++;
         if (m_num_propagations_since_last_gc > m_params.m_dack_gc) {
             gc();
+            if (m_params.m_dack_gc_triples)
+                gc_triples();
             m_num_propagations_since_last_gc = 0;
         }
         unsigned max_instances  = static_cast<unsigned>(m_context.get_num_conflicts() * m_params.m_dack_factor);
@@ -383,6 +404,18 @@ namespace smt {
         m_clause2app_pair.insert(cls, p);
     }
 
+    void dyn_ack_manager::collect_statistics(::statistics & st) const {
+        if (m_params.m_dack == DACK_DISABLED)
+            return;
+        st.update("dyn ack events", m_stats.m_num_events);
+        st.update("dyn ack candidates", m_stats.m_num_candidates);
+        st.update("dyn ack deleted", m_context.m_stats.m_num_del_dyn_ack);
+        // each entry of the exact maps stores the keys and the number of occurrences.
+        unsigned map_memory = m_app_pair2num_occs.capacity() * (2 * sizeof(app*) + sizeof(unsigned)) +
+            m_triple.m_app2num_occs.capacity() * (3 * sizeof(app*) + sizeof(unsigned));
+        st.update("dyn ack memory", m_sketch.memory() + m_triple.m_sketch.memory() + map_memory);
+    }
+
     void dyn_ack_manager::reset() {
         init_search_eh();
         m_instantiated.reset();
@@ -459,6 +492,7 @@ namespace smt {
     void dyn_ack_manager::gc_triples() {
         TRACE("dyn_ack", tout << "dyn_ack GC\n";);
         unsigned num_deleted = 0;
+        m_triple.m_sketch.decay(m_params.m_dack_gc_inv_decay);
         m_triple.m_to_instantiate.reset();
         m_triple.m_qhead = 0;
         svector<app_triple>::iterator it  = m_triple.m_apps.begin();
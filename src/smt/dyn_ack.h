@@ -24,6 +24,8 @@ Revision History:
 #include "util/obj_hashtable.h"
 #include "util/obj_pair_hashtable.h"
 #include "util/obj_triple_hashtable.h"
+#include "util/count_min_sketch.h"
+#include "util/statistics.h"
 #include "smt/smt_clause.h"
 
 namespace smt {
@@ -43,9 +45,20 @@ namespace smt {
         typedef obj_triple_hashtable<app, app, app>      app_triple_set;
         typedef obj_map<clause, app_triple>         clause2app_triple;
 
+        struct stats {
+            unsigned m_num_events;     // congruences and equalities counted
+            unsigned m_num_candidates; // pairs and triples counted exactly
+            void reset() { memset(this, 0, sizeof(*this)); }
+            stats() { reset(); }
+        };
+
         context &                                  m_context;
         ast_manager &                              m_manager;
         dyn_ack_params &                           m_params;
+        stats                                      m_stats;
+        // With dack.sketch_width > 0, the pairs are first counted in m_sketch, and
+        // only the pairs whose estimate reaches dack.threshold are stored in m_app_pair2num_occs.
+        count_min_sketch                           m_sketch;
         app_pair2num_occs                          m_app_pair2num_occs;
         app_pair_vector                            m_app_pairs;
         app_pair_vector                            m_to_instantiate;
@@ -56,6 +69,7 @@ namespace smt {
         clause2app_pair                            m_clause2app_pair;
 
         struct _triple {
+            count_min_sketch                       m_sketch;
             app_triple2num_occs                    m_app2num_occs;
             app_triple_vector                      m_apps;
             app_triple_vector                      m_to_instantiate;
@@ -126,6 +140,8 @@ namespace smt {
 
         void reset();
 
+        void collect_statistics(::statistics & st) const;
+
 #ifdef Z3DEBUG
         bool check_invariant() const;
 #endif
@@ -20,13 +20,14 @@ Revision History:
 
 namespace smt {
 
-    fingerprint::fingerprint(region & r, void * d, unsigned d_h, unsigned n, enode * const * args):
-        m_data(d), 
-        m_data_hash(d_h),
-        m_num_args(n), 
-        m_args(0) {
-        m_args = new (r) enode*[n];
-        memcpy(m_args, args, sizeof(enode*) * n);
+    fingerprint * fingerprint::mk(region & r, void * d, unsigned d_h, unsigned n, enode * const * args) {
+        void * mem = r.allocate(get_obj_size(n));
+        fingerprint * f = new (mem) fingerprint();
+        f->m_data      = d;
+        f->m_data_hash = d_h;
+        f->m_num_args  = n;
+        memcpy(f->m_args, args, sizeof(enode*) * n);
+        return f;
     }
 
     bool fingerprint_set::fingerprint_eq_proc::operator()(fingerprint const * f1, fingerprint const * f2) const {
@@ -42,13 +43,14 @@ namespace smt {
     }
 
     fingerprint * fingerprint_set::mk_dummy(void * data, unsigned data_hash, unsigned num_args, enode * const * args) {
-        m_tmp.reset();
-        m_tmp.append(num_args, args);
-        m_dummy.m_data      = data;
-        m_dummy.m_data_hash = data_hash;
-        m_dummy.m_num_args  = num_args;
-        m_dummy.m_args      = m_tmp.c_ptr();
-        return &m_dummy;
+        unsigned sz = (fingerprint::get_obj_size(num_args) + sizeof(enode*) - 1) / sizeof(enode*);
+        m_tmp.reserve(sz);
+        fingerprint * d = new (m_tmp.c_ptr()) fingerprint();
+        d->m_data      = data;
+        d->m_data_hash = data_hash;
+        d->m_num_args  = num_args;
+        memcpy(d->m_args, args, sizeof(enode*) * num_args);
+        return d;
     }
     
     fingerprint * fingerprint_set::insert(void * data, unsigned data_hash, unsigned num_args, enode * const * args) {
@@ -69,7 +71,7 @@ namespace smt {
         TRACE("fingerprint_bug", tout << "2) inserting: " << data_hash << " num_args: " << num_args;
               for (unsigned i = 0; i < num_args; i++) tout << " " << args[i]->get_owner_id(); 
               tout << "\n";);
-        fingerprint * f = new (m_region) fingerprint(m_region, data, data_hash, num_args, d->m_args);
+        fingerprint * f = fingerprint::mk(m_region, data, data_hash, num_args, d->m_args);
         m_fingerprints.push_back(f);
         m_set.insert(f);
         return f;
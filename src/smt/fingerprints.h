@@ -23,17 +23,22 @@ Revision History:
 
 namespace smt {
 
+    /**
+       \brief A fingerprint is allocated in a single block of the region:
+       the arguments are stored after the header.
+    */
     class fingerprint {
     protected:
         void *        m_data;
         unsigned      m_data_hash;
         unsigned      m_num_args;
-        enode * *     m_args;
+        enode *       m_args[0];
 
         friend class fingerprint_set;
         fingerprint() {}
+        static unsigned get_obj_size(unsigned n) { return sizeof(fingerprint) + n * sizeof(enode*); }
     public:
-        fingerprint(region & r, void * d, unsigned d_hash, unsigned n, enode * const * args);
+        static fingerprint * mk(region & r, void * d, unsigned d_hash, unsigned n, enode * const * args);
         void * get_data() const { return m_data; }
         unsigned get_data_hash() const { return m_data_hash; }
         unsigned get_num_args() const { return m_num_args;  }
@@ -61,8 +66,7 @@ namespace smt {
         set                      m_set;
         ptr_vector<fingerprint>  m_fingerprints;
         unsigned_vector          m_scopes;
-        ptr_vector<enode>        m_tmp;
-        fingerprint              m_dummy;
+        ptr_vector<enode>        m_tmp;   // storage of the dummy fingerprint used for lookups
 
         fingerprint * mk_dummy(void * data, unsigned data_hash, unsigned num_args, enode * const * args);
 
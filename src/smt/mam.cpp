@@ -23,6 +23,8 @@ Revision History:
 #include "ast/ast_ll_pp.h"
 #include "util/trail.h"
 #include "util/stopwatch.h"
+#include "util/scoped_ptr_vector.h"
+#include "util/z3_omp.h"
 #include "ast/ast_smt2_pp.h"
 #include<algorithm>
 
@@ -377,6 +379,234 @@ namespace smt {
         return out;
     }
 
+    // ------------------------------------
+    //
+    // Code Tree Profile
+    //
+    // ------------------------------------
+
+    /**
+       \brief Instructions are profiled by kind: the variants of an instruction
+       for different numbers of arguments have the same kind.
+    */
+    typedef enum {
+        IK_INIT, IK_BIND, IK_YIELD, IK_COMPARE, IK_CHECK, IK_FILTER, IK_CHOOSE,
+        IK_CONTINUE, IK_GET_ENODE, IK_GET_CGR, IK_IS_CGR, NUM_INSTR_KINDS
+    } instr_kind;
+
+    static char const * g_instr_kind_names[NUM_INSTR_KINDS] = {
+        "init", "bind", "yield", "compare", "check", "filter", "choose",
+        "continue", "get-enode", "get-cgr", "is-cgr"
+    };
+
+    static char const * g_instr_kind_stat_keys[NUM_INSTR_KINDS] = {
+        "mam init", "mam bind", "mam yield", "mam compare", "mam check", "mam filter", "mam choose",
+        "mam continue", "mam get enode", "mam get cgr", "mam is cgr"
+    };
+
+    static instr_kind get_instr_kind(opcode op) {
+        switch (op) {
+        case INIT1: case INIT2: case INIT3: case INIT4: case INIT5: case INIT6: case INITN:
+            return IK_INIT;
+        case BIND1: case BIND2: case BIND3: case BIND4: case BIND5: case BIND6: case BINDN:
+            return IK_BIND;
+        case YIELD1: case YIELD2: case YIELD3: case YIELD4: case YIELD5: case YIELD6: case YIELDN:
+            return IK_YIELD;
+        case COMPARE:
+            return IK_COMPARE;
+        case CHECK:
+            return IK_CHECK;
+        case FILTER: case CFILTER: case PFILTER:
+            return IK_FILTER;
+        case CHOOSE: case NOOP:
+            return IK_CHOOSE;
+        case CONTINUE:
+            return IK_CONTINUE;
+        case GET_ENODE:
+            return IK_GET_ENODE;
+        case IS_CGR:
+            return IK_IS_CGR;
+        default:
+            SASSERT(op >= GET_CGR1 && op <= GET_CGRN);
+            return IK_GET_CGR;
+        }
+    }
+
+    /**
+       \brief Counters of a code tree, maintained when qi.profile_ematching is set.
+    */
+    struct code_tree_profile {
+        unsigned        m_executions;   // number of enodes the code tree was executed on
+        unsigned        m_backtracks;   // number of backtrack points resumed
+        unsigned        m_instances;    // number of yields that produced a new instance
+        unsigned        m_instructions[NUM_INSTR_KINDS];
+        svector<symbol> m_qids;         // quantifiers matched by the code tree
+
+        code_tree_profile() {
+            reset();
+        }
+
+        void reset() {
+            m_executions = 0;
+            m_backtracks = 0;
+            m_instances  = 0;
+            for (unsigned i = 0; i < NUM_INSTR_KINDS; ++i)
+                m_instructions[i] = 0;
+            m_qids.reset();
+        }
+
+        bool empty() const {
+            return m_executions == 0;
+        }
+
+        unsigned num_instructions() const {
+            unsigned r = 0;
+            for (unsigned i = 0; i < NUM_INSTR_KINDS; ++i)
+                r += m_instructions[i];
+            return r;
+        }
+
+        /**
+           \brief Cost of the code tree: executed instructions, and resumed backtrack points.
+        */
+        unsigned cost() const {
+            return num_instructions() + m_backtracks;
+        }
+
+        void add_qid(symbol const & qid) {
+            if (!m_qids.contains(qid))
+                m_qids.push_back(qid);
+        }
+
+        void add(code_tree_profile const & p) {
+            m_executions += p.m_executions;
+            m_backtracks += p.m_backtracks;
+            m_instances  += p.m_instances;
+            for (unsigned i = 0; i < NUM_INSTR_KINDS; ++i)
+                m_instructions[i] += p.m_instructions[i];
+            for (symbol const & qid : p.m_qids)
+                add_qid(qid);
+        }
+
+        void collect_statistics(::statistics & st) const {
+            st.update("mam executions", m_executions);
+            st.update("mam instructions", num_instructions());
+            st.update("mam backtracks", m_backtracks);
+            st.update("mam instances", m_instances);
+            for (unsigned i = 0; i < NUM_INSTR_KINDS; ++i)
+                st.update(g_instr_kind_stat_keys[i], m_instructions[i]);
+        }
+
+        void display(std::ostream & out) const {
+            out << " :cost " << cost()
+                << " :executions " << m_executions
+                << " :backtracks " << m_backtracks
+                << " :instances " << m_instances;
+            for (unsigned i = 0; i < NUM_INSTR_KINDS; ++i) {
+                if (m_instructions[i] > 0)
+                    out << " :" << g_instr_kind_names[i] << " " << m_instructions[i];
+            }
+            if (!m_qids.empty()) {
+                out << " :qids (";
+                for (unsigned i = 0; i < m_qids.size(); ++i)
+                    out << (i > 0 ? " " : "") << m_qids[i];
+                out << ")";
+            }
+        }
+    };
+
+    /**
+       \brief Global E-matching profile. The MAMs add the counters of their code
+       trees to it at the end of each search, and before a code tree is deleted.
+       Code trees are identified by their root label and number of arguments.
+    */
+    class mam_profile {
+        typedef std::pair<symbol, unsigned> key;
+
+        struct key_hash_proc {
+            unsigned operator()(key const & k) const { return combine_hash(k.first.hash(), k.second); }
+        };
+
+        struct entry {
+            symbol            m_lbl;
+            unsigned          m_num_args;
+            code_tree_profile m_profile;
+        };
+
+        struct cost_lt {
+            vector<entry> const & m_entries;
+            cost_lt(vector<entry> const & es):m_entries(es) {}
+            bool operator()(unsigned i, unsigned j) const {
+                return m_entries[i].m_profile.cost() > m_entries[j].m_profile.cost();
+            }
+        };
+
+        vector<entry>                                  m_entries;
+        map<key, unsigned, key_hash_proc, default_eq<key> > m_key2entry;
+
+    public:
+        void add(symbol const & lbl, unsigned num_args, code_tree_profile const & p) {
+            key k(lbl, num_args);
+            unsigned idx;
+            if (!m_key2entry.find(k, idx)) {
+                idx = m_entries.size();
+                m_entries.push_back(entry());
+                m_entries.back().m_lbl      = lbl;
+                m_entries.back().m_num_args = num_args;
+                m_key2entry.insert(k, idx);
+            }
+            m_entries[idx].m_profile.add(p);
+        }
+
+        void display(std::ostream & out, unsigned max_trees) const {
+            unsigned_vector order;
+            for (unsigned i = 0; i < m_entries.size(); ++i)
+                order.push_back(i);
+            std::stable_sort(order.begin(), order.end(), cost_lt(m_entries));
+            out << "(ematching-profile";
+            for (unsigned i = 0; i < order.size() && i < max_trees; ++i) {
+                entry const & e = m_entries[order[i]];
+                out << "\n  (" << e.m_lbl << " :num-args " << e.m_num_args;
+                e.m_profile.display(out);
+                out << ")";
+            }
+            out << ")\n";
+        }
+    };
+
+    static mam_profile * g_mam_profile = 0;
+
+    static void add_to_mam_profile(symbol const & lbl, unsigned num_args, code_tree_profile const & p) {
+        #pragma omp critical (mam_profile)
+        {
+            if (!g_mam_profile)
+                g_mam_profile = alloc(mam_profile);
+            g_mam_profile->add(lbl, num_args, p);
+        }
+    }
+
+    void display_mam_profile(std::ostream & out, unsigned max_trees) {
+        #pragma omp critical (mam_profile)
+        {
+            if (g_mam_profile)
+                g_mam_profile->display(out, max_trees);
+            else
+                out << "(ematching-profile)\n";
+        }
+    }
+
+    void reset_mam_profile() {
+        finalize_mam_profile();
+    }
+
+    void finalize_mam_profile() {
+        #pragma omp critical (mam_profile)
+        {
+            dealloc(g_mam_profile);
+            g_mam_profile = 0;
+        }
+    }
+
     // ------------------------------------
     //
     // Code Tree 
@@ -405,6 +635,7 @@ namespace smt {
         unsigned                   m_num_choices;
         instruction *              m_root;
         enode_vector               m_candidates; 
+        code_tree_profile          m_profile;
 #ifdef Z3DEBUG
         context *                  m_context;
         ptr_vector<app>            m_patterns;
@@ -553,6 +784,24 @@ namespace smt {
             return m_candidates;
         }
 
+        code_tree_profile & get_profile() {
+            return m_profile;
+        }
+
+        code_tree_profile const & get_profile() const {
+            return m_profile;
+        }
+
+        /**
+           \brief Add the profile of the code tree to the global profile, and reset it.
+        */
+        void flush_profile() {
+            if (!m_profile.empty()) {
+                add_to_mam_profile(m_root_lbl->get_name(), m_num_args, m_profile);
+                m_profile.reset();
+            }
+        }
+
 #ifdef Z3DEBUG
         void set_context(context * ctx) {
             SASSERT(m_context == 0);
@@ -1848,6 +2097,20 @@ namespace smt {
     };
 
     typedef svector<backtrack_point> backtrack_stack;
+
+    /**
+       \brief A match found by a worker of a batched round (qi.ematching_threads > 1).
+       It is inserted in the instantiation queue after the round.
+    */
+    struct deferred_match {
+        quantifier * m_qa;
+        app *        m_pat;
+        unsigned     m_num_bindings;
+        unsigned     m_bindings;         // index of the first binding in the deferred bindings
+        unsigned     m_max_generation;
+        unsigned     m_min_top_generation;
+        unsigned     m_max_top_generation;
+    };
     
     class interpreter {
         context &           m_context;
@@ -1860,6 +2123,14 @@ namespace smt {
         backtrack_stack     m_backtrack_stack;
         unsigned            m_top;
         const instruction * m_pc;
+        bool                m_profile;         // qi.profile_ematching
+        code_tree_profile * m_tree_profile;    // profile of the code tree being executed
+        tmp_enode           m_tmp_enode;       // used by GET_CGR
+        // The interpreter of a worker of a batched round only reads the e-graph.
+        // It records its matches instead of passing them to the MAM.
+        bool                m_defer;
+        svector<deferred_match> m_deferred;
+        enode_vector        m_deferred_bindings;
 
         // auxiliary temporary variables
         unsigned            m_max_generation;  // the maximum generation of an app enode processed.
@@ -1995,6 +2266,24 @@ namespace smt {
 
         void display_pc_info(std::ostream & out);
 
+        void defer_match(yield const * y, unsigned num_bindings) {
+            deferred_match d;
+            d.m_qa             = y->m_qa;
+            d.m_pat            = y->m_pat;
+            d.m_num_bindings   = num_bindings;
+            d.m_bindings       = m_deferred_bindings.size();
+            d.m_max_generation = m_max_generation;
+            get_min_max_top_generation(d.m_min_top_generation, d.m_max_top_generation);
+            m_deferred_bindings.append(num_bindings, m_bindings.c_ptr());
+            m_deferred.push_back(d);
+        }
+
+        bool resource_limits_exceeded() {
+            if (m_defer)
+                return m_ast_manager.limit().get_cancel_flag() || memory::above_high_watermark();
+            return m_context.resource_limits_exceeded();
+        }
+
 #define INIT_ARGS_SIZE 16
 
     public:
@@ -2002,7 +2291,10 @@ namespace smt {
             m_context(ctx),
             m_ast_manager(ctx.get_manager()),
             m_mam(m), 
-            m_use_filters(use_filters) {
+            m_use_filters(use_filters),
+            m_profile(false),
+            m_tree_profile(0),
+            m_defer(false) {
             m_args.resize(INIT_ARGS_SIZE, 0);
         }
 
@@ -2015,6 +2307,15 @@ namespace smt {
             m_bindings.reserve(t->get_num_regs(), 0);
             if (m_backtrack_stack.size() < t->get_num_choices())
                 m_backtrack_stack.resize(t->get_num_choices());
+            m_profile = m_context.get_fparams().m_qi_profile_ematching;
+            m_tree_profile = &t->get_profile();
+        }
+
+        /**
+           \brief Return the profile of the code tree being executed, or 0 if profiling is disabled.
+        */
+        code_tree_profile * get_tree_profile() const {
+            return m_profile ? m_tree_profile : 0;
         }
         
         void execute(code_tree * t) {
@@ -2052,6 +2353,62 @@ namespace smt {
         // init(t) must be invoked before execute_core
         void execute_core(code_tree * t, enode * n);
 
+        /**
+           \brief Append to cs the candidates of t that execute(t) executes t on, in the same order.
+        */
+        void collect_candidates(code_tree * t, enode_vector & cs) {
+            enode_vector::const_iterator it  = t->get_candidates().begin();
+            enode_vector::const_iterator end = t->get_candidates().end();
+            if (t->filter_candidates()) {
+                for (; it != end; ++it) {
+                    enode * app = *it;
+                    if (!app->is_marked() && app->is_cgr()) {
+                        cs.push_back(app);
+                        app->set_mark();
+                    }
+                }
+                it  = t->get_candidates().begin();
+                for (; it != end; ++it) {
+                    enode * app = *it;
+                    if (app->is_marked())
+                        app->unset_mark();
+                }
+            }
+            else {
+                for (; it != end; ++it) {
+                    enode * app = *it;
+                    if (app->is_cgr())
+                        cs.push_back(app);
+                }
+            }
+        }
+
+        /**
+           \brief Execute t on the candidates [begin, end), and record the matches
+           instead of passing them to the MAM. The counters of the execution are
+           added to p. The e-graph is only read.
+        */
+        void execute_deferred(code_tree * t, enode * const * begin, enode * const * end, code_tree_profile & p) {
+            flet<bool> _defer(m_defer, true);
+            init(t);
+            m_tree_profile = &p;
+            for (; begin != end; ++begin)
+                execute_core(t, *begin);
+        }
+
+        svector<deferred_match> const & get_deferred() const {
+            return m_deferred;
+        }
+
+        enode * const * get_deferred_bindings(deferred_match const & d) const {
+            return m_deferred_bindings.c_ptr() + d.m_bindings;
+        }
+
+        void reset_deferred() {
+            m_deferred.reset();
+            m_deferred_bindings.reset();
+        }
+
         // Return the min, max generation of the enodes in m_pattern_instances.
 
         void get_min_max_top_generation(unsigned& min, unsigned& max) {
@@ -2307,6 +2664,8 @@ namespace smt {
         m_pc             = t->get_root();
         m_registers[0]   = n;
         m_top            = 0;
+        if (m_profile)
+            m_tree_profile->m_executions++;
 
         
     main_loop:
@@ -2315,6 +2674,8 @@ namespace smt {
 #ifdef _PROFILE_MAM
         const_cast<instruction*>(m_pc)->m_counter++;
 #endif
+        if (m_profile)
+            m_tree_profile->m_instructions[get_instr_kind(m_pc->m_opcode)]++;
         switch (m_pc->m_opcode) {
         case INIT1:
             m_app          = m_registers[0];
@@ -2519,14 +2880,22 @@ namespace smt {
             m_bindings[0] = m_registers[static_cast<const yield *>(m_pc)->m_bindings[0]];
 #define ON_MATCH(NUM)                                                   \
             m_max_generation = std::max(m_max_generation, get_max_generation(NUM, m_bindings.begin())); \
-            if (m_context.get_cancel_flag()) {                          \
-                return;                                                 \
+            if (m_defer) {                                              \
+                if (m_ast_manager.limit().get_cancel_flag()) {          \
+                    return;                                             \
+                }                                                       \
+                defer_match(static_cast<const yield *>(m_pc), NUM);     \
             }                                                           \
-            m_mam.on_match(static_cast<const yield *>(m_pc)->m_qa,                                      \
-                           static_cast<const yield *>(m_pc)->m_pat,                                     \
-                           NUM,                                                                         \
-                           m_bindings.begin(),                                                          \
-                           m_max_generation, m_used_enodes)
+            else {                                                      \
+                if (m_context.get_cancel_flag()) {                      \
+                    return;                                             \
+                }                                                       \
+                m_mam.on_match(static_cast<const yield *>(m_pc)->m_qa,                                  \
+                               static_cast<const yield *>(m_pc)->m_pat,                                 \
+                               NUM,                                                                     \
+                               m_bindings.begin(),                                                      \
+                               m_max_generation, m_used_enodes);                                        \
+            }
             ON_MATCH(1);
             goto backtrack;
             
@@ -2584,7 +2953,7 @@ namespace smt {
 
         case GET_CGR1:
 #define GET_CGR_COMMON()                                                                                                                                                \
-            m_n1 = m_context.get_enode_eq_to(static_cast<const get_cgr *>(m_pc)->m_label, static_cast<const get_cgr *>(m_pc)->m_num_args, m_args.c_ptr());              \
+            m_n1 = m_context.get_enode_eq_to(m_tmp_enode, static_cast<const get_cgr *>(m_pc)->m_label, static_cast<const get_cgr *>(m_pc)->m_num_args, m_args.c_ptr());              \
             if (m_n1 == 0 || !m_context.is_relevant(m_n1))                                                                                                              \
                 goto backtrack;                                                                                                                                         \
             m_registers[static_cast<const get_cgr *>(m_pc)->m_oreg] = m_n1;                                                                                             \
@@ -2677,6 +3046,8 @@ namespace smt {
         }
         backtrack_point & bp = m_backtrack_stack[m_top - 1];
         m_max_generation     = bp.m_old_max_generation;
+        if (m_profile)
+            m_tree_profile->m_backtracks++;
 
         if (m_ast_manager.has_trace_stream())
             m_used_enodes.shrink(bp.m_old_used_enodes_size);
@@ -2689,7 +3060,7 @@ namespace smt {
 
         if (since_last_check++ > 100) {
             since_last_check = 0;
-            if (m_context.resource_limits_exceeded()) {
+            if (resource_limits_exceeded()) {
                 // Soft timeout...
                 // Cleanup before exiting
                 while (m_top != 0) {
@@ -2853,10 +3224,7 @@ namespace smt {
             unsigned                m_lbl_id;
         public:
             mk_tree_trail(ptr_vector<code_tree> & t, unsigned id):m_trees(t), m_lbl_id(id) {}
-            virtual void undo(mam_impl & m) {
-                dealloc(m_trees[m_lbl_id]);
-                m_trees[m_lbl_id] = 0;
-            }
+            virtual void undo(mam_impl & m);
         };
         
     public:
@@ -2930,6 +3298,10 @@ namespace smt {
         ptr_vector<code_tree>::iterator end_code_trees() {
             return m_trees.end();
         }
+
+        ptr_vector<code_tree> const & get_code_trees() const {
+            return m_trees;
+        }
     };
 
     // ------------------------------------
@@ -3072,6 +3444,21 @@ namespace smt {
         compiler                    m_compiler;
         interpreter                 m_interpreter;
         code_tree_map               m_trees;      
+
+        // Batched rounds (qi.ematching_threads > 1).
+        // The candidates of the trees to match are split into items executed by the workers.
+        struct match_item {
+            code_tree *       m_tree;
+            unsigned          m_begin;       // candidates [m_begin, m_end) in m_candidates
+            unsigned          m_end;
+            unsigned          m_worker;
+            unsigned          m_matches_begin; // deferred matches of m_worker found on the item
+            unsigned          m_matches_end;
+            code_tree_profile m_profile;
+        };
+        scoped_ptr_vector<interpreter> m_workers;
+        enode_vector                m_candidates;
+        vector<match_item>          m_items;
         
         ptr_vector<code_tree>       m_tmp_trees;
         ptr_vector<func_decl>       m_tmp_trees_to_delete;
@@ -3103,6 +3490,8 @@ namespace smt {
 
         obj_hashtable<enode>        m_shared_enodes; // ground terms that appear in patterns.
 
+        code_tree_profile           m_profile; // flushed profiles of the code trees
+
         enode *                     m_r1; // temp field
         enode *                     m_r2; // temp field
         
@@ -3777,6 +4166,7 @@ namespace smt {
                         m_interpreter.execute_core(tmp_tree, app);
                 }
                 m_tmp_trees[lbl_id] = 0;
+                flush_profile(tmp_tree);
                 dealloc(tmp_tree);
             }
             m_new_patterns.reset();
@@ -3829,6 +4219,7 @@ namespace smt {
         }
         
         virtual ~mam_impl() {
+            flush_profile();
             m_trail_stack.reset();
         }
 
@@ -3874,6 +4265,7 @@ namespace smt {
         }
 
         virtual void reset() {
+            flush_profile();
             m_trail_stack.reset();
             m_trees.reset();
             m_to_match.reset();
@@ -3897,13 +4289,20 @@ namespace smt {
         
         virtual void match() { 
             TRACE("trigger_bug", tout << "match\n"; display(tout););
-            ptr_vector<code_tree>::iterator it  = m_to_match.begin();
-            ptr_vector<code_tree>::iterator end = m_to_match.end();
-            for (; it != end; ++it) {
-                code_tree * t = *it;
-                SASSERT(t->has_candidates());
-                m_interpreter.execute(t);
-                t->reset_candidates();
+            if (!use_batch_match()) {
+                ptr_vector<code_tree>::iterator it  = m_to_match.begin();
+                ptr_vector<code_tree>::iterator end = m_to_match.end();
+                for (; it != end; ++it) {
+                    code_tree * t = *it;
+                    SASSERT(t->has_candidates());
+                    m_interpreter.execute(t);
+                    t->reset_candidates();
+                }
+            }
+            else {
+                batch_match();
+                for (code_tree * t : m_to_match)
+                    t->reset_candidates();
             }
             m_to_match.reset();
             if (!m_new_patterns.empty()) {
@@ -3912,6 +4311,117 @@ namespace smt {
             }
         }
 
+        bool use_batch_match() const {
+#ifdef _NO_OMP_
+            return false;
+#else
+            unsigned num_threads = m_context.get_fparams().m_qi_ematching_threads;
+            if (num_threads <= 1 || m_ast_manager.has_trace_stream() || omp_in_parallel())
+                return false;
+            // small rounds are not worth the overhead of the threads.
+            unsigned num_candidates = 0;
+            for (code_tree * t : m_to_match)
+                num_candidates += t->get_candidates().size();
+            return num_candidates >= 64 * num_threads;
+#endif
+        }
+
+        /**
+           \brief Match the trees of m_to_match with the workers, and then insert
+           the matches in the order in which m_interpreter would have found them.
+
+           The e-graph is not modified while matching, and on_match only queues the
+           instances. So the instances, and their order, are the same as in a sequential round.
+        */
+        void batch_match() {
+            unsigned num_threads = m_context.get_fparams().m_qi_ematching_threads;
+            while (m_workers.size() < num_threads)
+                m_workers.push_back(alloc(interpreter, m_context, *this, m_use_filters));
+            m_candidates.reset();
+            m_items.reset();
+            svector<std::pair<code_tree *, unsigned> > trees; // tree and end of its candidates
+            for (code_tree * t : m_to_match) {
+                SASSERT(t->has_candidates());
+                m_interpreter.collect_candidates(t, m_candidates);
+                trees.push_back(std::make_pair(t, m_candidates.size()));
+            }
+            unsigned chunk = std::max(16u, m_candidates.size() / (8 * num_threads));
+            unsigned begin = 0;
+            for (auto const & p : trees) {
+                for (; begin < p.second; begin += chunk) {
+                    m_items.push_back(match_item());
+                    match_item & item = m_items.back();
+                    item.m_tree  = p.first;
+                    item.m_begin = begin;
+                    item.m_end   = std::min(begin + chunk, p.second);
+                }
+                begin = p.second;
+            }
+            // the first exception raised by a worker is rethrown, with its kind, once the items are done.
+            enum exception_kind { NO_EX, DEFAULT_EX, ERROR_EX };
+            exception_kind ex_kind = NO_EX;
+            unsigned error_code = 0;
+            std::string ex_msg;
+            int num_items = static_cast<int>(m_items.size());
+            #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+            for (int i = 0; i < num_items; ++i) {
+                match_item & item = m_items[i];
+                item.m_worker = omp_get_thread_num();
+                interpreter & w = *m_workers[item.m_worker];
+                item.m_matches_begin = w.get_deferred().size();
+                try {
+                    w.execute_deferred(item.m_tree, m_candidates.c_ptr() + item.m_begin, m_candidates.c_ptr() + item.m_end, item.m_profile);
+                }
+                catch (z3_error & err) {
+                    #pragma omp critical (mam_batch_match)
+                    {
+                        if (ex_kind == NO_EX) {
+                            ex_kind = ERROR_EX;
+                            error_code = err.error_code();
+                        }
+                    }
+                }
+                catch (z3_exception & ex) {
+                    #pragma omp critical (mam_batch_match)
+                    {
+                        if (ex_kind == NO_EX) {
+                            ex_kind = DEFAULT_EX;
+                            ex_msg = ex.msg();
+                        }
+                    }
+                }
+                item.m_matches_end = w.get_deferred().size();
+            }
+            if (ex_kind == NO_EX) {
+                bool profile = m_context.get_fparams().m_qi_profile_ematching;
+                ptr_vector<enode> used_enodes; // only collected with a trace stream
+                for (match_item & item : m_items) {
+                    code_tree_profile * p = 0;
+                    if (profile) {
+                        p = &item.m_tree->get_profile();
+                        p->add(item.m_profile);
+                    }
+                    interpreter & w = *m_workers[item.m_worker];
+                    for (unsigned j = item.m_matches_begin; j < item.m_matches_end; ++j) {
+                        if (m_context.get_cancel_flag())
+                            break;
+                        deferred_match const & d = w.get_deferred()[j];
+                        add_instance(p, d.m_qa, d.m_pat, d.m_num_bindings, w.get_deferred_bindings(d),
+                                     d.m_max_generation, d.m_min_top_generation, d.m_max_top_generation, used_enodes);
+                    }
+                }
+            }
+            for (unsigned i = 0; i < m_workers.size(); ++i)
+                m_workers[i]->reset_deferred();
+            m_candidates.reset();
+            m_items.reset();
+            switch (ex_kind) {
+            case ERROR_EX: throw z3_error(error_code);
+            case DEFAULT_EX: throw default_exception(ex_msg.c_str());
+            default: break;
+            }
+        }
+
         virtual void rematch(bool use_irrelevant) {
             ptr_vector<code_tree>::iterator it  = m_trees.begin_code_trees();
             ptr_vector<code_tree>::iterator end = m_trees.end_code_trees();
@@ -3961,7 +4471,41 @@ namespace smt {
 #endif
             unsigned min_gen, max_gen;
             m_interpreter.get_min_max_top_generation(min_gen, max_gen);
-            m_context.add_instance(qa, pat, num_bindings, bindings, max_generation, min_gen, max_gen, used_enodes);
+            add_instance(m_interpreter.get_tree_profile(), qa, pat, num_bindings, bindings, max_generation, min_gen, max_gen, used_enodes);
+        }
+
+        void add_instance(code_tree_profile * p, quantifier * qa, app * pat, unsigned num_bindings, enode * const * bindings,
+                          unsigned max_generation, unsigned min_gen, unsigned max_gen, ptr_vector<enode> & used_enodes) {
+            bool is_new = m_context.add_instance(qa, pat, num_bindings, bindings, max_generation, min_gen, max_gen, used_enodes);
+            if (p) {
+                p->add_qid(qa->get_qid());
+                if (is_new)
+                    p->m_instances++;
+            }
+        }
+
+        void flush_profile(code_tree * t) {
+            m_profile.add(t->get_profile());
+            t->flush_profile();
+        }
+
+        virtual void flush_profile() {
+            for (code_tree * t : m_trees.get_code_trees()) {
+                if (t)
+                    flush_profile(t);
+            }
+        }
+
+        virtual void collect_statistics(::statistics & st) const {
+            if (!m_context.get_fparams().m_qi_profile_ematching)
+                return;
+            code_tree_profile p;
+            p.add(m_profile);
+            for (code_tree const * t : m_trees.get_code_trees()) {
+                if (t)
+                    p.add(t->get_profile());
+            }
+            p.collect_statistics(st);
         }
 
         virtual bool is_shared(enode * n) const {
@@ -4034,6 +4578,12 @@ namespace smt {
         }
     };
 
+    void code_tree_map::mk_tree_trail::undo(mam_impl & m) {
+        m.flush_profile(m_trees[m_lbl_id]);
+        dealloc(m_trees[m_lbl_id]);
+        m_trees[m_lbl_id] = 0;
+    }
+
     mam * mk_mam(context & ctx) {
         return alloc(mam_impl, ctx, true);
     }
@@ -21,6 +21,7 @@ Revision History:
 
 #include "ast/ast.h"
 #include "smt/smt_types.h"
+#include "util/statistics.h"
 
 namespace smt {
     /**
@@ -61,12 +62,34 @@ namespace smt {
         
         virtual bool is_shared(enode * n) const = 0;
 
+        /**
+           \brief Add the counters of the code trees (qi.profile_ematching) to the
+           global E-matching profile, and reset them.
+        */
+        virtual void flush_profile() = 0;
+
+        virtual void collect_statistics(::statistics & st) const = 0;
+
 #ifdef Z3DEBUG
         virtual bool check_missing_instances() = 0;
 #endif
     };
 
     mam * mk_mam(context & ctx);
+
+    /**
+       \brief Display the global E-matching profile, most expensive code trees first.
+       The code trees of different MAMs with the same root label are combined.
+       At most max_trees code trees are displayed.
+    */
+    void display_mam_profile(std::ostream & out, unsigned max_trees = UINT_MAX);
+
+    void reset_mam_profile();
+
+    void finalize_mam_profile();
+    /*
+      ADD_FINALIZER('smt::finalize_mam_profile();')
+    */
 };
 
 #endif /* MAM_H_ */
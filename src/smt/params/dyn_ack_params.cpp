@@ -27,6 +27,9 @@ void dyn_ack_params::updt_params(params_ref const & _p) {
     m_dack_threshold = p.dack_threshold();
     m_dack_gc = p.dack_gc();
     m_dack_gc_inv_decay = p.dack_gc_inv_decay();
+    m_dack_gc_triples = p.dack_gc_triples();
+    m_dack_sketch_width = p.dack_sketch_width();
+    m_dack_sketch_depth = p.dack_sketch_depth();
 }
 
 #define DISPLAY_PARAM(X) out << #X"=" << X << std::endl;
@@ -38,4 +41,7 @@ void dyn_ack_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_dack_threshold);
     DISPLAY_PARAM(m_dack_gc);
     DISPLAY_PARAM(m_dack_gc_inv_decay);
+    DISPLAY_PARAM(m_dack_gc_triples);
+    DISPLAY_PARAM(m_dack_sketch_width);
+    DISPLAY_PARAM(m_dack_sketch_depth);
 }
\ No newline at end of file
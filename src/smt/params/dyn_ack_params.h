@@ -34,6 +34,9 @@ struct dyn_ack_params {
     unsigned         m_dack_threshold;
     unsigned         m_dack_gc;
     double           m_dack_gc_inv_decay;
+    bool             m_dack_gc_triples;
+    unsigned         m_dack_sketch_width;
+    unsigned         m_dack_sketch_depth;
 
 public:
     dyn_ack_params(params_ref const & p = params_ref()) :
@@ -42,7 +45,10 @@ public:
         m_dack_factor(0.1),
         m_dack_threshold(10),
         m_dack_gc(2000), 
-        m_dack_gc_inv_decay(0.8) {
+        m_dack_gc_inv_decay(0.8),
+        m_dack_gc_triples(false),
+        m_dack_sketch_width(0),
+        m_dack_sketch_depth(4) {
         updt_params(p);
     }
 
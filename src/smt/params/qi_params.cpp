@@ -28,9 +28,14 @@ void qi_params::updt_params(params_ref const & _p) {
     m_mbqi_trace = p.mbqi_trace();
     m_mbqi_force_template = p.mbqi_force_template();
     m_mbqi_id = p.mbqi_id();
+    m_mbqi_incremental = p.mbqi_incremental();
+    m_mbqi_threads = p.mbqi_threads();
     m_qi_profile = p.qi_profile();
     m_qi_profile_freq = p.qi_profile_freq();
+    m_qi_profile_ematching = p.qi_profile_ematching();
+    m_qi_ematching_threads = p.qi_ematching_threads();
     m_qi_max_instances = p.qi_max_instances();
+    m_qi_persistent_instances = p.qi_persistent_instances();
     m_qi_eager_threshold = p.qi_eager_threshold();
     m_qi_lazy_threshold = p.qi_lazy_threshold();
     m_qi_cost = p.qi_cost();
@@ -49,10 +54,13 @@ void qi_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_qi_max_lazy_multipattern_matching);
     DISPLAY_PARAM(m_qi_profile);
     DISPLAY_PARAM(m_qi_profile_freq);
+    DISPLAY_PARAM(m_qi_profile_ematching);
+    DISPLAY_PARAM(m_qi_ematching_threads);
     DISPLAY_PARAM(m_qi_quick_checker);
     DISPLAY_PARAM(m_qi_lazy_quick_checker);
     DISPLAY_PARAM(m_qi_promote_unsat);
     DISPLAY_PARAM(m_qi_max_instances);
+    DISPLAY_PARAM(m_qi_persistent_instances);
     DISPLAY_PARAM(m_qi_lazy_instantiation);
     DISPLAY_PARAM(m_qi_conservative_final_check);
     DISPLAY_PARAM(m_mbqi);
@@ -62,4 +70,6 @@ void qi_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_mbqi_trace);
     DISPLAY_PARAM(m_mbqi_force_template);
     DISPLAY_PARAM(m_mbqi_id);
+    DISPLAY_PARAM(m_mbqi_incremental);
+    DISPLAY_PARAM(m_mbqi_threads);
 }
@@ -38,10 +38,13 @@ struct qi_params {
     unsigned           m_qi_max_lazy_multipattern_matching;
     bool               m_qi_profile;
     unsigned           m_qi_profile_freq;
+    bool               m_qi_profile_ematching;
+    unsigned           m_qi_ematching_threads;
     quick_checker_mode m_qi_quick_checker;
     bool               m_qi_lazy_quick_checker;
     bool               m_qi_promote_unsat;
     unsigned           m_qi_max_instances;
+    bool               m_qi_persistent_instances;
     bool               m_qi_lazy_instantiation;
     bool               m_qi_conservative_final_check;
 
@@ -52,6 +55,8 @@ struct qi_params {
     bool               m_mbqi_trace;
     unsigned           m_mbqi_force_template;
     const char *       m_mbqi_id;
+    bool               m_mbqi_incremental;
+    unsigned           m_mbqi_threads;
 
     qi_params(params_ref const & p = params_ref()):
         /*
@@ -87,10 +92,13 @@ struct qi_params {
         m_qi_max_lazy_multipattern_matching(2),
         m_qi_profile(false),
         m_qi_profile_freq(UINT_MAX),
+        m_qi_profile_ematching(false),
+        m_qi_ematching_threads(1),
         m_qi_quick_checker(MC_NO),
         m_qi_lazy_quick_checker(true),
         m_qi_promote_unsat(true),
         m_qi_max_instances(UINT_MAX),
+        m_qi_persistent_instances(false),
         m_qi_lazy_instantiation(false),
         m_qi_conservative_final_check(false),
         m_mbqi(true), // enabled by default
@@ -99,7 +107,9 @@ struct qi_params {
         m_mbqi_max_iterations(1000),
         m_mbqi_trace(false),
         m_mbqi_force_template(10),
-        m_mbqi_id(0)  
+        m_mbqi_id(0),
+        m_mbqi_incremental(false),
+        m_mbqi_threads(1)
     {
         updt_params(p);
     }
@@ -28,7 +28,8 @@ enum arith_solver_id {
     AS_ARITH,
     AS_DENSE_DIFF_LOGIC,
     AS_UTVPI,
-    AS_OPTINF
+    AS_OPTINF,
+    AS_LRA
 };
 
 enum bound_prop_mode {
@@ -102,6 +103,7 @@ struct theory_arith_params {
     unsigned                m_nl_arith_max_degree;
     bool                    m_nl_arith_branching;
     unsigned                m_nl_arith_rounds;
+    unsigned                m_nl_arith_nlsat_max_core;
 
     // euclidean solver for tighting bounds 
     bool                    m_arith_euclidean_solver;
@@ -151,6 +153,7 @@ struct theory_arith_params {
         m_nl_arith_max_degree(6),
         m_nl_arith_branching(true),
         m_nl_arith_rounds(1024),
+        m_nl_arith_nlsat_max_core(64),
         m_arith_euclidean_solver(false) {
         updt_params(p);
     }
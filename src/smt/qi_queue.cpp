@@ -35,9 +35,10 @@ namespace smt {
         m_cost_function(m_manager),
         m_new_gen_function(m_manager),
         m_parser(m_manager),
-        m_evaluator(m_manager),
         m_subst(m_manager),
-        m_instances(m_manager) {
+        m_instances(m_manager),
+        m_persistent_exprs(m_manager),
+        m_persistent_head(0) {
         init_parser_vars();
         m_vals.resize(15, 0.0f);
     }
@@ -62,6 +63,8 @@ namespace smt {
             warning_msg("invalid new_gen function '%s', switching to default one", m_params.m_qi_new_gen.c_str());
             VERIFY(m_parser.parse_string("cost", m_new_gen_function));
         }
+        m_cost.compile(m_manager, m_cost_function, m_vals.size());
+        m_new_gen.compile(m_manager, m_new_gen_function, m_vals.size());
         m_eager_cost_threshold = m_params.m_qi_eager_threshold;
     }
 
@@ -121,7 +124,7 @@ namespace smt {
 
     float qi_queue::get_cost(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation) {
         quantifier_stat * stat = set_values(q, pat, generation, min_top_generation, max_top_generation, 0);
-        float r = m_evaluator(m_cost_function, m_vals.size(), m_vals.c_ptr());
+        float r = m_cost(m_vals.c_ptr());
         stat->update_max_cost(r);
         return r;
     }
@@ -129,7 +132,7 @@ namespace smt {
     unsigned qi_queue::get_new_gen(quantifier * q, unsigned generation, float cost) {
         // max_top_generation and min_top_generation are not available for computing inc_gen
         set_values(q, 0, generation, 0, 0, cost);
-        float r = m_evaluator(m_new_gen_function, m_vals.size(), m_vals.c_ptr());
+        float r = m_new_gen(m_vals.c_ptr());
         return static_cast<unsigned>(r);
     }
 
@@ -292,6 +295,9 @@ namespace smt {
         unsigned gen = get_new_gen(q, generation, ent.m_cost);
         display_instance_profile(f, q, num_bindings, bindings, proof_id, gen);
         m_context.internalize_instance(lemma, pr1, gen);
+        if (m_params.m_qi_persistent_instances && !m_manager.proofs_enabled() &&
+            m_context.get_base_level() > 0 && m_context.get_scope_level() == m_context.get_base_level())
+            persist_instance(q, lemma, num_bindings, bindings, gen);
         TRACE_CODE({
             static unsigned num_useless = 0;
             if (m_manager.is_or(lemma)) {
@@ -344,10 +350,75 @@ namespace smt {
         m_instances.shrink(s.m_instances_lim);
         m_new_entries.reset();
         m_scopes.shrink(new_lvl);
+        // the persistent instances are created at base levels, so only user pops reach them.
+        while (m_persistent_head > 0 && m_persistent[m_persistent_head - 1].m_scope > new_lvl)
+            --m_persistent_head;
+        for (unsigned i = m_persistent_head; i < m_persistent.size(); i++)
+            m_persistent[i].m_scope = new_lvl;
         TRACE("new_entries_bug", tout << "[qi:pop-scope]\n";);
     }
 
+    void qi_queue::persist_instance(quantifier * q, expr * lemma, unsigned num_bindings, enode * const * bindings, unsigned generation) {
+        SASSERT(m_persistent.empty() || m_persistent.back().m_scope <= m_context.get_scope_level());
+        persistent_instance p;
+        p.m_scope        = m_context.get_scope_level();
+        p.m_generation   = generation;
+        p.m_num_bindings = num_bindings;
+        p.m_exprs        = m_persistent_exprs.size();
+        m_persistent_exprs.push_back(q);
+        m_persistent_exprs.push_back(lemma);
+        for (unsigned i = 0; i < num_bindings; i++)
+            m_persistent_exprs.push_back(bindings[i]->get_owner());
+        m_persistent.push_back(p);
+        m_persistent_head = m_persistent.size();
+    }
+
+    void qi_queue::reassert_instances() {
+        if (m_persistent_head == m_persistent.size())
+            return;
+        SASSERT(m_context.get_scope_level() == m_context.get_base_level());
+        unsigned head = m_persistent_head;
+        unsigned sz   = m_persistent.size();
+        unsigned lim  = m_persistent[head].m_exprs;
+        expr_ref_vector exprs(m_manager);
+        for (unsigned i = lim; i < m_persistent_exprs.size(); i++)
+            exprs.push_back(m_persistent_exprs.get(i));
+        m_persistent_exprs.shrink(lim);
+        ptr_buffer<enode> bindings;
+        unsigned j = head;
+        for (unsigned i = head; i < sz; i++) {
+            persistent_instance p = m_persistent[i];
+            expr * const * es     = exprs.c_ptr() + (p.m_exprs - lim);
+            quantifier * q        = to_quantifier(es[0]);
+            expr * lemma          = es[1];
+            if (!m_context.b_internalized(q))
+                continue;
+            bindings.reset();
+            for (unsigned k = 0; k < p.m_num_bindings; k++) {
+                expr * b = es[2 + k];
+                if (!m_context.e_internalized(b))
+                    break;
+                bindings.push_back(m_context.get_enode(b));
+            }
+            if (bindings.size() < p.m_num_bindings)
+                continue;
+            TRACE("qi_queue", tout << "reasserting:\n" << mk_pp(lemma, m_manager) << "\n";);
+            m_context.add_fingerprint(q, q->get_id(), bindings.size(), bindings.c_ptr());
+            m_context.internalize_instance(lemma, 0, p.m_generation);
+            m_stats.m_num_reasserted_instances++;
+            p.m_scope = m_context.get_scope_level();
+            p.m_exprs = m_persistent_exprs.size();
+            m_persistent_exprs.append(p.m_num_bindings + 2, es);
+            m_persistent[j++] = p;
+        }
+        m_persistent.shrink(j);
+        m_persistent_head = j;
+    }
+
     void qi_queue::reset() {
+        m_persistent.reset();
+        m_persistent_exprs.reset();
+        m_persistent_head = 0;
         m_new_entries.reset();
         m_delayed_entries.reset();
         m_instances.reset();
@@ -470,6 +541,8 @@ namespace smt {
     void qi_queue::collect_statistics(::statistics & st) const {
         st.update("quant instantiations", m_stats.m_num_instances);
         st.update("lazy quant instantiations", m_stats.m_num_lazy_instances);
+        if (m_params.m_qi_persistent_instances)
+            st.update("reasserted quant instantiations", m_stats.m_num_reasserted_instances);
         st.update("missed quant instantiations", m_delayed_entries.size());
         float min, max;
         get_min_max_costs(min, max);
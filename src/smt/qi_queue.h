@@ -34,7 +34,7 @@ namespace smt {
     class context;
 
     struct qi_queue_stats {
-        unsigned m_num_instances, m_num_lazy_instances;
+        unsigned m_num_instances, m_num_lazy_instances, m_num_reasserted_instances;
         void reset() { memset(this, 0, sizeof(qi_queue_stats)); }
         qi_queue_stats() { reset(); }
     };
@@ -49,7 +49,8 @@ namespace smt {
         expr_ref                      m_cost_function;
         expr_ref                      m_new_gen_function;
         cost_parser                   m_parser;
-        cost_evaluator                m_evaluator;
+        compiled_cost_function        m_cost;          // compiled m_cost_function
+        compiled_cost_function        m_new_gen;       // compiled m_new_gen_function
         cached_var_subst              m_subst;
         svector<float>                m_vals;
         double                        m_eager_cost_threshold;
@@ -71,6 +72,19 @@ namespace smt {
         };
         svector<scope>                m_scopes;
 
+        // Instances created at the base level of a user scope, kept with qi.persistent_instances.
+        // The scope levels of the instances are non-decreasing. The instances popped
+        // by pop_scope form a suffix, from m_persistent_head, and are asserted again by reassert_instances.
+        struct persistent_instance {
+            unsigned m_scope;
+            unsigned m_generation;
+            unsigned m_num_bindings;
+            unsigned m_exprs;        // quantifier, lemma and bindings are stored from m_persistent_exprs[m_exprs]
+        };
+        svector<persistent_instance>  m_persistent;
+        expr_ref_vector               m_persistent_exprs;
+        unsigned                      m_persistent_head;
+
         void init_parser_vars();
         quantifier_stat * set_values(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation, float cost);
         float get_cost(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation);
@@ -78,6 +92,7 @@ namespace smt {
         void instantiate(entry & ent);
         void get_min_max_costs(float & min, float & max) const;
         void display_instance_profile(fingerprint * f, quantifier * q, unsigned num_bindings, enode * const * bindings, unsigned proof_id, unsigned generation);
+        void persist_instance(quantifier * q, expr * lemma, unsigned num_bindings, enode * const * bindings, unsigned generation);
 
     public:
         qi_queue(quantifier_manager & qm, context & ctx, qi_params & params);
@@ -94,6 +109,12 @@ namespace smt {
         bool final_check_eh();
         void push_scope();
         void pop_scope(unsigned num_scopes);
+        /**
+           \brief Assert again the persistent instances popped by the last pop_scope,
+           if their quantifier and bindings are still internalized.
+           Must be invoked at the base level, after the user scopes are popped.
+        */
+        void reassert_instances();
         void reset();
         void display_delayed_instances_stats(std::ostream & out) const;
         void collect_statistics(::statistics & st) const;
@@ -17,8 +17,10 @@ Notes:
 
 --*/
 #include "cmd_context/cmd_context.h"
+#include "cmd_context/cmd_util.h"
 #include "parsers/smt2/smt2parser.h"
 #include "smt/smt2_extra_cmds.h"
+#include "smt/mam.h"
 
 class include_cmd : public cmd {
     char const * m_filename;
@@ -42,6 +44,33 @@ public:
     virtual void finalize(cmd_context & ctx) { reset(ctx); }
 };
 
+class get_ematching_profile_cmd : public cmd {
+    unsigned m_max_trees;
+public:
+    get_ematching_profile_cmd() : cmd("get-ematching-profile"), m_max_trees(UINT_MAX) {}
+    virtual char const * get_usage() const { return "<numeral>?"; }
+    virtual char const * get_descr(cmd_context & ctx) const {
+        return "display the E-matching code trees profiled with smt.qi.profile_ematching=true, most expensive first; the optional numeral bounds the number of code trees displayed";
+    }
+    virtual unsigned get_arity() const { return VAR_ARITY; }
+    virtual cmd_arg_kind next_arg_kind(cmd_context & ctx) const { return CPK_UINT; }
+    virtual void set_next_arg(cmd_context & ctx, unsigned val) {
+        if (m_max_trees != UINT_MAX)
+            throw cmd_exception("invalid get-ematching-profile command, too many arguments");
+        m_max_trees = val;
+    }
+    virtual void execute(cmd_context & ctx) {
+        smt::display_mam_profile(ctx.regular_stream(), m_max_trees);
+    }
+    virtual void prepare(cmd_context & ctx) { reset(ctx); }
+    virtual void reset(cmd_context & ctx) { m_max_trees = UINT_MAX; }
+    virtual void finalize(cmd_context & ctx) { reset(ctx); }
+};
+
+ATOMIC_CMD(reset_ematching_profile_cmd, "reset-ematching-profile", "reset the E-matching profile", smt::reset_mam_profile(); ctx.print_success(););
+
 void install_smt2_extra_cmds(cmd_context & ctx) {
     ctx.insert(alloc(include_cmd));
+    ctx.insert(alloc(get_ematching_profile_cmd));
+    ctx.insert(alloc(reset_ematching_profile_cmd));
 }
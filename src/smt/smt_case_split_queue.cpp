@@ -24,66 +24,116 @@ Revision History:
 #include "ast/ast_pp.h"
 #include "util/map.h"
 #include "util/hashtable.h"
+#include "util/keyed_heap.h"
 
 namespace smt {
 
     typedef map<bool_var, double, int_hash, default_eq<bool_var> > theory_var_priority_map;
 
-    struct bool_var_act_lt {
-        svector<double> const & m_activity;
-        bool_var_act_lt(svector<double> const & a):m_activity(a) {}
-        bool operator()(bool_var v1, bool_var v2) const {
-            return m_activity[v1] > m_activity[v2];
+    /**
+       \brief Store in result the (at most) n unassigned variables of q with the highest keys.
+    */
+    static void next_case_splits_core(context & ctx, keyed_heap const & q, unsigned n, bool_var_vector & result) {
+        svector<keyed_heap::entry> entries;
+        for (keyed_heap::entry const & e : q) {
+            if (ctx.get_assignment(e.m_value) == l_undef)
+                entries.push_back(e);
+        }
+        n = std::min(n, entries.size());
+        std::partial_sort(entries.begin(), entries.begin() + n, entries.end(),
+                          [](keyed_heap::entry const & e1, keyed_heap::entry const & e2) { return e1.m_key > e2.m_key; });
+        result.reset();
+        for (unsigned i = 0; i < n; ++i) {
+            result.push_back(entries[i].m_value);
         }
-    };
-
-    typedef heap<bool_var_act_lt> bool_var_act_queue;
+    }
 
-    struct theory_aware_act_lt {
-        svector<double> const & m_activity;
-        theory_var_priority_map const & m_theory_var_priority;
-        theory_aware_act_lt(svector<double> const & act, theory_var_priority_map const & a):m_activity(act),m_theory_var_priority(a) {}
-        bool operator()(bool_var v1, bool_var v2) const {
-            double p_v1, p_v2;
-            if (!m_theory_var_priority.find(v1, p_v1)) {
-                p_v1 = 0.0;
-            }
-            if (!m_theory_var_priority.find(v2, p_v2)) {
-                p_v2 = 0.0;
+    static void display_queue(context & ctx, keyed_heap const & q, std::ostream & out) {
+        bool first = true;
+        for (keyed_heap::entry const & e : q) {
+            if (ctx.get_assignment(e.m_value) == l_undef) {
+                if (first) {
+                    out << "remaining case-splits:\n";
+                    first = false;
+                }
+                out << "#" << ctx.bool_var2expr(e.m_value)->get_id() << " ";
             }
-            // add clause activity
-            p_v1 += m_activity[v1];
-            p_v2 += m_activity[v2];
-            return p_v1 > p_v2;
         }
-    };
-
-    typedef heap<theory_aware_act_lt> theory_aware_act_queue;
+        if (!first)
+            out << "\n";
+    }
 
     /**
        \brief Case split queue based on activity and random splits.
+
+       The heap caches the activity of the variables, and it contains only
+       unassigned variables: a variable is removed when it is assigned, and
+       inserted again when it is unassigned. So next_case_split does not
+       need to skip assigned variables.
     */
     class act_case_split_queue : public case_split_queue {
     protected:
         context &          m_context;
         smt_params &       m_params;  
-        bool_var_act_queue m_queue;
+        keyed_heap         m_queue;
+
+        /**
+           \brief The key of v in the heaps. The larger the key, the earlier v is split on.
+        */
+        virtual double get_key(bool_var v) const {
+            return m_context.get_activity(v);
+        }
+
+        struct get_key_proc {
+            act_case_split_queue const & m_owner;
+            get_key_proc(act_case_split_queue const & o):m_owner(o) {}
+            double operator()(unsigned v) const { return m_owner.get_key(v); }
+        };
+
+        void update_key(keyed_heap & q, bool_var v) {
+            if (q.contains(v))
+                q.set_key(v, get_key(v));
+        }
+
+        bool random_case_split(bool_var & next) {
+            if (m_context.get_random_value() < static_cast<int>(m_params.m_random_var_freq * random_gen::max_value())) {
+                SASSERT(m_context.get_num_b_internalized() > 0);
+                next = m_context.get_random_value() % m_context.get_num_b_internalized(); 
+                TRACE("random_split", tout << "next: " << next << " get_assignment(next): " << m_context.get_assignment(next) << "\n";);
+                return m_context.get_assignment(next) == l_undef;
+            }
+            return false;
+        }
+
+        bool erase_max(keyed_heap & q, bool_var & next) {
+            // only variables assigned without going through assign_lit_eh, such as
+            // true_bool_var, are skipped here.
+            while (!q.empty()) {
+                next = q.erase_max();
+                if (m_context.get_assignment(next) == l_undef)
+                    return true;
+            }
+            return false;
+        }
+
     public:
         act_case_split_queue(context & ctx, smt_params & p):
             m_context(ctx),
-            m_params(p),
-            m_queue(1024, bool_var_act_lt(ctx.get_activity_vector())) {
+            m_params(p) {
         }
             
         virtual void activity_increased_eh(bool_var v) {
-            if (m_queue.contains(v))
-                m_queue.decreased(v);
+            update_key(m_queue, v);
+        }
+
+        virtual void activity_rescaled_eh() {
+            m_queue.rekey(get_key_proc(*this));
         }
 
         virtual void mk_var_eh(bool_var v) {
             m_queue.reserve(v+1);
             SASSERT(!m_queue.contains(v));
-            m_queue.insert(v);
+            m_queue.insert(v, get_key(v));
         }
 
         virtual void del_var_eh(bool_var v) {
@@ -91,9 +141,14 @@ namespace smt {
                 m_queue.erase(v);
         }
 
+        virtual void assign_lit_eh(literal l) {
+            if (m_queue.contains(l.var()))
+                m_queue.erase(l.var());
+        }
+
         virtual void unassign_var_eh(bool_var v) {
             if (!m_queue.contains(v))
-                m_queue.insert(v);
+                m_queue.insert(v, get_key(v));
         }
 
         virtual void relevant_eh(expr * n) {}
@@ -112,59 +167,41 @@ namespace smt {
 
         virtual void next_case_split(bool_var & next, lbool & phase) {
             phase = l_undef;
-            
-            if (m_context.get_random_value() < static_cast<int>(m_params.m_random_var_freq * random_gen::max_value())) {
-                next = m_context.get_random_value() % m_context.get_num_b_internalized(); 
-                TRACE("random_split", tout << "next: " << next << " get_assignment(next): " << m_context.get_assignment(next) << "\n";);
-                if (m_context.get_assignment(next) == l_undef)
-                    return;
-            }
-            
-            while (!m_queue.empty()) {
-                next = m_queue.erase_min();
-                if (m_context.get_assignment(next) == l_undef)
-                    return;
-            }
-            
+            if (random_case_split(next) || erase_max(m_queue, next))
+                return;
             next = null_bool_var;
         }
 
+        virtual void next_case_splits(unsigned n, bool_var_vector & result) {
+            next_case_splits_core(m_context, m_queue, n, result);
+        }
+
         virtual void display(std::ostream & out) {
-            bool first = true;
-            for (unsigned v : m_queue) {
-                if (m_context.get_assignment(v) == l_undef) {
-                    if (first) {
-                        out << "remaining case-splits:\n";
-                        first = false;
-                    }
-                    out << "#" << m_context.bool_var2expr(v)->get_id() << " ";
-                }
-            }
-            if (!first)
-                out << "\n";            
+            display_queue(m_context, m_queue, out);
         }
 
         virtual ~act_case_split_queue() {};
     };
 
     /**
-       \brief Similar to dact_case_split_queue, but delay case splits
+       \brief Similar to act_case_split_queue, but delay case splits
        created during the search.
     */
     class dact_case_split_queue : public act_case_split_queue {
-        bool_var_act_queue m_delayed_queue;
+        keyed_heap m_delayed_queue;
     public:
         dact_case_split_queue(context & ctx, smt_params & p):
-            act_case_split_queue(ctx, p),
-            m_delayed_queue(1024, bool_var_act_lt(ctx.get_activity_vector())) {
+            act_case_split_queue(ctx, p) {
         }
 
         virtual void activity_increased_eh(bool_var v) {
-            act_case_split_queue::activity_increased_eh(v);
-            if (m_queue.contains(v))
-                m_queue.decreased(v);
-            if (m_delayed_queue.contains(v))
-                m_delayed_queue.decreased(v);
+            update_key(m_queue, v);
+            update_key(m_delayed_queue, v);
+        }
+
+        virtual void activity_rescaled_eh() {
+            m_queue.rekey(get_key_proc(*this));
+            m_delayed_queue.rekey(get_key_proc(*this));
         }
 
         virtual void mk_var_eh(bool_var v) {
@@ -173,9 +210,9 @@ namespace smt {
             SASSERT(!m_delayed_queue.contains(v));
             SASSERT(!m_queue.contains(v));
             if (m_context.is_searching()) 
-                m_delayed_queue.insert(v);
+                m_delayed_queue.insert(v, get_key(v));
             else
-                m_queue.insert(v);
+                m_queue.insert(v, get_key(v));
         }
 
         virtual void del_var_eh(bool_var v) {
@@ -184,6 +221,17 @@ namespace smt {
                 m_delayed_queue.erase(v);
         }
 
+        virtual void assign_lit_eh(literal l) {
+            act_case_split_queue::assign_lit_eh(l);
+            if (m_delayed_queue.contains(l.var()))
+                m_delayed_queue.erase(l.var());
+        }
+
+        virtual void unassign_var_eh(bool_var v) {
+            if (!m_queue.contains(v) && !m_delayed_queue.contains(v))
+                m_queue.insert(v, get_key(v));
+        }
+
         virtual void relevant_eh(expr * n) {}
 
         virtual void init_search_eh() {}
@@ -207,11 +255,8 @@ namespace smt {
             m_queue.swap(m_delayed_queue);
             SASSERT(m_delayed_queue.empty());
             
-            while (!m_queue.empty()) {
-                next = m_queue.erase_min();
-                if (m_context.get_assignment(next) == l_undef)
-                    return;
-            }
+            if (erase_max(m_queue, next))
+                return;
             
             next = null_bool_var;
         }
@@ -495,7 +540,7 @@ namespace smt {
         ptr_vector<expr>  m_queue;
         unsigned          m_head;
         int               m_bs_num_bool_vars; //!< Number of boolean variable before starting to search.
-        bool_var_act_queue m_delayed_queue;
+        keyed_heap        m_delayed_queue; // variables created during the search, by activity
         svector<scope>    m_scopes;
     public:
         rel_act_case_split_queue(context & ctx, smt_params & p):
@@ -503,17 +548,24 @@ namespace smt {
             m_manager(ctx.get_manager()),
             m_params(p),
             m_head(0),
-            m_bs_num_bool_vars(UINT_MAX),
-            m_delayed_queue(1024, bool_var_act_lt(ctx.get_activity_vector())) {
+            m_bs_num_bool_vars(UINT_MAX) {
         }
 
-        virtual void activity_increased_eh(bool_var v) {}
+        virtual void activity_increased_eh(bool_var v) {
+            if (m_delayed_queue.contains(v))
+                m_delayed_queue.set_key(v, m_context.get_activity(v));
+        }
+
+        virtual void activity_rescaled_eh() {
+            context & ctx = m_context;
+            m_delayed_queue.rekey([&](unsigned v) { return ctx.get_activity(v); });
+        }
 
         virtual void mk_var_eh(bool_var v) {
             if (m_context.is_searching()) {
                 SASSERT(v >= m_bs_num_bool_vars);
                 m_delayed_queue.reserve(v+1);
-                m_delayed_queue.insert(v);
+                m_delayed_queue.insert(v, m_context.get_activity(v));
             }
         }
 
@@ -522,11 +574,16 @@ namespace smt {
                 m_delayed_queue.erase(v);
         }
 
+        virtual void assign_lit_eh(literal l) {
+            if (m_delayed_queue.contains(l.var()))
+                m_delayed_queue.erase(l.var());
+        }
+
         virtual void unassign_var_eh(bool_var v) {
             if (v < m_bs_num_bool_vars)
                 return;
             if (!m_delayed_queue.contains(v))
-                m_delayed_queue.insert(v);
+                m_delayed_queue.insert(v, m_context.get_activity(v));
         }
 
         virtual void relevant_eh(expr * n) {
@@ -645,7 +702,7 @@ namespace smt {
                 return;
             phase = l_undef;
             while (!m_delayed_queue.empty()) {
-                next = m_delayed_queue.erase_min();
+                next = m_delayed_queue.erase_max();
                 if (m_context.get_assignment(next) == l_undef)
                     return;
             }
@@ -1111,115 +1168,42 @@ namespace smt {
         }
     };
 
-    class theory_aware_branching_queue : public case_split_queue {
+    /**
+       \brief Activity based case split queue, where theories can raise the priority
+       of variables and set their phase. The key of a variable is its priority plus
+       its activity.
+    */
+    class theory_aware_branching_queue : public act_case_split_queue {
     protected:
-        context &          m_context;
-        smt_params &       m_params;
         theory_var_priority_map m_theory_var_priority;
-        theory_aware_act_queue m_queue;
-
-        int_hashtable<int_hash, default_eq<bool_var> > m_theory_vars;
         map<bool_var, lbool, int_hash, default_eq<bool_var> > m_theory_var_phase;
-    public:
-        theory_aware_branching_queue(context & ctx, smt_params & p):
-            m_context(ctx),
-            m_params(p),
-            m_theory_var_priority(),
-            m_queue(1024, theory_aware_act_lt(ctx.get_activity_vector(), m_theory_var_priority)) {
-        }
 
-        virtual void activity_increased_eh(bool_var v) {
-            if (m_queue.contains(v))
-                m_queue.decreased(v);
-        }
-
-        virtual void mk_var_eh(bool_var v) {
-            m_queue.reserve(v+1);
-            m_queue.insert(v);
-        }
-
-        virtual void del_var_eh(bool_var v) {
-            if (m_queue.contains(v))
-                m_queue.erase(v);
-        }
-
-        virtual void unassign_var_eh(bool_var v) {
-            if (!m_queue.contains(v))
-                m_queue.insert(v);
+        virtual double get_key(bool_var v) const {
+            double p;
+            if (!m_theory_var_priority.find(v, p)) {
+                p = 0.0;
+            }
+            // add clause activity
+            return p + m_context.get_activity(v);
         }
 
-        virtual void relevant_eh(expr * n) {}
-
-        virtual void init_search_eh() {}
-
-        virtual void end_search_eh() {}
-
-        virtual void reset() {
-            m_queue.reset();
+    public:
+        theory_aware_branching_queue(context & ctx, smt_params & p):
+            act_case_split_queue(ctx, p) {
         }
 
-        virtual void push_scope() {}
-
-        virtual void pop_scope(unsigned num_scopes) {}
-
         virtual void next_case_split(bool_var & next, lbool & phase) {
-            int threshold = static_cast<int>(m_params.m_random_var_freq * random_gen::max_value());
-            SASSERT(threshold >= 0);
-            if (m_context.get_random_value() < threshold) {
-                SASSERT(m_context.get_num_b_internalized() > 0);
-                next = m_context.get_random_value() % m_context.get_num_b_internalized(); 
-                TRACE("random_split", tout << "next: " << next << " get_assignment(next): " << m_context.get_assignment(next) << "\n";);
-                if (m_context.get_assignment(next) == l_undef)
-                    return;
-            }
-
-            while (!m_queue.empty()) {
-                next = m_queue.erase_min();
-                if (m_context.get_assignment(next) == l_undef)
-                    return;
-            }
-
-            next = null_bool_var;
-            if (m_theory_vars.contains(next)) {
-                if (!m_theory_var_phase.find(next, phase)) {
-                    phase = l_undef;
-                }
+            act_case_split_queue::next_case_split(next, phase);
+            if (next != null_bool_var && !m_theory_var_phase.find(next, phase)) {
+                phase = l_undef;
             }
         }
 
         virtual void add_theory_aware_branching_info(bool_var v, double priority, lbool phase) {
             TRACE("theory_aware_branching", tout << "Add theory-aware branching information for l#" << v << ": priority=" << priority << std::endl;);
-            m_theory_vars.insert(v);
             m_theory_var_phase.insert(v, phase);
             m_theory_var_priority.insert(v, priority);
-            if (m_queue.contains(v)) {
-                if (priority > 0.0) {
-                    m_queue.decreased(v);
-                } else {
-                    m_queue.increased(v);
-                }
-            }
-            // m_theory_queue.reserve(v+1);
-            // m_theory_queue.insert(v);
-        }
-
-        virtual void display(std::ostream & out) {
-            bool first = true;
-            bool_var_act_queue::const_iterator it  = m_queue.begin();
-            bool_var_act_queue::const_iterator end = m_queue.end();
-            for (; it != end ; ++it) {
-                unsigned v = *it;
-                if (m_context.get_assignment(v) == l_undef) {
-                    if (first) {
-                        out << "remaining case-splits:\n";
-                        first = false;
-                    }
-                    out << "#" << m_context.bool_var2expr(v)->get_id() << " ";
-                }
-            }
-            if (!first)
-                out << "\n";
-
+            update_key(m_queue, v);
         }
 
         virtual ~theory_aware_branching_queue() {};
@@ -32,6 +32,11 @@ namespace smt {
     class case_split_queue {
     public:
         virtual void activity_increased_eh(bool_var v) = 0;
+        /**
+           \brief The activity of all variables was scaled down.
+           Queues that cache activities must refresh them.
+        */
+        virtual void activity_rescaled_eh() {}
         virtual void mk_var_eh(bool_var v) = 0;
         virtual void del_var_eh(bool_var v) = 0;
         virtual void assign_lit_eh(literal l) {}
@@ -44,6 +49,13 @@ namespace smt {
         virtual void push_scope() = 0;
         virtual void pop_scope(unsigned num_scopes) = 0;
         virtual void next_case_split(bool_var & next, lbool & phase) = 0;
+        /**
+           \brief Store in result at most n unassigned variables, in the order in which
+           they are preferred as case splits. It does not change the queue,
+           and it is used to split the search space into cubes.
+           The default implementation leaves result empty.
+        */
+        virtual void next_case_splits(unsigned n, bool_var_vector & result) {}
         virtual void display(std::ostream & out) = 0;
         virtual ~case_split_queue() {}
 
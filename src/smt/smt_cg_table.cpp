@@ -107,7 +107,7 @@ namespace smt {
 
 #else
     // one table per func_decl implementation
-    unsigned cg_table::cg_hash::operator()(enode * n) const {
+    unsigned cg_nary_sig::mk(enode * n, cg_nary_sig & s) {
         SASSERT(n->get_decl()->is_flat_associative() || n->get_num_args() >= 3);
         unsigned a, b, c;
         a = b = 0x9e3779b9;
@@ -135,10 +135,12 @@ namespace smt {
         return c;
     }
 
-    bool cg_table::cg_eq::operator()(enode * n1, enode * n2) const {
-        SASSERT(n1->get_num_args() == n2->get_num_args());
+    bool cg_nary_sig::eq(cg_nary_sig const & s1, enode * n1, cg_nary_sig const & s2, enode * n2, bool & comm) {
         SASSERT(n1->get_decl() == n2->get_decl());
         unsigned num = n1->get_num_args();
+        // applications of flat associative symbols can have different numbers of arguments.
+        if (num != n2->get_num_args())
+            return false;
         for (unsigned i = 0; i < num; i++) 
             if (n1->get_arg(i)->get_root() != n2->get_arg(i)->get_root())
                 return false;
@@ -169,7 +171,7 @@ namespace smt {
                 return r;
             }
             else if (d->is_commutative()) {
-                r = TAG(void*, alloc(comm_table, cg_comm_hash(), cg_comm_eq(m_commutativity)), BINARY_COMM);
+                r = TAG(void*, alloc(comm_table), BINARY_COMM);
                 SASSERT(GET_TAG(r) == BINARY_COMM);
                 return r;
             }
@@ -240,6 +242,22 @@ namespace smt {
 
 #ifdef Z3DEBUG
     bool cg_table::check_invariant() const {
+        for (void * t : m_tables) {
+            switch (GET_TAG(t)) {
+            case UNARY:
+                SASSERT(UNTAG(unary_table*, t)->check_signatures());
+                break;
+            case BINARY:
+                SASSERT(UNTAG(binary_table*, t)->check_signatures());
+                break;
+            case BINARY_COMM:
+                SASSERT(UNTAG(comm_table*, t)->check_signatures());
+                break;
+            case NARY:
+                SASSERT(UNTAG(table*, t)->check_signatures());
+                break;
+            }
+        }
         return true;
     }
 #endif
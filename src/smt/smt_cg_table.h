@@ -21,7 +21,6 @@ Revision History:
 
 #include "smt/smt_enode.h"
 #include "util/hashtable.h"
-#include "util/chashtable.h"
 
 namespace smt {
 
@@ -113,111 +112,238 @@ namespace smt {
     // one table per function symbol
 
     /**
-       \brief Congruence table.
+       \brief Signature of a unary enode: the id of the root of its argument.
     */
-    class cg_table {
-        struct cg_unary_hash {
-            unsigned operator()(enode * n) const {
-                SASSERT(n->get_num_args() == 1);
-                return n->get_arg(0)->get_root()->hash();
+    struct cg_unary_sig {
+        unsigned m_arg;
+        static unsigned mk(enode * n, cg_unary_sig & s) {
+            SASSERT(n->get_num_args() == 1);
+            s.m_arg = n->get_arg(0)->get_root()->get_owner_id();
+            return hash_u(s.m_arg);
+        }
+        static bool eq(cg_unary_sig const & s1, enode * n1, cg_unary_sig const & s2, enode * n2, bool & comm) {
+            return s1.m_arg == s2.m_arg;
+        }
+    };
+
+    /**
+       \brief Signature of a binary enode: the ids of the roots of its arguments.
+    */
+    struct cg_binary_sig {
+        unsigned m_arg1;
+        unsigned m_arg2;
+        static unsigned mk(enode * n, cg_binary_sig & s) {
+            SASSERT(n->get_num_args() == 2);
+            s.m_arg1 = n->get_arg(0)->get_root()->get_owner_id();
+            s.m_arg2 = n->get_arg(1)->get_root()->get_owner_id();
+            return hash_u_u(s.m_arg1, s.m_arg2);
+        }
+        static bool eq(cg_binary_sig const & s1, enode * n1, cg_binary_sig const & s2, enode * n2, bool & comm) {
+            return s1.m_arg1 == s2.m_arg1 && s1.m_arg2 == s2.m_arg2;
+        }
+    };
+
+    /**
+       \brief Signature of a binary enode of a commutative function symbol.
+       The hash does not depend on the order of the arguments.
+    */
+    struct cg_comm_sig : public cg_binary_sig {
+        static unsigned mk(enode * n, cg_comm_sig & s) {
+            cg_binary_sig::mk(n, s);
+            return s.m_arg1 < s.m_arg2 ? hash_u_u(s.m_arg1, s.m_arg2) : hash_u_u(s.m_arg2, s.m_arg1);
+        }
+        static bool eq(cg_comm_sig const & s1, enode * n1, cg_comm_sig const & s2, enode * n2, bool & comm) {
+            if (s1.m_arg1 == s2.m_arg1 && s1.m_arg2 == s2.m_arg2)
+                return true;
+            if (s1.m_arg1 == s2.m_arg2 && s1.m_arg2 == s2.m_arg1) {
+                comm = true;
+                return true;
             }
+            return false;
+        }
+    };
+
+    /**
+       \brief Enodes with more arguments only cache their hash, and
+       their arguments are compared directly.
+    */
+    struct cg_nary_sig {
+        static unsigned mk(enode * n, cg_nary_sig & s);
+        static bool eq(cg_nary_sig const & s1, enode * n1, cg_nary_sig const & s2, enode * n2, bool & comm);
+    };
+
+    /**
+       \brief Open addressing table of the enodes of one function symbol.
+
+       A cell stores the signature of its enode and the hash of the
+       signature, computed when the enode was inserted. They remain valid
+       while the enode is in the table, because the context removes an
+       enode from the congruence table before the root of one of its
+       arguments changes (see context::remove_parents_from_cg_table). So
+       probing compares the signature of the query with the cached
+       signatures, without following the arguments of the enodes in the
+       table.
+
+       The table uses linear probing with a load factor of at most 1/2.
+       Erasing shifts the following cells of the probe sequence back, so
+       the many erase/insert pairs done by merges and backtracking do not
+       leave tombstones behind.
+    */
+    template<typename Sig>
+    class cg_sig_table {
+        struct cell {
+            enode *  m_node;    // 0 if the cell is free
+            unsigned m_hash;
+            Sig      m_sig;
         };
 
-        struct cg_unary_eq {
-            bool operator()(enode * n1, enode * n2) const {
-                SASSERT(n1->get_num_args() == 1);
-                SASSERT(n2->get_num_args() == 1);
-                SASSERT(n1->get_decl() == n2->get_decl());
-                return n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root();
+        svector<cell> m_cells;
+        unsigned      m_size;
+
+        void alloc_cells(unsigned capacity) {
+            cell c;
+            c.m_node = 0;
+            c.m_hash = 0;
+            m_cells.reset();
+            m_cells.resize(capacity, c);
+        }
+
+        void rehash(unsigned new_capacity) {
+            svector<cell> old_cells;
+            old_cells.swap(m_cells);
+            alloc_cells(new_capacity);
+            unsigned mask = new_capacity - 1;
+            for (cell const & c : old_cells) {
+                if (c.m_node != 0) {
+                    unsigned idx = c.m_hash & mask;
+                    while (m_cells[idx].m_node != 0)
+                        idx = (idx + 1) & mask;
+                    m_cells[idx] = c;
+                }
             }
-        };
+        }
 
-        typedef chashtable<enode *, cg_unary_hash, cg_unary_eq> unary_table;
-        
-        struct cg_binary_hash {
-            unsigned operator()(enode * n) const {
-                SASSERT(n->get_num_args() == 2);
-                // too many collisions
-                // unsigned r = 17 + n->get_arg(0)->get_root()->hash();
-                // return r * 31 + n->get_arg(1)->get_root()->hash();
-                return combine_hash(n->get_arg(0)->get_root()->hash(), n->get_arg(1)->get_root()->hash());
+        void reserve_one() {
+            if (2 * (m_size + 1) > m_cells.size())
+                rehash(2 * m_cells.size());
+        }
+
+    public:
+        cg_sig_table():m_size(0) {
+            alloc_cells(8);
+        }
+
+        unsigned size() const { return m_size; }
+
+        /**
+           \brief Return the enode in the table congruent to n, or 0.
+        */
+        enode * find(enode * n, bool & comm) const {
+            Sig s;
+            unsigned h    = Sig::mk(n, s);
+            unsigned mask = m_cells.size() - 1;
+            unsigned idx  = h & mask;
+            while (true) {
+                cell const & c = m_cells[idx];
+                if (c.m_node == 0)
+                    return 0;
+                if (c.m_hash == h && Sig::eq(c.m_sig, c.m_node, s, n, comm))
+                    return c.m_node;
+                idx = (idx + 1) & mask;
             }
-        };
+        }
 
-        struct cg_binary_eq {
-            bool operator()(enode * n1, enode * n2) const {
-                SASSERT(n1->get_num_args() == 2);
-                SASSERT(n2->get_num_args() == 2);
-                SASSERT(n1->get_decl() == n2->get_decl());
-#if 1
-                return 
-                    n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root() &&
-                    n1->get_arg(1)->get_root() == n2->get_arg(1)->get_root();
-#else
-                bool r = 
-                    n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root() &&
-                    n1->get_arg(1)->get_root() == n2->get_arg(1)->get_root();
-                static unsigned counter = 0;
-                static unsigned failed  = 0;
-                if (!r) 
-                    failed++;
-                counter++;
-                if (counter % 100000 == 0) 
-                    std::cerr << "[cg_eq] " << counter << " " << failed << "\n";
-                return r;
-#endif
+        enode * insert_if_not_there(enode * n, bool & comm) {
+            reserve_one();
+            Sig s;
+            unsigned h    = Sig::mk(n, s);
+            unsigned mask = m_cells.size() - 1;
+            unsigned idx  = h & mask;
+            while (true) {
+                cell & c = m_cells[idx];
+                if (c.m_node == 0)
+                    break;
+                if (c.m_hash == h && Sig::eq(c.m_sig, c.m_node, s, n, comm))
+                    return c.m_node;
+                idx = (idx + 1) & mask;
             }
-        };
+            cell & c = m_cells[idx];
+            c.m_node = n;
+            c.m_hash = h;
+            c.m_sig  = s;
+            m_size++;
+            return n;
+        }
 
-        typedef chashtable<enode*, cg_binary_hash, cg_binary_eq> binary_table;
-        
-        struct cg_comm_hash {
-            unsigned operator()(enode * n) const {
-                SASSERT(n->get_num_args() == 2);
-                unsigned h1 = n->get_arg(0)->get_root()->hash();
-                unsigned h2 = n->get_arg(1)->get_root()->hash();
-                if (h1 > h2)
-                    std::swap(h1, h2);
-                return hash_u((h1 << 16) | (h2 & 0xFFFF));
+        void erase(enode * n) {
+            Sig s;
+            unsigned h    = Sig::mk(n, s);
+            unsigned mask = m_cells.size() - 1;
+            unsigned idx  = h & mask;
+            while (m_cells[idx].m_node != n) {
+                if (m_cells[idx].m_node == 0)
+                    return;
+                idx = (idx + 1) & mask;
             }
-        };
-        
-        struct cg_comm_eq {
-            bool & m_commutativity;
-            cg_comm_eq(bool & c):m_commutativity(c) {}
-            bool operator()(enode * n1, enode * n2) const {
-                SASSERT(n1->get_num_args() == 2);
-                SASSERT(n2->get_num_args() == 2);
-                SASSERT(n1->get_decl() == n2->get_decl());
-                enode * c1_1 = n1->get_arg(0)->get_root();
-                enode * c1_2 = n1->get_arg(1)->get_root();
-                enode * c2_1 = n2->get_arg(0)->get_root();
-                enode * c2_2 = n2->get_arg(1)->get_root();
-                if (c1_1 == c2_1 && c1_2 == c2_2) {
-                    return true;
-                }
-                if (c1_1 == c2_2 && c1_2 == c2_1) {
-                    m_commutativity = true;
-                    return true;
+            m_size--;
+            // shift back the cells of the probe sequence, so that no tombstone is needed.
+            unsigned hole = idx;
+            while (true) {
+                idx = (idx + 1) & mask;
+                cell & c = m_cells[idx];
+                if (c.m_node == 0)
+                    break;
+                // c can move to the hole if its home position is not in (hole, idx].
+                unsigned home = c.m_hash & mask;
+                if (((idx - home) & mask) >= ((idx - hole) & mask)) {
+                    m_cells[hole] = c;
+                    hole = idx;
                 }
-                return false;
             }
-        };
-
-        typedef chashtable<enode*, cg_comm_hash, cg_comm_eq> comm_table;
+            m_cells[hole].m_node = 0;
+        }
 
-        struct cg_hash {
-            unsigned operator()(enode * n) const;
-        };
+        bool contains_ptr(enode * n) const {
+            Sig s;
+            unsigned h    = Sig::mk(n, s);
+            unsigned mask = m_cells.size() - 1;
+            unsigned idx  = h & mask;
+            while (true) {
+                cell const & c = m_cells[idx];
+                if (c.m_node == 0)
+                    return false;
+                if (c.m_node == n)
+                    return true;
+                idx = (idx + 1) & mask;
+            }
+        }
 
-        struct cg_eq {
-            bool operator()(enode * n1, enode * n2) const;
-        };
+        /**
+           \brief Check that the cached signatures match the current roots of the arguments.
+        */
+        bool check_signatures() const {
+            for (cell const & c : m_cells) {
+                if (c.m_node != 0) {
+                    Sig s;
+                    bool comm = false;
+                    SASSERT(Sig::mk(c.m_node, s) == c.m_hash);
+                    SASSERT(Sig::eq(c.m_sig, c.m_node, s, c.m_node, comm));
+                }
+            }
+            return true;
+        }
+    };
 
-        typedef chashtable<enode*, cg_hash, cg_eq> table;
+    /**
+       \brief Congruence table.
+    */
+    class cg_table {
+        typedef cg_sig_table<cg_unary_sig>  unary_table;
+        typedef cg_sig_table<cg_binary_sig> binary_table;
+        typedef cg_sig_table<cg_comm_sig>   comm_table;
+        typedef cg_sig_table<cg_nary_sig>   table;
 
         ast_manager &                 m_manager;
-        bool                          m_commutativity; //!< true if the last found congruence used commutativity
         ptr_vector<void>              m_tables;
         obj_map<func_decl, unsigned>  m_func_decl2id;
 
@@ -239,6 +365,20 @@ namespace smt {
             return m_tables[tid];
         }
 
+        static enode * find_in(void * t, enode * n) {
+            bool comm = false;
+            switch (static_cast<table_kind>(GET_TAG(t))) {
+            case UNARY:
+                return UNTAG(unary_table*, t)->find(n, comm);
+            case BINARY:
+                return UNTAG(binary_table*, t)->find(n, comm);
+            case BINARY_COMM:
+                return UNTAG(comm_table*, t)->find(n, comm);
+            default:
+                return UNTAG(table*, t)->find(n, comm);
+            }
+        }
+
     public:
         cg_table(ast_manager & m);
         ~cg_table();
@@ -253,22 +393,23 @@ namespace smt {
             // it doesn't make sense to insert a constant.
             SASSERT(n->get_num_args() > 0);
             enode * n_prime;
+            bool comm = false;
             void * t = get_table(n); 
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                n_prime = UNTAG(unary_table*, t)->insert_if_not_there(n);
-                return enode_bool_pair(n_prime, false);
+                n_prime = UNTAG(unary_table*, t)->insert_if_not_there(n, comm);
+                break;
             case BINARY:
-                n_prime = UNTAG(binary_table*, t)->insert_if_not_there(n);
-                return enode_bool_pair(n_prime, false);
+                n_prime = UNTAG(binary_table*, t)->insert_if_not_there(n, comm);
+                break;
             case BINARY_COMM:
-                m_commutativity = false;
-                n_prime = UNTAG(comm_table*, t)->insert_if_not_there(n);
-                return enode_bool_pair(n_prime, m_commutativity);
+                n_prime = UNTAG(comm_table*, t)->insert_if_not_there(n, comm);
+                break;
             default:
-                n_prime = UNTAG(table*, t)->insert_if_not_there(n);
-                return enode_bool_pair(n_prime, false);
+                n_prime = UNTAG(table*, t)->insert_if_not_there(n, comm);
+                break;
             }
+            return enode_bool_pair(n_prime, comm);
         }
 
         void erase(enode * n) {
@@ -291,49 +432,42 @@ namespace smt {
         }
 
         bool contains(enode * n) const {
-            SASSERT(n->get_num_args() > 0);
-            void * t = const_cast<cg_table*>(this)->get_table(n); 
-            switch (static_cast<table_kind>(GET_TAG(t))) {
-            case UNARY:
-                return UNTAG(unary_table*, t)->contains(n);
-            case BINARY:
-                return UNTAG(binary_table*, t)->contains(n);
-            case BINARY_COMM:
-                return UNTAG(comm_table*, t)->contains(n);
-            default:
-                return UNTAG(table*, t)->contains(n);
-            }
+            return find(n) != 0;
         }
 
         enode * find(enode * n) const {
             SASSERT(n->get_num_args() > 0);
-            enode * r = 0;
-            void * t = const_cast<cg_table*>(this)->get_table(n); 
-            switch (static_cast<table_kind>(GET_TAG(t))) {
-            case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) ? r : 0;
-            case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) ? r : 0;
-            case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) ? r : 0;
-            default:
-                return UNTAG(table*, t)->find(n, r) ? r : 0;
+            return find_in(const_cast<cg_table*>(this)->get_table(n), n);
+        }
+
+        /**
+           \brief Return the element congruent to n, or 0. As opposed to find,
+           no table is created for the function symbol of n, so several threads
+           can look up (their own) n while the table is not updated.
+        */
+        enode * find_existing(enode * n) const {
+            SASSERT(n->get_num_args() > 0);
+            unsigned tid = n->get_func_decl_id();
+            if (tid == UINT_MAX) {
+                if (!m_func_decl2id.find(n->get_decl(), tid))
+                    return 0;
+                n->set_func_decl_id(tid);
             }
+            return find_in(m_tables[tid], n);
         }
 
         bool contains_ptr(enode * n) const {
-            enode * r;
             SASSERT(n->get_num_args() > 0);
             void * t = const_cast<cg_table*>(this)->get_table(n); 
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) && n == r;
+                return UNTAG(unary_table*, t)->contains_ptr(n);
             case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) && n == r;
+                return UNTAG(binary_table*, t)->contains_ptr(n);
             case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) && n == r;
+                return UNTAG(comm_table*, t)->contains_ptr(n);
             default:
-                return UNTAG(table*, t)->find(n, r) && n == r;
+                return UNTAG(table*, t)->contains_ptr(n);
             }
         }
 
@@ -351,4 +485,3 @@ namespace smt {
 };
 
 #endif /* SMT_CG_TABLE_H_ */
-
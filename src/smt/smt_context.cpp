@@ -53,6 +53,7 @@ namespace smt {
         m_flushing(false),
         m_progress_callback(0),
         m_next_progress_sample(0),
+        m_parents_allocator("enode_parents"),
         m_fingerprints(m_region),
         m_b_internalized_stack(m),
         m_e_internalized_stack(m),
@@ -676,7 +677,7 @@ namespace smt {
        the one that implied r1 = r2.
     */
     void context::reinsert_parents_into_cg_table(enode * r1, enode * r2, enode * n1, enode * n2, eq_justification js) {
-        enode_vector & r2_parents  = r2->m_parents;
+        enode_parents & r2_parents = r2->m_parents;
         enode_vector::iterator it  = r1->begin_parents();
         enode_vector::iterator end = r1->end_parents();
         for (; it != end; ++it) {
@@ -712,7 +713,7 @@ namespace smt {
                     SASSERT(parent);
                     SASSERT(parent->is_cgr());
                     SASSERT(m_cg_table.contains_ptr(parent));
-                    r2_parents.push_back(parent);
+                    r2_parents.push_back(m_parents_allocator, parent);
                     continue;
                 }
                 parent->m_cg = parent_prime;
@@ -727,7 +728,7 @@ namespace smt {
             else {
                 // If congruence closure is not enabled for parent, then I just copy it
                 // to r2_parents
-                r2_parents.push_back(parent);
+                r2_parents.push_back(m_parents_allocator, parent);
             }
         }
     }
@@ -1832,6 +1833,7 @@ namespace smt {
         for (; it != end; ++it)
             *it *= INV_ACTIVITY_LIMIT;
         m_bvar_inc *= INV_ACTIVITY_LIMIT;
+        m_case_split_queue->activity_rescaled_eh();
     }
 
     /**
@@ -2915,6 +2917,7 @@ namespace smt {
         if (num_scopes > m_scope_lvl) return;
         pop_to_base_lvl();
         pop_scope(num_scopes);
+        m_qmanager->user_pop_eh();
     }
 
     /**
@@ -2935,7 +2938,7 @@ namespace smt {
         del_clauses(m_lemmas, 0);
         del_justifications(m_justifications, 0);
         if (m_is_diseq_tmp) { 
-            m_is_diseq_tmp->del_eh(m_manager, false);
+            m_is_diseq_tmp->del_eh(m_manager, m_parents_allocator, false);
             m_manager.dec_ref(m_is_diseq_tmp->get_owner()); 
             enode::del_dummy(m_is_diseq_tmp);
             m_is_diseq_tmp = 0; 
@@ -3417,6 +3420,35 @@ namespace smt {
         return r;
     }
 
+    struct bool_var_act_gt {
+        svector<double> const & m_activity;
+        bool_var_act_gt(svector<double> const & a):m_activity(a) {}
+        bool operator()(bool_var v1, bool_var v2) const { return m_activity[v1] > m_activity[v2]; }
+    };
+
+    void context::get_cube_literals(unsigned n, expr_ref_vector & lits) {
+        pop_to_base_lvl();
+        bool_var_vector vars;
+        m_case_split_queue->next_case_splits(n, vars);
+        if (vars.empty()) {
+            // the queue does not rank the variables, use their activity.
+            for (bool_var v = 0; v < static_cast<bool_var>(get_num_bool_vars()); ++v) {
+                if (get_assignment(v) == l_undef)
+                    vars.push_back(v);
+            }
+            n = std::min(n, vars.size());
+            std::partial_sort(vars.begin(), vars.begin() + n, vars.end(), bool_var_act_gt(m_activity));
+            vars.shrink(n);
+        }
+        for (bool_var v : vars) {
+            bool_var_data const & d = get_bdata(v);
+            bool is_pos = !d.m_phase_available || d.m_phase;
+            expr * e = bool_var2expr(v);
+            lits.push_back(is_pos ? e : m_manager.mk_not(e));
+        }
+        TRACE("cube", tout << lits << "\n";);
+    }
+
     void context::init_search() {
         ptr_vector<theory>::iterator it  = m_theory_set.begin();
         ptr_vector<theory>::iterator end = m_theory_set.end();
@@ -3447,6 +3479,7 @@ namespace smt {
 
     void context::end_search() {
         m_case_split_queue ->end_search_eh();
+        m_qmanager         ->end_search_eh();
     }
 
     void context::inc_limits() {
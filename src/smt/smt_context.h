@@ -63,9 +63,11 @@ Revision History:
 namespace smt {
 
     class model_generator;
+    class parallel;
 
     class context {
         friend class model_generator;
+        friend class parallel;
     public:
         statistics                  m_stats;
 
@@ -91,6 +93,7 @@ namespace smt {
         unsigned                    m_next_progress_sample;
 
         region                      m_region;
+        small_object_allocator      m_parents_allocator; //!< storage of the parents of the enodes
 
         fingerprint_set             m_fingerprints;
 
@@ -1023,6 +1026,15 @@ namespace smt {
 
         enode * get_enode_eq_to(func_decl * f, unsigned num_args, enode * const * args);
 
+        /**
+           \brief As get_enode_eq_to, but the application is built in tmp and the
+           congruence table is not updated. Threads with their own tmp can call it
+           concurrently while the e-graph does not change.
+        */
+        enode * get_enode_eq_to(tmp_enode & tmp, func_decl * f, unsigned num_args, enode * const * args) const {
+            return m_cg_table.find_existing(tmp.set(f, num_args, args));
+        }
+
     protected:
         bool decide();
 
@@ -1487,6 +1499,13 @@ namespace smt {
 
         lbool preferred_sat(expr_ref_vector const& asms, vector<expr_ref_vector>& cores);
 
+        /**
+           \brief Store in lits at most n literals for splitting the search space into cubes.
+           Their variables are unassigned at base level, and they are chosen by the case split
+           heuristic. The sign of a literal follows the cached phase of its variable.
+        */
+        void get_cube_literals(unsigned n, expr_ref_vector & lits);
+
         lbool setup_and_check(bool reset_cancel = true);
 
         // return 'true' if assertions are inconsistent.
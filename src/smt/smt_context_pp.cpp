@@ -390,6 +390,11 @@ namespace smt {
         st.update("minimized lits", m_stats.m_num_minimized_lits);
         st.update("num checks", m_stats.m_num_checks);
         st.update("mk bool var", m_stats.m_num_mk_bool_var);
+        if (m_stats.m_num_cubes > 0) {
+            st.update("cubes", m_stats.m_num_cubes);
+            st.update("pruned cubes", m_stats.m_num_pruned_cubes);
+            st.update("shared units", m_stats.m_num_shared_units);
+        }
 
 #if 0
         // missing?
@@ -404,6 +409,7 @@ namespace smt {
         st.update("frwrd subs res", m_stats.m_num_fsr);
 #endif
         m_qmanager->collect_statistics(st);
+        m_dyn_ack_manager.collect_statistics(st);
         m_asserted_formulas.collect_statistics(st);
         ptr_vector<theory>::const_iterator it  = m_theory_set.begin();
         ptr_vector<theory>::const_iterator end = m_theory_set.end();
@@ -24,7 +24,7 @@ namespace smt {
     /**
        \brief Initialize an enode in the given memory position.
     */
-    enode * enode::init(ast_manager & m, void * mem, app2enode_t const & app2enode, app * owner, 
+    enode * enode::init(ast_manager & m, void * mem, small_object_allocator * parents_alloc, app2enode_t const & app2enode, app * owner, 
                         unsigned generation, bool suppress_args, bool merge_tf, unsigned iscope_lvl,
                         bool cgc_enabled, bool update_children_parent) {
         SASSERT(m.is_bool(owner) || !merge_tf);
@@ -53,29 +53,50 @@ namespace smt {
             n->m_args[i] = arg;
             SASSERT(n->get_arg(i) == arg);
             if (update_children_parent)
-                arg->get_root()->m_parents.push_back(n);
+                arg->get_root()->m_parents.push_back(*parents_alloc, n);
         }
         TRACE("mk_enode_detail", tout << "new enode suppress_args: " << n->m_suppress_args << "\n";);
         SASSERT(n->m_suppress_args == suppress_args);
         return n;
     }
 
-    enode * enode::mk(ast_manager & m, region & r, app2enode_t const & app2enode, app * owner, 
+    enode * enode::mk(ast_manager & m, region & r, small_object_allocator & parents_alloc, app2enode_t const & app2enode, app * owner, 
                            unsigned generation, bool suppress_args, bool merge_tf, unsigned iscope_lvl,
                            bool cgc_enabled, bool update_children_parent) {
         SASSERT(m.is_bool(owner) || !merge_tf);
         unsigned sz           = get_enode_size(suppress_args ? 0 : owner->get_num_args());
         void * mem            = r.allocate(sz);
-        return init(m, mem, app2enode, owner, generation, suppress_args, merge_tf, iscope_lvl, cgc_enabled, update_children_parent);
+        return init(m, mem, &parents_alloc, app2enode, owner, generation, suppress_args, merge_tf, iscope_lvl, cgc_enabled, update_children_parent);
+    }
+
+    void enode_parents::expand(small_object_allocator & a) {
+        unsigned old_capacity = capacity();
+        unsigned new_capacity = old_capacity == 0 ? 2 : (3 * old_capacity + 1) >> 1;
+        unsigned * mem        = static_cast<unsigned*>(a.allocate(sizeof(unsigned) * 2 + sizeof(enode*) * new_capacity));
+        mem[0]                = new_capacity;
+        mem[1]                = size();
+        enode ** new_data     = reinterpret_cast<enode**>(mem + 2);
+        if (m_data) {
+            memcpy(new_data, m_data, sizeof(enode*) * size());
+            finalize(a);
+        }
+        m_data = new_data;
+    }
+
+    void enode_parents::finalize(small_object_allocator & a) {
+        if (m_data) {
+            a.deallocate(sizeof(unsigned) * 2 + sizeof(enode*) * capacity(), header());
+            m_data = 0;
+        }
     }
 
     enode * enode::mk_dummy(ast_manager & m, app2enode_t const & app2enode, app * owner) {
         unsigned sz           = get_enode_size(owner->get_num_args());
         void * mem            = alloc_svect(char, sz);
-        return init(m, mem, app2enode, owner, 0, false, false, 0, true, false);
+        return init(m, mem, 0, app2enode, owner, 0, false, false, 0, true, false);
     }
 
-    void enode::del_eh(ast_manager & m, bool update_children_parent) {
+    void enode::del_eh(ast_manager & m, small_object_allocator & parents_alloc, bool update_children_parent) {
         SASSERT(m_class_size == 1);
         SASSERT(m_root == this);
         SASSERT(m_next == this);
@@ -87,6 +108,7 @@ namespace smt {
                 arg->get_root()->m_parents.pop_back();
             }
         }
+        m_parents.finalize(parents_alloc);
         this->~enode();
     }
     
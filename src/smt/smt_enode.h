@@ -24,6 +24,7 @@ Revision History:
 #include "smt/smt_eq_justification.h"
 #include "smt/smt_theory_var_list.h"
 #include "util/approx_set.h"
+#include "util/small_object_allocator.h"
 
 namespace smt {
     /**
@@ -63,18 +64,75 @@ namespace smt {
 
     class tmp_enode;
 
+    /**
+       \brief Vector of the parents of an enode.
+
+       As in ptr_vector, the capacity and size are stored in front of the
+       elements, and an empty vector is a null pointer. The storage comes
+       from a small_object_allocator owned by the context, so the short
+       vectors of most enodes are carved from shared pages and recycled
+       through its free lists.
+    */
+    class enode_parents {
+        enode ** m_data;
+
+        unsigned * header() const { return reinterpret_cast<unsigned*>(m_data) - 2; }
+
+        void expand(small_object_allocator & a);
+
+    public:
+        typedef enode ** iterator;
+        typedef enode * const * const_iterator;
+
+        enode_parents():m_data(0) {}
+
+        unsigned size() const { return m_data ? header()[1] : 0; }
+
+        unsigned capacity() const { return m_data ? header()[0] : 0; }
+
+        bool empty() const { return size() == 0; }
+
+        enode * operator[](unsigned idx) const { SASSERT(idx < size()); return m_data[idx]; }
+
+        enode * back() const { SASSERT(!empty()); return m_data[size() - 1]; }
+
+        void push_back(small_object_allocator & a, enode * n) {
+            if (size() == capacity())
+                expand(a);
+            m_data[header()[1]++] = n;
+        }
+
+        void pop_back() { SASSERT(!empty()); header()[1]--; }
+
+        void shrink(unsigned s) {
+            SASSERT(s <= size());
+            if (m_data)
+                header()[1] = s;
+        }
+
+        void finalize(small_object_allocator & a);
+
+        iterator begin() { return m_data; }
+
+        iterator end() { return m_data + size(); }
+
+        const_iterator begin() const { return m_data; }
+
+        const_iterator end() const { return m_data + size(); }
+    };
+
     /**
        \brief Aditional data-structure for implementing congruence closure,
        equality propagation, and the theory central bus of equalities.
     */
     class enode {
+        // The fields used by union-find and congruence checks come first,
+        // so that they share the first cache line of the enode.
         app  *              m_owner;    //!< The application that 'owns' this enode.
         enode *             m_root;     //!< Representative of the equivalence class
         enode *             m_next;     //!< Next element in the equivalence class.
         enode *             m_cg;       
         unsigned            m_class_size;    //!< Size of the equivalence class if the enode is the root.
-        unsigned            m_generation; //!< Tracks how many quantifier instantiation rounds were needed to generate this enode.
-
         unsigned            m_func_decl_id; //!< Id generated by the congruence table for fast indexing.
 
         unsigned            m_mark:1;        //!< Multi-purpose auxiliary mark. 
@@ -86,7 +144,7 @@ namespace smt {
         unsigned            m_bool:1;           //!< True if it is a boolean enode
         unsigned            m_merge_tf:1;       //!< True if the enode should be merged with true/false when the associated boolean variable is assigned.
         unsigned            m_cgc_enabled:1;    //!< True if congruence closure is enabled for this enode.
-        unsigned            m_iscope_lvl;       //!< When the enode was internalized
+        signed char         m_lbl_hash;         //!< It is different from -1, if enode is used in a pattern
         /*
           The following property is valid for m_parents
           
@@ -102,10 +160,11 @@ namespace smt {
           elements of an equivalence class. So, if there is a f(a) that is relevant,
           then the congruent f(b) in m_parents will also be relevant. 
         */
-        enode_vector        m_parents;          //!< Parent enodes of the equivalence class.
+        enode_parents       m_parents;          //!< Parent enodes of the equivalence class.
+        unsigned            m_generation; //!< Tracks how many quantifier instantiation rounds were needed to generate this enode.
+        unsigned            m_iscope_lvl;       //!< When the enode was internalized
         theory_var_list     m_th_var_list;      //!< List of theories that 'care' about this enode.
         trans_justification m_trans;            //!< A justification for the enode being equal to its root.
-        signed char         m_lbl_hash;         //!< It is different from -1, if enode is used in a pattern
         approx_set          m_lbls;
         approx_set          m_plbls;
         enode *             m_args[0];          //!< Cached args
@@ -139,7 +198,7 @@ namespace smt {
 
         friend class tmp_enode;
 
-        static enode * init(ast_manager & m, void * mem, app2enode_t const & app2enode, app * owner, 
+        static enode * init(ast_manager & m, void * mem, small_object_allocator * parents_alloc, app2enode_t const & app2enode, app * owner, 
                             unsigned generation, bool suppress_args, bool merge_tf, unsigned iscope_lvl,
                             bool cgc_enabled, bool update_children_parent);
     public:
@@ -148,7 +207,10 @@ namespace smt {
             return sizeof(enode) + num_args * sizeof(enode*);
         }
         
-        static enode * mk(ast_manager & m, region & r, app2enode_t const & app2enode, app * owner, 
+        /**
+           \brief Create an enode in r. The parent vectors of the enodes are allocated with parents_alloc.
+        */
+        static enode * mk(ast_manager & m, region & r, small_object_allocator & parents_alloc, app2enode_t const & app2enode, app * owner, 
                           unsigned generation, bool suppress_args, bool merge_tf, unsigned iscope_lvl,
                           bool cgc_enabled, bool update_children_parent);
 
@@ -172,7 +234,7 @@ namespace smt {
         }
 
 
-        void del_eh(ast_manager & m, bool update_children_parent = true);
+        void del_eh(ast_manager & m, small_object_allocator & parents_alloc, bool update_children_parent = true);
         
         app * get_owner() const { 
             return m_owner; 
@@ -289,19 +351,19 @@ namespace smt {
             return m_parents.size();
         }
 
-        enode_vector::iterator begin_parents() { 
+        enode_parents::iterator begin_parents() { 
             return m_parents.begin(); 
         }
 
-        enode_vector::iterator end_parents() { 
+        enode_parents::iterator end_parents() { 
             return m_parents.end(); 
         }
 
-        enode_vector::const_iterator begin_parents() const { 
+        enode_parents::const_iterator begin_parents() const { 
             return m_parents.begin(); 
         }
         
-        enode_vector::const_iterator end_parents() const { 
+        enode_parents::const_iterator end_parents() const { 
             return m_parents.end(); 
         }
         
@@ -894,7 +894,7 @@ namespace smt {
             CTRACE("cached_generation", generation != m_generation,
                    tout << "cached_generation: #" << n->get_id() << " " << generation << " " << m_generation << "\n";);
         }
-        enode * e           = enode::mk(m_manager, m_region, m_app2enode, n, generation, suppress_args, merge_tf, m_scope_lvl, cgc_enabled, true);
+        enode * e           = enode::mk(m_manager, m_region, m_parents_allocator, m_app2enode, n, generation, suppress_args, merge_tf, m_scope_lvl, cgc_enabled, true);
         TRACE("mk_enode_detail", tout << "e.get_num_args() = " << e->get_num_args() << "\n";);
         if (n->get_num_args() == 0 && m_manager.is_unique_value(n))
             e->mark_as_interpreted();
@@ -968,7 +968,7 @@ namespace smt {
             SASSERT(m_decl2enodes[decl_id].back() == e);
             m_decl2enodes[decl_id].pop_back();
         }
-        e->del_eh(m_manager);
+        e->del_eh(m_manager, m_parents_allocator);
         SASSERT(m_e_internalized_stack.size() == m_enodes.size());
         m_enodes.pop_back();
         m_e_internalized_stack.pop_back();
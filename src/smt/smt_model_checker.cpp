@@ -27,9 +27,56 @@ Revision History:
 #include "ast/ast_ll_pp.h"
 #include "model/model_pp.h"
 #include "ast/ast_smt2_pp.h"
+#include "ast/ast_util.h"
+#include "ast/ast_translation.h"
+#include "util/z3_omp.h"
 
 namespace smt {
 
+    /**
+       \brief A copy of the auxiliary context, with its own manager, used by one thread
+       to check the quantifiers of an MBQI round.
+    */
+    struct model_checker::worker {
+        ast_manager     m;
+        smt_params      m_params;
+        context         m_ctx;
+        expr_ref_vector m_fmls;    // formulas of the quantifiers assigned to the worker
+        unsigned_vector m_lim;     // the formulas of the k-th quantifier end at m_lim[k]
+        svector<lbool>  m_results;
+
+        worker(context & src, smt_params const & p):
+            m(src.get_manager(), true),
+            m_params(p),
+            m_ctx(m, m_params),
+            m_fmls(m) {
+            m_params.m_mbqi_threads = 1;
+            context::copy(src, m_ctx);
+        }
+
+        void reset() {
+            m_fmls.reset();
+            m_lim.reset();
+            m_results.reset();
+        }
+
+        void check() {
+            m_results.resize(m_lim.size(), l_undef);
+            unsigned start = 0;
+            for (unsigned k = 0; k < m_lim.size(); ++k) {
+                m_ctx.push();
+                for (unsigned i = start; i < m_lim[k]; ++i) {
+                    m_ctx.assert_expr(m_fmls.get(i));
+                }
+                m_results[k] = m_ctx.check();
+                m_ctx.pop(1);
+                start = m_lim[k];
+                if (m_results[k] == l_undef && m.canceled())
+                    return;
+            }
+        }
+    };
+
     model_checker::model_checker(ast_manager & m, qi_params const & p, model_finder & mf):
         m(m),
         m_params(p),
@@ -44,10 +91,39 @@ namespace smt {
     }
 
     model_checker::~model_checker() {
+        reset_satisfied();
+        for (worker * w : m_workers) {
+            dealloc(w);
+        }
         m_aux_context = 0; // delete aux context before fparams
         m_fparams = 0;
     }
 
+    void model_checker::reset_satisfied() {
+        obj_map<quantifier, expr *>::iterator it  = m_satisfied.begin();
+        obj_map<quantifier, expr *>::iterator end = m_satisfied.end();
+        for (; it != end; ++it) {
+            m.dec_ref(it->m_key);
+            m.dec_ref(it->m_value);
+        }
+        m_satisfied.reset();
+    }
+
+    void model_checker::set_satisfied(quantifier * q, expr * neg_q_m) {
+        obj_map<quantifier, expr *>::obj_map_entry * e = m_satisfied.insert_if_not_there2(q, 0);
+        m.inc_ref(neg_q_m);
+        if (e->get_data().m_value == 0)
+            m.inc_ref(q);
+        else
+            m.dec_ref(e->get_data().m_value);
+        e->get_data().m_value = neg_q_m;
+    }
+
+    bool model_checker::is_satisfied(quantifier * q, expr * neg_q_m) const {
+        expr * r = 0;
+        return m_satisfied.find(q, r) && r == neg_q_m;
+    }
+
     quantifier * model_checker::get_flat_quantifier(quantifier * q) {
         return m_model_finder.get_flat_quantifier(q);
     }
@@ -80,60 +156,78 @@ namespace smt {
     }
 
     /**
-       \brief Assert in m_aux_context, the constraint
+       \brief Store in r the constraint
 
-         sk = e_1 OR ... OR sk = e_n
+         t = e_1 OR ... OR t = e_n
 
          where {e_1, ..., e_n} is the universe.
      */
-    void model_checker::restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe) {
+    void model_checker::mk_universe_constraint(expr * t, obj_hashtable<expr> const & universe, expr_ref & r) {
         SASSERT(!universe.empty());
         ptr_buffer<expr> eqs;
         obj_hashtable<expr>::iterator it  = universe.begin();
         obj_hashtable<expr>::iterator end = universe.end();
         for (; it != end; ++it) {
             expr * e = *it;
-            eqs.push_back(m.mk_eq(sk, e));
+            eqs.push_back(m.mk_eq(t, e));
         }
-        expr_ref fml(m.mk_or(eqs.size(), eqs.c_ptr()), m);
-        m_aux_context->assert_expr(fml);
+        r = m.mk_or(eqs.size(), eqs.c_ptr());
     }
 
 #define PP_DEPTH 8
 
     /**
-       \brief Assert the negation of q after applying the interpretation in m_curr_model to the uninterpreted symbols in q.
+       \brief Store in fmls the negation of q after applying the interpretation in m_curr_model to the uninterpreted symbols in q,
+       preceded by the restriction of the variables of finite sorts to their universe.
+       The formulas contain the variables of q. Return false if q could not be evaluated.
 
-       The variables are replaced by skolem constants. These constants are stored in sks.
+       Since the formulas are hash-consed, they are the same in two rounds if the interpretations
+       used by q did not change.
     */
-
-    void model_checker::assert_neg_q_m(quantifier * q, expr_ref_vector & sks) {
+    bool model_checker::mk_neg_q_m(quantifier * q, expr_ref_vector & fmls) {
         expr_ref tmp(m);
         if (!m_curr_model->eval(q->get_expr(), tmp, true)) {
-            return;
+            return false;
         }
         TRACE("model_checker", tout << "q after applying interpretation:\n" << mk_ismt2_pp(tmp, m) << "\n";);        
-        ptr_buffer<expr> subst_args;
         unsigned num_decls = q->get_num_decls();
-        subst_args.resize(num_decls, 0);
-        sks.resize(num_decls, 0);
         for (unsigned i = 0; i < num_decls; i++) {
+            // (VAR i) is bound by the declaration num_decls - i - 1.
             sort * s  = q->get_decl_sort(num_decls - i - 1);
-            expr * sk = m.mk_fresh_const(0, s);
-            sks[num_decls - i - 1]        = sk;
-            subst_args[num_decls - i - 1] = sk;
             if (m_curr_model->is_finite(s)) {
-                restrict_to_universe(sk, m_curr_model->get_known_universe(s));
+                expr_ref r(m);
+                mk_universe_constraint(m.mk_var(i, s), m_curr_model->get_known_universe(s), r);
+                fmls.push_back(r);
             }
         }
+        fmls.push_back(m.mk_not(tmp));
+        return true;
+    }
+
+    /**
+       \brief Create the skolem constants that replace the variables of q.
+    */
+    void model_checker::mk_sks(quantifier * q, expr_ref_vector & sks) {
+        unsigned num_decls = q->get_num_decls();
+        sks.resize(num_decls, 0);
+        for (unsigned i = 0; i < num_decls; i++) {
+            sort * s  = q->get_decl_sort(num_decls - i - 1);
+            sks[num_decls - i - 1] = m.mk_fresh_const(0, s);
+        }
+    }
 
-        expr_ref sk_body(m);
+    /**
+       \brief Assert in m_aux_context the formulas produced by mk_neg_q_m, where the variables are replaced by skolem constants.
+       These constants are stored in sks.
+    */
+    void model_checker::assert_neg_q_m(expr_ref_vector const & fmls, expr_ref_vector & sks) {
         var_subst s(m);
-        s(tmp, subst_args.size(), subst_args.c_ptr(), sk_body);
         expr_ref r(m);
-        r = m.mk_not(sk_body);
-        TRACE("model_checker", tout << "mk_neg_q_m:\n" << mk_ismt2_pp(r, m) << "\n";);
-        m_aux_context->assert_expr(r);
+        for (unsigned i = 0; i < fmls.size(); i++) {
+            s(fmls[i], sks.size(), sks.c_ptr(), r);
+            TRACE("model_checker", tout << "mk_neg_q_m:\n" << mk_ismt2_pp(r, m) << "\n";);
+            m_aux_context->assert_expr(r);
+        }
     }
 
     bool model_checker::add_instance(quantifier * q, model * cex, expr_ref_vector & sks, bool use_inv) {
@@ -259,14 +353,24 @@ namespace smt {
     */
     bool model_checker::check(quantifier * q) {
         SASSERT(!m_aux_context->relevancy());
-        m_aux_context->push();
-        
         quantifier * flat_q = get_flat_quantifier(q);
         TRACE("model_checker", tout << "model checking:\n" << mk_ismt2_pp(q->get_expr(), m) << "\n" << 
               mk_ismt2_pp(flat_q->get_expr(), m) << "\n";);
-        expr_ref_vector sks(m);
-
-        assert_neg_q_m(flat_q, sks);
+        expr_ref_vector fmls(m), sks(m);
+        expr_ref neg_q_m(m);
+        if (mk_neg_q_m(flat_q, fmls)) {
+            neg_q_m = mk_and(fmls);
+            if (is_satisfied(q, neg_q_m)) {
+                TRACE("model_checker", tout << "satisfied in a previous round\n";);
+                if (!m_checked_by_workers.contains(q))
+                    m_stats.m_num_cached_checks++;
+                return true;
+            }
+            mk_sks(flat_q, sks);
+        }
+        m_stats.m_num_checks++;
+        m_aux_context->push();
+        assert_neg_q_m(fmls, sks);
         TRACE("model_checker", tout << "skolems:\n"; 
               for (unsigned i = 0; i < sks.size(); i++) {
                   expr * sk = sks.get(i);
@@ -277,6 +381,8 @@ namespace smt {
         TRACE("model_checker", tout << "[complete] model-checker result: " << to_sat_str(r) << "\n";);
         if (r != l_true) {
             m_aux_context->pop(1);
+            if (r == l_false && neg_q_m)
+                set_satisfied(q, neg_q_m);
             return r == l_false; // quantifier is satisfied by m_curr_model
         }
         
@@ -363,6 +469,100 @@ namespace smt {
         }
     }
 
+    void model_checker::init_workers() {
+        if (m_workers.size() >= m_params.m_mbqi_threads)
+            return;
+        symbol logic;
+        scoped_ptr<context> src = m_context->mk_fresh(&logic, m_fparams.get());
+        while (m_workers.size() < m_params.m_mbqi_threads) {
+            m_workers.push_back(alloc(worker, *src, *m_fparams));
+        }
+    }
+
+    /**
+       \brief Check the quantifiers qs in parallel, and record the ones that are satisfied by m_curr_model.
+       The other quantifiers are checked again by check(q), which creates their instances in the main thread.
+    */
+    void model_checker::check_parallel(ptr_vector<quantifier> const & qs) {
+        init_workers();
+        m_checked_by_workers.reset();
+        unsigned num_workers = m_params.m_mbqi_threads;
+        for (unsigned i = 0; i < num_workers; ++i) {
+            m_workers[i]->reset();
+        }
+        // the quantifier jobs[j] is checked by the worker j % num_workers,
+        // its formulas are stored in [lims[j], lims[j+1]) of job_fmls.
+        ptr_vector<quantifier> jobs;
+        expr_ref_vector neg_q_ms(m), job_fmls(m), fmls(m), sks(m);
+        unsigned_vector lims;
+        expr_ref r(m);
+        var_subst subst(m);
+        lims.push_back(0);
+        for (unsigned i = 0; i < qs.size(); ++i) {
+            quantifier * q      = qs[i];
+            quantifier * flat_q = get_flat_quantifier(q);
+            fmls.reset();
+            if (!mk_neg_q_m(flat_q, fmls))
+                continue;
+            expr_ref neg_q_m = mk_and(fmls);
+            if (is_satisfied(q, neg_q_m))
+                continue;
+            sks.reset();
+            mk_sks(flat_q, sks);
+            for (unsigned k = 0; k < fmls.size(); ++k) {
+                subst(fmls.get(k), sks.size(), sks.c_ptr(), r);
+                job_fmls.push_back(r);
+            }
+            lims.push_back(job_fmls.size());
+            jobs.push_back(q);
+            neg_q_ms.push_back(neg_q_m);
+        }
+        if (jobs.size() < 2) {
+            // not worth the threads, the quantifier is checked by check(q).
+            return;
+        }
+        for (unsigned j = 0; j < jobs.size(); ++j) {
+            worker & w = *m_workers[j % num_workers];
+            ast_translation tr(m, w.m);
+            for (unsigned k = lims[j]; k < lims[j + 1]; ++k) {
+                w.m_fmls.push_back(tr(job_fmls.get(k)));
+            }
+            w.m_lim.push_back(w.m_fmls.size());
+        }
+        IF_VERBOSE(10, verbose_stream() << "(smt.mbqi :parallel " << jobs.size() << ")\n";);
+        {
+            scoped_limits scl(m.limit());
+            for (unsigned i = 0; i < num_workers; ++i) {
+                // a worker may have been canceled in a previous round.
+                m_workers[i]->m.limit().reset_cancel();
+                scl.push_child(&m_workers[i]->m.limit());
+            }
+            int n = static_cast<int>(num_workers);
+            #pragma omp parallel for
+            for (int i = 0; i < n; ++i) {
+                worker & w = *m_workers[i];
+                try {
+                    w.check();
+                }
+                catch (z3_exception &) {
+                    // the remaining quantifiers of w are checked by check(q).
+                }
+            }
+        }
+        for (unsigned j = 0; j < jobs.size(); ++j) {
+            worker & w = *m_workers[j % num_workers];
+            unsigned k = j / num_workers;
+            m_stats.m_num_parallel_checks++;
+            if (k < w.m_results.size() && w.m_results[k] == l_false) {
+                set_satisfied(jobs[j], neg_q_ms.get(j));
+                m_checked_by_workers.insert(jobs[j]);
+            }
+        }
+        for (unsigned i = 0; i < num_workers; ++i) {
+            m_workers[i]->reset();
+        }
+    }
+
     bool model_checker::check(proto_model * md, obj_map<enode, app *> const & root2value) {
         SASSERT(md != 0);
 
@@ -371,6 +571,11 @@ namespace smt {
         if (m_qm->num_quantifiers() == 0)
             return true;
 
+        // the quantifiers of popped scopes are no longer checked.
+        if (!m_params.m_mbqi_incremental || m_satisfied.size() > m_qm->num_quantifiers())
+            reset_satisfied();
+        m_checked_by_workers.reset();
+
         if (m_iteration_idx >= m_params.m_mbqi_max_iterations) {
             IF_VERBOSE(1, verbose_stream() << "(smt.mbqi \"max instantiations " << m_iteration_idx << " reached\")\n";);
             m_context->set_reason_unknown("max mbqi instantiations reached");
@@ -423,6 +628,20 @@ namespace smt {
     void model_checker::check_quantifiers(bool strict_rec_fun, bool& found_relevant, unsigned& num_failures) {
         ptr_vector<quantifier>::const_iterator it  = m_qm->begin_quantifiers();
         ptr_vector<quantifier>::const_iterator end = m_qm->end_quantifiers();
+#ifndef _NO_OMP_
+        if (m_params.m_mbqi_threads > 1 && !omp_in_parallel()) {
+            ptr_vector<quantifier> qs;
+            for (; it != end; ++it) {
+                quantifier * q = *it;
+                if (m_qm->mbqi_enabled(q) && !m.is_rec_fun_def(q) && 
+                    m_context->is_relevant(q) && m_context->get_assignment(q) == l_true)
+                    qs.push_back(q);
+            }
+            if (qs.size() > 1)
+                check_parallel(qs);
+            it = m_qm->begin_quantifiers();
+        }
+#endif
         for (; it != end; ++it) {
             quantifier * q = *it;
         if(!m_qm->mbqi_enabled(q)) continue;
@@ -477,6 +696,13 @@ namespace smt {
         reset_new_instances();
     }
 
+    void model_checker::collect_statistics(::statistics & st) const {
+        st.update("mbqi checks", m_stats.m_num_checks);
+        st.update("mbqi cached checks", m_stats.m_num_cached_checks);
+        if (m_params.m_mbqi_threads > 1)
+            st.update("mbqi parallel checks", m_stats.m_num_parallel_checks);
+    }
+
     void model_checker::assert_new_instances() {
         TRACE("model_checker_bug_detail", tout << "assert_new_instances, inconsistent: " << m_context->inconsistent() << "\n";);
         ptr_buffer<enode> bindings;
@@ -26,6 +26,7 @@ Revision History:
 #include "smt/params/qi_params.h"
 #include "smt/params/smt_params.h"
 #include "util/region.h"
+#include "util/statistics.h"
 
 class proto_model;
 class model;
@@ -53,14 +54,39 @@ namespace smt {
         obj_map<expr, expr *>                       m_value2expr;
         friend class instantiation_set;
 
+        struct stats {
+            unsigned m_num_checks;          // quantifiers checked in the auxiliary context
+            unsigned m_num_cached_checks;   // quantifiers satisfied by the same negation in a previous round
+            unsigned m_num_parallel_checks; // quantifiers checked by the workers
+            void reset() { memset(this, 0, sizeof(*this)); }
+            stats() { reset(); }
+        };
+        stats                                       m_stats;
+
+        // m_satisfied[q] is the negation of q, after applying the interpretation of a previous model,
+        // that was found unsatisfiable. The quantifier is not checked again while the negation is unchanged.
+        obj_map<quantifier, expr *>                 m_satisfied;
+
+        // copies of the auxiliary context used to check quantifiers in parallel (mbqi.threads).
+        struct worker;
+        ptr_vector<worker>                          m_workers;
+        obj_hashtable<quantifier>                   m_checked_by_workers; // quantifiers found satisfied by the workers in this round
+
         void init_aux_context();
+        void init_workers();
+        void reset_satisfied();
+        void set_satisfied(quantifier * q, expr * neg_q_m);
+        bool is_satisfied(quantifier * q, expr * neg_q_m) const;
         expr * get_term_from_ctx(expr * val);
-        void restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe);
-        void assert_neg_q_m(quantifier * q, expr_ref_vector & sks);
+        void mk_universe_constraint(expr * t, obj_hashtable<expr> const & universe, expr_ref & r);
+        bool mk_neg_q_m(quantifier * q, expr_ref_vector & fmls);
+        void mk_sks(quantifier * q, expr_ref_vector & sks);
+        void assert_neg_q_m(expr_ref_vector const & fmls, expr_ref_vector & sks);
         bool add_blocking_clause(model * cex, expr_ref_vector & sks);
         bool check(quantifier * q);
         bool check_rec_fun(quantifier* q, bool strict_rec_fun);
         void check_quantifiers(bool strict_rec_fun, bool& found_relevant, unsigned& num_failures);
+        void check_parallel(ptr_vector<quantifier> const & qs);
 
         struct instance {
             quantifier * m_q;
@@ -100,6 +126,8 @@ namespace smt {
 
         void reset();
 
+        void collect_statistics(::statistics & st) const;
+
         void operator()(expr* e);
 
     };
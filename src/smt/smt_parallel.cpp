@@ -0,0 +1,372 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    smt_parallel.cpp
+
+Abstract:
+
+    Cube and conquer for smt::context.
+
+Author:
+
+    agent (agent@local) 2026-10-16.
+
+Revision History:
+
+--*/
+#include "smt/smt_parallel.h"
+#include "ast/ast_translation.h"
+#include "model/model.h"
+#include "util/z3_omp.h"
+
+namespace smt {
+
+    /**
+       \brief A copy of the context, with its own manager, solved by one thread.
+    */
+    struct parallel::worker {
+        unsigned        m_id;
+        ast_manager     m;
+        smt_params      m_params;
+        context         m_ctx;
+        expr_ref_vector m_pos;          // m_pos[j] is a proxy for the cube literal l_j
+        expr_ref_vector m_neg;          // m_neg[j] is a proxy for ~l_j
+        unsigned        m_num_vars;     // units over the variables of the copy are shared
+        unsigned        m_units_head;   // number of shared units imported
+        unsigned        m_exported_lim; // number of base level assignments exported
+
+        worker(unsigned id, context & src, expr_ref_vector const & lits):
+            m_id(id),
+            m(src.get_manager(), true),
+            m_params(src.get_fparams()),
+            m_ctx(m, m_params, src.get_params()),
+            m_pos(m),
+            m_neg(m),
+            m_units_head(0),
+            m_exported_lim(0) {
+            m_params.m_threads = 1;
+            m_params.m_random_seed += id;
+            context::copy(src, m_ctx);
+            m_num_vars = m_ctx.get_num_bool_vars();
+            // cube literals are not necessarily valid assumptions.
+            ast_translation tr(src.get_manager(), m);
+            for (unsigned j = 0; j < lits.size(); ++j) {
+                expr_ref l(tr(lits.get(j)), m);
+                expr_ref p(m.mk_fresh_const("cube", m.mk_bool_sort()), m);
+                expr_ref n(m.mk_fresh_const("cube", m.mk_bool_sort()), m);
+                m_ctx.assert_expr(m.mk_implies(p, l));
+                m_ctx.assert_expr(m.mk_implies(n, m.mk_not(l)));
+                m_pos.push_back(p);
+                m_neg.push_back(n);
+            }
+        }
+    };
+
+    parallel::parallel(context & ctx):
+        m_context(ctx),
+        m(ctx.get_manager()),
+        m_lits(m),
+        m_num_cubes(0),
+        m_next_cube(0),
+        m_units(m),
+        m_done(false),
+        m_result(l_undef),
+        m_winner(UINT_MAX),
+        m_ex_kind(NO_EX),
+        m_error_code(0) {
+    }
+
+    parallel::~parallel() {
+        for (worker * w : m_workers) {
+            dealloc(w);
+        }
+    }
+
+    unsigned parallel::cube_depth() const {
+        unsigned depth = m_context.get_fparams().m_threads_cube_depth;
+        if (depth == 0) {
+            while ((1u << depth) < 4 * m_context.get_fparams().m_threads)
+                ++depth;
+        }
+        return std::min(depth, 20u);
+    }
+
+    bool parallel::is_refuted(unsigned c) const {
+        for (sub_cube const & s : m_refuted) {
+            if (((c ^ s.second) & s.first) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+       \brief Return the next cube that is not refuted, or UINT_MAX if there is none.
+       Must be called in the critical section.
+    */
+    unsigned parallel::next_cube() {
+        while (!m_done && m_next_cube < m_num_cubes) {
+            unsigned c = m_next_cube++;
+            if (!is_refuted(c))
+                return c;
+            m_context.m_stats.m_num_pruned_cubes++;
+        }
+        return UINT_MAX;
+    }
+
+    /**
+       \brief Translate the units found by other workers since the last import.
+       Must be called in the critical section.
+    */
+    void parallel::import_units(worker & w, expr_ref_vector & units) {
+        ast_translation tr(m, w.m);
+        for (; w.m_units_head < m_units.size(); ++w.m_units_head) {
+            units.push_back(tr(m_units.get(w.m_units_head)));
+        }
+    }
+
+    /**
+       \brief Publish the literals assigned at base level by w since the last export.
+       Must be called in the critical section.
+    */
+    void parallel::export_units(worker & w) {
+        context & ctx = w.m_ctx;
+        // number of literals assigned at base level
+        unsigned lim = ctx.m_scope_lvl > ctx.m_base_lvl ? ctx.m_scopes[ctx.m_base_lvl].m_assigned_literals_lim : ctx.m_assigned_literals.size();
+        ast_translation tr(w.m, m);
+        expr_ref e(w.m), u(m);
+        for (unsigned i = w.m_exported_lim; i < lim; ++i) {
+            literal l = ctx.m_assigned_literals[i];
+            if (l.var() == true_bool_var || static_cast<unsigned>(l.var()) >= w.m_num_vars)
+                continue;
+            ctx.literal2expr(l, e);
+            u = tr(e.get());
+            if (!m_unit_set.contains(u)) {
+                m_unit_set.insert(u);
+                m_units.push_back(u);
+                m_context.m_stats.m_num_shared_units++;
+            }
+        }
+        w.m_exported_lim = lim;
+    }
+
+    void parallel::cancel_others(worker & w) {
+        for (worker * w2 : m_workers) {
+            if (w2 != &w)
+                w2->m.limit().cancel();
+        }
+    }
+
+    /**
+       \brief record the first exception raised by a worker, it is rethrown when all workers are done.
+    */
+    void parallel::set_exception(worker & w, exception_kind k, unsigned error_code, char const * msg) {
+        bool first = false;
+        #pragma omp critical (smt_parallel)
+        {
+            if (!m_done) {
+                m_done       = true;
+                m_ex_kind    = k;
+                m_error_code = error_code;
+                m_ex_msg     = msg;
+                first        = true;
+            }
+        }
+        if (first) {
+            cancel_others(w);
+        }
+    }
+
+    void parallel::solve(worker & w) {
+        expr_ref_vector units(w.m), cube(w.m);
+        while (true) {
+            unsigned c;
+            units.reset();
+            #pragma omp critical (smt_parallel)
+            {
+                c = next_cube();
+                if (c != UINT_MAX)
+                    import_units(w, units);
+            }
+            if (c == UINT_MAX)
+                return;
+            for (unsigned i = 0; i < units.size(); ++i) {
+                w.m_ctx.assert_expr(units.get(i));
+            }
+            cube.reset();
+            for (unsigned j = 0; j < w.m_pos.size(); ++j) {
+                cube.push_back((c & (1u << j)) ? w.m_neg.get(j) : w.m_pos.get(j));
+            }
+            lbool r = w.m_ctx.check(cube.size(), cube.c_ptr());
+            IF_VERBOSE(2, verbose_stream() << "(smt.parallel :worker " << w.m_id << " :cube " << c << " " << r << ")\n";);
+            if (r == l_undef && w.m.canceled())
+                return;
+            // the literals of the cube in the core.
+            unsigned support = 0, signs = 0;
+            if (r == l_false) {
+                for (unsigned i = 0; i < w.m_ctx.get_unsat_core_size(); ++i) {
+                    expr * e = w.m_ctx.get_unsat_core_expr(i);
+                    for (unsigned j = 0; j < w.m_pos.size(); ++j) {
+                        if (e == w.m_pos.get(j)) {
+                            support |= (1u << j);
+                        }
+                        else if (e == w.m_neg.get(j)) {
+                            support |= (1u << j);
+                            signs   |= (1u << j);
+                        }
+                    }
+                }
+            }
+            bool finished = false;
+            #pragma omp critical (smt_parallel)
+            {
+                if (!m_done) {
+                    switch (r) {
+                    case l_true:
+                        finished = true;
+                        break;
+                    case l_false:
+                        // a refutation that does not depend on the cube refutes the problem.
+                        finished = support == 0;
+                        m_refuted.push_back(sub_cube(support, signs));
+                        export_units(w);
+                        break;
+                    case l_undef:
+                        if (m_reason_unknown.empty())
+                            m_reason_unknown = w.m_ctx.last_failure_as_string();
+                        export_units(w);
+                        break;
+                    }
+                    if (finished) {
+                        m_done   = true;
+                        m_result = r;
+                        m_winner = w.m_id;
+                    }
+                }
+            }
+            if (finished) {
+                cancel_others(w);
+                return;
+            }
+        }
+    }
+
+    /**
+       \brief Transfer the result to m_context.
+    */
+    void parallel::set_result() {
+        context & ctx = m_context;
+        ctx.m_unknown = "";
+        ctx.m_last_search_failure = OK;
+        switch (m_result) {
+        case l_true: {
+            worker & w = *m_workers[m_winner];
+            model_ref mdl;
+            w.m_ctx.get_model(mdl);
+            if (mdl) {
+                for (unsigned j = 0; j < w.m_pos.size(); ++j) {
+                    mdl->unregister_decl(to_app(w.m_pos.get(j))->get_decl());
+                    mdl->unregister_decl(to_app(w.m_neg.get(j))->get_decl());
+                }
+                ast_translation tr(w.m, m);
+                ctx.m_model = mdl->translate(tr);
+            }
+            else {
+                ctx.m_model = 0;
+            }
+            break;
+        }
+        case l_false:
+            ctx.m_model = 0;
+            break;
+        case l_undef:
+            ctx.m_model = 0;
+            ctx.m_last_search_failure = UNKNOWN;
+            ctx.m_unknown = m_reason_unknown.empty() ? "canceled" : m_reason_unknown;
+            break;
+        }
+    }
+
+    bool parallel::use_sequential(unsigned num_assumptions) const {
+        smt_params const & fp = m_context.get_fparams();
+        if (fp.m_threads <= 1 || num_assumptions > 0 || m.proofs_enabled() || m_context.get_base_level() > 0)
+            return true;
+#ifdef _NO_OMP_
+        return true;
+#else
+        return 0 != omp_in_parallel();
+#endif
+    }
+
+    lbool parallel::operator()(unsigned num_assumptions, expr * const * assumptions) {
+        if (use_sequential(num_assumptions))
+            return m_context.check(num_assumptions, assumptions);
+        return check_core(false);
+    }
+
+    lbool parallel::setup_and_check() {
+        if (use_sequential(0))
+            return m_context.setup_and_check();
+        return check_core(true);
+    }
+
+    lbool parallel::check_core(bool setup) {
+        smt_params & fp = m_context.get_fparams();
+        // search sequentially until the case split heuristic is informed.
+        unsigned max_conflicts = fp.m_max_conflicts;
+        fp.m_max_conflicts = std::min(max_conflicts, fp.m_threads_max_conflicts);
+        lbool r = setup ? m_context.setup_and_check() : m_context.check();
+        fp.m_max_conflicts = max_conflicts;
+        if (r != l_undef || m_context.get_last_search_failure() != NUM_CONFLICTS || fp.m_threads_max_conflicts >= max_conflicts) {
+            return r;
+        }
+        m_context.get_cube_literals(cube_depth(), m_lits);
+        if (m_lits.empty()) {
+            return m_context.check();
+        }
+        m_num_cubes = 1u << m_lits.size();
+        m_context.m_stats.m_num_cubes += m_num_cubes;
+
+        scoped_limits scl(m.limit());
+        for (unsigned i = 0; i < fp.m_threads; ++i) {
+            worker * w = alloc(worker, i, m_context, m_lits);
+            m_workers.push_back(w);
+            scl.push_child(&w->m.limit());
+        }
+        IF_VERBOSE(1, verbose_stream() << "(smt.parallel :threads " << m_workers.size() << " :cubes " << m_num_cubes << ")\n";);
+
+        int num_workers = static_cast<int>(m_workers.size());
+        #pragma omp parallel for
+        for (int i = 0; i < num_workers; ++i) {
+            worker & w = *m_workers[i];
+            try {
+                solve(w);
+            }
+            catch (z3_error & err) {
+                set_exception(w, ERROR_EX, err.error_code(), "");
+            }
+            catch (z3_exception & ex) {
+                set_exception(w, DEFAULT_EX, 0, ex.msg());
+            }
+        }
+        switch (m_ex_kind) {
+        case ERROR_EX: throw z3_error(m_error_code);
+        case DEFAULT_EX: throw default_exception(m_ex_msg.c_str());
+        default: break;
+        }
+        if (!m_done && m.canceled()) {
+            m_reason_unknown = "canceled";
+        }
+        else if (!m_done && m_reason_unknown.empty()) {
+            // all cubes are refuted.
+            m_result = l_false;
+        }
+        set_result();
+        IF_VERBOSE(1, verbose_stream() << "(smt.parallel " << m_result
+                   << " :pruned " << m_context.m_stats.m_num_pruned_cubes
+                   << " :units " << m_units.size() << ")\n";);
+        return m_result;
+    }
+
+};
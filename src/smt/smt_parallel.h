@@ -0,0 +1,103 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    smt_parallel.h
+
+Abstract:
+
+    Cube and conquer for smt::context.
+
+    The context first searches sequentially with a small conflict budget.
+    If that does not settle the problem, the search space is split into
+    cubes over the literals that the case split heuristic ranks highest.
+    The cubes are solved as assumptions by copies of the context, one per
+    thread, each with its own ast_manager.
+
+    The threads share:
+    - the literals (units and equalities) they fix at base level, and
+    - the sub-cubes refuted by their unsat cores. No cube that contains
+      one of them is solved again.
+
+    The problem is unsatisfiable if all cubes are refuted, or if one
+    refutation does not depend on its cube.
+
+Author:
+
+    agent (agent@local) 2026-10-16.
+
+Revision History:
+
+--*/
+#ifndef SMT_PARALLEL_H_
+#define SMT_PARALLEL_H_
+
+#include "smt/smt_context.h"
+
+namespace smt {
+
+    class parallel {
+        struct worker;
+
+        // A cube over the cube literals l_0 ... l_{k-1} is a bit-mask c:
+        // it contains l_j if bit j of c is 0, and ~l_j otherwise.
+        // A refuted sub-cube is a pair (support, signs) of bit-masks.
+        typedef std::pair<unsigned, unsigned> sub_cube;
+
+        enum exception_kind {
+            NO_EX,
+            DEFAULT_EX,
+            ERROR_EX
+        };
+
+        context &               m_context;
+        ast_manager &           m;
+        expr_ref_vector         m_lits;        // cube literals
+        unsigned                m_num_cubes;
+        unsigned                m_next_cube;
+        svector<sub_cube>       m_refuted;
+        expr_ref_vector         m_units;       // units found by the workers
+        obj_hashtable<expr>     m_unit_set;
+        ptr_vector<worker>      m_workers;
+        bool                    m_done;
+        lbool                   m_result;
+        unsigned                m_winner;
+        std::string             m_reason_unknown;
+        exception_kind          m_ex_kind;     // kind of the first exception raised by a worker
+        unsigned                m_error_code;
+        std::string             m_ex_msg;
+
+        unsigned cube_depth() const;
+        bool is_refuted(unsigned c) const;
+        unsigned next_cube();
+        void import_units(worker & w, expr_ref_vector & units);
+        void export_units(worker & w);
+        void cancel_others(worker & w);
+        void set_exception(worker & w, exception_kind k, unsigned error_code, char const * msg);
+        void solve(worker & w);
+        void set_result();
+        bool use_sequential(unsigned num_assumptions) const;
+        lbool check_core(bool setup);
+
+    public:
+        parallel(context & ctx);
+
+        ~parallel();
+
+        /**
+           \brief Check satisfiability of the context using m_threads threads.
+           The context is checked sequentially if there is only one thread,
+           if there are assumptions, if proofs are enabled, or inside a user scope.
+        */
+        lbool operator()(unsigned num_assumptions, expr * const * assumptions);
+
+        /**
+           \brief Setup the context based on its assertions, and check it as operator().
+        */
+        lbool setup_and_check();
+    };
+
+};
+
+#endif
@@ -186,6 +186,10 @@ namespace smt {
             m_qi_queue.pop_scope(num_scopes);
         }
 
+        void user_pop_eh() {
+            m_qi_queue.reassert_instances();
+        }
+
         bool can_propagate() {
             return m_qi_queue.has_work() || m_plugin->can_propagate();
         }
@@ -314,6 +318,10 @@ namespace smt {
         m_imp->init_search_eh();
     }
 
+    void quantifier_manager::end_search_eh() {
+        m_imp->m_plugin->end_search_eh();
+    }
+
     void quantifier_manager::assign_eh(quantifier * q) {
         m_imp->assign_eh(q);
     }
@@ -366,6 +374,10 @@ namespace smt {
         m_imp->pop(num_scopes);
     }
 
+    void quantifier_manager::user_pop_eh() {
+        m_imp->user_pop_eh();
+    }
+
     void quantifier_manager::reset() {
         context & ctx        = m_imp->m_context;
         smt_params & p = m_imp->m_params;
@@ -380,6 +392,7 @@ namespace smt {
 
     void quantifier_manager::collect_statistics(::statistics & st) const {
         m_imp->m_qi_queue.collect_statistics(st);
+        m_imp->m_plugin->collect_statistics(st);
     }
 
     void quantifier_manager::reset_statistics() {
@@ -490,6 +503,19 @@ namespace smt {
             }
         }
 
+        virtual void end_search_eh() {
+            if (m_fparams->m_qi_profile_ematching) {
+                m_mam->flush_profile();
+                m_lazy_mam->flush_profile();
+            }
+        }
+
+        virtual void collect_statistics(::statistics & st) const {
+            m_mam->collect_statistics(st);
+            m_lazy_mam->collect_statistics(st);
+            m_model_checker->collect_statistics(st);
+        }
+
         virtual void assign_eh(quantifier * q) {
             m_active = true;
             if (!m_fparams->m_ematching) {
@@ -61,6 +61,7 @@ namespace smt {
         bool add_instance(quantifier * q, unsigned num_bindings, enode * const * bindings, unsigned generation = 0);
 
         void init_search_eh();
+        void end_search_eh();
         void assign_eh(quantifier * q);
         void add_eq_eh(enode * n1, enode * n2);
         void relevant_eh(enode * n);
@@ -81,6 +82,10 @@ namespace smt {
 
         void push();
         void pop(unsigned num_scopes);
+        /**
+           \brief Invoked after user scopes are popped. See qi.persistent_instances.
+        */
+        void user_pop_eh();
         void reset();
 
         void display(std::ostream & out) const;
@@ -125,6 +130,10 @@ namespace smt {
            \brief This method is invoked when a new search() is started.
         */
         virtual void init_search_eh() = 0;
+        /**
+           \brief This method is invoked when search() is finished.
+        */
+        virtual void end_search_eh() = 0;
         /**
            \brief Final_check event handler.
         */
@@ -167,6 +176,8 @@ namespace smt {
         virtual void push() = 0;
         virtual void pop(unsigned num_scopes) = 0;
 
+        virtual void collect_statistics(::statistics & st) const = 0;
+
 
 
     };
@@ -720,7 +720,12 @@ namespace smt {
     }
 
     void setup::setup_i_arith() {
-        m_context.register_plugin(alloc(smt::theory_i_arith, m_manager, m_params));        
+        if (AS_LRA == m_params.m_arith_mode) {
+            setup_r_arith();
+        }
+        else {
+            m_context.register_plugin(alloc(smt::theory_i_arith, m_manager, m_params));        
+        }
     }
 
     void setup::setup_r_arith() {
@@ -730,7 +735,10 @@ namespace smt {
     }
 
     void setup::setup_mi_arith() {
-        if (m_params.m_arith_mode == AS_OPTINF) {
+        if (m_params.m_arith_mode == AS_LRA) {
+            setup_r_arith();
+        }
+        else if (m_params.m_arith_mode == AS_OPTINF) {
             m_context.register_plugin(alloc(smt::theory_inf_arith, m_manager, m_params));            
         }
         else {
@@ -789,6 +797,9 @@ namespace smt {
         case AS_OPTINF:
             m_context.register_plugin(alloc(smt::theory_inf_arith, m_manager, m_params));            
             break;
+        case AS_LRA:
+            setup_r_arith();
+            break;
         default:
             if (m_params.m_arith_int_only && int_only)
                 m_context.register_plugin(alloc(smt::theory_i_arith, m_manager, m_params));
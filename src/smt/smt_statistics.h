@@ -46,6 +46,9 @@ namespace smt {
         unsigned m_max_generation;
         unsigned m_num_minimized_lits;
         unsigned m_num_checks;
+        unsigned m_num_cubes;
+        unsigned m_num_pruned_cubes;
+        unsigned m_num_shared_units;
         statistics() {
             reset();
         }
@@ -24,7 +24,10 @@ Revision History:
 #include "util/lp/lp_dual_simplex.h"
 #include "util/lp/indexed_value.h"
 #include "util/lp/lar_solver.h"
+#include "util/lp/int_solver.h"
+#include "util/lp/nla_solver.h"
 #include "util/nat_set.h"
+#include "util/uint_set.h"
 #include "util/optional.h"
 #include "lp_params.hpp"
 #include "util/inf_rational.h"
@@ -36,6 +39,8 @@ Revision History:
 #include "smt/arith_eq_adapter.h"
 #include "util/nat_set.h"
 #include "tactic/filter_model_converter.h"
+#include "tactic/tactic.h"
+#include "nlsat/tactic/nlsat_tactic.h"
 
 namespace lp {
     enum bound_kind { lower_t, upper_t };
@@ -97,6 +102,8 @@ namespace lp {
         unsigned m_make_feasible;
         unsigned m_max_cols;
         unsigned m_max_rows;
+        unsigned m_nlsat_calls;
+        unsigned m_nlsat_conflicts;
         stats() { reset(); }
         void reset() {
             memset(this, 0, sizeof(*this));
@@ -266,6 +273,9 @@ namespace smt {
         lp::stats              m_stats;
         arith_factory*         m_factory;       
         scoped_ptr<lean::lar_solver> m_solver;
+        scoped_ptr<lean::int_solver> m_lia;
+        scoped_ptr<lean::nla_solver> m_nla;
+        unsigned               m_nla_rounds;
         resource_limit         m_resource_limit;
         lp_bounds              m_new_bounds;
 
@@ -288,6 +298,12 @@ namespace smt {
             reset_variable_values();
             m_solver->settings().bound_propagation() = BP_NONE != propagation_mode();
             m_solver->set_propagate_bounds_on_pivoted_rows_mode(lp.bprop_on_pivoted_rows());
+            m_solver->settings().m_int_branch_cut_ratio = m_arith_params.m_arith_branch_cut_ratio;
+            m_solver->settings().m_int_hnf_cut_period = lp.hnf_cut_period();
+            m_solver->settings().m_int_cube_period = lp.cube_period();
+            m_solver->settings().m_float_first = lp.float_first();
+            m_lia = alloc(lean::int_solver, *m_solver.get());
+            m_nla = alloc(lean::nla_solver, *m_solver.get());
             //m_solver->settings().set_ostream(0);
         }
 
@@ -373,10 +389,25 @@ namespace smt {
                     coeff += coeffs[index]*r;
                     ++index;
                 }
+                else if (a.is_mul(n) && is_numeral(to_app(n)->get_arg(0), r) && use_nla()) {
+                    // (* k x y ...)
+                    coeffs[index] *= r;
+                    terms[index] = a.mk_mul(to_app(n)->get_num_args() - 1, to_app(n)->get_args() + 1);
+                    st.terms_to_internalize().push_back(to_app(n)->get_arg(0));
+                }
+                else if (a.is_mul(n) && use_nla()) {
+                    theory_var v = internalize_mul(to_app(n));
+                    coeffs[vars.size()] = coeffs[index];
+                    vars.push_back(v);
+                    ++index;
+                }
                 else if (a.is_uminus(n, n1)) {
                     coeffs[index].neg();
                     terms[index] = n1;
                 }
+                else if (a.is_to_real(n, n1)) {
+                    terms[index] = n1;
+                }
                 else if (is_app(n) && a.get_family_id() == to_app(n)->get_family_id()) {
                     app* t = to_app(n);
                     found_not_handled(n);
@@ -391,9 +422,6 @@ namespace smt {
                     if (is_app(n)) {
                         internalize_args(to_app(n));
                     }
-                    if (a.is_int(n)) {
-                        found_not_handled(n);
-                    }
                     theory_var v = mk_var(n);
                     coeffs[vars.size()] = coeffs[index];
                     vars.push_back(v);
@@ -410,6 +438,42 @@ namespace smt {
             st.terms_to_internalize().reset();
         }
 
+        bool use_nla() const {
+            return !m_delay_constraints && m_arith_params.m_nl_arith;
+        }
+
+        theory_var internalize_factor(expr* n) {
+            if (ctx().e_internalized(n) && th.is_attached_to_var(get_enode(n))) {
+                return get_enode(n)->get_th_var(get_id());
+            }
+            if (is_app(n) && a.get_family_id() == to_app(n)->get_family_id()) {
+                return internalize_def(to_app(n));
+            }
+            return mk_var(n);
+        }
+
+        // products are binarized: (* x y z) = (* x (* y z))
+        theory_var internalize_mul(app* t) {
+            SASSERT(a.is_mul(t));
+            expr_ref y(m);
+            if (t->get_num_args() == 2) {
+                y = t->get_arg(1);
+            }
+            else {
+                y = a.mk_mul(t->get_num_args() - 1, t->get_args() + 1);
+            }
+            theory_var vx = internalize_factor(t->get_arg(0));
+            theory_var vy = internalize_factor(y);
+            enode* e = mk_enode(t);
+            bool is_new = !th.is_attached_to_var(e);
+            theory_var v = mk_var(t);
+            if (is_new) {
+                TRACE("arith", tout << "v" << v << " := v" << vx << " * v" << vy << "\n";);
+                m_nla->add_monomial(get_var_index(v), get_var_index(vx), get_var_index(vy));
+            }
+            return v;
+        }
+
         void internalize_args(app* t) {
             for (unsigned i = 0; reflect(t) && i < t->get_num_args(); ++i) {
                 if (!ctx().e_internalized(t->get_arg(i))) {
@@ -490,7 +554,7 @@ namespace smt {
                 result = m_theory_var2var_index[v];
             }
             if (result == UINT_MAX) {
-                result = m_solver->add_var(v); // TBD: is_int(v);
+                result = m_solver->add_var(v, is_int(v));
                 m_theory_var2var_index.setx(v, result, UINT_MAX);
                 m_var_index2theory_var.setx(result, v, UINT_MAX);
                 m_var_trail.push_back(v);
@@ -600,7 +664,7 @@ namespace smt {
 
         theory_var internalize_def(app* term, scoped_internalize_state& st) {
             linearize_term(term, st);
-            if (is_unit_var(st)) {
+            if (is_unit_var(st) && !a.is_to_real(term)) {
                 return st.vars()[0];
             }
             else {
@@ -617,7 +681,7 @@ namespace smt {
         theory_var internalize_def(app* term) {
             scoped_internalize_state st(*this);
             linearize_term(term, st);
-            if (is_unit_var(st)) {
+            if (is_unit_var(st) && !a.is_to_real(term)) {
                 return st.vars()[0];
             }
             else {
@@ -661,6 +725,7 @@ namespace smt {
             m_num_conflicts(0),
             m_model_eqs(DEFAULT_HASHTABLE_INITIAL_CAPACITY, var_value_hash(*this), var_value_eq(*this)),
             m_solver(0),
+            m_nla_rounds(0),
             m_resource_limit(*this) {
         }
         
@@ -817,7 +882,10 @@ namespace smt {
             s.m_not_handled = m_not_handled;
             s.m_underspecified_lim = m_underspecified.size();
             s.m_var_trail_lim = m_var_trail.size();
-            if (!m_delay_constraints) m_solver->push();
+            if (!m_delay_constraints) {
+                m_solver->push();
+                m_nla->push();
+            }
         }
 
         void pop_scope_eh(unsigned num_scopes) {
@@ -846,7 +914,10 @@ namespace smt {
             m_var_trail.shrink(m_scopes[old_size].m_var_trail_lim);
             m_not_handled = m_scopes[old_size].m_not_handled;
             m_scopes.resize(old_size);            
-            if (!m_delay_constraints) m_solver->pop(num_scopes);
+            if (!m_delay_constraints) {
+                m_solver->pop(num_scopes);
+                m_nla->pop(num_scopes);
+            }
             // VERIFY(l_false != make_feasible());
             m_new_bounds.reset();
             m_to_check.reset();
@@ -1003,6 +1074,7 @@ namespace smt {
         void init_search_eh() {
             m_arith_eq_adapter.init_search_eh();
             m_num_conflicts = 0;
+            m_nla_rounds = 0;
         }
 
         bool can_get_value(theory_var v) const {
@@ -1083,7 +1155,10 @@ namespace smt {
                   }
                   tout << "\n";
                   );
-            m_solver->random_update(vars.size(), vars.c_ptr());
+            if (!m_solver->has_int_var() && m_nla->empty()) {
+                // the random update does not preserve integrality nor products
+                m_solver->random_update(vars.size(), vars.c_ptr());
+            }
             m_model_eqs.reset();
             TRACE("arith", display(tout););
             
@@ -1142,6 +1217,283 @@ namespace smt {
             return false;
         }
 
+        theory_var lp2th_var(lean::var_index vi) const {
+            return m_solver->is_term(vi) ?
+                m_term_index2theory_var.get(m_solver->adjust_term_index(vi), null_theory_var) :
+                m_var_index2theory_var.get(vi, null_theory_var);
+        }
+
+        /**
+           \brief Create the arithmetic term for a term of the lar_solver over variable and term indices.
+        */
+        expr_ref mk_term(lean::lar_term const& term, bool is_int) {
+            expr_ref_vector args(m);
+            for (auto const& c : term.m_coeffs) {
+                theory_var v = lp2th_var(c.first);
+                SASSERT(v != null_theory_var);
+                expr* o = get_enode(v)->get_owner();
+                if (!is_int && a.is_int(o)) {
+                    o = a.mk_to_real(o);
+                }
+                if (c.second.is_one()) {
+                    args.push_back(o);
+                }
+                else {
+                    args.push_back(a.mk_mul(a.mk_numeral(c.second, is_int), o));
+                }
+            }
+            if (args.empty()) {
+                return expr_ref(a.mk_numeral(rational::zero(), is_int), m);
+            }
+            if (args.size() == 1) {
+                return expr_ref(args.get(0), m);
+            }
+            return expr_ref(a.mk_add(args.size(), args.c_ptr()), m);
+        }
+
+        bool is_int_term(lean::lar_term const& term) {
+            for (auto const& c : term.m_coeffs) {
+                theory_var v = lp2th_var(c.first);
+                if (v == null_theory_var || !is_int(v) || !c.second.is_int()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        app_ref mk_bound(lean::lar_term const& term, rational const& k, bool upper) {
+            bool is_int = is_int_term(term);
+            rational bound = k;
+            if (is_int && !bound.is_int()) {
+                bound = upper ? floor(bound) : ceil(bound);
+            }
+            expr_ref t = mk_term(term, is_int);
+            app_ref atom(m);
+            if (upper) {
+                atom = a.mk_le(t, a.mk_numeral(bound, is_int));
+            }
+            else {
+                atom = a.mk_ge(t, a.mk_numeral(bound, is_int));
+            }
+            TRACE("arith", tout << atom << "\n";);
+            ctx().internalize(atom, true);
+            ctx().mark_as_relevant(atom.get());
+            return atom;
+        }
+
+        /**
+           \brief Check integrality of the current feasible solution.
+           Return l_false if a branch, a cut, or a conflict was created.
+        */
+        lbool check_lia() {
+            if (m.canceled()) {
+                return l_undef;
+            }
+            if (m_arith_params.m_arith_ignore_int || !m_lia) {
+                return l_true;
+            }
+            lean::lar_term term;
+            lean::mpq k;
+            bool upper = false;
+            m_explanation.clear();
+            switch (m_lia->check(term, k, upper, m_explanation)) {
+            case lean::lia_move::ok:
+                return l_true;
+            case lean::lia_move::branch: {
+                TRACE("arith", tout << "branch\n";);
+                mk_bound(term, k, upper);
+                return l_false;
+            }
+            case lean::lia_move::cut: {
+                TRACE("arith", tout << "cut\n";);
+                app_ref b = mk_bound(term, k, upper);
+                m_eqs.reset();
+                m_core.reset();
+                m_params.reset();
+                for (auto const& ev : m_explanation) {
+                    if (!ev.first.is_zero()) {
+                        set_evidence(ev.second);
+                    }
+                }
+                assign(literal(ctx().get_bool_var(b), false));
+                return l_false;
+            }
+            case lean::lia_move::conflict:
+                TRACE("arith", tout << "int conflict\n";);
+                set_conflict1();
+                return l_false;
+            case lean::lia_move::give_up:
+                TRACE("arith", tout << "lia giveup\n";);
+                return l_undef;
+            default:
+                UNREACHABLE();
+            }
+            return l_undef;
+        }
+
+        literal mk_literal(lean::ineq const& in) {
+            bool upper = in.m_cmp == lean::LE || in.m_cmp == lean::GT;
+            app_ref b = mk_bound(in.m_term, in.m_rs, upper);
+            literal lit(ctx().get_bool_var(b), false);
+            return (in.m_cmp == lean::LT || in.m_cmp == lean::GT) ? ~lit : lit;
+        }
+
+        /**
+           \brief Check that the monomials evaluate to the products of their factors.
+           Return l_false if lemmas or a conflict were created.
+        */
+        lbool check_nla() {
+            if (m.canceled()) {
+                return l_undef;
+            }
+            if (!m_nla || m_nla->empty()) {
+                return l_true;
+            }
+            vector<lean::lemma> lemmas;
+            switch (m_nla->check(lemmas)) {
+            case l_true:
+                return l_true;
+            case l_undef:
+                // the model is too close to the lemmas of earlier rounds to be cut off cheaply.
+                return check_nlsat() == l_false ? l_false : l_undef;
+            default:
+                break;
+            }
+            if (m_nla_rounds >= m_arith_params.m_nl_arith_rounds) {
+                return check_nlsat() == l_false ? l_false : l_undef;
+            }
+            ++m_nla_rounds;
+            // the lemmas may refine the model forever, for instance when all solutions are irrational,
+            // so nlsat gets a chance to refute the bounds at exponentially spaced rounds.
+            // When nlsat finds a model of the bounds, the lemmas keep refining the linear model.
+            if (m_nla_rounds >= 8 && (m_nla_rounds & (m_nla_rounds - 1)) == 0 && check_nlsat() == l_false) {
+                return l_false;
+            }
+            for (lean::lemma const& l : lemmas) {
+                literal_vector lits;
+                for (lean::ineq const& in : l) {
+                    lits.push_back(mk_literal(in));
+                }
+                TRACE("arith", ctx().display_literals_verbose(tout, lits); tout << "\n";);
+                ctx().mk_th_axiom(get_id(), lits.size(), lits.c_ptr());
+            }
+            return l_false;
+        }
+
+        void add_columns(lean::var_index vi, uint_set& cols) {
+            if (m_solver->is_term(vi)) {
+                for (auto const& p : m_solver->get_term(vi).m_coeffs) {
+                    cols.insert(p.first);
+                }
+            }
+            else {
+                cols.insert(vi);
+            }
+        }
+
+        /**
+           \brief Incremental linearization got stuck. Try to decide the asserted bounds
+           that share columns with the monomials using nlsat, provided there are few of them.
+           Return l_false if they are refuted, and l_true if nlsat found a model of them.
+        */
+        lbool check_nlsat() {
+            unsigned max_core = m_arith_params.m_nl_arith_nlsat_max_core;
+            if (max_core == 0) {
+                return l_undef;
+            }
+            uint_set cols, vis;
+            svector<lean::var_index> vars;
+            m_nla->get_monomial_vars(vars);
+            for (lean::var_index vi : vars) {
+                add_columns(vi, cols);
+            }
+            literal_vector core;
+            svector<bool> in_core(m_asserted_atoms.size(), false);
+            bool change = true;
+            while (change) {
+                change = false;
+                for (unsigned i = 0; i < m_asserted_atoms.size(); ++i) {
+                    if (in_core[i]) {
+                        continue;
+                    }
+                    bool_var bv = m_asserted_atoms[i].m_bv;
+                    lp::bound* b = 0;
+                    if (!m_bool_var2bound.find(bv, b)) {
+                        continue;
+                    }
+                    lean::var_index vi = m_theory_var2var_index.get(b->get_var(), UINT_MAX);
+                    if (vi == UINT_MAX) {
+                        continue;
+                    }
+                    vis.reset();
+                    add_columns(vi, vis);
+                    bool connected = false;
+                    for (unsigned c : vis) {
+                        connected |= cols.contains(c);
+                    }
+                    if (!connected) {
+                        continue;
+                    }
+                    for (unsigned c : vis) {
+                        cols.insert(c);
+                    }
+                    in_core[i] = true;
+                    core.push_back(literal(bv, !m_asserted_atoms[i].m_is_true));
+                    change = true;
+                    if (core.size() > max_core) {
+                        return l_undef;
+                    }
+                }
+            }
+            ++m_stats.m_nlsat_calls;
+            // the literals are tracked as dependencies, so that nlsat returns an unsat core.
+            goal_ref g = alloc(goal, m, false, false, true);
+            expr_ref_vector fmls(m);
+            obj_map<expr, literal> fml2lit;
+            for (literal lit : core) {
+                expr_ref e(m);
+                ctx().literal2expr(lit, e);
+                fmls.push_back(e);
+                fml2lit.insert(e, lit);
+                g->assert_expr(e, m.mk_leaf(e));
+            }
+            goal_ref_buffer result;
+            model_converter_ref mc;
+            proof_converter_ref pc;
+            expr_dependency_ref dep(m);
+            params_ref p;
+            p.set_uint("max_conflicts", 10000);
+            tactic_ref nlsat = mk_nlsat_tactic(m, p);
+            try {
+                (*nlsat)(g, result, mc, pc, dep);
+            }
+            catch (z3_exception& ex) {
+                TRACE("arith", tout << "nlsat: " << ex.msg() << "\n";);
+                return l_undef;
+            }
+            if (result.size() == 1 && result[0]->is_decided_sat()) {
+                return l_true;
+            }
+            if (result.size() != 1 || !result[0]->is_decided_unsat()) {
+                return l_undef;
+            }
+            ptr_vector<expr> leaves;
+            m.linearize(result[0]->dep(0), leaves);
+            core.reset();
+            for (expr* e : leaves) {
+                core.push_back(fml2lit[e]);
+            }
+            TRACE("arith", tout << "nlsat conflict\n"; ctx().display_literals_verbose(tout, core); tout << "\n";);
+            ++m_stats.m_nlsat_conflicts;
+            ++m_stats.m_conflicts;
+            ctx().set_conflict(
+                ctx().mk_justification(
+                    ext_theory_conflict_justification(
+                        get_id(), ctx().get_region(), 
+                        core.size(), core.c_ptr(), 0, 0, 0, 0)));
+            return l_false;
+        }
+
         bool has_delayed_constraints() const {
             return !(m_asserted_atoms.empty() && m_delayed_terms.empty() && m_delayed_equalities.empty());
         }
@@ -1174,6 +1526,22 @@ namespace smt {
                 if (delayed_assume_eqs()) {
                     return FC_CONTINUE;
                 }
+                switch (check_lia()) {
+                case l_true:
+                    break;
+                case l_false:
+                    return FC_CONTINUE;
+                case l_undef:
+                    return m.canceled() ? FC_CONTINUE : FC_GIVEUP;
+                }
+                switch (check_nla()) {
+                case l_true:
+                    break;
+                case l_false:
+                    return FC_CONTINUE;
+                case l_undef:
+                    return m.canceled() ? FC_CONTINUE : FC_GIVEUP;
+                }
                 if (assume_eqs()) {
                     return FC_CONTINUE;
                 }
@@ -1965,12 +2333,23 @@ namespace smt {
             else {
                 ++m_stats.m_assert_upper;
             }
+            rational value = b.get_value();
+            if (is_int(b.get_var())) {
+                // strengthen the bound to an integer: x < v is x <= ceil(v) - 1, x <= v is x <= floor(v).
+                switch (k) {
+                case lean::LT: k = lean::LE; value = ceil(value) - rational::one(); break;
+                case lean::LE: value = floor(value); break;
+                case lean::GT: k = lean::GE; value = floor(value) + rational::one(); break;
+                case lean::GE: value = ceil(value); break;
+                default: break;
+                }
+            }
             auto vi = get_var_index(b.get_var());
-            auto ci = m_solver->add_var_bound(vi, k, b.get_value());
+            auto ci = m_solver->add_var_bound(vi, k, value);
             TRACE("arith", tout << "v" << b.get_var() << "\n";);
             add_ineq_constraint(ci, literal(bv, !is_true));
 
-            propagate_eqs(vi, ci, k, b);
+            propagate_eqs(vi, ci, k, b, value);
         }
 
         //
@@ -1988,9 +2367,8 @@ namespace smt {
         typedef map<value_sort_pair, theory_var, value_sort_pair_hash, default_eq<value_sort_pair> > value2var;
         value2var               m_fixed_var_table;
 
-        void propagate_eqs(lean::var_index vi, lean::constraint_index ci, lean::lconstraint_kind k, lp::bound& b) {
+        void propagate_eqs(lean::var_index vi, lean::constraint_index ci, lean::lconstraint_kind k, lp::bound& b, rational const& value) {
             if (propagate_eqs()) {
-                rational const& value = b.get_value();
                 if (k == lean::GE) {
                     set_lower_bound(vi, ci, value);
                     if (has_upper_bound(vi, ci, value)) {
@@ -2202,12 +2580,16 @@ namespace smt {
         }
 
         void set_conflict() {
-            m_eqs.reset();
-            m_core.reset();
-            m_params.reset();
             m_explanation.clear();
             m_solver->get_infeasibility_explanation(m_explanation);
             // m_solver->shrink_explanation_to_minimum(m_explanation); // todo, enable when perf is fixed
+            set_conflict1();
+        }
+
+        void set_conflict1() {
+            m_eqs.reset();
+            m_core.reset();
+            m_params.reset();
             /*
             static unsigned cn = 0;
             static unsigned num_l = 0;
@@ -2238,6 +2620,8 @@ namespace smt {
 
         void reset_eh() {
             m_arith_eq_adapter.reset_eh();
+            m_lia = 0;
+            m_nla = 0;
             m_solver = 0;
             m_not_handled = nullptr;
             del_bounds(0);
@@ -2512,6 +2896,33 @@ namespace smt {
             st.update("arith-make-feasible", m_stats.m_make_feasible);
             st.update("arith-max-columns", m_stats.m_max_cols);
             st.update("arith-max-rows", m_stats.m_max_rows);
+            if (m_solver) {
+                lean::stats const& s = m_solver->settings().st();
+                st.update("arith-float-first-solves", s.m_float_first_solves);
+                st.update("arith-float-first-repairs", s.m_float_first_repairs);
+                st.update("arith-float-first-repair-iterations", s.m_float_first_repair_iterations);
+                st.update("arith-float-first-fallbacks", s.m_float_first_fallbacks);
+            }
+            if (m_lia) {
+                lean::int_solver::stats const& s = m_lia->st();
+                st.update("arith-patches", s.m_patches);
+                st.update("arith-cube-calls", s.m_cube_calls);
+                st.update("arith-cube-success", s.m_cube_success);
+                st.update("arith-hnf-cuts", s.m_hnf_cuts);
+                st.update("arith-gomory-cuts", s.m_gomory_cuts);
+                st.update("arith-branch", s.m_branches);
+                st.update("arith-int-conflicts", s.m_conflicts);
+            }
+            if (m_nla) {
+                lean::nla_solver::stats const& s = m_nla->st();
+                st.update("arith-nl-zero-lemmas", s.m_zero_lemmas);
+                st.update("arith-nl-sign-lemmas", s.m_sign_lemmas);
+                st.update("arith-nl-monotone-lemmas", s.m_monotone_lemmas);
+                st.update("arith-nl-tangent-lemmas", s.m_tangent_lemmas);
+                st.update("arith-nl-repairs", s.m_repairs);
+            }
+            st.update("arith-nl-nlsat-calls", m_stats.m_nlsat_calls);
+            st.update("arith-nl-nlsat-conflicts", m_stats.m_nlsat_conflicts);
         }        
     };
     
@@ -0,0 +1,32 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    bench_util.h
+
+Abstract:
+
+    Timing helper shared by the microbenchmarks of the test driver.
+
+--*/
+#ifndef BENCH_UTIL_H_
+#define BENCH_UTIL_H_
+
+#include<chrono>
+#include<iostream>
+
+/**
+   \brief run f, which performs ops operations and returns a checksum of their results,
+   and print its throughput. The checksum keeps the compiler from dropping the work.
+*/
+template<typename F>
+void bench_op(char const * name, unsigned long long ops, F f) {
+    auto start = std::chrono::steady_clock::now();
+    unsigned long long checksum = f();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << ops << " ops in " << secs << "s, " << (secs > 0 ? ops / secs / 1e6 : 0)
+              << " Mops/s, checksum: " << checksum << "\n";
+}
+
+#endif
@@ -0,0 +1,57 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    count_min_sketch.cpp
+
+Abstract:
+
+    Test the count-min sketch against exact counts.
+
+--*/
+#include "util/count_min_sketch.h"
+#include "util/hash.h"
+#include "util/util.h"
+#include "util/debug.h"
+#include <iostream>
+
+static void tst_estimates(unsigned width, unsigned depth, unsigned num_keys, unsigned num_incs) {
+    count_min_sketch s;
+    s.reset(width, depth);
+    ENSURE(!s.empty());
+    unsigned_vector counts;
+    counts.resize(num_keys, 0);
+    random_gen r(0);
+    for (unsigned i = 0; i < num_incs; ++i) {
+        unsigned k = r() % num_keys;
+        counts[k]++;
+        ENSURE(s.inc(hash_u(k), hash_u_u(k, 17)) >= counts[k]);
+    }
+    unsigned num_exact = 0;
+    for (unsigned k = 0; k < num_keys; ++k) {
+        unsigned e = s.estimate(hash_u(k), hash_u_u(k, 17));
+        ENSURE(e >= counts[k]);
+        if (e == counts[k])
+            num_exact++;
+    }
+    std::cout << "width: " << width << " depth: " << depth << " keys: " << num_keys
+              << " exact: " << num_exact << " memory: " << s.memory() << "\n";
+    if (width >= 16 * num_keys) {
+        ENSURE(2 * num_exact > num_keys);
+    }
+    s.decay(0.5);
+    for (unsigned k = 0; k < num_keys; ++k) {
+        ENSURE(s.estimate(hash_u(k), hash_u_u(k, 17)) >= counts[k] / 2);
+    }
+}
+
+void tst_count_min_sketch() {
+    count_min_sketch s;
+    ENSURE(s.empty());
+    s.reset(0, 4);
+    ENSURE(s.empty());
+    tst_estimates(1000, 4, 100, 10000);
+    tst_estimates(64, 4, 1000, 10000);
+    tst_estimates(16, 1, 100, 1000);
+}
@@ -0,0 +1,89 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    keyed_heap.cpp
+
+Abstract:
+
+    Test heap with cached keys.
+
+--*/
+#include<iostream>
+#include "util/keyed_heap.h"
+#include "util/util.h"
+#include "util/trace.h"
+
+#define N 10000
+
+static double g_key[N];
+
+static void tst1() {
+    random_gen r(0);
+    keyed_heap h;
+    h.reserve(N);
+    for (unsigned i = 0; i < N * 10; i++) {
+        unsigned cmd = r(10);
+        unsigned val = r(N);
+        if (cmd <= 3) {
+            if (!h.contains(val)) {
+                g_key[val] = r();
+                h.insert(val, g_key[val]);
+                ENSURE(h.contains(val));
+            }
+        }
+        else if (cmd <= 5) {
+            if (h.contains(val)) {
+                h.erase(val);
+                ENSURE(!h.contains(val));
+            }
+        }
+        else if (cmd <= 8) {
+            if (h.contains(val)) {
+                g_key[val] = r();
+                h.set_key(val, g_key[val]);
+                ENSURE(h.get_key(val) == g_key[val]);
+            }
+        }
+        else if (i % 100 == 0) {
+            // scaling keys by a different factor per parity breaks the heap order.
+            h.rekey([&](unsigned v) { return g_key[v] = (v % 2 == 0 ? 0.5 : 2.0) * g_key[v]; });
+        }
+        ENSURE(h.check_invariant());
+    }
+    double last = 0;
+    bool first = true;
+    while (!h.empty()) {
+        unsigned v = h.max_value();
+        ENSURE(h.get_key(v) == g_key[v]);
+        ENSURE(first || g_key[v] <= last);
+        last  = g_key[v];
+        first = false;
+        ENSURE(h.erase_max() == v);
+        ENSURE(!h.contains(v));
+    }
+}
+
+static void tst2() {
+    keyed_heap h1, h2;
+    h1.reserve(10);
+    h2.reserve(10);
+    for (unsigned i = 0; i < 10; ++i) {
+        h1.insert(i, static_cast<double>(i));
+    }
+    h1.swap(h2);
+    ENSURE(h1.empty());
+    ENSURE(h2.size() == 10);
+    ENSURE(h2.max_value() == 9);
+    h2.reset();
+    ENSURE(h2.empty());
+    ENSURE(!h2.contains(9));
+    h2.insert(3, 1.0);
+    ENSURE(h2.max_value() == 3);
+}
+
+void tst_keyed_heap() {
+    tst1();
+    tst2();
+}
@@ -30,6 +30,7 @@ Author: Lev Nachmanson
 #include "util/lp/stacked_value.h"
 #include "util/lp/stacked_unordered_set.h"
 #include "util/lp/int_set.h"
+#include "util/lp/lp_simd.h"
 #include "util/stopwatch.h"
 namespace lean {
 unsigned seed = 1;
@@ -1282,6 +1283,103 @@ void solve_mps_in_rational(std::string file_name, bool dual, argument_parser & /
     }
 }
 
+// compares the vector kernels of every level that the cpu supports with the scalar kernels
+void test_simd_kernels() {
+    simd_level supported = simd::supported_level();
+    std::cout << "simd level: " << simd::level_to_string(supported) << std::endl;
+    for (unsigned t = 0; t < 1000; t++) {
+        unsigned n = 100;
+        vector<double> w;
+        vector<unsigned> basis;
+        for (unsigned j = 0; j < n; j++) {
+            w.push_back(static_cast<int>(my_random() % 200) - 100);
+            basis.push_back(n - 1 - j);
+        }
+        vector<row_cell<double>> row;
+        for (unsigned l = my_random() % 40; l > 0; l--)
+            row.push_back(row_cell<double>(my_random() % n, 0, (static_cast<int>(my_random() % 2000) - 1000) / 7.0));
+        indexed_vector<double> ed(n);
+        for (unsigned i = 0; i < n; i++)
+            if (my_random() % 3 == 0)
+                ed.set_value(my_random() % 4 == 0 ? 1e-16 : (static_cast<int>(my_random() % 100) - 50) / 3.0, i);
+        double dot = 0, max_abs = 0, min_abs = 0;
+        vector<double> x0, copy0;
+        indexed_vector<double> ed0;
+        for (unsigned l = 0; l <= static_cast<unsigned>(supported); l++) {
+            simd::set_level(static_cast<simd_level>(l));
+            double d = simd::dot_row(row.c_ptr(), row.size(), w.c_ptr());
+            double mx = simd::max_abs_row(row.c_ptr(), row.size());
+            double mn = simd::min_abs_row(row.c_ptr(), row.size());
+            vector<double> x, copy(n, 0.0);
+            for (unsigned j = 0; j < n; j++)
+                x.push_back(j / 2.0);
+            simd::axpy_on_index(x.c_ptr(), basis.c_ptr(), ed.m_data.c_ptr(), ed.m_index.c_ptr(), ed.m_index.size(), 3.25, copy.c_ptr());
+            indexed_vector<double> e = ed;
+            e.clean_up();
+            if (l == 0) {
+                dot = d; max_abs = mx; min_abs = mn;
+                x0 = x; copy0 = copy; ed0 = e;
+                continue;
+            }
+            // the vector kernels may sum in another order, or fuse the multiplication and the addition
+            VERIFY(abs(d - dot) <= 1e-9 * (1 + abs(dot)));
+            VERIFY(mx == max_abs && mn == min_abs);
+            for (unsigned j = 0; j < n; j++) {
+                VERIFY(abs(x[j] - x0[j]) <= 1e-12 * (1 + abs(x0[j])));
+                VERIFY(copy[j] == copy0[j]);
+            }
+            VERIFY(e.m_index.size() == ed0.m_index.size());
+            for (unsigned k = 0; k < e.m_index.size(); k++)
+                VERIFY(e.m_index[k] == ed0.m_index[k]);
+            for (unsigned i = 0; i < n; i++)
+                VERIFY(e[i] == ed0[i]);
+        }
+    }
+    simd::set_level(supported);
+}
+
+// times the double simplex and the row kernels on an mps file for every simd level that the cpu supports
+void bench_simd(std::string file_name, unsigned max_iterations, unsigned time_limit, argument_parser & args_parser) {
+    simd_level supported = simd::supported_level();
+    for (unsigned l = 0; l <= static_cast<unsigned>(supported); l++) {
+        simd::set_level(static_cast<simd_level>(l));
+        mps_reader<double, double> reader(file_name);
+        reader.read();
+        if (!reader.is_ok()) {
+            std::cout << "cannot process " << file_name << std::endl;
+            break;
+        }
+        lp_solver<double, double> * solver = reader.create_solver(false);
+        setup_solver(max_iterations, time_limit, args_parser.option_is_used("--min"), args_parser, solver);
+        stopwatch sw;
+        sw.start();
+        solver->find_maximal_solution();
+        sw.stop();
+        std::cout << simd::level_to_string(static_cast<simd_level>(l)) << ": " << lp_status_to_string(solver->get_status())
+                  << ", cost = " << solver->get_current_cost() << ", " << solver->m_total_iterations << " iterations in "
+                  << sw.get_seconds() << " seconds";
+        static_matrix<double, double> * A = solver->m_A;
+        if (A != nullptr) {
+            vector<double> w;
+            for (unsigned j = 0; j < A->column_count(); j++)
+                w.push_back(1.0 / (j + 1));
+            double sum = 0;
+            stopwatch rsw;
+            rsw.start();
+            for (unsigned k = 0; k < 1000; k++) {
+                for (unsigned i = 0; i < A->row_count(); i++)
+                    sum += A->dot_product_with_row(i, w) + A->get_max_abs_in_row(i) - A->get_min_abs_in_row(i);
+            }
+            rsw.stop();
+            std::cout << ", 1000 passes of the row kernels over " << A->row_count() << " rows in " << rsw.get_seconds()
+                      << " seconds (checksum " << sum << ")";
+        }
+        std::cout << std::endl;
+        delete solver;
+    }
+    simd::set_level(supported);
+}
+
 void test_upair_queue() {
     int n = 10;
     binary_heap_upair_queue<int> q(2);
@@ -1909,6 +2007,8 @@ void setup_args_parser(argument_parser & parser) {
     parser.add_option_with_help_string("--test_mpq", "test rationals");
     parser.add_option_with_help_string("--test_mpq_np", "test rationals");
     parser.add_option_with_help_string("--test_mpq_np_plus", "test rationals using plus instead of +=");
+    parser.add_option_with_help_string("--test_simd", "compare the vector kernels of the double solver with the scalar ones");
+    parser.add_option_with_help_string("--bench_simd", "time the double solver on the file given by --file with every supported simd level");
 }
 
 struct fff { int a; int b;};
@@ -3104,6 +3204,10 @@ void test_lp_local(int argn, char**argv) {
         test_bound_propagation();
         return finalize(0);
     }
+    if (args_parser.option_is_used("--test_simd")) {
+        test_simd_kernels();
+        return finalize(0);
+    }
         
     
     std::string lufile = args_parser.get_option_value("--checklu");
@@ -3206,6 +3310,11 @@ void test_lp_local(int argn, char**argv) {
     bool dual = args_parser.option_is_used("--dual");
     bool solve_for_rational = args_parser.option_is_used("--mpq");
     std::string file_name = args_parser.get_option_value("--file");
+    if (file_name.size() > 0 && args_parser.option_is_used("--bench_simd")) {
+        bench_simd(file_name, max_iters, time_limit, args_parser);
+        ret = 0;
+        return finalize(ret);
+    }
     if (file_name.size() > 0) {
         solve_mps(file_name, args_parser.option_is_used("--min"), max_iters, time_limit, solve_for_rational, dual, args_parser.option_is_used("--compare_with_primal"), args_parser);
         ret = 0;
@@ -3238,3 +3347,7 @@ void test_lp_local(int argn, char**argv) {
 void tst_lp(char ** argv, int argc, int& i) {
     lean::test_lp_local(argc - 2, argv + 2);
 }
+
+void tst_lp_simd() {
+    lean::test_simd_kernels();
+}
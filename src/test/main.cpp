@@ -146,6 +146,7 @@ int main(int argc, char ** argv) {
     TST(region);
     TST(symbol);
     TST(heap);
+    TST(keyed_heap);
     TST(hashtable);
     TST(rational);
     TST(inf_rational);
@@ -178,6 +179,8 @@ int main(int argc, char ** argv) {
     TST(object_allocator);
     TST(mpz);
     TST(mpq);
+    TST_ARGV(mpz_bench);
+    TST_ARGV(mpq_bench);
     TST(mpf);
     TST(total_order);
     TST(dl_table);
@@ -190,13 +193,20 @@ int main(int argc, char ** argv) {
     TST(escaped);
     TST(buffer);
     TST(chashtable);
+    TST(count_min_sketch);
     TST(ex);
     TST(nlarith_util);
     TST(api_bug);
     TST(arith_rewriter);
     TST(check_assumptions);
     TST(smt_context);
+    TST(smt_ematching);
+    TST(smt_mbqi);
+    TST(smt_parallel);
     TST(theory_dl);
+    TST(theory_lra_float);
+    TST(theory_lra_int);
+    TST(theory_lra_nl);
     TST(model_retrieval);
     TST(model_based_opt);
     TST(factor_rewriter);
@@ -240,9 +250,17 @@ int main(int argc, char ** argv) {
     TST_ARGV(ddnf);
     TST(model_evaluator);
     TST_ARGV(lp);
+    TST(lp_simd);
     TST(get_consequences);
     TST(pb2bv);
     TST_ARGV(cnf_backbones);
+    TST_ARGV(sat_par);
+    TST(sat_drat);
+    TST(sat_local_search);
+    TST(sat_simplifier);
+    TST(sat_xor);
+    TST_ARGV(sat_bcp);
+    TST(sat_clause_arena);
     //TST_ARGV(hs);
 }
 
@@ -20,6 +20,7 @@ Revision History:
 #include "util/mpq.h"
 #include "util/rational.h"
 #include "util/timeit.h"
+#include "test/bench_util.h"
 
 static void tst0() {
     synch_mpq_manager m;
@@ -170,3 +171,72 @@ void tst_mpq() {
 }
 
 
+
+// Microbenchmark of the rational operations of a simplex pivot on coefficients
+// whose numerators and denominators fit in 64 bits.
+//
+// Usage: test mpq_bench [num_values] [rounds]
+
+static void mk_mid_size_values(unsynch_mpq_manager & m, random_gen & r, unsigned n, scoped_mpq_vector & vs) {
+    scoped_mpq v(m);
+    for (unsigned i = 0; i < n; i++) {
+        int64 num = (static_cast<int64>(r(1 << 15)) << 15 | r(1 << 15)) >> r(24);
+        if (num == 0)
+            num = 1;
+        uint64 den = 1 + (r(1 << 15) >> r(12));
+        m.set(v, r(2) == 0 ? num : -num, den);
+        vs.push_back(v);
+    }
+}
+
+void tst_mpq_bench(char ** argv, int argc, int & i) {
+    unsigned n = 1000;
+    unsigned rounds = 1000;
+    if (i + 1 < argc)
+        n = atoi(argv[++i]);
+    if (i + 1 < argc)
+        rounds = atoi(argv[++i]);
+    unsynch_mpq_manager m;
+    random_gen r(0);
+    scoped_mpq_vector as(m);
+    mk_mid_size_values(m, r, n, as);
+    unsigned long long ops = static_cast<unsigned long long>(n) * rounds;
+    scoped_mpq c(m);
+    bench_op("add", ops, [&]() {
+        unsigned long long h = 0;
+        for (unsigned k = 0; k < rounds; k++)
+            for (unsigned j = 0, l = k % n; j < n; j++, l = l + 1 == n ? 0 : l + 1) {
+                m.add(as[j], as[l], c);
+                h += m.is_neg(c);
+            }
+        return h;
+    });
+    bench_op("mul", ops, [&]() {
+        unsigned long long h = 0;
+        for (unsigned k = 0; k < rounds; k++)
+            for (unsigned j = 0, l = k % n; j < n; j++, l = l + 1 == n ? 0 : l + 1) {
+                m.mul(as[j], as[l], c);
+                h += m.is_neg(c);
+            }
+        return h;
+    });
+    bench_op("div", ops, [&]() {
+        unsigned long long h = 0;
+        for (unsigned k = 0; k < rounds; k++)
+            for (unsigned j = 0, l = k % n; j < n; j++, l = l + 1 == n ? 0 : l + 1) {
+                m.div(as[j], as[l], c);
+                h += m.is_neg(c);
+            }
+        return h;
+    });
+    // the row operation of a pivot: a_j - a_k * a_l
+    bench_op("submul", ops, [&]() {
+        unsigned long long h = 0;
+        for (unsigned k = 0; k < rounds; k++)
+            for (unsigned j = 0, l = k % n; j < n; j++, l = l + 1 == n ? 0 : l + 1) {
+                m.submul(as[j], as[k % n], as[l], c);
+                h += m.is_neg(c);
+            }
+        return h;
+    });
+}
@@ -21,6 +21,7 @@ Revision History:
 #include "util/rational.h"
 #include "util/timeit.h"
 #include "util/scoped_numeral.h"
+#include "test/bench_util.h"
 
 static void tst1() {
     synch_mpz_manager m;
@@ -490,9 +491,101 @@ static void tst_pw2() {
     }
 }
 
+// small numbers range over int64, check the operations at the boundaries
+static void tst_int64_boundary() {
+    unsynch_mpz_manager m;
+    scoped_mpz a(m), b(m), c(m), d(m);
+    m.set(a, static_cast<int64>(INT64_MAX));
+    m.add(a, mpz(1), b);
+    ENSURE(m.to_string(b) == "9223372036854775808");
+    ENSURE(!m.is_int64(b));
+    m.neg(b);
+    ENSURE(m.is_int64(b) && m.get_int64(b) == INT64_MIN);
+    m.set(c, static_cast<int64>(INT64_MIN));
+    ENSURE(m.eq(b, c));
+    m.neg(c);
+    ENSURE(m.to_string(c) == "9223372036854775808");
+    m.sub(c, mpz(1), c);
+    ENSURE(m.eq(a, c) && m.is_small(c));
+
+    m.set(a, static_cast<int64>(UINT_MAX));
+    m.mul(a, a, b);
+    ENSURE(m.to_string(b) == "18446744065119617025");
+    m.set(a, static_cast<int64>(3037000500ll));
+    m.mul(a, a, b);
+    ENSURE(m.to_string(b) == "9223372037000250000");
+    m.set(a, static_cast<int64>(-3037000499ll));
+    m.mul(a, a, b);
+    ENSURE(m.is_small(b) && m.get_int64(b) == 9223372030926249001ll);
+
+    // results of the big operations that fit in 64 bits are small
+    m.set(a, "18446744073709551616");
+    m.set(b, "18446744073709551615");
+    m.sub(a, b, c);
+    ENSURE(m.is_one(c));
+    m.set(b, static_cast<int64>(1ll << 40));
+    m.add(a, b, c);
+    m.sub(c, a, c);
+    ENSURE(m.is_small(c) && m.eq(b, c) && m.hash(b) == m.hash(c));
+
+    m.set(a, static_cast<int64>(3ll << 40));
+    m.set(b, static_cast<int64>(9ll << 35));
+    m.gcd(a, b, c);
+    ENSURE(m.get_int64(c) == (3ll << 35));
+
+    m.set(a, 3);
+    m.mul2k(a, 61, b);
+    ENSURE(m.to_string(b) == "6917529027641081856");
+    m.mul2k(a, 62, b);
+    ENSURE(m.to_string(b) == "13835058055282163712");
+    m.machine_div2k(b, 62);
+    ENSURE(m.eq(a, b));
+    m.power(mpz(2), 62, b);
+    ENSURE(m.is_small(b) && m.log2(b) == 62);
+    m.power(mpz(2), 63, b);
+    ENSURE(m.to_string(b) == "9223372036854775808");
+    m.set(a, static_cast<int64>(INT64_MAX));
+    ENSURE(m.log2(a) == 62 && m.power_of_two_multiple(b) == 63);
+    m.set(a, static_cast<int64>(-(1ll << 40) - 5));
+    svector<digit_t> ds;
+    ENSURE(m.decompose(a, ds) && ds.size() == 2 && ds[0] == 5 && ds[1] == 256);
+
+    // the small paths agree with the big paths: a op b == ((a + 2^64) op b) - (2^64 op b)
+    random_gen r(0);
+    scoped_mpz two64(m), e(m);
+    m.set(two64, "18446744073709551616");
+    for (unsigned i = 0; i < 10000; i++) {
+        uint64 ux = 0, uy = 0;
+        for (unsigned k = 0; k < 5; k++) {
+            ux = (ux << 15) | r(1 << 15);
+            uy = (uy << 15) | r(1 << 15);
+        }
+        int64 x = static_cast<int64>(ux >> (1 + r(63)));
+        int64 y = static_cast<int64>(uy >> (1 + r(63)));
+        m.set(a, r(2) == 0 ? x : -x);
+        m.set(b, r(2) == 0 ? y : -y);
+        m.add(a, two64, c);
+        m.add(c, b, d);
+        m.sub(d, two64, d);
+        m.add(a, b, e);
+        ENSURE(m.eq(d, e));
+        m.sub(c, b, d);
+        m.sub(d, two64, d);
+        m.sub(a, b, e);
+        ENSURE(m.eq(d, e));
+        m.mul(c, b, d);
+        m.mul(two64, b, c);
+        m.sub(d, c, d);
+        m.mul(a, b, e);
+        ENSURE(m.eq(d, e));
+        ENSURE(m.is_small(e) == m.is_int64(e) || m.get_int64(e) == INT64_MIN);
+    }
+}
+
 void tst_mpz() {
     disable_trace("mpz");
     enable_trace("mpz_2k");
+    tst_int64_boundary();
     tst_pw2();
     tst5();
     tst_div2k_bug();
@@ -512,3 +605,88 @@ void tst_mpz() {
     tst2();
     tst2b();
 }
+
+// Microbenchmark of the operations on numbers of up to 64 bits, the coefficients
+// that dominate the simplex on integer programs.
+//
+// Usage: test mpz_bench [num_values] [rounds]
+
+static void mk_mid_size_values(unsynch_mpz_manager & m, random_gen & r, unsigned n, unsigned max_bits, scoped_mpz_vector & vs) {
+    scoped_mpz v(m);
+    for (unsigned i = 0; i < n; i++) {
+        unsigned bits = 1 + r(max_bits);
+        int64 val = 0;
+        for (unsigned b = 0; b < bits; b += 15)
+            val = (val << 15) | r(1 << 15);
+        val &= (static_cast<int64>(1) << bits) - 1;
+        if (val == 0)
+            val = 1;
+        m.set(v, r(2) == 0 ? val : -val);
+        vs.push_back(v);
+    }
+}
+
+void tst_mpz_bench(char ** argv, int argc, int & i) {
+    unsigned n = 1000;
+    unsigned rounds = 2000;
+    if (i + 1 < argc)
+        n = atoi(argv[++i]);
+    if (i + 1 < argc)
+        rounds = atoi(argv[++i]);
+    unsynch_mpz_manager m;
+    random_gen r(0);
+    // many products of the values of up to 32 bits, and most sums of the values of up to 62 bits, do not fit in an int
+    scoped_mpz_vector as(m), bs(m), cs(m);
+    mk_mid_size_values(m, r, n, 32, as);
+    mk_mid_size_values(m, r, n, 62, bs);
+    mk_mid_size_values(m, r, n, 24, cs);
+    unsigned long long ops = static_cast<unsigned long long>(n) * rounds;
+    scoped_mpz c(m), d(m);
+    bench_op("add", ops, [&]() {
+        unsigned long long h = 0;
+        for (unsigned k = 0; k < rounds; k++)
+            for (unsigned j = 0, l = k % n; j < n; j++, l = l + 1 == n ? 0 : l + 1) {
+                m.add(bs[j], bs[l], c);
+                h += m.is_odd(c);
+            }
+        return h;
+    });
+    bench_op("mul", ops, [&]() {
+        unsigned long long h = 0;
+        for (unsigned k = 0; k < rounds; k++)
+            for (unsigned j = 0, l = k % n; j < n; j++, l = l + 1 == n ? 0 : l + 1) {
+                m.mul(as[j], as[l], c);
+                h += m.is_odd(c);
+            }
+        return h;
+    });
+    bench_op("addmul", ops, [&]() {
+        unsigned long long h = 0;
+        for (unsigned k = 0; k < rounds; k++) {
+            m.reset(d);
+            for (unsigned j = 0, l = k % n; j < n; j++, l = l + 1 == n ? 0 : l + 1)
+                m.addmul(d, cs[j], cs[l], d);
+            h += m.hash(d);
+        }
+        return h;
+    });
+    bench_op("gcd", ops, [&]() {
+        unsigned long long h = 0;
+        for (unsigned k = 0; k < rounds; k++)
+            for (unsigned j = 0, l = k % n; j < n; j++, l = l + 1 == n ? 0 : l + 1) {
+                m.mul(cs[j], cs[l], c);
+                m.gcd(c, bs[j], d);
+                h += m.hash(d);
+            }
+        return h;
+    });
+    bench_op("div", ops, [&]() {
+        unsigned long long h = 0;
+        for (unsigned k = 0; k < rounds; k++)
+            for (unsigned j = 0, l = k % n; j < n; j++, l = l + 1 == n ? 0 : l + 1) {
+                m.div(bs[j], as[l], c);
+                h += m.is_odd(c);
+            }
+        return h;
+    });
+}
@@ -0,0 +1,80 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_bcp.cpp
+
+Abstract:
+
+    Propagation throughput of the SAT solver. The instances are random
+    and dominated by binary and ternary clauses, as the clauses produced
+    by bit-blasting are. The search is stopped after a fixed number of
+    conflicts.
+
+    Usage: test sat_bcp [num_vars] [max_conflicts]
+
+--*/
+#include <chrono>
+#include <cstdlib>
+#include "sat/sat_solver.h"
+#include "util/util.h"
+
+static void add_random_clause(sat::solver& s, random_gen& r, unsigned num_vars, unsigned sz) {
+    sat::literal_vector lits;
+    for (unsigned i = 0; i < sz; ++i) {
+        lits.push_back(sat::literal(1 + r(num_vars), r(2) == 0));
+    }
+    s.mk_clause(lits.size(), lits.c_ptr());
+}
+
+static void sat_bcp(unsigned num_vars, unsigned max_conflicts, unsigned seed) {
+    random_gen r(seed);
+    params_ref p;
+    p.set_uint("max_conflicts", max_conflicts);
+    reslimit lim;
+    sat::solver s(p, lim, 0);
+    for (unsigned i = 0; i <= num_vars; ++i) {
+        s.mk_var(false, true);
+    }
+    for (unsigned i = 0; i < num_vars / 2; ++i) {
+        add_random_clause(s, r, num_vars, 2);
+    }
+    for (unsigned i = 0; i < 3 * num_vars; ++i) {
+        add_random_clause(s, r, num_vars, 3);
+    }
+    for (unsigned i = 0; i < num_vars / 4; ++i) {
+        add_random_clause(s, r, num_vars, 4 + r(5));
+    }
+    auto start = std::chrono::steady_clock::now();
+    lbool res = s.check();
+    auto stop = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(stop - start).count();
+
+    statistics st;
+    s.collect_statistics(st);
+    unsigned long long props = 0;
+    for (unsigned i = 0; i < st.size(); ++i) {
+        std::string key(st.get_key(i));
+        if (key == "propagations" || key == "binary propagations" || key == "ternary propagations") {
+            props += st.get_uint_value(i);
+        }
+    }
+    std::cout << "seed: " << seed << " result: " << res << " propagations: " << props
+              << " time: " << secs << "s propagations/s: " << (secs > 0 ? props / secs : 0) << "\n";
+}
+
+void tst_sat_bcp(char ** argv, int argc, int& i) {
+    unsigned num_vars = 20000;
+    unsigned max_conflicts = 20000;
+    if (i + 1 < argc) {
+        num_vars = atoi(argv[++i]);
+    }
+    if (i + 1 < argc) {
+        max_conflicts = atoi(argv[++i]);
+    }
+    std::cout << "watch record: " << sizeof(sat::watched) << " bytes\n";
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        sat_bcp(num_vars, max_conflicts, seed);
+    }
+}
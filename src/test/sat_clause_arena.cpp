@@ -0,0 +1,71 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_clause_arena.cpp
+
+Abstract:
+
+    Compaction of the clause arena of the SAT solver. Frequent garbage
+    collection of learned clauses forces the arena to be compacted during
+    the search, with and without sat.gc.defrag, and the search goes on
+    with the relocated clauses.
+
+--*/
+#include "sat/sat_solver.h"
+#include "util/util.h"
+
+static lbool check_random_3sat(unsigned seed, bool defrag, unsigned & num_compactions) {
+    unsigned num_vars = 200;
+    unsigned num_clauses = 852; // ratio 4.26
+    random_gen r(seed);
+    params_ref p;
+    p.set_bool("gc.defrag", defrag);
+    p.set_uint("gc.initial", 300);
+    p.set_uint("gc.increment", 50);
+    reslimit lim;
+    sat::solver s(p, lim, 0);
+    for (unsigned i = 0; i < num_vars; ++i) {
+        s.mk_var(false, true);
+    }
+    vector<sat::literal_vector> clauses;
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        sat::literal_vector lits;
+        for (unsigned j = 0; j < 3; ++j) {
+            lits.push_back(sat::literal(r(num_vars), r(2) == 0));
+        }
+        clauses.push_back(lits);
+        s.mk_clause(lits.size(), lits.c_ptr());
+    }
+    lbool res = s.check();
+    if (res == l_true) {
+        sat::model const & m = s.get_model();
+        for (unsigned i = 0; i < clauses.size(); ++i) {
+            bool is_sat = false;
+            for (unsigned j = 0; j < clauses[i].size(); ++j) {
+                is_sat |= sat::value_at(clauses[i][j], m) == l_true;
+            }
+            ENSURE(is_sat);
+        }
+    }
+    statistics st;
+    s.collect_statistics(st);
+    num_compactions = st.get_uint("clause arena compactions");
+    std::cout << "seed " << seed << " defrag " << defrag << " " << res
+              << " compactions " << num_compactions << "\n";
+    return res;
+}
+
+void tst_sat_clause_arena() {
+    unsigned compactions[2] = { 0, 0 };
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        unsigned n1 = 0, n2 = 0;
+        lbool r1 = check_random_3sat(seed, true, n1);
+        lbool r2 = check_random_3sat(seed, false, n2);
+        ENSURE(r1 != l_undef && r1 == r2);
+        compactions[0] += n1;
+        compactions[1] += n2;
+    }
+    ENSURE(compactions[0] > 0 && compactions[1] > 0);
+}
@@ -0,0 +1,252 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.cpp
+
+Abstract:
+
+    Test the in-process DRAT checker on small proofs, on the proofs
+    produced by the SAT solver for random unsatisfiable 3-CNF formulas,
+    and on proof files written by the solver in both formats.
+
+--*/
+#include "sat/sat_drat_checker.h"
+#include "sat/sat_solver.h"
+#include "util/util.h"
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+enum step_kind { input, lemma, deletion };
+
+static void add_step(sat::drat_checker& c, step_kind k, std::initializer_list<int> lits) {
+    sat::literal_vector ls;
+    for (int l : lits) {
+        ls.push_back(sat::literal(static_cast<unsigned>(l < 0 ? -l : l), l < 0));
+    }
+    switch (k) {
+    case input:    c.add_input(ls.size(), ls.c_ptr()); break;
+    case lemma:    c.add_lemma(ls.size(), ls.c_ptr()); break;
+    case deletion: c.del(ls.size(), ls.c_ptr()); break;
+    }
+}
+
+static void add_xor_inputs(sat::drat_checker& c) {
+    add_step(c, input, {1, 2});
+    add_step(c, input, {-1, 2});
+    add_step(c, input, {1, -2});
+    add_step(c, input, {-1, -2});
+}
+
+static void tst_drat_checker() {
+    reslimit lim;
+    {
+        // RUP lemmas
+        sat::drat_checker c;
+        add_xor_inputs(c);
+        add_step(c, lemma, {2});
+        add_step(c, lemma, {});
+        ENSURE(c.check(lim) == l_true);
+    }
+    {
+        // a lemma that is not implied, and not used
+        sat::drat_checker c;
+        add_xor_inputs(c);
+        add_step(c, lemma, {3});
+        add_step(c, lemma, {1});
+        add_step(c, lemma, {});
+        ENSURE(c.check(lim) == l_true);
+    }
+    {
+        // a lemma that is not implied, and used
+        sat::drat_checker c;
+        add_step(c, input, {1, 2});
+        add_step(c, input, {-1, 2});
+        add_step(c, input, {1, -2});
+        add_step(c, lemma, {-2});
+        add_step(c, lemma, {});
+        ENSURE(c.check(lim) == l_false);
+    }
+    {
+        // no empty clause
+        sat::drat_checker c;
+        add_xor_inputs(c);
+        add_step(c, lemma, {2});
+        ENSURE(c.check(lim) == l_undef);
+    }
+    {
+        // RAT lemmas on a fresh variable, the clauses they replace are deleted.
+        sat::drat_checker c;
+        add_xor_inputs(c);
+        add_step(c, lemma, {3, 1});
+        add_step(c, lemma, {-3, 1});
+        add_step(c, deletion, {1, -2});
+        add_step(c, deletion, {2, 1});
+        add_step(c, lemma, {1});
+        add_step(c, lemma, {});
+        ENSURE(c.check(lim) == l_true);
+    }
+    {
+        // a clause that is deleted after it is used
+        sat::drat_checker c;
+        add_step(c, input, {1, 2, 3});
+        add_step(c, input, {-1, 2});
+        add_step(c, input, {1, -2});
+        add_step(c, input, {-1, -2});
+        add_step(c, input, {-3});
+        add_step(c, lemma, {1, 2});
+        add_step(c, deletion, {3, 2, 1});
+        add_step(c, lemma, {2});
+        add_step(c, lemma, {});
+        ENSURE(c.check(lim) == l_true);
+    }
+}
+
+static void tst_drat_solver(unsigned seed) {
+    unsigned num_vars = 60;
+    unsigned num_clauses = 340;
+    random_gen r(seed);
+    params_ref p;
+    p.set_bool("drat.check", true);
+    reslimit lim;
+    sat::solver s(p, lim, 0);
+    for (unsigned i = 0; i <= num_vars; ++i) {
+        s.mk_var(false, true);
+    }
+    sat::literal_vector lits;
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        lits.reset();
+        for (unsigned j = 0; j < 3; ++j) {
+            lits.push_back(sat::literal(1 + r(num_vars), r(2) == 0));
+        }
+        s.mk_clause(lits.size(), lits.c_ptr());
+    }
+    lbool res = s.check();
+    std::cout << "seed " << seed << " " << res << " drat check " << s.drat_check_result() << "\n";
+    ENSURE(res != l_false || s.drat_check_result() == l_true);
+}
+
+static std::vector<unsigned> sorted_indices(sat::literal_vector const& lits) {
+    std::vector<unsigned> r;
+    for (sat::literal l : lits) r.push_back(l.index());
+    std::sort(r.begin(), r.end());
+    return r;
+}
+
+/**
+   \brief read back a proof written by the solver, mapping DIMACS variable k to solver variable k-1.
+*/
+static void replay_proof(char const* file, bool binary, sat::drat_checker& c, std::set<std::vector<unsigned>>& lemmas) {
+    std::ifstream in(file, std::ios::in | std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    sat::literal_vector lits;
+    unsigned i = 0, n = text.size();
+    while (i < n) {
+        lits.reset();
+        bool is_del = false;
+        if (binary) {
+            ENSURE(text[i] == 'a' || text[i] == 'd');
+            is_del = text[i++] == 'd';
+            while (true) {
+                unsigned u = 0, shift = 0;
+                unsigned char b;
+                do {
+                    ENSURE(i < n);
+                    b = static_cast<unsigned char>(text[i++]);
+                    u |= (b & 127u) << shift;
+                    shift += 7;
+                }
+                while (b & 128);
+                if (u == 0) break;
+                ENSURE(u >= 2);
+                lits.push_back(sat::literal(u / 2 - 1, (u & 1) != 0));
+            }
+        }
+        else {
+            size_t eol = text.find('\n', i);
+            ENSURE(eol != std::string::npos);
+            std::istringstream line(text.substr(i, eol - i));
+            i = static_cast<unsigned>(eol + 1);
+            std::string tok;
+            while (line >> tok) {
+                if (tok == "d") { is_del = true; continue; }
+                int k = atoi(tok.c_str());
+                if (k == 0) break;
+                lits.push_back(sat::literal(static_cast<unsigned>(k < 0 ? -k : k) - 1, k < 0));
+            }
+        }
+        if (is_del) {
+            c.del(lits.size(), lits.c_ptr());
+        }
+        else {
+            c.add_lemma(lits.size(), lits.c_ptr());
+            lemmas.insert(sorted_indices(lits));
+        }
+    }
+}
+
+static void tst_drat_var0(unsigned seed, bool binary) {
+    char const* file = "sat_drat_var0.drat";
+    unsigned num_vars = 40;
+    unsigned num_clauses = 240;
+    random_gen r(seed);
+    vector<sat::literal_vector> inputs;
+    lbool res;
+    {
+        params_ref p;
+        p.set_sym("drat.file", symbol(file));
+        p.set_bool("drat.binary", binary);
+        reslimit lim;
+        sat::solver s(p, lim, 0);
+        for (unsigned i = 0; i < num_vars; ++i) {
+            s.mk_var(false, true);
+        }
+        sat::literal_vector lits;
+        for (unsigned i = 0; i < num_clauses; ++i) {
+            lits.reset();
+            // every fourth clause mentions variable 0.
+            if (i % 4 == 0) lits.push_back(sat::literal(0, r(2) == 0));
+            while (lits.size() < 3) {
+                sat::literal l(r(num_vars), r(2) == 0);
+                bool fresh = true;
+                for (sat::literal l2 : lits) fresh &= l2.var() != l.var();
+                if (fresh) lits.push_back(l);
+            }
+            inputs.push_back(lits);
+            s.mk_clause(lits.size(), lits.c_ptr());
+        }
+        res = s.check();
+    }
+    std::cout << "seed " << seed << (binary ? " binary " : " text ") << res << "\n";
+    if (res == l_false) {
+        sat::drat_checker c;
+        for (sat::literal_vector const& cls : inputs) {
+            c.add_input(cls.size(), cls.c_ptr());
+        }
+        std::set<std::vector<unsigned>> lemmas;
+        replay_proof(file, binary, c, lemmas);
+        reslimit lim;
+        ENSURE(c.check(lim) == l_true);
+        // input clauses are not repeated as lemmas.
+        for (sat::literal_vector const& cls : inputs) {
+            ENSURE(lemmas.find(sorted_indices(cls)) == lemmas.end());
+        }
+    }
+    remove(file);
+}
+
+void tst_sat_drat() {
+    tst_drat_checker();
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        tst_drat_var0(seed, false);
+        tst_drat_var0(seed, true);
+    }
+    for (unsigned seed = 1; seed <= 10; ++seed) {
+        tst_drat_solver(seed);
+    }
+}
@@ -0,0 +1,103 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_local_search.cpp
+
+Abstract:
+
+    Test local search on random 3-CNF formulas with a planted solution,
+    standalone and as a member of the parallel portfolio.
+
+--*/
+#include "sat/sat_local_search.h"
+#include "sat/sat_solver.h"
+#include "util/util.h"
+
+static void add_planted_clauses(sat::solver& s, random_gen& r, svector<bool> const& planted, unsigned num_clauses,
+                                vector<sat::literal_vector>& clauses) {
+    unsigned num_vars = planted.size();
+    sat::literal_vector lits;
+    while (num_clauses > 0) {
+        lits.reset();
+        bool is_sat = false;
+        for (unsigned j = 0; j < 3; ++j) {
+            sat::literal l(r(num_vars), r(2) == 0);
+            is_sat |= planted[l.var()] != l.sign();
+            lits.push_back(l);
+        }
+        if (is_sat) {
+            s.mk_clause(lits.size(), lits.c_ptr());
+            clauses.push_back(lits);
+            --num_clauses;
+        }
+    }
+}
+
+static bool is_model(vector<sat::literal_vector> const& clauses, sat::model const& m) {
+    for (unsigned i = 0; i < clauses.size(); ++i) {
+        bool is_sat = false;
+        for (unsigned j = 0; j < clauses[i].size(); ++j) {
+            is_sat |= sat::value_at(clauses[i][j], m) == l_true;
+        }
+        if (!is_sat) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void tst_local_search(unsigned seed) {
+    unsigned num_vars = 400;
+    random_gen r(seed);
+    svector<bool> planted;
+    for (unsigned v = 0; v < num_vars; ++v) {
+        planted.push_back(r(2) == 0);
+    }
+    reslimit lim;
+    params_ref p;
+    sat::solver s(p, lim, 0);
+    for (unsigned v = 0; v < num_vars; ++v) {
+        s.mk_var(false, true);
+    }
+    vector<sat::literal_vector> clauses;
+    add_planted_clauses(s, r, planted, 4 * num_vars, clauses);
+    sat::local_search ls(lim, seed, 100000, 2.5);
+    ls.import(s, 0, 0);
+    lbool res = ls.check(10);
+    std::cout << "seed " << seed << " local search " << res << " best unsat " << ls.best_unsat() << "\n";
+    ENSURE(res == l_true);
+    ENSURE(is_model(clauses, ls.get_model()));
+}
+
+static void tst_local_search_portfolio(unsigned seed) {
+    unsigned num_vars = 400;
+    random_gen r(seed);
+    svector<bool> planted;
+    for (unsigned v = 0; v < num_vars; ++v) {
+        planted.push_back(r(2) == 0);
+    }
+    reslimit lim;
+    params_ref p;
+    p.set_uint("parallel_threads", 2);
+    p.set_bool("local_search", true);
+    p.set_uint("local_search.rephase", 1);
+    sat::solver s(p, lim, 0);
+    for (unsigned v = 0; v < num_vars; ++v) {
+        s.mk_var(false, true);
+    }
+    vector<sat::literal_vector> clauses;
+    add_planted_clauses(s, r, planted, 4 * num_vars, clauses);
+    lbool res = s.check();
+    std::cout << "seed " << seed << " portfolio " << res << "\n";
+    ENSURE(res == l_true);
+    ENSURE(is_model(clauses, s.get_model()));
+}
+
+void tst_sat_local_search() {
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        tst_local_search(seed);
+        tst_local_search_portfolio(seed);
+    }
+}
@@ -0,0 +1,83 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_par.cpp
+
+Abstract:
+
+    Throughput of the clause exchange used by the parallel SAT solver.
+    Every thread exports clauses to its ring and periodically imports
+    the clauses of its peers, as the solver does at restarts.
+
+    Usage: test sat_par [max_threads] [clauses_per_thread]
+
+--*/
+#include <chrono>
+#include <cstdlib>
+#include "sat/sat_par.h"
+#include "util/z3_omp.h"
+#include "util/util.h"
+
+static void sat_par_exchange(unsigned num_threads, unsigned num_clauses) {
+    sat::par par(num_threads);
+    unsigned const sync_period = 64;
+    svector<unsigned> num_in(num_threads, 0u);
+    auto start = std::chrono::steady_clock::now();
+    #pragma omp parallel for num_threads(num_threads)
+    for (int t = 0; t < static_cast<int>(num_threads); ++t) {
+        unsigned owner = static_cast<unsigned>(t);
+        random_gen rand(owner + 1);
+        sat::literal_vector lits, in_lits;
+        unsigned_vector in_sizes;
+        for (unsigned i = 0; i < num_clauses; ++i) {
+            lits.reset();
+            unsigned sz = 2 + rand(6);
+            for (unsigned j = 0; j < sz; ++j) {
+                lits.push_back(sat::literal(rand(10000), rand(2) == 0));
+            }
+            par.share_clause(owner, lits.size(), lits.c_ptr());
+            if (i % sync_period == 0) {
+                in_lits.reset();
+                in_sizes.reset();
+                par.get_clauses(owner, in_lits, in_sizes);
+                unsigned n = 0;
+                for (unsigned k = 0; k < in_sizes.size(); ++k) {
+                    ENSURE(2 <= in_sizes[k] && in_sizes[k] < 8);
+                    n += in_sizes[k];
+                }
+                ENSURE(n == in_lits.size());
+                for (unsigned k = 0; k < in_lits.size(); ++k) {
+                    ENSURE(in_lits[k].var() < 10000);
+                }
+                num_in[owner] += in_sizes.size();
+            }
+        }
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    unsigned total_in = 0;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        total_in += num_in[t];
+    }
+    double total_out = static_cast<double>(num_threads) * num_clauses;
+    std::cout << "threads: " << num_threads 
+              << " exported: " << total_out 
+              << " imported: " << total_in 
+              << " time: " << secs << "s"
+              << " exported/s: " << (secs > 0 ? total_out / secs : 0) << "\n";
+}
+
+void tst_sat_par(char ** argv, int argc, int& i) {
+    unsigned max_threads = 8;
+    unsigned num_clauses = 200000;
+    if (i + 1 < argc) {
+        max_threads = atoi(argv[++i]);
+    }
+    if (i + 1 < argc) {
+        num_clauses = atoi(argv[++i]);
+    }
+    for (unsigned n = 1; n <= max_threads; n *= 2) {
+        sat_par_exchange(n, num_clauses);
+    }
+}
@@ -0,0 +1,205 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_simplifier.cpp
+
+Abstract:
+
+    Test gate-aware variable elimination and bounded variable addition.
+    Results are cross-checked against the original clauses, and
+    refutations with the in-process DRAT checker.
+
+--*/
+#include "sat/sat_solver.h"
+#include "util/util.h"
+
+class cnf {
+    vector<sat::literal_vector> m_clauses;
+    unsigned                    m_num_vars;
+public:
+    cnf(): m_num_vars(0) {}
+
+    sat::literal mk_var() { return sat::literal(m_num_vars++, false); }
+
+    void add(sat::literal_vector const& lits) { m_clauses.push_back(lits); }
+
+    void add(sat::literal a, sat::literal b) {
+        sat::literal_vector lits;
+        lits.push_back(a); lits.push_back(b);
+        add(lits);
+    }
+
+    void add(sat::literal a, sat::literal b, sat::literal c) {
+        sat::literal_vector lits;
+        lits.push_back(a); lits.push_back(b); lits.push_back(c);
+        add(lits);
+    }
+
+    sat::literal mk_and(sat::literal a, sat::literal b) {
+        sat::literal r = mk_var();
+        add(~r, a);
+        add(~r, b);
+        add(r, ~a, ~b);
+        return r;
+    }
+
+    sat::literal mk_xor(sat::literal a, sat::literal b) {
+        sat::literal r = mk_var();
+        add(~r, a, b);
+        add(~r, ~a, ~b);
+        add(r, ~a, b);
+        add(r, a, ~b);
+        return r;
+    }
+
+    sat::literal mk_ite(sat::literal c, sat::literal t, sat::literal e) {
+        sat::literal r = mk_var();
+        add(~r, ~c, t);
+        add(~r, c, e);
+        add(r, ~c, ~t);
+        add(r, c, ~e);
+        return r;
+    }
+
+    /**
+       \brief add a copy of every clause, extended by the literal l.
+       The simplifier only eliminates variables of clauses that changed since its last
+       round, so the copies, which subsumption removes, queue all variables for the first round.
+    */
+    void add_subsumed_copies(sat::literal l) {
+        for (unsigned i = 0, sz = m_clauses.size(); i < sz; ++i) {
+            sat::literal_vector lits(m_clauses[i]);
+            lits.push_back(l);
+            add(lits);
+        }
+    }
+
+    lbool check(params_ref const& p, statistics& st) {
+        reslimit lim;
+        sat::solver s(p, lim, 0);
+        for (unsigned i = 0; i < m_num_vars; ++i) {
+            s.mk_var(false, true);
+        }
+        for (unsigned i = 0; i < m_clauses.size(); ++i) {
+            s.mk_clause(m_clauses[i].size(), m_clauses[i].c_ptr());
+        }
+        lbool r = s.check();
+        if (r == l_true) {
+            sat::model const& m = s.get_model();
+            for (unsigned i = 0; i < m_clauses.size(); ++i) {
+                bool is_sat = false;
+                for (unsigned j = 0; j < m_clauses[i].size(); ++j) {
+                    is_sat |= sat::value_at(m_clauses[i][j], m) == l_true;
+                }
+                ENSURE(is_sat);
+            }
+        }
+        if (r == l_false) {
+            ENSURE(s.drat_check_result() == l_true);
+        }
+        s.collect_statistics(st);
+        return r;
+    }
+};
+
+static params_ref mk_params(bool gates, bool bva) {
+    params_ref p;
+    p.set_bool("elim_vars.gates", gates);
+    p.set_bool("bva", bva);
+    p.set_bool("drat.check", true);
+    // simplify before the first conflict
+    p.set_uint("burst_search", 0);
+    return p;
+}
+
+/**
+   \brief miter of two circuits over random AND, XOR and ITE gates,
+   the second one with the inputs of the XOR gates swapped.
+ */
+static void tst_gates(unsigned seed) {
+    random_gen r(seed);
+    cnf f;
+    unsigned num_inputs = 12, num_gates = 60;
+    sat::literal_vector in1, in2;
+    for (unsigned i = 0; i < num_inputs; ++i) {
+        in1.push_back(f.mk_var());
+    }
+    in2.append(in1);
+    for (unsigned i = 0; i < num_gates; ++i) {
+        unsigned a = r(in1.size()), b = r(in1.size()), c = r(in1.size());
+        bool na = r(2) == 0, nb = r(2) == 0;
+        switch (r(3)) {
+        case 0:
+            in1.push_back(f.mk_and(na ? ~in1[a] : in1[a], nb ? ~in1[b] : in1[b]));
+            in2.push_back(f.mk_and(na ? ~in2[a] : in2[a], nb ? ~in2[b] : in2[b]));
+            break;
+        case 1:
+            in1.push_back(f.mk_xor(in1[a], in1[b]));
+            in2.push_back(f.mk_xor(in2[b], in2[a]));
+            break;
+        default:
+            in1.push_back(f.mk_ite(in1[a], in1[b], in1[c]));
+            in2.push_back(f.mk_ite(in2[a], in2[b], in2[c]));
+            break;
+        }
+    }
+    f.add_subsumed_copies(f.mk_var());
+    sat::literal_vector diff;
+    for (unsigned i = in1.size() - 4; i < in1.size(); ++i) {
+        diff.push_back(f.mk_xor(in1[i], in2[i]));
+    }
+    statistics st0, st1, st2;
+    // without the miter output, the model is reconstructed for the eliminated gates.
+    ENSURE(f.check(mk_params(true, false), st0) == l_true);
+    f.add(diff);
+    lbool r1 = f.check(mk_params(false, false), st1);
+    lbool r2 = f.check(mk_params(true, false), st2);
+    std::cout << "gates seed " << seed << " " << r1 << " " << r2
+              << " elim vars " << st1.get_uint("elim bool vars") << " -> " << st2.get_uint("elim bool vars")
+              << " elim gates " << st2.get_uint("elim gates") << "\n";
+    ENSURE(r1 == l_false && r2 == l_false);
+    ENSURE(st2.get_uint("elim gates") > 0);
+}
+
+/**
+   \brief pigeon hole problem with a pairwise at-most-one encoding of the holes.
+ */
+static void add_pigeons(cnf& f, unsigned num_pigeons, unsigned num_holes) {
+    vector<sat::literal_vector> p(num_pigeons);
+    for (unsigned i = 0; i < num_pigeons; ++i) {
+        for (unsigned j = 0; j < num_holes; ++j) {
+            p[i].push_back(f.mk_var());
+        }
+        f.add(p[i]);
+    }
+    for (unsigned j = 0; j < num_holes; ++j) {
+        for (unsigned i = 0; i < num_pigeons; ++i) {
+            for (unsigned k = i + 1; k < num_pigeons; ++k) {
+                f.add(~p[i][j], ~p[k][j]);
+            }
+        }
+    }
+}
+
+static void tst_bva(unsigned num_holes, bool is_sat) {
+    cnf f;
+    add_pigeons(f, is_sat ? num_holes : num_holes + 1, num_holes);
+    statistics st;
+    lbool r = f.check(mk_params(true, true), st);
+    std::cout << "bva holes " << num_holes << " " << r
+              << " bva vars " << st.get_uint("bva vars")
+              << " clauses reduced " << st.get_uint("bva clauses reduced") << "\n";
+    ENSURE(r == (is_sat ? l_true : l_false));
+    ENSURE(st.get_uint("bva vars") > 0);
+}
+
+void tst_sat_simplifier() {
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        tst_gates(seed);
+    }
+    tst_bva(6, false);
+    tst_bva(7, false);
+    tst_bva(12, true);
+}
@@ -0,0 +1,176 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_xor.cpp
+
+Abstract:
+
+    Test the XOR constraints extracted from CNF by the SAT solver.
+
+--*/
+#include "sat/sat_solver.h"
+#include "util/util.h"
+
+class xor_cnf {
+    vector<sat::literal_vector> m_clauses;
+    unsigned                    m_num_vars;
+public:
+    xor_cnf(): m_num_vars(0) {}
+
+    sat::bool_var mk_var() { return m_num_vars++; }
+
+    void add(sat::literal_vector const& lits) { m_clauses.push_back(lits); }
+
+    /**
+       \brief add vars[0] xor ... xor vars[k-1] = rhs as 2^(k-1) clauses.
+    */
+    void add_xor(sat::bool_var_vector const& vars, bool rhs) {
+        unsigned k = vars.size();
+        for (unsigned mask = 0; mask < (1u << k); ++mask) {
+            // the clause with the negative literals in mask excludes the assignment
+            // where exactly the variables in mask are true.
+            bool parity = false;
+            sat::literal_vector lits;
+            for (unsigned i = 0; i < k; ++i) {
+                bool neg = (mask & (1u << i)) != 0;
+                parity ^= neg;
+                lits.push_back(sat::literal(vars[i], neg));
+            }
+            if (parity != rhs) {
+                add(lits);
+            }
+        }
+    }
+
+    lbool check(params_ref const& p, statistics& st) {
+        reslimit lim;
+        sat::solver s(p, lim, 0);
+        for (unsigned i = 0; i < m_num_vars; ++i) {
+            s.mk_var(false, true);
+        }
+        for (unsigned i = 0; i < m_clauses.size(); ++i) {
+            s.mk_clause(m_clauses[i].size(), m_clauses[i].c_ptr());
+        }
+        lbool r = s.check();
+        if (r == l_true) {
+            sat::model const& m = s.get_model();
+            for (unsigned i = 0; i < m_clauses.size(); ++i) {
+                bool is_sat = false;
+                for (unsigned j = 0; j < m_clauses[i].size(); ++j) {
+                    is_sat |= sat::value_at(m_clauses[i][j], m) == l_true;
+                }
+                ENSURE(is_sat);
+            }
+        }
+        s.collect_statistics(st);
+        return r;
+    }
+};
+
+static params_ref mk_params(bool use_xor) {
+    params_ref p;
+    p.set_bool("xor_solver", use_xor);
+    // simplify before the first conflict
+    p.set_uint("burst_search", 0);
+    return p;
+}
+
+/**
+   \brief Tseitin formula of a cubic graph on num_nodes nodes: a cycle and a random
+   perfect matching. The edges are the variables, and the edges incident to
+   a node have the parity of its charge. The formula is unsatisfiable iff the
+   sum of the charges is odd. Odd instances are hard for resolution, but
+   Gauss-Jordan elimination refutes them without search.
+ */
+static void tst_tseitin(unsigned seed, unsigned num_nodes, bool is_sat) {
+    random_gen r(seed);
+    xor_cnf f;
+    vector<sat::bool_var_vector> edges(num_nodes);
+    for (unsigned i = 0; i < num_nodes; ++i) {
+        sat::bool_var e = f.mk_var();
+        edges[i].push_back(e);
+        edges[(i + 1) % num_nodes].push_back(e);
+    }
+    unsigned_vector nodes;
+    for (unsigned i = 0; i < num_nodes; ++i) {
+        nodes.push_back(i);
+    }
+    for (unsigned i = num_nodes; i-- > 1; ) {
+        std::swap(nodes[i], nodes[r(i + 1)]);
+    }
+    for (unsigned i = 0; i < num_nodes; i += 2) {
+        sat::bool_var e = f.mk_var();
+        edges[nodes[i]].push_back(e);
+        edges[nodes[i + 1]].push_back(e);
+    }
+    bool sum = false;
+    for (unsigned i = 0; i < num_nodes; ++i) {
+        bool charge = i + 1 < num_nodes ? r(2) == 0 : sum == is_sat;
+        sum ^= charge;
+        f.add_xor(edges[i], charge);
+    }
+    statistics st;
+    lbool res = f.check(mk_params(true), st);
+    std::cout << "tseitin seed " << seed << " nodes " << num_nodes << " " << res
+              << " xors " << st.get_uint("xor constraints")
+              << " conflicts " << st.get_uint("conflicts") << "\n";
+    ENSURE(res == (is_sat ? l_true : l_false));
+    ENSURE(is_sat || st.get_uint("conflicts") == 0);
+}
+
+/**
+   \brief random XOR constraints and clauses satisfied by a random assignment,
+   solved with and without the XOR constraints.
+ */
+static void tst_planted(unsigned seed) {
+    random_gen r(seed);
+    xor_cnf f;
+    unsigned num_vars = 60;
+    svector<bool> sol;
+    for (unsigned i = 0; i < num_vars; ++i) {
+        f.mk_var();
+        sol.push_back(r(2) == 0);
+    }
+    for (unsigned i = 0; i < 40; ++i) {
+        sat::bool_var_vector vars;
+        bool rhs = false;
+        while (vars.size() < 3 + r(3)) {
+            sat::bool_var v = r(num_vars);
+            if (std::find(vars.begin(), vars.end(), v) == vars.end()) {
+                vars.push_back(v);
+                rhs ^= sol[v];
+            }
+        }
+        f.add_xor(vars, rhs);
+    }
+    for (unsigned i = 0; i < 120; ++i) {
+        sat::literal_vector lits;
+        bool is_sat = false;
+        for (unsigned j = 0; j < 3; ++j) {
+            sat::literal l(r(num_vars), r(2) == 0);
+            is_sat |= sol[l.var()] != l.sign();
+            lits.push_back(l);
+        }
+        if (is_sat) {
+            f.add(lits);
+        }
+    }
+    statistics st0, st1;
+    lbool r0 = f.check(mk_params(false), st0);
+    lbool r1 = f.check(mk_params(true), st1);
+    std::cout << "planted seed " << seed << " " << r0 << " " << r1
+              << " xors " << st1.get_uint("xor constraints")
+              << " xor propagations " << st1.get_uint("xor propagations") << "\n";
+    ENSURE(r0 == l_true && r1 == l_true);
+    ENSURE(st1.get_uint("xor constraints") > 0);
+}
+
+void tst_sat_xor() {
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        tst_tseitin(seed, 100, false);
+        tst_tseitin(seed, 100, true);
+        tst_planted(seed);
+    }
+}
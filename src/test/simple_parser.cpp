@@ -24,7 +24,7 @@ Revision History:
 #include "util/warning.h"
 #include "ast/reg_decl_plugins.h"
 
-void tst_simple_parser() {
+static void tst1() {
     ast_manager    m;
     reg_decl_plugins(m);
     arith_util     m_util(m);
@@ -61,3 +61,41 @@ void tst_simple_parser() {
           tout << "val: " << eval(r, 2, vals) << "\n";);
 }
 
+
+static void tst2() {
+    ast_manager    m;
+    reg_decl_plugins(m);
+    cost_parser    p(m);
+    cost_evaluator eval(m);
+    p.add_var("x");
+    p.add_var("y");
+    p.add_var("z");
+    char const * fs[] = {
+        "(+ x y)",
+        "y",
+        "(+ 2 (* 3 4))",
+        "(+ x (* (+ 1 2) y))",
+        "(ite (and (> x 3) (<= y 4)) 2 10)",
+        "(ite (or (> x 3) (<= y 4) (= z 0)) (- x y) (/ z 2))",
+        "(implies (< x y) (>= y z))",
+        "(ite (not (xor (> x 1) (> y 1))) (- 0 z) (* x (+ y z)))",
+        "(/ x (+ y 1))"
+    };
+    random_gen r(0);
+    for (char const * f : fs) {
+        expr_ref e(m);
+        VERIFY(p.parse_string(f, e));
+        compiled_cost_function c;
+        c.compile(m, e, 3);
+        TRACE("simple_parser", tout << mk_pp(e, m) << " code size: " << c.code_size() << "\n";);
+        for (unsigned i = 0; i < 100; ++i) {
+            float vals[3] = { static_cast<float>(r(6)), static_cast<float>(r(6)), static_cast<float>(r(6)) };
+            ENSURE(c(vals) == eval(e, 3, vals));
+        }
+    }
+}
+
+void tst_simple_parser() {
+    tst1();
+    tst2();
+}
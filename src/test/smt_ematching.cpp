@@ -0,0 +1,115 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    smt_ematching.cpp
+
+Abstract:
+
+    Test that batched E-matching rounds produce the instances of sequential rounds,
+    and that persistent instances are not created again after a pop.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "test/smt_test_util.h"
+#include "ast/arith_decl_plugin.h"
+
+/**
+   \brief a chain le(c_0, c_1), ..., le(c_{n-1}, c_n) closed under transitivity.
+   If goal is true, then the negation of le(c_0, c_n) is asserted, and the
+   negation of le(c_n, c_0) otherwise.
+*/
+static void add_chain(ast_manager & m, expr_ref_vector & fmls, unsigned n, bool goal) {
+    std::stringstream strm;
+    strm << "(declare-sort U 0)\n"
+         << "(declare-fun le (U U) Bool)\n";
+    for (unsigned i = 0; i <= n; ++i)
+        strm << "(declare-const c" << i << " U)\n";
+    strm << "(assert (forall ((x U) (y U) (z U)) (! (=> (and (le x y) (le y z)) (le x z)) :pattern ((le x y) (le y z)) :qid trans)))\n";
+    for (unsigned i = 0; i < n; ++i)
+        strm << "(assert (le c" << i << " c" << (i + 1) << "))\n";
+    if (goal)
+        strm << "(assert (not (le c0 c" << n << ")))\n";
+    else
+        strm << "(assert (not (le c" << n << " c0)))\n";
+    parse_smt2_fmls(m, strm.str(), fmls);
+}
+
+static lbool check(unsigned n, bool goal, unsigned threads, ::statistics & st) {
+    // a fresh manager, so that both runs see the same ast ids.
+    ast_manager m;
+    reg_decl_plugins(m);
+    expr_ref_vector fmls(m);
+    add_chain(m, fmls, n, goal);
+    smt_params fp;
+    fp.m_qi_ematching_threads = threads;
+    return check_smt_fmls(fmls, fp, st);
+}
+
+static void tst_chain(unsigned n, bool goal, lbool expected) {
+    ::statistics st1, st4;
+    lbool r1 = check(n, goal, 1, st1);
+    lbool r4 = check(n, goal, 4, st4);
+    std::cout << "chain " << n << " " << r1 << " " << r4
+              << " instances " << st1.get_uint("quant instantiations") << " " << st4.get_uint("quant instantiations")
+              << " conflicts " << st1.get_uint("conflicts") << " " << st4.get_uint("conflicts") << "\n";
+    ENSURE(r1 == expected);
+    ENSURE(r4 == expected);
+    ENSURE(st1.get_uint("quant instantiations") > 0);
+    ENSURE(st1.get_uint("quant instantiations") == st4.get_uint("quant instantiations"));
+    ENSURE(st1.get_uint("conflicts") == st4.get_uint("conflicts"));
+    ENSURE(st1.get_uint("decisions") == st4.get_uint("decisions"));
+}
+
+/**
+   \brief forall x. h(x) > x, and for each round and i in [0, n): push, assert h(a_i) < a_i, check and pop.
+   The instance for a_i is created at the base level of the user scope, and its binding a_i is asserted at level 0.
+*/
+static unsigned check_rounds(bool persistent, unsigned n, unsigned num_rounds) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    sort * int_sort = a.mk_int();
+    func_decl_ref h(m.mk_func_decl(symbol("h"), int_sort, int_sort), m);
+    expr_ref x(m.mk_var(0, int_sort), m);
+    app_ref hx(m.mk_app(h, x.get()), m);
+    expr * pats[1] = { m.mk_pattern(hx) };
+    symbol x_name("x");
+    expr_ref q(m.mk_forall(1, &int_sort, &x_name, a.mk_gt(hx, x), 0, symbol("h_gt"), symbol::null, 1, pats), m);
+    expr_ref_vector as(m);
+    smt_params fp;
+    fp.m_qi_persistent_instances = persistent;
+    smt::kernel k(m, fp);
+    k.assert_expr(q);
+    for (unsigned i = 0; i < n; ++i) {
+        std::stringstream strm;
+        strm << "a" << i;
+        as.push_back(m.mk_const(symbol(strm.str().c_str()), int_sort));
+        k.assert_expr(a.mk_ge(as.get(i), a.mk_numeral(rational(i), true)));
+    }
+    for (unsigned r = 0; r < num_rounds; ++r) {
+        for (unsigned i = 0; i < n; ++i) {
+            k.push();
+            k.assert_expr(a.mk_lt(m.mk_app(h, as.get(i)), as.get(i)));
+            ENSURE(k.check() == l_false);
+            k.pop(1);
+        }
+    }
+    ::statistics st;
+    k.collect_statistics(st);
+    std::cout << "rounds persistent: " << persistent
+              << " instances " << st.get_uint("quant instantiations")
+              << " reasserted " << st.get_uint("reasserted quant instantiations") << "\n";
+    return st.get_uint("quant instantiations");
+}
+
+void tst_smt_ematching() {
+    unsigned n1 = check_rounds(false, 10, 3);
+    unsigned n2 = check_rounds(true, 10, 3);
+    ENSURE(n1 >= 30);
+    ENSURE(n2 < n1);
+    tst_chain(60, true, l_false);
+    tst_chain(100, true, l_false);
+    tst_chain(20, false, l_true);
+}
@@ -0,0 +1,69 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    smt_mbqi.cpp
+
+Abstract:
+
+    Test that MBQI rounds give the same answers when quantifiers satisfied in
+    a previous round are not checked again, and when they are checked in parallel.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "test/smt_test_util.h"
+
+/**
+   \brief n quantifiers forall x. g_i(x) >= 0 whose interpretation does not change between rounds,
+   and forall x. 1 <= x < 10 => f(x) > f(x - 1), which needs several rounds.
+   If goal is true, then f(9) < 5 is asserted, and the problem is unsat.
+*/
+static void add_fmls(ast_manager & m, expr_ref_vector & fmls, unsigned n, bool goal) {
+    std::stringstream strm;
+    strm << "(declare-fun f (Int) Int)\n";
+    for (unsigned i = 0; i < n; ++i) {
+        strm << "(declare-fun g" << i << " (Int) Int)\n"
+             << "(assert (forall ((x Int)) (! (>= (g" << i << " x) 0) :qid g" << i << ")))\n"
+             << "(assert (> (g" << i << " " << i << ") 3))\n";
+    }
+    strm << "(assert (forall ((x Int)) (! (=> (and (<= 1 x) (< x 10)) (> (f x) (f (- x 1)))) :qid f)))\n"
+         << "(assert (= (f 0) 3))\n";
+    if (goal)
+        strm << "(assert (< (f 9) 5))\n";
+    parse_smt2_fmls(m, strm.str(), fmls);
+}
+
+static lbool check(unsigned n, bool goal, bool incremental, unsigned threads, ::statistics & st) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    expr_ref_vector fmls(m);
+    add_fmls(m, fmls, n, goal);
+    smt_params fp;
+    fp.m_ematching = false;
+    fp.m_mbqi_incremental = incremental;
+    fp.m_mbqi_threads = threads;
+    lbool r = check_smt_fmls(fmls, fp, st);
+    std::cout << "mbqi " << n << " " << goal << " incremental: " << incremental << " threads: " << threads << " " << r
+              << " checks " << st.get_uint("mbqi checks")
+              << " cached " << st.get_uint("mbqi cached checks")
+              << " parallel " << st.get_uint("mbqi parallel checks") << "\n";
+    return r;
+}
+
+static void tst_rounds(unsigned n, bool goal, lbool expected) {
+    ::statistics st1, st2, st3;
+    ENSURE(check(n, goal, false, 1, st1) == expected);
+    ENSURE(check(n, goal, true, 1, st2) == expected);
+    ENSURE(check(n, goal, true, 3, st3) == expected);
+    ENSURE(st1.get_uint("mbqi cached checks") == 0);
+    ENSURE(st2.get_uint("mbqi cached checks") > 0);
+    ENSURE(st2.get_uint("mbqi checks") < st1.get_uint("mbqi checks"));
+    ENSURE(st3.get_uint("mbqi parallel checks") > 0);
+    ENSURE(st3.get_uint("mbqi checks") < st2.get_uint("mbqi checks"));
+}
+
+void tst_smt_mbqi() {
+    tst_rounds(6, false, l_true);
+    tst_rounds(6, true, l_false);
+}
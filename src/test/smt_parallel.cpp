@@ -0,0 +1,106 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    smt_parallel.cpp
+
+Abstract:
+
+    Test cube and conquer on smt::kernel.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+#include "test/smt_test_util.h"
+
+/**
+   \brief num_holes + 1 integer variables in [1, num_holes] that are pairwise different.
+*/
+static void add_pigeons(ast_manager & m, expr_ref_vector & fmls, unsigned num_holes) {
+    unsigned num_pigeons = num_holes + 1;
+    arith_util a(m);
+    expr_ref_vector xs(m);
+    for (unsigned i = 0; i < num_pigeons; ++i) {
+        std::stringstream strm;
+        strm << "x" << i;
+        expr * x = m.mk_const(symbol(strm.str().c_str()), a.mk_int());
+        xs.push_back(x);
+        fmls.push_back(a.mk_ge(x, a.mk_numeral(rational(1), true)));
+        fmls.push_back(a.mk_le(x, a.mk_numeral(rational(num_holes), true)));
+    }
+    for (unsigned i = 0; i < num_pigeons; ++i) {
+        for (unsigned j = i + 1; j < num_pigeons; ++j) {
+            fmls.push_back(m.mk_not(m.mk_eq(xs.get(i), xs.get(j))));
+        }
+    }
+}
+
+/**
+   \brief random 3-CNF at the threshold ratio, with the clauses satisfied by a random assignment.
+*/
+static void add_planted_3sat(ast_manager & m, expr_ref_vector & fmls, unsigned seed, unsigned num_vars) {
+    random_gen r(seed);
+    expr_ref_vector bs(m);
+    svector<bool> sol;
+    for (unsigned i = 0; i < num_vars; ++i) {
+        std::stringstream strm;
+        strm << "b" << i;
+        bs.push_back(m.mk_const(symbol(strm.str().c_str()), m.mk_bool_sort()));
+        sol.push_back(r(2) == 0);
+    }
+    unsigned num_clauses = 0;
+    while (num_clauses < 426 * num_vars / 100) {
+        expr_ref_vector lits(m);
+        bool is_sat = false;
+        for (unsigned j = 0; j < 3; ++j) {
+            unsigned v = r(num_vars);
+            bool sign = r(2) == 0;
+            is_sat |= sol[v] != sign;
+            lits.push_back(sign ? m.mk_not(bs.get(v)) : bs.get(v));
+        }
+        if (is_sat) {
+            fmls.push_back(m.mk_or(lits.size(), lits.c_ptr()));
+            ++num_clauses;
+        }
+    }
+}
+
+static lbool check(expr_ref_vector const & fmls, unsigned threads, ::statistics & st) {
+    smt_params fp;
+    fp.m_threads = threads;
+    fp.m_threads_max_conflicts = 0;
+    return check_smt_fmls(fmls, fp, st);
+}
+
+static void tst_check(char const * name, expr_ref_vector const & fmls, lbool expected) {
+    ::statistics st1, st4;
+    lbool r1 = check(fmls, 1, st1);
+    lbool r4 = check(fmls, 4, st4);
+    std::cout << name << " " << r1 << " " << r4
+              << " cubes " << st4.get_uint("cubes")
+              << " pruned cubes " << st4.get_uint("pruned cubes")
+              << " shared units " << st4.get_uint("shared units")
+              << " conflicts " << st1.get_uint("conflicts") << "\n";
+    ENSURE(r1 == expected);
+    ENSURE(r4 == expected);
+    ENSURE(st1.get_uint("cubes") == 0);
+    ENSURE(st4.get_uint("cubes") > 0);
+}
+
+void tst_smt_parallel() {
+    {
+        ast_manager m;
+        reg_decl_plugins(m);
+        expr_ref_vector fmls(m);
+        add_pigeons(m, fmls, 6);
+        tst_check("pigeons", fmls, l_false);
+    }
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        ast_manager m;
+        reg_decl_plugins(m);
+        expr_ref_vector fmls(m);
+        add_planted_3sat(m, fmls, seed, 150);
+        tst_check("planted 3-sat", fmls, l_true);
+    }
+}
@@ -0,0 +1,70 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    smt_test_util.h
+
+Abstract:
+
+    Fixture shared by the tests of the SMT kernel: parse the assertions
+    of an SMT2 script, and check formulas with a kernel whose models are
+    validated against the formulas.
+
+--*/
+#ifndef SMT_TEST_UTIL_H_
+#define SMT_TEST_UTIL_H_
+
+#include<sstream>
+#include "smt/smt_kernel.h"
+#include "smt/params/smt_params.h"
+#include "cmd_context/cmd_context.h"
+#include "parsers/smt2/smt2parser.h"
+#include "model/model.h"
+
+/**
+   \brief append the assertions of the SMT2 script to fmls.
+*/
+inline void parse_smt2_fmls(ast_manager & m, std::string const & script, expr_ref_vector & fmls) {
+    cmd_context ctx(false, &m);
+    ctx.set_ignore_check(true);
+    std::istringstream is(script);
+    VERIFY(parse_smt2_commands(ctx, is));
+    ptr_vector<expr>::const_iterator it  = ctx.begin_assertions();
+    ptr_vector<expr>::const_iterator end = ctx.end_assertions();
+    for (; it != end; ++it)
+        fmls.push_back(*it);
+}
+
+/**
+   \brief check fmls with a fresh kernel and add its statistics to st.
+   When the answer is sat, every quantifier-free formula must evaluate to true in the model.
+*/
+inline lbool check_smt_fmls(expr_ref_vector const & fmls, smt_params & fp, params_ref const & p, ::statistics & st) {
+    ast_manager & m = fmls.get_manager();
+    smt::kernel k(m, fp, p);
+    for (unsigned i = 0; i < fmls.size(); ++i) {
+        k.assert_expr(fmls.get(i));
+    }
+    lbool r = k.check();
+    if (r == l_true) {
+        model_ref mdl;
+        k.get_model(mdl);
+        ENSURE(mdl);
+        for (unsigned i = 0; i < fmls.size(); ++i) {
+            if (is_quantifier(fmls.get(i)))
+                continue;
+            expr_ref val(m);
+            ENSURE(mdl->eval(fmls.get(i), val, true));
+            ENSURE(m.is_true(val));
+        }
+    }
+    k.collect_statistics(st);
+    return r;
+}
+
+inline lbool check_smt_fmls(expr_ref_vector const & fmls, smt_params & fp, ::statistics & st) {
+    return check_smt_fmls(fmls, fp, params_ref(), st);
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    theory_lra_float.cpp
+
+Abstract:
+
+    Test that theory_lra (arith.solver=6) with lp.float_first, which
+    pivots in doubles and repairs the basis in rationals, agrees with
+    the rational simplex on random linear real problems, and that its
+    models satisfy them.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "test/smt_test_util.h"
+#include "util/util.h"
+
+static void add_fmls(ast_manager & m, expr_ref_vector & fmls, unsigned seed) {
+    random_gen r(seed);
+    unsigned n = 4 + r(8);
+    std::stringstream strm;
+    for (unsigned i = 0; i < n; ++i) {
+        strm << "(declare-fun x" << i << " () Real)\n"
+             << "(assert (<= (- " << r(100) << ") x" << i << " " << r(100) << "))\n";
+    }
+    char const * ops[5] = { "<=", ">=", "=", "<", ">" };
+    unsigned num_fmls = n + r(n);
+    for (unsigned k = 0; k < num_fmls; ++k) {
+        strm << "(assert (or";
+        for (unsigned l = 1 + (r(4) == 0); l > 0; --l) {
+            strm << " (" << ops[r(5)] << " (+ 0";
+            for (unsigned i = 0; i < n; ++i) {
+                if (r(3) == 0)
+                    strm << " (* (/ " << (static_cast<int>(r(41)) - 20) << " " << (1 + r(7)) << ") x" << i << ")";
+            }
+            strm << ") " << (static_cast<int>(r(201)) - 100) << ")";
+        }
+        strm << "))\n";
+    }
+    parse_smt2_fmls(m, strm.str(), fmls);
+}
+
+static lbool check(expr_ref_vector const & fmls, bool float_first, ::statistics & st) {
+    smt_params fp;
+    fp.m_arith_mode = AS_LRA;
+    params_ref p;
+    p.set_bool("float_first", float_first);
+    return check_smt_fmls(fmls, fp, p, st);
+}
+
+void tst_theory_lra_float() {
+    unsigned num_sat = 0, num_unsat = 0, num_solves = 0, num_repairs = 0;
+    for (unsigned seed = 0; seed < 100; ++seed) {
+        ast_manager m;
+        reg_decl_plugins(m);
+        expr_ref_vector fmls(m);
+        add_fmls(m, fmls, seed);
+        ::statistics st1, st2;
+        lbool r1 = check(fmls, false, st1);
+        lbool r2 = check(fmls, true, st2);
+        ENSURE(r1 == r2);
+        ENSURE(st1.get_uint("arith-float-first-solves") == 0);
+        num_sat     += r2 == l_true;
+        num_unsat   += r2 == l_false;
+        num_solves  += st2.get_uint("arith-float-first-solves");
+        num_repairs += st2.get_uint("arith-float-first-repairs");
+    }
+    std::cout << "lra float first sat: " << num_sat << " unsat: " << num_unsat
+              << " solves: " << num_solves << " repairs: " << num_repairs << "\n";
+    ENSURE(num_sat > 0 && num_unsat > 0);
+    ENSURE(num_solves > 0);
+}
@@ -0,0 +1,71 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    theory_lra_int.cpp
+
+Abstract:
+
+    Test that theory_lra (arith.solver=6) agrees with theory_arith on
+    random linear integer problems, which need patching, the cube test,
+    HNF cuts, Gomory cuts and branching.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "test/smt_test_util.h"
+#include "util/util.h"
+
+static void add_fmls(ast_manager & m, expr_ref_vector & fmls, unsigned seed) {
+    random_gen r(seed);
+    unsigned n = 2 + r(5);
+    std::stringstream strm;
+    for (unsigned i = 0; i < n; ++i) {
+        strm << "(declare-fun x" << i << " () Int)\n"
+             << "(assert (<= (- " << r(100) << ") x" << i << " " << r(100) << "))\n";
+    }
+    char const * ops[5] = { "<=", ">=", "=", "<", ">" };
+    unsigned num_fmls = 2 + r(6);
+    for (unsigned k = 0; k < num_fmls; ++k) {
+        strm << "(assert (or";
+        for (unsigned l = 1 + r(2); l > 0; --l) {
+            strm << " (" << ops[r(5)] << " (+ 0";
+            for (unsigned i = 0; i < n; ++i) {
+                if (r(2) == 0)
+                    strm << " (* " << (static_cast<int>(r(41)) - 20) << " x" << i << ")";
+            }
+            strm << ") " << (static_cast<int>(r(201)) - 100) << ")";
+        }
+        strm << "))\n";
+    }
+    parse_smt2_fmls(m, strm.str(), fmls);
+}
+
+static lbool check(expr_ref_vector const & fmls, bool lra, ::statistics & st) {
+    smt_params fp;
+    if (lra)
+        fp.m_arith_mode = AS_LRA;
+    return check_smt_fmls(fmls, fp, st);
+}
+
+void tst_theory_lra_int() {
+    unsigned num_sat = 0, num_unsat = 0, num_cuts = 0, num_branches = 0;
+    for (unsigned seed = 0; seed < 100; ++seed) {
+        ast_manager m;
+        reg_decl_plugins(m);
+        expr_ref_vector fmls(m);
+        add_fmls(m, fmls, seed);
+        ::statistics st1, st2;
+        lbool r1 = check(fmls, false, st1);
+        lbool r2 = check(fmls, true, st2);
+        ENSURE(r1 == r2);
+        num_sat   += r2 == l_true;
+        num_unsat += r2 == l_false;
+        num_cuts  += st2.get_uint("arith-gomory-cuts") + st2.get_uint("arith-hnf-cuts");
+        num_branches += st2.get_uint("arith-branch");
+    }
+    std::cout << "lra int sat: " << num_sat << " unsat: " << num_unsat
+              << " cuts: " << num_cuts << " branches: " << num_branches << "\n";
+    ENSURE(num_sat > 0 && num_unsat > 0);
+    ENSURE(num_branches > 0);
+}
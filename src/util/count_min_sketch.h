@@ -0,0 +1,92 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    count_min_sketch.h
+
+Abstract:
+
+    Approximate counters for a large set of keys in a fixed amount of memory.
+
+    The sketch has depth rows of width counters. A key is given by two hash
+    codes h1 and h2, and is mapped to the counter (h1 + i * h2) % width in row i.
+    The estimate of a key is the minimum of its counters, it never
+    underestimates the number of increments of the key. Increments are
+    conservative: only the counters equal to the minimum are incremented.
+
+Revision History:
+
+--*/
+#ifndef COUNT_MIN_SKETCH_H_
+#define COUNT_MIN_SKETCH_H_
+
+#include "util/vector.h"
+
+class count_min_sketch {
+    unsigned        m_depth;
+    unsigned        m_mask;    // width - 1, the width is a power of two
+    unsigned_vector m_counts;
+
+    unsigned idx(unsigned row, unsigned h1, unsigned h2) const {
+        return row * (m_mask + 1) + ((h1 + row * h2) & m_mask);
+    }
+
+public:
+    count_min_sketch():m_depth(0), m_mask(0) {}
+
+    /**
+       \brief Reset the sketch to depth rows of at least width counters.
+       The sketch is empty if width or depth is 0.
+    */
+    void reset(unsigned width, unsigned depth) {
+        m_counts.reset();
+        if (width == 0 || depth == 0) {
+            m_depth = 0;
+            m_mask  = 0;
+            return;
+        }
+        unsigned w = 1;
+        while (w < width && w < (1u << 30))
+            w *= 2;
+        m_depth = depth;
+        m_mask  = w - 1;
+        m_counts.resize(w * depth, 0);
+    }
+
+    bool empty() const { return m_counts.empty(); }
+
+    unsigned estimate(unsigned h1, unsigned h2) const {
+        h2 |= 1; // odd steps visit different counters in each row
+        unsigned r = UINT_MAX;
+        for (unsigned i = 0; i < m_depth; ++i)
+            r = std::min(r, m_counts[idx(i, h1, h2)]);
+        return r;
+    }
+
+    /**
+       \brief Increment the key, and return its new estimate.
+    */
+    unsigned inc(unsigned h1, unsigned h2) {
+        unsigned r = estimate(h1, h2) + 1;
+        h2 |= 1;
+        for (unsigned i = 0; i < m_depth; ++i) {
+            unsigned & c = m_counts[idx(i, h1, h2)];
+            if (c < r)
+                c = r;
+        }
+        return r;
+    }
+
+    /**
+       \brief Multiply all counters by the factor f in [0, 1].
+    */
+    void decay(double f) {
+        for (unsigned i = 0; i < m_counts.size(); ++i)
+            m_counts[i] = static_cast<unsigned>(m_counts[i] * f);
+    }
+
+    unsigned memory() const { return m_counts.size() * sizeof(unsigned); }
+};
+
+#endif /* COUNT_MIN_SKETCH_H_ */
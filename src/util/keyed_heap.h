@@ -0,0 +1,209 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    keyed_heap.h
+
+Abstract:
+
+    Max-heap of unsigned values with cached double keys.
+
+    The key of a value is stored next to it in the heap array, so
+    comparisons do not read memory outside of the heap. The heap is
+    4-ary: the four children of a node are adjacent 16-byte entries
+    starting at 4i+1, so moving down reads at most two cache lines
+    per level, and the heap is half as deep as a binary heap.
+
+Author:
+
+    agent (agent@local) 2026-10-16.
+
+Revision History:
+
+--*/
+#ifndef KEYED_HEAP_H_
+#define KEYED_HEAP_H_
+
+#include "util/vector.h"
+#include "util/debug.h"
+
+class keyed_heap {
+public:
+    struct entry {
+        double   m_key;
+        unsigned m_value;
+        entry() {}
+        entry(double key, unsigned value): m_key(key), m_value(value) {}
+    };
+
+    typedef entry const * const_iterator;
+
+private:
+    svector<entry>  m_entries;
+    unsigned_vector m_value2index; // UINT_MAX if the value is not in the heap
+
+    static unsigned parent(unsigned idx) {
+        return (idx - 1) >> 2;
+    }
+
+    static unsigned first_child(unsigned idx) {
+        return (idx << 2) + 1;
+    }
+
+    void set(unsigned idx, entry const & e) {
+        m_entries[idx]           = e;
+        m_value2index[e.m_value] = idx;
+    }
+
+    void move_up(unsigned idx) {
+        entry e = m_entries[idx];
+        while (idx > 0) {
+            unsigned parent_idx = parent(idx);
+            if (m_entries[parent_idx].m_key >= e.m_key)
+                break;
+            set(idx, m_entries[parent_idx]);
+            idx = parent_idx;
+        }
+        set(idx, e);
+    }
+
+    void move_down(unsigned idx) {
+        entry e     = m_entries[idx];
+        unsigned sz = m_entries.size();
+        while (true) {
+            unsigned child_idx = first_child(idx);
+            if (child_idx >= sz)
+                break;
+            unsigned end      = std::min(child_idx + 4, sz);
+            unsigned max_idx  = child_idx;
+            double   max_key  = m_entries[child_idx].m_key;
+            for (unsigned i = child_idx + 1; i < end; ++i) {
+                if (m_entries[i].m_key > max_key) {
+                    max_idx = i;
+                    max_key = m_entries[i].m_key;
+                }
+            }
+            if (max_key <= e.m_key)
+                break;
+            set(idx, m_entries[max_idx]);
+            idx = max_idx;
+        }
+        set(idx, e);
+    }
+
+    void heapify() {
+        if (m_entries.size() > 1) {
+            for (unsigned i = parent(m_entries.size() - 1) + 1; i-- > 0; ) {
+                move_down(i);
+            }
+        }
+        CASSERT("keyed_heap", check_invariant());
+    }
+
+public:
+    bool check_invariant() const {
+        for (unsigned i = 1; i < m_entries.size(); ++i) {
+            SASSERT(m_entries[parent(i)].m_key >= m_entries[i].m_key);
+        }
+        for (unsigned i = 0; i < m_entries.size(); ++i) {
+            SASSERT(m_value2index[m_entries[i].m_value] == i);
+        }
+        return true;
+    }
+
+    bool empty() const { return m_entries.empty(); }
+
+    unsigned size() const { return m_entries.size(); }
+
+    bool contains(unsigned v) const {
+        return v < m_value2index.size() && m_value2index[v] != UINT_MAX;
+    }
+
+    void reserve(unsigned s) {
+        if (s > m_value2index.size())
+            m_value2index.resize(s, UINT_MAX);
+    }
+
+    void reset() {
+        for (entry const & e : m_entries) {
+            m_value2index[e.m_value] = UINT_MAX;
+        }
+        m_entries.reset();
+    }
+
+    double get_key(unsigned v) const {
+        SASSERT(contains(v));
+        return m_entries[m_value2index[v]].m_key;
+    }
+
+    unsigned max_value() const {
+        SASSERT(!empty());
+        return m_entries[0].m_value;
+    }
+
+    void insert(unsigned v, double key) {
+        SASSERT(v < m_value2index.size());
+        SASSERT(!contains(v));
+        m_entries.push_back(entry(key, v));
+        move_up(m_entries.size() - 1);
+        CASSERT("keyed_heap", check_invariant());
+    }
+
+    void erase(unsigned v) {
+        SASSERT(contains(v));
+        unsigned idx      = m_value2index[v];
+        entry last        = m_entries.back();
+        m_value2index[v]  = UINT_MAX;
+        m_entries.pop_back();
+        if (idx < m_entries.size()) {
+            double old_key = m_entries[idx].m_key;
+            set(idx, last);
+            if (last.m_key > old_key)
+                move_up(idx);
+            else
+                move_down(idx);
+        }
+        CASSERT("keyed_heap", check_invariant());
+    }
+
+    unsigned erase_max() {
+        unsigned v = max_value();
+        erase(v);
+        return v;
+    }
+
+    void set_key(unsigned v, double key) {
+        SASSERT(contains(v));
+        unsigned idx   = m_value2index[v];
+        double old_key = m_entries[idx].m_key;
+        m_entries[idx].m_key = key;
+        if (key > old_key)
+            move_up(idx);
+        else
+            move_down(idx);
+        CASSERT("keyed_heap", check_invariant());
+    }
+
+    /**
+       \brief Replace the key of every value v in the heap by key(v).
+    */
+    template<typename Key>
+    void rekey(Key const & key) {
+        for (entry & e : m_entries) {
+            e.m_key = key(e.m_value);
+        }
+        heapify();
+    }
+
+    const_iterator begin() const { return m_entries.begin(); }
+
+    const_iterator end() const { return m_entries.end(); }
+
+    void swap(keyed_heap & other) {
+        m_entries.swap(other.m_entries);
+        m_value2index.swap(other.m_value2index);
+    }
+};
+
+#endif /* KEYED_HEAP_H_ */
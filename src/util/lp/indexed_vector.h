@@ -10,6 +10,7 @@
 #include <iomanip>
 #include "util/lp/lp_utils.h"
 #include "util/lp/lp_settings.h"
+#include "util/lp/lp_simd.h"
 #include <unordered_set>
 namespace lean {
 
@@ -166,4 +167,9 @@ public:
     void print(std::ostream & out);
 #endif
 };
+
+template <>
+inline void indexed_vector<double>::clean_up() {
+    m_index.shrink(simd::drop_small_on_index(m_data.c_ptr(), m_index.c_ptr(), m_index.size(), 1e-14));
+}
 }
@@ -9,7 +9,7 @@ bool strategy_is_undecided() const {
     return m_settings.simplex_strategy() == simplex_strategy_enum::undecided;
 }
 
-var_index add_var(unsigned ext_j) {
+var_index add_var(unsigned ext_j, bool is_int = false) {
     var_index i;
     lean_assert (ext_j < m_terms_start_index); 
 
@@ -22,21 +22,29 @@ var_index add_var(unsigned ext_j) {
     lean_assert(m_vars_to_ul_pairs.size() == A_r().column_count());
     i = A_r().column_count();
     m_vars_to_ul_pairs.push_back (ul_pair(static_cast<unsigned>(-1)));
-    add_non_basic_var_to_core_fields(ext_j);
+    add_non_basic_var_to_core_fields(ext_j, is_int);
     lean_assert(sizes_are_correct());
     return i;
 }
 
-void register_new_ext_var_index(unsigned ext_v) {
+void register_new_ext_var_index(unsigned ext_v, bool is_int) {
     lean_assert(!contains(m_ext_vars_to_columns, ext_v));
     unsigned j = static_cast<unsigned>(m_ext_vars_to_columns.size());
     m_ext_vars_to_columns[ext_v] = j;
     lean_assert(m_columns_to_ext_vars_or_term_indices.size() == j);
     m_columns_to_ext_vars_or_term_indices.push_back(ext_v);
+    m_column_is_int.push_back(is_int);
 }
 
-void add_non_basic_var_to_core_fields(unsigned ext_j) {
-    register_new_ext_var_index(ext_j);
+bool term_is_int(const lar_term * term) const {
+    for (auto const & p : term->m_coeffs)
+        if (!p.second.is_int() || is_term(p.first) || !column_is_int(p.first))
+            return false;
+    return true;
+}
+
+void add_non_basic_var_to_core_fields(unsigned ext_j, bool is_int) {
+    register_new_ext_var_index(ext_j, is_int);
     m_mpq_lar_core_solver.m_column_types.push_back(column_type::free_column);
     m_columns_with_changed_bound.increase_size_by_one();
     add_new_var_to_core_fields_for_mpq(false);
@@ -121,7 +129,7 @@ void add_row_for_term(const lar_term * term, unsigned term_ext_index) {
 }
 
 void add_row_from_term_no_constraint(const lar_term * term, unsigned term_ext_index) {
-    register_new_ext_var_index(term_ext_index);
+    register_new_ext_var_index(term_ext_index, term_is_int(term));
     // j will be a new variable
 	unsigned j = A_r().column_count();
     ul_pair ul(j);
@@ -0,0 +1,634 @@
+/*
+  Copyright (c) 2017 Microsoft Corporation
+  Author: agent (agent@local) 2026-10-16
+*/
+#include "util/lp/int_solver.h"
+#include "util/lp/lar_solver.h"
+namespace lean {
+
+static mpq floor_impq(impq const & v) {
+    if (v.x.is_int())
+        return v.y.is_neg() ? v.x - one_of_type<mpq>() : v.x;
+    return floor(v.x);
+}
+
+static mpq ceil_impq(impq const & v) {
+    if (v.x.is_int())
+        return v.y.is_pos() ? v.x + one_of_type<mpq>() : v.x;
+    return ceil(v.x);
+}
+
+static mpq fractional_part(mpq const & v) {
+    return v - floor(v);
+}
+
+int_solver::int_solver(lar_solver & s): m_lar_solver(s) {}
+
+lp_settings & int_solver::settings() { return m_lar_solver.settings(); }
+
+lp_settings const & int_solver::settings() const { return m_lar_solver.settings(); }
+
+vector<impq> & int_solver::x() { return m_lar_solver.m_mpq_lar_core_solver.m_r_x; }
+
+const impq & int_solver::get_value(unsigned j) { return x()[j]; }
+
+bool int_solver::column_is_int(unsigned j) const { return m_lar_solver.column_is_int(j); }
+
+bool int_solver::column_is_int_inf(unsigned j) {
+    if (!column_is_int(j) || m_lar_solver.column_is_term(j))
+        return false;
+    impq const & v = get_value(j);
+    return !v.y.is_zero() || !v.x.is_int();
+}
+
+bool int_solver::has_inf_int() {
+    unsigned n = m_lar_solver.column_count();
+    for (unsigned j = 0; j < n; j++)
+        if (column_is_int_inf(j))
+            return true;
+    return false;
+}
+
+bool int_solver::has_low(unsigned j) const {
+    switch (m_lar_solver.m_mpq_lar_core_solver.m_column_types()[j]) {
+    case column_type::low_bound:
+    case column_type::boxed:
+    case column_type::fixed:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool int_solver::has_upper(unsigned j) const {
+    switch (m_lar_solver.m_mpq_lar_core_solver.m_column_types()[j]) {
+    case column_type::upper_bound:
+    case column_type::boxed:
+    case column_type::fixed:
+        return true;
+    default:
+        return false;
+    }
+}
+
+const impq & int_solver::low_bound(unsigned j) const { return m_lar_solver.m_mpq_lar_core_solver.m_r_low_bounds()[j]; }
+
+const impq & int_solver::upper_bound(unsigned j) const { return m_lar_solver.m_mpq_lar_core_solver.m_r_upper_bounds()[j]; }
+
+bool int_solver::at_low(unsigned j) { return has_low(j) && get_value(j) == low_bound(j); }
+
+bool int_solver::at_upper(unsigned j) { return has_upper(j) && get_value(j) == upper_bound(j); }
+
+bool int_solver::is_fixed(unsigned j) const { return m_lar_solver.m_mpq_lar_core_solver.m_column_types()[j] == column_type::fixed; }
+
+bool int_solver::is_boxed(unsigned j) const {
+    column_type t = m_lar_solver.m_mpq_lar_core_solver.m_column_types()[j];
+    return t == column_type::boxed || t == column_type::fixed;
+}
+
+bool int_solver::is_basic(unsigned j) const { return m_lar_solver.m_mpq_lar_core_solver.m_r_heading[j] >= 0; }
+
+constraint_index int_solver::low_witness(unsigned j) const { return m_lar_solver.column_low_bound_witness(j); }
+
+constraint_index int_solver::upper_witness(unsigned j) const { return m_lar_solver.column_upper_bound_witness(j); }
+
+void int_solver::get_row(unsigned i, row_t & row) {
+    row.clear();
+    lar_core_solver & cs = m_lar_solver.m_mpq_lar_core_solver;
+    if (settings().use_tableau()) {
+        unsigned bj = cs.m_r_basis[i];
+        for (auto const & c : m_lar_solver.A_r().m_rows[i])
+            if (c.m_j != bj)
+                row.push_back(std::make_pair(c.get_val(), c.m_j));
+        return;
+    }
+    unsigned bj = cs.m_r_basis[i];
+    cs.calculate_pivot_row(i);
+    for (unsigned j : cs.m_r_solver.m_pivot_row.m_index)
+        if (j != bj && !is_zero(cs.m_r_solver.m_pivot_row.m_data[j]))
+            row.push_back(std::make_pair(cs.m_r_solver.m_pivot_row.m_data[j], j));
+}
+
+// adds coeff * column j to t <= k, or t >= k. A term column
+// stands for the term without its free coefficient, which moves to k.
+void int_solver::add_to_term(lar_term & t, mpq & k, mpq const & coeff, unsigned j) {
+    unsigned vi = m_lar_solver.adjust_column_index_to_term_index(j);
+    if (m_lar_solver.column_is_term(j))
+        k += coeff * m_lar_solver.get_column_term(j).m_v;
+    t.add_to_map(vi, coeff);
+}
+
+// ------------------------------------------------------------------
+// patching
+
+bool int_solver::patch_nbasic_column(unsigned j, impq const & v) {
+    if ((has_low(j) && v < low_bound(j)) || (has_upper(j) && upper_bound(j) < v))
+        return false;
+    impq delta = v - get_value(j);
+    auto const & A = m_lar_solver.A_r();
+    for (auto const & c : A.m_columns[j]) {
+        unsigned bj = m_lar_solver.m_mpq_lar_core_solver.m_r_basis[c.m_i];
+        impq bv = get_value(bj) - A.get_val(c) * delta;
+        if ((has_low(bj) && bv < low_bound(bj)) || (has_upper(bj) && upper_bound(bj) < bv))
+            return false;
+    }
+    x()[j] = v;
+    m_lar_solver.change_basic_x_by_delta_on_column(j, delta);
+    m_stats.m_patches++;
+    return true;
+}
+
+void int_solver::patch_nbasic_columns() {
+    if (!settings().use_tableau())
+        return;
+    for (unsigned j : m_lar_solver.m_mpq_lar_core_solver.m_r_nbasis) {
+        if (!column_is_int_inf(j))
+            continue;
+        impq const & v = get_value(j);
+        if (!patch_nbasic_column(j, impq(floor_impq(v))))
+            patch_nbasic_column(j, impq(ceil_impq(v)));
+    }
+}
+
+// ------------------------------------------------------------------
+// cube test
+
+bool int_solver::round_and_check() {
+    unsigned n = m_lar_solver.column_count();
+    vector<impq> & xs = x();
+    for (unsigned j = 0; j < n; j++) {
+        if (column_is_int(j) && !m_lar_solver.column_is_term(j))
+            xs[j] = impq(floor(xs[j].x + mpq(1, 2)));
+    }
+    for (unsigned j = 0; j < n; j++) {
+        if (!m_lar_solver.column_is_term(j))
+            continue;
+        impq v;
+        for (auto const & p : m_lar_solver.get_column_term(j).m_coeffs)
+            v += p.second * xs[p.first];
+        xs[j] = v;
+    }
+    for (unsigned j = 0; j < n; j++) {
+        if ((has_low(j) && xs[j] < low_bound(j)) || (has_upper(j) && upper_bound(j) < xs[j]))
+            return false;
+    }
+    return true;
+}
+
+bool int_solver::find_cube() {
+    if (!settings().use_tableau_rows())
+        return false;
+    m_stats.m_cube_calls++;
+    vector<impq> saved_x(x());
+    unsigned n = m_lar_solver.column_count();
+    m_lar_solver.push();
+    for (unsigned j = 0; j < n; j++) {
+        if (!m_lar_solver.column_is_term(j))
+            continue;
+        lar_term const & t = m_lar_solver.get_column_term(j);
+        // rounding the integer columns changes the term by at most delta.
+        mpq delta;
+        for (auto const & p : t.m_coeffs)
+            if (column_is_int(p.first))
+                delta += abs(p.second);
+        if (is_zero(delta))
+            continue;
+        delta /= mpq(2);
+        unsigned ti = m_lar_solver.adjust_column_index_to_term_index(j);
+        if (has_upper(j)) {
+            impq const & u = upper_bound(j);
+            m_lar_solver.add_var_bound(ti, u.y.is_neg() ? LT : LE, u.x + t.m_v - delta);
+        }
+        if (has_low(j)) {
+            impq const & l = low_bound(j);
+            m_lar_solver.add_var_bound(ti, l.y.is_pos() ? GT : GE, l.x + t.m_v + delta);
+        }
+    }
+    lp_status st = m_lar_solver.find_feasible_solution();
+    m_lar_solver.pop(1);
+    bool found = (st == OPTIMAL || st == FEASIBLE) && round_and_check();
+    if (!found) {
+        // the solution before the cube test is feasible in the current basis.
+        x() = saved_x;
+    }
+    for (unsigned j = 0; j < n; j++)
+        m_lar_solver.m_mpq_lar_core_solver.m_r_solver.update_column_in_inf_set(j);
+    if (found)
+        m_stats.m_cube_success++;
+    return found;
+}
+
+// ------------------------------------------------------------------
+// Hermite normal form cuts
+//
+// The tight rows A x <= b over integer columns at the current solution x0 satisfy A x0 = b.
+// For linearly independent rows there is a unimodular U such that A U = [B 0] with B lower triangular,
+// so y = B^-1 A x is integral for every integral x. If y_i = (B^-1 b)_i is not integral,
+// and the row l = e_i B^-1 is non-negative on the inequality rows, then l A x <= floor(l b)
+// is implied and violated by x0. Rows l that are non-positive give l A x >= ceil(l b).
+
+namespace {
+    struct hnf_row {
+        std::unordered_map<unsigned, mpq> m_coeffs; // over integer variable columns
+        mpq              m_b;
+        unsigned         m_j;        // the column whose bound is tight
+        bool             m_is_eq;
+        bool             m_is_upper; // a x <= b stands for the upper bound of m_j, and -a x <= -b for the lower bound
+    };
+}
+
+lia_move int_solver::hnf_cut(lar_term & t, mpq & k, bool & upper, explanation & ex) {
+    unsigned n = m_lar_solver.column_count();
+    unsigned max_rows = settings().m_int_hnf_cut_max_rows;
+    // collect the tight rows that contain a fractional integer column
+    vector<hnf_row> rows;
+    std::unordered_map<unsigned, unsigned> var2index;
+    for (unsigned j = 0; j < n && rows.size() < max_rows; j++) {
+        bool lo = at_low(j), up = at_upper(j);
+        if (!lo && !up)
+            continue;
+        impq const & bnd = lo ? low_bound(j) : upper_bound(j);
+        if (!bnd.y.is_zero() || !bnd.x.is_int())
+            continue;
+        hnf_row r;
+        bool ok = true, has_frac = false;
+        if (m_lar_solver.column_is_term(j)) {
+            for (auto const & p : m_lar_solver.get_column_term(j).m_coeffs) {
+                if (!p.second.is_int() || m_lar_solver.column_is_term(p.first) || !column_is_int(p.first)) {
+                    ok = false;
+                    break;
+                }
+                has_frac |= column_is_int_inf(p.first);
+                r.m_coeffs[p.first] = p.second;
+            }
+        }
+        else {
+            // unit rows of fixed columns keep the other rows from being satisfiable by shifting this column.
+            ok = column_is_int(j) && is_fixed(j);
+            r.m_coeffs[j] = one_of_type<mpq>();
+        }
+        if (!ok || (!has_frac && m_lar_solver.column_is_term(j)))
+            continue;
+        r.m_j = j;
+        r.m_is_eq = is_fixed(j);
+        r.m_is_upper = !lo || r.m_is_eq;
+        r.m_b = bnd.x;
+        if (!r.m_is_upper) {
+            for (auto & p : r.m_coeffs)
+                p.second.neg();
+            r.m_b.neg();
+        }
+        rows.push_back(r);
+    }
+    if (rows.empty())
+        return lia_move::give_up;
+    for (auto const & r : rows)
+        for (auto const & p : r.m_coeffs)
+            if (var2index.find(p.first) == var2index.end()) {
+                unsigned idx = static_cast<unsigned>(var2index.size());
+                var2index[p.first] = idx;
+            }
+    unsigned nv = static_cast<unsigned>(var2index.size());
+
+    // select linearly independent rows, equalities first
+    vector<unsigned> order;
+    for (unsigned i = 0; i < rows.size(); i++) if (rows[i].m_is_eq) order.push_back(i);
+    for (unsigned i = 0; i < rows.size(); i++) if (!rows[i].m_is_eq) order.push_back(i);
+    vector<unsigned> basis;           // selected rows
+    vector<vector<mpq>> echelon;      // reduced copies of the selected rows
+    vector<unsigned> pivots;          // pivot position of each reduced row
+    for (unsigned i : order) {
+        vector<mpq> v(nv, zero_of_type<mpq>());
+        for (auto const & p : rows[i].m_coeffs)
+            v[var2index[p.first]] = p.second;
+        for (unsigned e = 0; e < echelon.size(); e++) {
+            mpq const & c = v[pivots[e]];
+            if (is_zero(c)) continue;
+            mpq f = c / echelon[e][pivots[e]];
+            for (unsigned l = 0; l < nv; l++)
+                if (!is_zero(echelon[e][l]))
+                    v[l] -= f * echelon[e][l];
+        }
+        unsigned p = 0;
+        while (p < nv && is_zero(v[p])) p++;
+        if (p == nv)
+            continue;
+        basis.push_back(i);
+        echelon.push_back(v);
+        pivots.push_back(p);
+    }
+    unsigned m = basis.size();
+
+    // bring A to the form [B 0] by unimodular column operations
+    vector<vector<mpq>> A;
+    for (unsigned i : basis) {
+        vector<mpq> v(nv, zero_of_type<mpq>());
+        for (auto const & p : rows[i].m_coeffs)
+            v[var2index[p.first]] = p.second;
+        A.push_back(v);
+    }
+    for (unsigned i = 0; i < m; i++) {
+        for (unsigned j = i + 1; j < nv; j++) {
+            if (is_zero(A[i][j]))
+                continue;
+            if (is_zero(A[i][i])) {
+                for (unsigned r = i; r < m; r++)
+                    std::swap(A[r][i], A[r][j]);
+                continue;
+            }
+            mpq a = A[i][i], b = A[i][j], s, u;
+            mpq g = gcd(a, b, s, u);
+            mpq ag = a / g, bg = b / g;
+            for (unsigned r = i; r < m; r++) {
+                mpq ci = A[r][i], cj = A[r][j];
+                A[r][i] = s * ci + u * cj;
+                A[r][j] = ag * cj - bg * ci;
+                if (!A[r][i].is_int64() || !A[r][j].is_int64())
+                    return lia_move::give_up;
+            }
+        }
+        lean_assert(!is_zero(A[i][i]));
+        if (A[i][i].is_neg())
+            for (unsigned r = i; r < m; r++)
+                A[r][i].neg();
+    }
+
+    // y = B^-1 b
+    vector<mpq> y(m);
+    for (unsigned i = 0; i < m; i++) {
+        mpq v = rows[basis[i]].m_b;
+        for (unsigned l = 0; l < i; l++)
+            v -= A[i][l] * y[l];
+        y[i] = v / A[i][i];
+    }
+    for (unsigned i = 0; i < m; i++) {
+        if (y[i].is_int())
+            continue;
+        // l = e_i B^-1, it is zero beyond i since B is lower triangular
+        vector<mpq> l(m, zero_of_type<mpq>());
+        for (unsigned c = i + 1; c-- > 0; ) {
+            mpq v = c == i ? one_of_type<mpq>() : zero_of_type<mpq>();
+            for (unsigned r = c + 1; r <= i; r++)
+                v -= l[r] * A[r][c];
+            l[c] = v / A[c][c];
+        }
+        int sign = 0;
+        bool mixed = false;
+        for (unsigned r = 0; r <= i && !mixed; r++) {
+            if (is_zero(l[r]) || rows[basis[r]].m_is_eq)
+                continue;
+            int s = l[r].is_pos() ? 1 : -1;
+            mixed = sign != 0 && s != sign;
+            sign = s;
+        }
+        if (mixed)
+            continue;
+        std::unordered_map<unsigned, mpq> cut;
+        for (unsigned r = 0; r <= i; r++) {
+            if (is_zero(l[r]))
+                continue;
+            for (auto const & p : rows[basis[r]].m_coeffs)
+                cut[p.first] += l[r] * p.second;
+        }
+        bool all_int = true, small = true;
+        for (auto const & p : cut) {
+            all_int &= p.second.is_int();
+            small &= is_small_cut_coeff(p.second);
+        }
+        if (!all_int || !small)
+            continue;
+        t.m_coeffs.clear();
+        t.m_v.reset();
+        upper = sign >= 0;
+        k = upper ? floor(y[i]) : ceil(y[i]);
+        for (auto const & p : cut)
+            if (!is_zero(p.second))
+                add_to_term(t, k, p.second, p.first);
+        ex.clear();
+        for (unsigned r = 0; r <= i; r++) {
+            if (is_zero(l[r]))
+                continue;
+            hnf_row const & row = rows[basis[r]];
+            if (row.m_is_eq || row.m_is_upper)
+                ex.push_back(std::make_pair(l[r], upper_witness(row.m_j)));
+            if (row.m_is_eq || !row.m_is_upper)
+                ex.push_back(std::make_pair(l[r], low_witness(row.m_j)));
+        }
+        if (t.m_coeffs.empty()) {
+            if (upper ? !k.is_neg() : !k.is_pos())
+                continue;
+            // 0 <= k with k negative, or 0 >= k with k positive
+            m_stats.m_conflicts++;
+            return lia_move::conflict;
+        }
+        m_stats.m_hnf_cuts++;
+        return lia_move::cut;
+    }
+    return lia_move::give_up;
+}
+
+// ------------------------------------------------------------------
+// Gomory cuts
+
+// cuts derived from the rows of earlier cuts have quickly growing coefficients,
+// and these slow down the simplex. Such cuts are dropped in favor of branching.
+bool int_solver::is_small_cut_coeff(mpq const & a) const {
+    return a.is_small() && abs(a) <= mpq(settings().m_int_cut_max_coeff);
+}
+
+bool int_solver::is_gomory_cut_target(row_t const & row) {
+    for (auto const & p : row) {
+        unsigned j = p.second;
+        if (p.first.is_big())
+            return false;
+        if (!at_low(j) && !at_upper(j))
+            return false;
+        if (column_is_int(j) && (!get_value(j).y.is_zero() || !get_value(j).x.is_int()))
+            return false;
+    }
+    return true;
+}
+
+int int_solver::find_gomory_row() {
+    lar_core_solver & cs = m_lar_solver.m_mpq_lar_core_solver;
+    unsigned m = cs.m_r_basis.size();
+    if (m == 0)
+        return -1;
+    unsigned start = settings().random_next() % m;
+    row_t row;
+    for (unsigned k = 0; k < m; k++) {
+        unsigned i = (start + k) % m;
+        unsigned bj = cs.m_r_basis[i];
+        if (!column_is_int_inf(bj) || !get_value(bj).y.is_zero())
+            continue;
+        get_row(i, row);
+        if (is_gomory_cut_target(row))
+            return i;
+    }
+    return -1;
+}
+
+/**
+   \brief Create a Gomory cut from the row x_b + sum a_j x_j = 0 where x_b is fractional and
+   the columns x_j are at their bounds. The cut has the form sum c_j x_j >= k.
+   See theory_arith<Ext>::mk_gomory_cut.
+*/
+lia_move int_solver::mk_gomory_cut(unsigned i, lar_term & t, mpq & k, bool & upper, explanation & ex) {
+    row_t row;
+    get_row(i, row);
+    unsigned bj = m_lar_solver.m_mpq_lar_core_solver.m_r_basis[i];
+    mpq f_0 = fractional_part(get_value(bj).x);
+    mpq one_minus_f_0 = one_of_type<mpq>() - f_0;
+    lean_assert(!is_zero(f_0) && !is_zero(one_minus_f_0));
+    mpq lcm_den = one_of_type<mpq>();
+    unsigned num_ints = 0;
+    vector<std::pair<mpq, unsigned>> pol;
+    k = one_of_type<mpq>();
+    for (auto const & p : row) {
+        unsigned j = p.second;
+        mpq a = -p.first; // x_b = sum a x_j
+        mpq new_a;
+        if (!column_is_int(j)) {
+            if (at_low(j)) {
+                new_a = a.is_pos() ? a / one_minus_f_0 : -a / f_0;
+                k += new_a * low_bound(j).x;
+                ex.push_back(std::make_pair(new_a, low_witness(j)));
+            }
+            else {
+                new_a = a.is_pos() ? -a / f_0 : a / one_minus_f_0;
+                k += new_a * upper_bound(j).x;
+                ex.push_back(std::make_pair(new_a, upper_witness(j)));
+            }
+            pol.push_back(std::make_pair(new_a, j));
+        }
+        else {
+            ++num_ints;
+            mpq f_j = fractional_part(a);
+            if (is_zero(f_j))
+                continue;
+            if (at_low(j)) {
+                new_a = f_j <= one_minus_f_0 ? f_j / one_minus_f_0 : (one_of_type<mpq>() - f_j) / f_0;
+                k += new_a * low_bound(j).x;
+                ex.push_back(std::make_pair(new_a, low_witness(j)));
+            }
+            else {
+                new_a = f_j <= f_0 ? f_j / f_0 : (one_of_type<mpq>() - f_j) / one_minus_f_0;
+                new_a.neg(); // the upper terms are inverted
+                k += new_a * upper_bound(j).x;
+                ex.push_back(std::make_pair(new_a, upper_witness(j)));
+            }
+            pol.push_back(std::make_pair(new_a, j));
+            lcm_den = lcm(lcm_den, denominator(new_a));
+        }
+    }
+    if (pol.empty()) {
+        // 0 >= k where k is positive
+        m_stats.m_conflicts++;
+        return lia_move::conflict;
+    }
+    if (!k.is_small())
+        return lia_move::give_up;
+    upper = false;
+    t.m_coeffs.clear();
+    t.m_v.reset();
+    if (pol.size() == 1) {
+        unsigned j = pol[0].second;
+        k /= pol[0].first;
+        upper = pol[0].first.is_neg();
+        if (column_is_int(j) && !k.is_int())
+            k = upper ? floor(k) : ceil(k);
+        add_to_term(t, k, one_of_type<mpq>(), j);
+    }
+    else {
+        if (num_ints > 0) {
+            lcm_den = lcm(lcm_den, denominator(k));
+            // normalize the coefficients of integer columns to be integers.
+            for (auto & p : pol)
+                p.first *= lcm_den;
+            k *= lcm_den;
+        }
+        for (auto const & p : pol) {
+            if (!is_small_cut_coeff(p.first))
+                return lia_move::give_up;
+            add_to_term(t, k, p.first, p.second);
+        }
+    }
+    m_stats.m_gomory_cuts++;
+    return lia_move::cut;
+}
+
+// ------------------------------------------------------------------
+// branching
+
+int int_solver::find_inf_int_column() {
+    unsigned n = m_lar_solver.column_count();
+    int result = -1;
+    mpq range;
+    bool boxed = false;
+    unsigned num_candidates = 0;
+    for (unsigned j = 0; j < n; j++) {
+        if (!column_is_int_inf(j))
+            continue;
+        if (is_boxed(j)) {
+            mpq r = upper_bound(j).x - low_bound(j).x;
+            if (!boxed || r < range) {
+                boxed = true;
+                range = r;
+                result = j;
+            }
+        }
+        else if (!boxed && settings().random_next() % (++num_candidates) == 0) {
+            result = j;
+        }
+    }
+    return result;
+}
+
+lia_move int_solver::check(lar_term & t, mpq & k, bool & upper, explanation & ex) {
+    if (!m_lar_solver.has_int_var())
+        return lia_move::ok;
+    lean_assert(m_lar_solver.get_status() == OPTIMAL || m_lar_solver.get_status() == FEASIBLE);
+    m_stats.m_checks++;
+    ex.clear();
+    t.m_coeffs.clear();
+    t.m_v.reset();
+    patch_nbasic_columns();
+    if (!has_inf_int())
+        return lia_move::ok;
+
+    unsigned cube_period = settings().m_int_cube_period;
+    if (cube_period != 0 && m_stats.m_checks % cube_period == 0 && find_cube())
+        return lia_move::ok;
+
+    unsigned hnf_period = settings().m_int_hnf_cut_period;
+    if (hnf_period != 0 && m_stats.m_checks % hnf_period == 0) {
+        lia_move r = hnf_cut(t, k, upper, ex);
+        if (r != lia_move::give_up)
+            return r;
+        ex.clear();
+        t.m_coeffs.clear();
+    }
+
+    unsigned ratio = settings().m_int_branch_cut_ratio;
+    if (ratio != 0 && m_stats.m_checks % ratio == 0) {
+        int i = find_gomory_row();
+        if (i != -1) {
+            lia_move r = mk_gomory_cut(i, t, k, upper, ex);
+            if (r != lia_move::give_up)
+                return r;
+            ex.clear();
+            t.m_coeffs.clear();
+        }
+    }
+
+    int j = find_inf_int_column();
+    if (j == -1)
+        return lia_move::ok;
+    m_stats.m_branches++;
+    k = floor_impq(get_value(j));
+    upper = true;
+    add_to_term(t, k, one_of_type<mpq>(), j);
+    return lia_move::branch;
+}
+
+}
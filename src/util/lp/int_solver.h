@@ -0,0 +1,112 @@
+/*
+  Copyright (c) 2017 Microsoft Corporation
+  Author: agent (agent@local) 2026-10-16
+*/
+#pragma once
+#include "util/vector.h"
+#include "util/lp/lp_settings.h"
+#include "util/lp/numeric_pair.h"
+#include "util/lp/lar_term.h"
+
+namespace lean {
+class lar_solver; // forward definition
+
+enum class lia_move {
+    ok,        // all integer columns have integral values
+    branch,    // split on t <= k or t > k
+    cut,       // the explanation implies the cut t <= k (or t >= k), which the current solution violates
+    conflict,  // the explanation is infeasible over the integers
+    give_up
+};
+
+typedef vector<std::pair<mpq, constraint_index>> explanation;
+
+/**
+   Integer reasoning on top of lar_solver. It is invoked when the rational
+   relaxation is feasible, and either patches the solution to an integral one
+   or produces a branch, a cut, or a conflict, in the spirit of
+   theory_arith_int.h:
+
+   - patching moves non-basic integer columns to integral values when this keeps the basic columns feasible,
+   - the cube test (Bromberger, Weidenbach) solves the relaxation with the term bounds shrunk
+     by half of the norm of their integer part, so that rounding the solution keeps it feasible,
+   - Hermite normal form cuts (Christ, Hoenicke) are derived from the tight integer rows,
+   - Gomory cuts are derived from a tableau row of a fractional basic column,
+   - otherwise it branches on a fractional column.
+*/
+class int_solver {
+public:
+    struct stats {
+        unsigned m_checks;
+        unsigned m_patches;
+        unsigned m_cube_calls;
+        unsigned m_cube_success;
+        unsigned m_hnf_cuts;
+        unsigned m_gomory_cuts;
+        unsigned m_branches;
+        unsigned m_conflicts;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+
+private:
+    lar_solver & m_lar_solver;
+    stats        m_stats;
+
+    // a row in the form x_b + sum a_j x_j = 0 with the basic column x_b omitted.
+    typedef vector<std::pair<mpq, unsigned>> row_t;
+
+    lp_settings & settings();
+    lp_settings const & settings() const;
+    vector<impq> & x();
+    const impq & get_value(unsigned j);
+    bool column_is_int(unsigned j) const;
+    bool column_is_int_inf(unsigned j);
+    bool has_inf_int();
+    bool has_low(unsigned j) const;
+    bool has_upper(unsigned j) const;
+    const impq & low_bound(unsigned j) const;
+    const impq & upper_bound(unsigned j) const;
+    bool at_low(unsigned j);
+    bool at_upper(unsigned j);
+    bool is_fixed(unsigned j) const;
+    bool is_boxed(unsigned j) const;
+    bool is_basic(unsigned j) const;
+    constraint_index low_witness(unsigned j) const;
+    constraint_index upper_witness(unsigned j) const;
+    void get_row(unsigned i, row_t & row);
+    void add_to_term(lar_term & t, mpq & k, mpq const & coeff, unsigned j);
+
+    // patching
+    void patch_nbasic_columns();
+    bool patch_nbasic_column(unsigned j, impq const & v);
+
+    // cube
+    bool find_cube();
+    bool round_and_check();
+
+    // HNF cuts
+    lia_move hnf_cut(lar_term & t, mpq & k, bool & upper, explanation & ex);
+
+    // Gomory cuts
+    bool is_small_cut_coeff(mpq const & a) const;
+    bool is_gomory_cut_target(row_t const & row);
+    int find_gomory_row();
+    lia_move mk_gomory_cut(unsigned i, lar_term & t, mpq & k, bool & upper, explanation & ex);
+
+    // branching
+    int find_inf_int_column();
+
+public:
+    int_solver(lar_solver & s);
+
+    /**
+       \brief Check that the integer columns have integral values in the current feasible solution.
+       On branch and cut, t <= k if upper is true, and t >= k otherwise.
+       The term t is over variable and term indices of the lar_solver.
+    */
+    lia_move check(lar_term & t, mpq & k, bool & upper, explanation & ex);
+
+    stats const & st() const { return m_stats; }
+};
+}
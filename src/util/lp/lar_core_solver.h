@@ -292,7 +292,7 @@ public:
             case column_type::boxed:
                 if (x > m_r_solver.m_upper_bounds[j]) {
                     delta = m_r_solver.m_upper_bounds[j] - x;
-                    x += m_r_solver.m_upper_bounds[j];
+                    x = m_r_solver.m_upper_bounds[j];
                 } else {
                     delta = m_r_solver.m_low_bounds[j] - x;
                     x = m_r_solver.m_low_bounds[j];
@@ -496,6 +496,30 @@ public:
         lean_assert(r_basis_is_OK());
     }
 
+    // The double solver gets a copy of the rational tableau, where the basis matrix is the identity.
+    void init_double_tableau() {
+        m_d_A.clear();
+        m_d_A.m_rows.resize(m_r_A.row_count());
+        m_d_A.m_columns.resize(m_r_A.column_count());
+        create_double_matrix(m_d_A);
+        fill_basis_d(m_d_basis, m_d_heading, m_d_nbasis);
+        m_d_x.resize(m_r_A.column_count());
+        init_factorization(m_d_solver.m_factorization, m_d_A, m_d_basis, settings());
+    }
+
+    // In the tableau mode the double solver is not kept in sync with the rational one between solves.
+    void clear_double_tableau() {
+        m_d_A.clear();
+        m_d_x.reset();
+        delete m_d_solver.m_factorization;
+        m_d_solver.m_factorization = nullptr;
+        m_d_basis = m_r_basis;
+        m_d_heading = m_r_heading;
+        m_d_nbasis = m_r_nbasis;
+    }
+
+    void solve_with_doubles_first();
+
     bool adjust_x_of_column(unsigned j) {
         /*
         if (m_r_solver.m_basis_heading[j] >= 0) {
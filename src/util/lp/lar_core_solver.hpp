@@ -242,6 +242,39 @@ void lar_core_solver::fill_not_improvable_zero_sum() {
 }
 
 
+// The pivoting runs on a double copy of the tableau with the LU based primal simplex.
+// The basis it ends with is then installed in the rational tableau, and the rational
+// solution on this basis is verified. If it is not feasible, which happens when the
+// doubles went wrong, the rational simplex repairs it starting from this basis.
+void lar_core_solver::solve_with_doubles_first() {
+    lean_assert(settings().use_tableau());
+    simplex_strategy_enum strategy = settings().simplex_strategy();
+    settings().simplex_strategy() = simplex_strategy_enum::lu;
+    init_double_tableau();
+    prefix_d();
+    m_d_solver.set_status(UNKNOWN);
+    lar_solution_signature signature;
+    vector<unsigned> changes_of_basis = find_solution_signature_with_doubles(signature);
+    settings().simplex_strategy() = strategy;
+    if (m_d_solver.get_status() == TIME_EXHAUSTED) {
+        clear_double_tableau();
+        m_r_solver.set_status(TIME_EXHAUSTED);
+        return;
+    }
+    stats & st = settings().st();
+    st.m_float_first_solves++;
+    if (!catch_up_in_lu_tableau(changes_of_basis, m_d_solver.m_basis_heading))
+        st.m_float_first_fallbacks++;
+    clear_double_tableau();
+    prepare_solver_x_with_signature_tableau(signature);
+    m_r_solver.find_feasible_solution();
+    if (m_r_solver.total_iterations() > 0) {
+        st.m_float_first_repairs++;
+        st.m_float_first_repair_iterations += m_r_solver.total_iterations();
+    }
+    lean_assert(r_basis_is_OK());
+}
+
 void lar_core_solver::solve() {
     lean_assert(m_r_solver.non_basic_columns_are_set_correctly());
     lean_assert(m_r_solver.inf_set_is_correct());
@@ -265,6 +298,10 @@ void lar_core_solver::solve() {
         else 
             solve_on_signature(solution_signature, changes_of_basis);
         lean_assert(!settings().use_tableau() || r_basis_is_OK());
+    } else if (settings().m_float_first && settings().use_tableau() && m_r_solver.m_look_for_feasible_solution_only) {
+        solve_with_doubles_first();
+        if (m_r_solver.get_status() == TIME_EXHAUSTED)
+            return;
     } else {
         if (!settings().use_tableau()) {
             bool snapped = m_r_solver.snap_non_basic_x_to_bound();   
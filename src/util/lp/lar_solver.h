@@ -39,6 +39,7 @@ class lar_solver : public column_namer {
     stacked_value<simplex_strategy_enum>    m_simplex_strategy;
     std::unordered_map<unsigned, var_index> m_ext_vars_to_columns;
     vector<unsigned>                        m_columns_to_ext_vars_or_term_indices;
+    vector<bool>                            m_column_is_int; // parallel to m_columns_to_ext_vars_or_term_indices
     stacked_vector<ul_pair>                 m_vars_to_ul_pairs;
     vector<lar_base_constraint*>            m_constraints;
     stacked_value<unsigned>                 m_constraint_count;
@@ -347,6 +348,38 @@ public:
         unsigned ext_var_or_term = m_columns_to_ext_vars_or_term_indices[j];
         return ext_var_or_term < m_terms_start_index ? j : ext_var_or_term;
     }
+
+    unsigned column_count() const { return A_r().column_count(); }
+
+    bool column_is_term(unsigned j) const {
+        return m_columns_to_ext_vars_or_term_indices[j] >= m_terms_start_index;
+    }
+
+    // the term of a term column, the column value is the term without its free coefficient
+    const lar_term & get_column_term(unsigned j) const {
+        lean_assert(column_is_term(j));
+        return *m_orig_terms[m_columns_to_ext_vars_or_term_indices[j] - m_terms_start_index];
+    }
+
+    // a term column is integral if its term has integer coefficients over integer columns
+    bool column_is_int(unsigned j) const { return m_column_is_int[j]; }
+
+    bool has_int_var() const {
+        for (unsigned j = 0; j < m_column_is_int.size(); j++)
+            if (m_column_is_int[j] && !column_is_term(j))
+                return true;
+        return false;
+    }
+
+    constraint_index column_low_bound_witness(unsigned j) const {
+        const ul_pair & ul = m_vars_to_ul_pairs[j];
+        return ul.low_bound_witness();
+    }
+
+    constraint_index column_upper_bound_witness(unsigned j) const {
+        const ul_pair & ul = m_vars_to_ul_pairs[j];
+        return ul.upper_bound_witness();
+    }
     
     void propagate_bounds_on_a_term(const lar_term& t, bound_propagator & bp, unsigned term_offset) {
         lean_assert(false); // not implemented
@@ -490,6 +523,7 @@ public:
 		for (unsigned j = n_was; j-- > n;)
 			m_ext_vars_to_columns.erase(m_columns_to_ext_vars_or_term_indices[j]);
 		m_columns_to_ext_vars_or_term_indices.resize(n);
+		m_column_is_int.resize(n);
 		if (m_settings.use_tableau()) {
             pop_tableau();
         }
@@ -687,4 +687,7 @@ public:
         return m_iters_with_no_cost_growing;
     }
 };
+
+// the double instantiation updates the basic columns with a vector kernel
+template <> void lp_core_solver_base<double, double>::update_x(unsigned entering, const double & delta);
 }
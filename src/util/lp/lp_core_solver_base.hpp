@@ -331,6 +331,17 @@ update_x(unsigned entering, const X& delta) {
         }
 }
 
+template <> void lp_core_solver_base<double, double>::update_x(unsigned entering, const double & delta) {
+    m_x[entering] += delta;
+    if (!use_tableau())
+        simd::axpy_on_index(m_x.c_ptr(), m_basis.c_ptr(), m_ed.m_data.c_ptr(), m_ed.m_index.c_ptr(), m_ed.m_index.size(), delta, m_copy_of_xB.c_ptr());
+    else 
+        for (const auto & c : m_A.m_columns[entering]) {
+            unsigned i = c.m_i;
+            m_x[m_basis[i]] -= delta * m_A.get_val(c);
+        }
+}
+
 
 template <typename T, typename X> void lp_core_solver_base<T, X>::
 print_statistics(char const* str, X cost, std::ostream & out) {
@@ -41,7 +41,6 @@ template void lean::lp_core_solver_base<double, double>::solve_Bd(unsigned int);
 template void lean::lp_core_solver_base<lean::mpq, lean::numeric_pair<lean::mpq>>::solve_Bd(unsigned int, indexed_vector<lean::mpq>&);
 template void lean::lp_core_solver_base<double, double>::solve_yB(vector<double >&);
 template bool lean::lp_core_solver_base<double, double>::update_basis_and_x(int, int, double const&);
-template void lean::lp_core_solver_base<double, double>::update_x(unsigned int, const double&);
 template bool lean::lp_core_solver_base<lean::mpq, lean::mpq>::A_mult_x_is_off() const;
 template bool lean::lp_core_solver_base<lean::mpq, lean::mpq>::A_mult_x_is_off_on_index(const vector<unsigned> &) const;
 template bool lean::lp_core_solver_base<lean::mpq, lean::mpq>::basis_heading_is_correct() const ;
@@ -80,6 +80,10 @@ struct stats {
     unsigned m_num_factorizations;
     unsigned m_num_of_implied_bounds;
     unsigned m_need_to_solve_inf;
+    unsigned m_float_first_solves;            // solves that pivoted in doubles first
+    unsigned m_float_first_repairs;           // solves where the basis found in doubles needed rational pivots
+    unsigned m_float_first_repair_iterations; // the rational pivots of these repairs
+    unsigned m_float_first_fallbacks;         // solves where the basis found in doubles was singular in rationals
     stats() { reset(); }
     void reset() { memset(this, 0, sizeof(*this)); }
 };
@@ -189,6 +193,7 @@ public:
                     relative_primal_feasibility_tolerance ( 1e-9), // page 71 of the PhD thesis of Achim Koberstein
                     m_bound_propagation ( true),
                     presolve_with_double_solver_for_lar(true),
+                    m_float_first(false),
                     m_simplex_strategy(simplex_strategy_enum::tableau_rows),
                     report_frequency(1000),
                     print_statistics(false),
@@ -198,7 +203,12 @@ public:
                     use_breakpoints_in_feasibility_search(false),
                     max_row_length_for_bound_propagation(300),
                     backup_costs(true),
-                    column_number_threshold_for_using_lu_in_lar_solver(4000)
+                    column_number_threshold_for_using_lu_in_lar_solver(4000),
+                    m_int_branch_cut_ratio(2),
+                    m_int_hnf_cut_period(4),
+                    m_int_hnf_cut_max_rows(50),
+                    m_int_cube_period(4),
+                    m_int_cut_max_coeff(1000)
     {}
 
     void set_resource_limit(lp_resource_limit& lim) { m_resource_limit = &lim; }
@@ -269,6 +279,8 @@ public:
     }
     // the method of lar solver to use
     bool presolve_with_double_solver_for_lar;
+    // with a tableau strategy, look for a feasible basis in doubles first, then verify and repair it in rationals
+    bool m_float_first;
     simplex_strategy_enum m_simplex_strategy;
     simplex_strategy_enum simplex_strategy() const {
         return m_simplex_strategy;
@@ -305,6 +317,12 @@ public:
     unsigned max_row_length_for_bound_propagation;
     bool backup_costs;
     unsigned column_number_threshold_for_using_lu_in_lar_solver;
+    // integer section, see int_solver
+    unsigned m_int_branch_cut_ratio;    // every m_int_branch_cut_ratio-th check tries a Gomory cut, 0 disables them
+    unsigned m_int_hnf_cut_period;      // every m_int_hnf_cut_period-th check tries a HNF cut, 0 disables them
+    unsigned m_int_hnf_cut_max_rows;    // the maximal number of tight rows a HNF cut is computed from
+    unsigned m_int_cube_period;         // every m_int_cube_period-th check tries the cube test, 0 disables it
+    unsigned m_int_cut_max_coeff;       // cuts with bigger coefficients are dropped in favor of branching
 }; // end of lp_settings class
 
 
@@ -0,0 +1,464 @@
+/*
+  Copyright (c) 2017 Microsoft Corporation
+  Author: agent (agent@local) 2026-10-16
+*/
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include "util/lp/lp_simd.h"
+#include "util/lp/static_matrix.h"
+
+// The vector kernels are compiled with function level target attributes and chosen at run time,
+// so the rest of z3 keeps the default compiler flags. Other compilers get the scalar kernels.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LP_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace lean {
+
+// the kernels read two consecutive row cells as four doubles: m_j and m_offset, then m_value
+static_assert(sizeof(row_cell<double>) == 2 * sizeof(double) && offsetof(row_cell<double>, m_value) == sizeof(double),
+              "unexpected layout of row_cell<double>");
+
+namespace simd {
+
+static double dot_row_scalar(row_cell<double> const * row, unsigned sz, double const * w) {
+    double ret = 0.0;
+    for (unsigned k = 0; k < sz; k++)
+        ret += w[row[k].m_j] * row[k].m_value;
+    return ret;
+}
+
+static double max_abs_row_scalar(row_cell<double> const * row, unsigned sz) {
+    double ret = 0.0;
+    for (unsigned k = 0; k < sz; k++) {
+        double a = std::fabs(row[k].m_value);
+        if (a > ret)
+            ret = a;
+    }
+    return ret;
+}
+
+static double min_abs_row_scalar(row_cell<double> const * row, unsigned sz) {
+    if (sz == 0)
+        return 0.0;
+    double ret = std::fabs(row[0].m_value);
+    for (unsigned k = 1; k < sz; k++) {
+        double a = std::fabs(row[k].m_value);
+        if (a < ret)
+            ret = a;
+    }
+    return ret;
+}
+
+static void axpy_on_index_scalar(double * x, unsigned const * basis, double const * ed, unsigned const * index, unsigned sz, double delta, double * copy) {
+    for (unsigned k = 0; k < sz; k++) {
+        unsigned i = index[k];
+        double & xj = x[basis[i]];
+        if (copy != nullptr)
+            copy[i] = xj;
+        xj -= delta * ed[i];
+    }
+}
+
+static unsigned drop_small_on_index_scalar(double * data, unsigned * index, unsigned sz, double eps) {
+    unsigned n = 0;
+    for (unsigned k = 0; k < sz; k++) {
+        unsigned i = index[k];
+        if (std::fabs(data[i]) < eps)
+            data[i] = 0.0;
+        else
+            index[n++] = i;
+    }
+    return n;
+}
+
+#ifdef LP_SIMD_X86
+
+// SSE4.1: two cells at a time, the column values are loaded one by one
+
+__attribute__((target("sse4.1")))
+static double dot_row_sse4_1(row_cell<double> const * row, unsigned sz, double const * w) {
+    __m128d acc = _mm_setzero_pd();
+    unsigned k = 0;
+    for (; k + 2 <= sz; k += 2) {
+        __m128d v = _mm_unpackhi_pd(_mm_loadu_pd(reinterpret_cast<double const*>(row + k)),
+                                    _mm_loadu_pd(reinterpret_cast<double const*>(row + k + 1)));
+        __m128d wv = _mm_loadh_pd(_mm_load_sd(w + row[k].m_j), w + row[k + 1].m_j);
+        acc = _mm_add_pd(acc, _mm_mul_pd(v, wv));
+    }
+    double ret = _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+    for (; k < sz; k++)
+        ret += w[row[k].m_j] * row[k].m_value;
+    return ret;
+}
+
+__attribute__((target("sse4.1")))
+static double max_abs_row_sse4_1(row_cell<double> const * row, unsigned sz) {
+    __m128d abs_mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    __m128d acc = _mm_setzero_pd();
+    unsigned k = 0;
+    for (; k + 2 <= sz; k += 2) {
+        __m128d v = _mm_unpackhi_pd(_mm_loadu_pd(reinterpret_cast<double const*>(row + k)),
+                                    _mm_loadu_pd(reinterpret_cast<double const*>(row + k + 1)));
+        acc = _mm_max_pd(acc, _mm_and_pd(v, abs_mask));
+    }
+    double ret = _mm_cvtsd_f64(_mm_max_sd(acc, _mm_unpackhi_pd(acc, acc)));
+    return std::max(ret, max_abs_row_scalar(row + k, sz - k));
+}
+
+__attribute__((target("sse4.1")))
+static double min_abs_row_sse4_1(row_cell<double> const * row, unsigned sz) {
+    if (sz < 2)
+        return min_abs_row_scalar(row, sz);
+    __m128d abs_mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    __m128d acc = _mm_set1_pd(std::fabs(row[0].m_value));
+    unsigned k = 0;
+    for (; k + 2 <= sz; k += 2) {
+        __m128d v = _mm_unpackhi_pd(_mm_loadu_pd(reinterpret_cast<double const*>(row + k)),
+                                    _mm_loadu_pd(reinterpret_cast<double const*>(row + k + 1)));
+        acc = _mm_min_pd(acc, _mm_and_pd(v, abs_mask));
+    }
+    double ret = _mm_cvtsd_f64(_mm_min_sd(acc, _mm_unpackhi_pd(acc, acc)));
+    return k < sz ? std::min(ret, min_abs_row_scalar(row + k, sz - k)) : ret;
+}
+
+// AVX2: four cells at a time, the column values are gathered
+
+// GCC seeds the unmasked gathers, and the unmasked AVX-512 forms below, with an undefined
+// register, which trips -Wmaybe-uninitialized once they are inlined. The kernels use the
+// masked forms with a zero source instead.
+__attribute__((target("avx2")))
+static __m256d gather_avx2(double const * base, __m128i idx) {
+    __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, idx, all, 8);
+}
+
+__attribute__((target("avx2")))
+static double hsum_avx2(__m256d v) {
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+__attribute__((target("avx2")))
+static double hmax_avx2(__m256d v) {
+    __m128d s = _mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_max_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+__attribute__((target("avx2")))
+static double hmin_avx2(__m256d v) {
+    __m128d s = _mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_min_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+// Loads the cells k, ..., k + 3 of the row. The values and the column indices come in the same order.
+__attribute__((target("avx2")))
+static __m256d load_cells_avx2(row_cell<double> const * row, __m256i & j) {
+    __m256d a = _mm256_loadu_pd(reinterpret_cast<double const*>(row));
+    __m256d b = _mm256_loadu_pd(reinterpret_cast<double const*>(row + 2));
+    j = _mm256_and_si256(_mm256_castpd_si256(_mm256_unpacklo_pd(a, b)), _mm256_set1_epi64x(0xffffffffLL));
+    return _mm256_unpackhi_pd(a, b);
+}
+
+__attribute__((target("avx2")))
+static double dot_row_avx2(row_cell<double> const * row, unsigned sz, double const * w) {
+    __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    __m256d acc = _mm256_setzero_pd();
+    unsigned k = 0;
+    for (; k + 4 <= sz; k += 4) {
+        __m256i j;
+        __m256d v = load_cells_avx2(row + k, j);
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(v, _mm256_mask_i64gather_pd(_mm256_setzero_pd(), w, j, all, 8)));
+    }
+    return hsum_avx2(acc) + dot_row_scalar(row + k, sz - k, w);
+}
+
+__attribute__((target("avx2")))
+static double max_abs_row_avx2(row_cell<double> const * row, unsigned sz) {
+    __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d acc = _mm256_setzero_pd();
+    unsigned k = 0;
+    for (; k + 4 <= sz; k += 4) {
+        __m256i j;
+        __m256d v = load_cells_avx2(row + k, j);
+        acc = _mm256_max_pd(acc, _mm256_and_pd(v, abs_mask));
+    }
+    return std::max(hmax_avx2(acc), max_abs_row_scalar(row + k, sz - k));
+}
+
+__attribute__((target("avx2")))
+static double min_abs_row_avx2(row_cell<double> const * row, unsigned sz) {
+    if (sz < 4)
+        return min_abs_row_scalar(row, sz);
+    __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d acc = _mm256_set1_pd(std::fabs(row[0].m_value));
+    unsigned k = 0;
+    for (; k + 4 <= sz; k += 4) {
+        __m256i j;
+        __m256d v = load_cells_avx2(row + k, j);
+        acc = _mm256_min_pd(acc, _mm256_and_pd(v, abs_mask));
+    }
+    double ret = hmin_avx2(acc);
+    return k < sz ? std::min(ret, min_abs_row_scalar(row + k, sz - k)) : ret;
+}
+
+// there is no scatter in AVX2, so the new values are stored one by one
+__attribute__((target("avx2")))
+static void axpy_on_index_avx2(double * x, unsigned const * basis, double const * ed, unsigned const * index, unsigned sz, double delta, double * copy) {
+    __m256d d = _mm256_set1_pd(delta);
+    unsigned k = 0;
+    for (; k + 4 <= sz; k += 4) {
+        __m128i idx = _mm_loadu_si128(reinterpret_cast<__m128i const*>(index + k));
+        __m128i bj = _mm_i32gather_epi32(reinterpret_cast<int const*>(basis), idx, 4);
+        __m256d xv = gather_avx2(x, bj);
+        __m256d nx = _mm256_sub_pd(xv, _mm256_mul_pd(d, gather_avx2(ed, idx)));
+        double xs[4], nxs[4];
+        unsigned bs[4];
+        _mm256_storeu_pd(xs, xv);
+        _mm256_storeu_pd(nxs, nx);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bs), bj);
+        for (unsigned l = 0; l < 4; l++) {
+            if (copy != nullptr)
+                copy[index[k + l]] = xs[l];
+            x[bs[l]] = nxs[l];
+        }
+    }
+    axpy_on_index_scalar(x, basis, ed, index + k, sz - k, delta, copy);
+}
+
+__attribute__((target("avx2")))
+static unsigned drop_small_on_index_avx2(double * data, unsigned * index, unsigned sz, double eps) {
+    __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d e = _mm256_set1_pd(eps);
+    unsigned n = 0, k = 0;
+    for (; k + 4 <= sz; k += 4) {
+        __m128i idx = _mm_loadu_si128(reinterpret_cast<__m128i const*>(index + k));
+        __m256d v = _mm256_and_pd(gather_avx2(data, idx), abs_mask);
+        int small = _mm256_movemask_pd(_mm256_cmp_pd(v, e, _CMP_LT_OQ));
+        unsigned is[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(is), idx);
+        for (unsigned l = 0; l < 4; l++) {
+            if (small & (1 << l))
+                data[is[l]] = 0.0;
+            else
+                index[n++] = is[l];
+        }
+    }
+    for (; k < sz; k++) {
+        unsigned i = index[k];
+        if (std::fabs(data[i]) < eps)
+            data[i] = 0.0;
+        else
+            index[n++] = i;
+    }
+    return n;
+}
+
+// AVX-512: eight cells at a time, with gather, scatter and compress
+
+__attribute__((target("avx512f")))
+static __m512d gather_avx512(double const * base, __m256i idx) {
+    return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xff, idx, base, 8);
+}
+
+__attribute__((target("avx512f")))
+static __m256d low_half_avx512(__m512d v) {
+    return _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xf, v, 0);
+}
+
+__attribute__((target("avx512f")))
+static __m256d high_half_avx512(__m512d v) {
+    return _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xf, v, 1);
+}
+
+__attribute__((target("avx512f")))
+static __m512d load_cells_avx512(row_cell<double> const * row, __m512i & j) {
+    __m512d a = _mm512_loadu_pd(reinterpret_cast<double const*>(row));
+    __m512d b = _mm512_loadu_pd(reinterpret_cast<double const*>(row + 4));
+    j = _mm512_and_si512(_mm512_castpd_si512(_mm512_maskz_unpacklo_pd(0xff, a, b)), _mm512_set1_epi64(0xffffffffLL));
+    return _mm512_maskz_unpackhi_pd(0xff, a, b);
+}
+
+__attribute__((target("avx512f")))
+static double dot_row_avx512(row_cell<double> const * row, unsigned sz, double const * w) {
+    __m512d acc = _mm512_setzero_pd();
+    unsigned k = 0;
+    for (; k + 8 <= sz; k += 8) {
+        __m512i j;
+        __m512d v = load_cells_avx512(row + k, j);
+        acc = _mm512_add_pd(acc, _mm512_mul_pd(v, _mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xff, j, w, 8)));
+    }
+    return hsum_avx2(_mm256_add_pd(low_half_avx512(acc), high_half_avx512(acc))) + dot_row_scalar(row + k, sz - k, w);
+}
+
+__attribute__((target("avx512f")))
+static double max_abs_row_avx512(row_cell<double> const * row, unsigned sz) {
+    __m512d acc = _mm512_setzero_pd();
+    unsigned k = 0;
+    for (; k + 8 <= sz; k += 8) {
+        __m512i j;
+        acc = _mm512_maskz_max_pd(0xff, acc, _mm512_abs_pd(load_cells_avx512(row + k, j)));
+    }
+    return std::max(hmax_avx2(_mm256_max_pd(low_half_avx512(acc), high_half_avx512(acc))), max_abs_row_scalar(row + k, sz - k));
+}
+
+__attribute__((target("avx512f")))
+static double min_abs_row_avx512(row_cell<double> const * row, unsigned sz) {
+    if (sz < 8)
+        return min_abs_row_scalar(row, sz);
+    __m512d acc = _mm512_set1_pd(std::fabs(row[0].m_value));
+    unsigned k = 0;
+    for (; k + 8 <= sz; k += 8) {
+        __m512i j;
+        acc = _mm512_maskz_min_pd(0xff, acc, _mm512_abs_pd(load_cells_avx512(row + k, j)));
+    }
+    double ret = hmin_avx2(_mm256_min_pd(low_half_avx512(acc), high_half_avx512(acc)));
+    return k < sz ? std::min(ret, min_abs_row_scalar(row + k, sz - k)) : ret;
+}
+
+__attribute__((target("avx512f")))
+static void axpy_on_index_avx512(double * x, unsigned const * basis, double const * ed, unsigned const * index, unsigned sz, double delta, double * copy) {
+    __m512d d = _mm512_set1_pd(delta);
+    unsigned k = 0;
+    for (; k + 8 <= sz; k += 8) {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(index + k));
+        __m256i bj = _mm256_i32gather_epi32(reinterpret_cast<int const*>(basis), idx, 4);
+        __m512d xv = gather_avx512(x, bj);
+        if (copy != nullptr)
+            _mm512_i32scatter_pd(copy, idx, xv, 8);
+        // the basis columns are distinct, so the lanes of the scatter do not collide
+        _mm512_i32scatter_pd(x, bj, _mm512_sub_pd(xv, _mm512_mul_pd(d, gather_avx512(ed, idx))), 8);
+    }
+    axpy_on_index_scalar(x, basis, ed, index + k, sz - k, delta, copy);
+}
+
+__attribute__((target("avx512f")))
+static unsigned drop_small_on_index_avx512(double * data, unsigned * index, unsigned sz, double eps) {
+    __m512d e = _mm512_set1_pd(eps);
+    __m512d zero = _mm512_setzero_pd();
+    unsigned n = 0, k = 0;
+    for (; k + 16 <= sz; k += 16) {
+        __m512i idx = _mm512_loadu_si512(index + k);
+        __m256i lo = _mm512_mask_extracti64x4_epi64(_mm256_setzero_si256(), 0xf, idx, 0);
+        __m256i hi = _mm512_mask_extracti64x4_epi64(_mm256_setzero_si256(), 0xf, idx, 1);
+        __mmask8 small_lo = _mm512_cmp_pd_mask(_mm512_abs_pd(gather_avx512(data, lo)), e, _CMP_LT_OQ);
+        __mmask8 small_hi = _mm512_cmp_pd_mask(_mm512_abs_pd(gather_avx512(data, hi)), e, _CMP_LT_OQ);
+        _mm512_mask_i32scatter_pd(data, small_lo, lo, zero, 8);
+        _mm512_mask_i32scatter_pd(data, small_hi, hi, zero, 8);
+        __mmask16 keep = static_cast<__mmask16>(~(small_lo | (small_hi << 8)));
+        // n <= k, so the compressed entries land on the part of index that is already loaded
+        _mm512_mask_compressstoreu_epi32(index + n, keep, idx);
+        n += __builtin_popcount(keep);
+    }
+    for (; k < sz; k++) {
+        unsigned i = index[k];
+        if (std::fabs(data[i]) < eps)
+            data[i] = 0.0;
+        else
+            index[n++] = i;
+    }
+    return n;
+}
+
+static simd_level detect_level() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return simd_level::avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return simd_level::avx2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return simd_level::sse4_1;
+    return simd_level::scalar;
+}
+
+#else
+
+static simd_level detect_level() {
+    return simd_level::scalar;
+}
+
+#endif
+
+static simd_level g_supported_level = detect_level();
+static simd_level g_level = g_supported_level;
+
+simd_level supported_level() {
+    return g_supported_level;
+}
+
+simd_level level() {
+    return g_level;
+}
+
+void set_level(simd_level l) {
+    g_level = l < g_supported_level ? l : g_supported_level;
+}
+
+const char * level_to_string(simd_level l) {
+    switch (l) {
+    case simd_level::scalar: return "scalar";
+    case simd_level::sse4_1: return "sse4.1";
+    case simd_level::avx2:   return "avx2";
+    case simd_level::avx512: return "avx512";
+    default: lean_unreachable();
+    }
+    return "unknown"; // it is unreachable
+}
+
+double dot_row(row_cell<double> const * row, unsigned sz, double const * w) {
+    switch (g_level) {
+#ifdef LP_SIMD_X86
+    case simd_level::avx512: return dot_row_avx512(row, sz, w);
+    case simd_level::avx2:   return dot_row_avx2(row, sz, w);
+    case simd_level::sse4_1: return dot_row_sse4_1(row, sz, w);
+#endif
+    default: return dot_row_scalar(row, sz, w);
+    }
+}
+
+double max_abs_row(row_cell<double> const * row, unsigned sz) {
+    switch (g_level) {
+#ifdef LP_SIMD_X86
+    case simd_level::avx512: return max_abs_row_avx512(row, sz);
+    case simd_level::avx2:   return max_abs_row_avx2(row, sz);
+    case simd_level::sse4_1: return max_abs_row_sse4_1(row, sz);
+#endif
+    default: return max_abs_row_scalar(row, sz);
+    }
+}
+
+double min_abs_row(row_cell<double> const * row, unsigned sz) {
+    switch (g_level) {
+#ifdef LP_SIMD_X86
+    case simd_level::avx512: return min_abs_row_avx512(row, sz);
+    case simd_level::avx2:   return min_abs_row_avx2(row, sz);
+    case simd_level::sse4_1: return min_abs_row_sse4_1(row, sz);
+#endif
+    default: return min_abs_row_scalar(row, sz);
+    }
+}
+
+// the 128 bit registers do not pay off on the indexed kernels, they go scalar below AVX2
+void axpy_on_index(double * x, unsigned const * basis, double const * ed, unsigned const * index, unsigned sz, double delta, double * copy) {
+    switch (g_level) {
+#ifdef LP_SIMD_X86
+    case simd_level::avx512: axpy_on_index_avx512(x, basis, ed, index, sz, delta, copy); return;
+    case simd_level::avx2:   axpy_on_index_avx2(x, basis, ed, index, sz, delta, copy); return;
+#endif
+    default: axpy_on_index_scalar(x, basis, ed, index, sz, delta, copy); return;
+    }
+}
+
+unsigned drop_small_on_index(double * data, unsigned * index, unsigned sz, double eps) {
+    switch (g_level) {
+#ifdef LP_SIMD_X86
+    case simd_level::avx512: return drop_small_on_index_avx512(data, index, sz, eps);
+    case simd_level::avx2:   return drop_small_on_index_avx2(data, index, sz, eps);
+#endif
+    default: return drop_small_on_index_scalar(data, index, sz, eps);
+    }
+}
+}
+}
@@ -0,0 +1,38 @@
+/*
+  Copyright (c) 2017 Microsoft Corporation
+  Author: agent (agent@local) 2026-10-16
+*/
+#pragma once
+namespace lean {
+template <typename T> struct row_cell; // forward definition
+
+// The instruction set used by the kernels below, the best one the cpu supports is picked at startup.
+enum class simd_level { scalar, sse4_1, avx2, avx512 };
+
+/**
+   Vectorized kernels for the double instantiation of the lp core: these are the
+   loops of the double simplex that run over a row or over the index of an
+   indexed_vector. The rational instantiations keep the generic loops.
+   The kernels may add the terms in a different order than the generic loops do,
+   so their results can differ in the last bits.
+*/
+namespace simd {
+simd_level supported_level();
+simd_level level();
+// sets the level of the kernels, it is capped by supported_level(); used for benchmarking
+void set_level(simd_level l);
+const char * level_to_string(simd_level l);
+
+// returns the sum of w[c.m_j] * c.m_value over the row
+double dot_row(row_cell<double> const * row, unsigned sz, double const * w);
+// returns the maximum and the minimum of |c.m_value| over the row, or 0 for an empty row
+double max_abs_row(row_cell<double> const * row, unsigned sz);
+double min_abs_row(row_cell<double> const * row, unsigned sz);
+// for every i in index: x[basis[i]] -= delta * ed[i]; when copy is not null, copy[i] gets the old value of x[basis[i]]
+// the basis entries have to be pairwise distinct
+void axpy_on_index(double * x, unsigned const * basis, double const * ed, unsigned const * index, unsigned sz, double delta, double * copy);
+// removes from index the entries i with |data[i]| < eps and sets data[i] to zero for them;
+// keeps the order of the remaining entries and returns their number
+unsigned drop_small_on_index(double * data, unsigned * index, unsigned sz, double eps);
+}
+}
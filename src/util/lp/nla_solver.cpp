@@ -0,0 +1,354 @@
+/*
+  Copyright (c) 2017 Microsoft Corporation
+  Author: agent (agent@local) 2026-10-16
+*/
+#include "util/lp/nla_solver.h"
+#include <unordered_set>
+#include "util/lp/lar_solver.h"
+namespace lean {
+
+static int sign(mpq const & v) {
+    return v.is_pos() ? 1 : (v.is_neg() ? -1 : 0);
+}
+
+nla_solver::nla_solver(lar_solver & s): m_lar_solver(s) {}
+
+void nla_solver::add_monomial(var_index v, var_index x, var_index y) {
+    m_monomials.push_back(monomial(v, x, y));
+}
+
+void nla_solver::push() {
+    m_monomials_lim.push_back(m_monomials.size());
+}
+
+void nla_solver::pop(unsigned n) {
+    if (n == 0)
+        return;
+    unsigned new_lim = m_monomials_lim.size() - n;
+    m_monomials.shrink(m_monomials_lim[new_lim]);
+    m_monomials_lim.shrink(new_lim);
+}
+
+// the value of a term index includes the free coefficient of the term
+mpq const & nla_solver::val(var_index vi) {
+    auto it = m_values.find(vi);
+    if (it != m_values.end())
+        return it->second;
+    lean_assert(m_lar_solver.is_term(vi));
+    lar_term const & t = m_lar_solver.get_term(vi);
+    mpq r = t.m_v;
+    for (auto const & p : t.m_coeffs)
+        r += p.second * val(p.first);
+    return m_values[vi] = r;
+}
+
+// adds c*x k rs to the lemma
+void nla_solver::add_ineq(lemma & l, var_index x, mpq const & c, lconstraint_kind k, mpq const & rs) {
+    lar_term t;
+    t.add_to_map(x, c);
+    l.push_back(ineq(k, t, rs));
+}
+
+// the nearest multiple of 1/2^k
+mpq nla_solver::approx(mpq const & v, unsigned k) {
+    mpq p(1 << k);
+    return floor(v * p + mpq(1, 2)) / p;
+}
+
+// the model satisfies none of the inequalities of the lemma
+bool nla_solver::is_violated(lemma const & l) {
+    for (auto const & in : l) {
+        mpq v = zero_of_type<mpq>();
+        for (auto const & p : in.m_term.m_coeffs)
+            v += p.second * val(p.first);
+        bool holds = false;
+        switch (in.m_cmp) {
+        case LE: holds = v <= in.m_rs; break;
+        case LT: holds = v <  in.m_rs; break;
+        case EQ: holds = v == in.m_rs; break;
+        case GT: holds = v >  in.m_rs; break;
+        case GE: holds = v >= in.m_rs; break;
+        }
+        if (holds)
+            return false;
+    }
+    return true;
+}
+
+// The lemmas below are valid for every choice of the constants a and b.
+// They are instantiated with the simplest approximation of the model values that
+// still cuts off the current model, so that the constants do not grow with
+// the model values produced by the simplex. When no approximation up to
+// max_precision cuts off the model, no lemma is added and false is returned.
+
+// z = 0 => m = 0
+void nla_solver::add_zero_lemma(monomial const & mon, var_index z, vector<lemma> & lemmas) {
+    lemma l;
+    add_ineq(l, z, one_of_type<mpq>(), LT, zero_of_type<mpq>());
+    add_ineq(l, z, one_of_type<mpq>(), GT, zero_of_type<mpq>());
+    add_ineq(l, mon.m_v, one_of_type<mpq>(), val(mon.m_v).is_pos() ? LE : GE, zero_of_type<mpq>());
+    lemmas.push_back(l);
+    m_stats.m_zero_lemmas++;
+}
+
+// m = x*x with val(x) != 0
+bool nla_solver::add_square_lemma(monomial const & mon, vector<lemma> & lemmas) {
+    mpq const & vm = val(mon.m_v);
+    mpq const & vx = val(mon.m_x);
+    if (vm.is_neg()) {
+        // m >= 0
+        lemma l;
+        add_ineq(l, mon.m_v, one_of_type<mpq>(), GE, zero_of_type<mpq>());
+        lemmas.push_back(l);
+        m_stats.m_sign_lemmas++;
+        return true;
+    }
+    bool below = vm < vx * vx;
+    mpq sx(sign(vx));
+    for (unsigned k = 0; k <= max_precision; k++) {
+        mpq a = approx(vx, k);
+        lemma l;
+        if (below) {
+            // the tangent at a: m >= 2*a*x - a*a
+            lar_term t;
+            t.add_to_map(mon.m_v, one_of_type<mpq>());
+            if (!is_zero(a))
+                t.add_to_map(mon.m_x, mpq(-2) * a);
+            l.push_back(ineq(GE, t, -(a * a)));
+        }
+        else {
+            // 0 <= sx*x <= |a| => m <= a*a
+            add_ineq(l, mon.m_x, sx, LT, zero_of_type<mpq>());
+            add_ineq(l, mon.m_x, sx, GT, abs(a));
+            add_ineq(l, mon.m_v, one_of_type<mpq>(), LE, a * a);
+        }
+        if (is_violated(l)) {
+            lemmas.push_back(l);
+            if (below)
+                m_stats.m_tangent_lemmas++;
+            else
+                m_stats.m_monotone_lemmas++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// sx*x > 0 & sy*y > 0 => sx*sy*m > 0
+void nla_solver::add_sign_lemma(monomial const & mon, int sx, int sy, vector<lemma> & lemmas) {
+    lemma l;
+    add_ineq(l, mon.m_x, mpq(sx), LE, zero_of_type<mpq>());
+    add_ineq(l, mon.m_y, mpq(sy), LE, zero_of_type<mpq>());
+    add_ineq(l, mon.m_v, mpq(sx * sy), GT, zero_of_type<mpq>());
+    lemmas.push_back(l);
+    m_stats.m_sign_lemmas++;
+}
+
+// with a and b approximating |val(x)| and |val(y)|:
+// |m| > |a*b|:  0 <= sx*x <= a & 0 <= sy*y <= b => sx*sy*m <= a*b
+// |m| < |a*b|:  sx*x >= a & sy*y >= b => sx*sy*m >= a*b
+bool nla_solver::add_monotone_lemma(monomial const & mon, int sx, int sy, vector<lemma> & lemmas) {
+    mpq vx = abs(val(mon.m_x)), vy = abs(val(mon.m_y));
+    bool above = abs(val(mon.m_v)) > vx * vy;
+    for (unsigned k = 0; k <= max_precision; k++) {
+        mpq a = approx(vx, k), b = approx(vy, k);
+        lemma l;
+        if (above) {
+            add_ineq(l, mon.m_x, mpq(sx), LT, zero_of_type<mpq>());
+            add_ineq(l, mon.m_y, mpq(sy), LT, zero_of_type<mpq>());
+            add_ineq(l, mon.m_x, mpq(sx), GT, a);
+            add_ineq(l, mon.m_y, mpq(sy), GT, b);
+            add_ineq(l, mon.m_v, mpq(sx * sy), LE, a * b);
+        }
+        else {
+            add_ineq(l, mon.m_x, mpq(sx), LT, a);
+            add_ineq(l, mon.m_y, mpq(sy), LT, b);
+            add_ineq(l, mon.m_v, mpq(sx * sy), GE, a * b);
+        }
+        if (is_violated(l)) {
+            lemmas.push_back(l);
+            m_stats.m_monotone_lemmas++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// with (a, b) approximating (val(x), val(y)) and the plane T = b*x + a*y - a*b:
+// val(m) < val(x)*val(y):  (x <= a & y <= b) | (x >= a & y >= b) => m >= T
+// val(m) > val(x)*val(y):  (x <= a & y >= b) | (x >= a & y <= b) => m <= T
+bool nla_solver::add_tangent_lemmas(monomial const & mon, vector<lemma> & lemmas) {
+    mpq const & vx = val(mon.m_x);
+    mpq const & vy = val(mon.m_y);
+    bool below = val(mon.m_v) < vx * vy;
+    for (unsigned k = 0; k <= max_precision; k++) {
+        mpq a = approx(vx, k), b = approx(vy, k);
+        lar_term t;
+        t.add_to_map(mon.m_v, one_of_type<mpq>());
+        if (!is_zero(b))
+            t.add_to_map(mon.m_x, -b);
+        if (!is_zero(a))
+            t.add_to_map(mon.m_y, -a);
+        bool found = false;
+        for (unsigned i = 0; i < 2; i++) {
+            bool x_up = i == 0;
+            bool y_up = below ? x_up : !x_up;
+            lemma l;
+            add_ineq(l, mon.m_x, one_of_type<mpq>(), x_up ? LT : GT, a);
+            add_ineq(l, mon.m_y, one_of_type<mpq>(), y_up ? LT : GT, b);
+            l.push_back(ineq(below ? GE : LE, t, -(a * b)));
+            if (is_violated(l)) {
+                lemmas.push_back(l);
+                found = true;
+            }
+        }
+        if (found) {
+            m_stats.m_tangent_lemmas++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// returns false if the monomial is violated but no lemma was found for it
+bool nla_solver::check_monomial(monomial const & mon, vector<lemma> & lemmas) {
+    mpq const & vm = val(mon.m_v);
+    mpq const & vx = val(mon.m_x);
+    mpq const & vy = val(mon.m_y);
+    if (vm == vx * vy)
+        return true;
+    if (is_zero(vx)) {
+        add_zero_lemma(mon, mon.m_x, lemmas);
+        return true;
+    }
+    if (is_zero(vy)) {
+        add_zero_lemma(mon, mon.m_y, lemmas);
+        return true;
+    }
+    if (mon.m_x == mon.m_y)
+        return add_square_lemma(mon, lemmas);
+    int sx = sign(vx), sy = sign(vy);
+    if (sign(vm) != sx * sy) {
+        add_sign_lemma(mon, sx, sy, lemmas);
+        return true;
+    }
+    bool found = add_monotone_lemma(mon, sx, sy, lemmas);
+    found |= add_tangent_lemmas(mon, lemmas);
+    return found;
+}
+
+// adds c*j to t, where j is a variable or a term index
+void nla_solver::add_to_term(lar_term & t, mpq const & c, var_index j) const {
+    // lar_term::add_to_map keeps zero coefficients of new indices
+    if (is_zero(c))
+        return;
+    if (!m_lar_solver.is_term(j)) {
+        t.add_to_map(j, c);
+        return;
+    }
+    lar_term const & s = m_lar_solver.get_term(j);
+    for (auto const & p : s.m_coeffs)
+        t.add_to_map(p.first, c * p.second);
+    t.m_v += c * s.m_v;
+}
+
+// Fix one factor of every monomial, which turns the monomials into linear equalities,
+// and look for a solution of the linear problem. The fixed values approximate the
+// current values, so that they do not grow from one repair to the next.
+// The solution is kept when it is found and the integer columns stay integral.
+bool nla_solver::fix_factors_and_solve() {
+    if (!m_lar_solver.settings().use_tableau())
+        return false;
+    auto & x = m_lar_solver.m_mpq_lar_core_solver.m_r_x;
+    vector<impq> saved_x(x);
+    unsigned n = m_lar_solver.column_count();
+    // prefer the factors that occur in many monomials, and alternate on ties
+    std::unordered_map<var_index, unsigned> occs;
+    for (auto const & mon : m_monomials) {
+        occs[mon.m_x]++;
+        if (mon.m_y != mon.m_x)
+            occs[mon.m_y]++;
+    }
+    bool fix_first = m_stats.m_checks % 2 == 0;
+    std::unordered_map<var_index, mpq> fixed;
+    for (auto const & mon : m_monomials) {
+        if (fixed.count(mon.m_x) || fixed.count(mon.m_y))
+            continue;
+        unsigned ox = occs[mon.m_x], oy = occs[mon.m_y];
+        var_index f = ox > oy || (ox == oy && fix_first) ? mon.m_x : mon.m_y;
+        fixed[f] = approx(val(f), repair_precision);
+    }
+    // a fixed monomial over fixed factors gets the product of their values,
+    // the factors of a monomial are registered before it.
+    for (auto const & mon : m_monomials) {
+        auto it = fixed.find(mon.m_v);
+        if (it != fixed.end() && fixed.count(mon.m_x) && fixed.count(mon.m_y))
+            it->second = fixed[mon.m_x] * fixed[mon.m_y];
+    }
+    m_lar_solver.push();
+    for (auto const & p : fixed)
+        m_lar_solver.add_var_bound(p.first, EQ, p.second);
+    for (auto const & mon : m_monomials) {
+        bool x_fixed = fixed.count(mon.m_x) > 0;
+        var_index f = x_fixed ? mon.m_x : mon.m_y;
+        var_index g = x_fixed ? mon.m_y : mon.m_x;
+        // m - val(f)*g = 0
+        lar_term t;
+        add_to_term(t, one_of_type<mpq>(), mon.m_v);
+        add_to_term(t, -fixed[f], g);
+        if (t.size() == 0)
+            continue;
+        var_index ti = m_lar_solver.add_term(t.coeffs_as_vector(), zero_of_type<mpq>());
+        m_lar_solver.add_var_bound(ti, EQ, -t.m_v);
+    }
+    lp_status st = m_lar_solver.find_feasible_solution();
+    m_lar_solver.pop(1);
+    bool found = st == OPTIMAL || st == FEASIBLE;
+    for (unsigned j = 0; found && j < n; j++) {
+        if (m_lar_solver.column_is_int(j) && !m_lar_solver.column_is_term(j))
+            found = x[j].y.is_zero() && x[j].x.is_int();
+    }
+    if (!found) {
+        // the solution before fixing the factors satisfies the rows, but the solve may have
+        // pivoted basic columns that are out of their bounds into the non-basis.
+        x = saved_x;
+    }
+    // non-basic columns go back to their bounds, and the basic columns follow them
+    for (unsigned j = 0; j < n; j++)
+        m_lar_solver.update_x_and_inf_costs_for_column_with_changed_bounds(j);
+    if (found)
+        m_stats.m_repairs++;
+    return found;
+}
+
+lbool nla_solver::check(vector<lemma> & lemmas) {
+    lemmas.reset();
+    if (m_monomials.empty())
+        return l_true;
+    m_stats.m_checks++;
+    m_values.clear();
+    m_lar_solver.get_model(m_values);
+    bool violated = false;
+    for (auto const & mon : m_monomials) {
+        unsigned sz = lemmas.size();
+        if (!check_monomial(mon, lemmas) || lemmas.size() > sz)
+            violated = true;
+    }
+    if (!violated)
+        return l_true;
+    if (fix_factors_and_solve()) {
+        lemmas.reset();
+        return l_true;
+    }
+    return lemmas.empty() ? l_undef : l_false;
+}
+
+void nla_solver::get_monomial_vars(svector<var_index> & vars) const {
+    for (auto const & mon : m_monomials) {
+        vars.push_back(mon.m_v);
+        vars.push_back(mon.m_x);
+        vars.push_back(mon.m_y);
+    }
+}
+
+}
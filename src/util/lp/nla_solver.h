@@ -0,0 +1,119 @@
+/*
+  Copyright (c) 2017 Microsoft Corporation
+  Author: agent (agent@local) 2026-10-16
+*/
+#pragma once
+#include <unordered_map>
+#include "util/vector.h"
+#include "util/lbool.h"
+#include "util/lp/lp_settings.h"
+#include "util/lp/numeric_pair.h"
+#include "util/lp/lar_term.h"
+#include "util/lp/ul_pair.h"
+
+namespace lean {
+class lar_solver; // forward definition
+
+// the inequality t cmp k, where t is over variable and term indices of the lar_solver
+struct ineq {
+    lconstraint_kind m_cmp;
+    lar_term         m_term;
+    mpq              m_rs;
+    ineq(lconstraint_kind cmp, lar_term const & t, mpq const & rs): m_cmp(cmp), m_term(t), m_rs(rs) {}
+};
+
+// a lemma is the disjunction of its inequalities, it is valid over the reals
+typedef vector<ineq> lemma;
+
+/**
+   Nonlinear reasoning on top of lar_solver by incremental linearization
+   (Cimatti, Griggio, Irfan, Roveri, Sebastiani). The monomials m = x*y are
+   columns of the lar_solver that are unconstrained by the linear solver.
+   When the value of m differs from the product of the values of x and y in
+   the current model, lemmas that are valid but violated by the model are
+   produced:
+
+   - zero and sign lemmas, e.g. x = 0 => m = 0, and x > 0 & y < 0 => m < 0,
+   - monotonicity lemmas, e.g. x >= a > 0 & y >= b > 0 => m >= a*b,
+   - tangent plane lemmas at the point (a, b): m - (b*x + a*y - a*b) = (x - a)*(y - b),
+     so m is above the plane when x - a and y - b have the same sign, and below it otherwise.
+
+   Before lemmas are added, the model is repaired by fixing one factor of every
+   monomial at its value and solving the resulting linear problem.
+   Products of more than two factors are binarized by the caller.
+*/
+class nla_solver {
+public:
+    struct stats {
+        unsigned m_checks;
+        unsigned m_zero_lemmas;
+        unsigned m_sign_lemmas;
+        unsigned m_monotone_lemmas;
+        unsigned m_tangent_lemmas;
+        unsigned m_repairs;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+
+private:
+    struct monomial {
+        var_index m_v; // m_v = m_x * m_y
+        var_index m_x;
+        var_index m_y;
+        monomial(var_index v, var_index x, var_index y): m_v(v), m_x(x), m_y(y) {}
+    };
+
+    lar_solver &                       m_lar_solver;
+    vector<monomial>                   m_monomials;
+    unsigned_vector                    m_monomials_lim;
+    std::unordered_map<var_index, mpq> m_values;
+    stats                              m_stats;
+
+    // the number of binary digits of the approximations of model values in lemmas
+    static const unsigned max_precision = 16;
+    // the number of binary digits of the values of the factors fixed by the repair
+    static const unsigned repair_precision = 8;
+
+    mpq const & val(var_index vi);
+    static mpq approx(mpq const & v, unsigned k);
+    bool is_violated(lemma const & l);
+    static void add_ineq(lemma & l, var_index x, mpq const & c, lconstraint_kind k, mpq const & rs);
+    void add_zero_lemma(monomial const & mon, var_index z, vector<lemma> & lemmas);
+    bool add_square_lemma(monomial const & mon, vector<lemma> & lemmas);
+    void add_sign_lemma(monomial const & mon, int sx, int sy, vector<lemma> & lemmas);
+    bool add_monotone_lemma(monomial const & mon, int sx, int sy, vector<lemma> & lemmas);
+    bool add_tangent_lemmas(monomial const & mon, vector<lemma> & lemmas);
+    bool check_monomial(monomial const & mon, vector<lemma> & lemmas);
+    void add_to_term(lar_term & t, mpq const & c, var_index j) const;
+    bool fix_factors_and_solve();
+
+public:
+    nla_solver(lar_solver & s);
+
+    /**
+       \brief Register the monomial v = x * y. The indices are variable or term indices.
+    */
+    void add_monomial(var_index v, var_index x, var_index y);
+
+    bool empty() const { return m_monomials.empty(); }
+
+    void push();
+
+    void pop(unsigned n);
+
+    /**
+       \brief Return l_true if the value of every monomial is the product of the values of its
+       factors in the current model of the lar_solver, possibly after repairing the model.
+       Otherwise return l_false and add lemmas that are violated by it, or return l_undef
+       if no lemma with small constants cuts off the model.
+    */
+    lbool check(vector<lemma> & lemmas);
+
+    /**
+       \brief Collect the indices of the monomials and of their factors.
+    */
+    void get_monomial_vars(svector<var_index> & vars) const;
+
+    stats const & st() const { return m_stats; }
+};
+}
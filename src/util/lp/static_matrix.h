@@ -12,6 +12,7 @@
 #include "util/lp/indexed_vector.h"
 #include "util/lp/permutation_matrix.h"
 #include "util/lp/linear_combination_iterator.h"
+#include "util/lp/lp_simd.h"
 #include <stack>
 namespace lean {
 
@@ -361,4 +362,22 @@ public:
         return ret;
     }
 };
+
+// the double instantiation runs the loops over the row cells with vector kernels
+
+template <> template <>
+inline double static_matrix<double, double>::dot_product_with_row<double>(unsigned row, const vector<double> & w) const {
+    lean_assert(row < m_rows.size());
+    return simd::dot_row(m_rows[row].c_ptr(), m_rows[row].size(), w.c_ptr());
+}
+
+template <>
+inline double static_matrix<double, double>::get_max_abs_in_row(unsigned row) const {
+    return simd::max_abs_row(m_rows[row].c_ptr(), m_rows[row].size());
+}
+
+template <>
+inline double static_matrix<double, double>::get_min_abs_in_row(unsigned row) const {
+    return simd::min_abs_row(m_rows[row].c_ptr(), m_rows[row].size());
+}
 }
@@ -28,7 +28,6 @@ template std::set<std::pair<unsigned, unsigned>> lean::static_matrix<lean::mpq,
 template double static_matrix<double, double>::get_elem(unsigned int, unsigned int) const;
 template double static_matrix<double, double>::get_max_abs_in_column(unsigned int) const;
 template double static_matrix<double, double>::get_min_abs_in_column(unsigned int) const;
-template double static_matrix<double, double>::get_min_abs_in_row(unsigned int) const;
 template void static_matrix<double, double>::init_empty_matrix(unsigned int, unsigned int);
 template void static_matrix<double, double>::init_row_columns(unsigned int, unsigned int);
 template static_matrix<double, double>::ref & static_matrix<double, double>::ref::operator=(double const&);
@@ -43,7 +42,6 @@ template mpq static_matrix<mpq, mpq>::get_balance() const;
 template mpq static_matrix<mpq, mpq>::get_elem(unsigned int, unsigned int) const;
 template mpq static_matrix<mpq, mpq>::get_max_abs_in_column(unsigned int) const;
 template mpq static_matrix<mpq, mpq>::get_max_abs_in_row(unsigned int) const;
-template double static_matrix<double, double>::get_max_abs_in_row(unsigned int) const;
 template mpq static_matrix<mpq, mpq>::get_min_abs_in_column(unsigned int) const;
 template mpq static_matrix<mpq, mpq>::get_min_abs_in_row(unsigned int) const;
 template void static_matrix<mpq, mpq>::init_row_columns(unsigned int, unsigned int);
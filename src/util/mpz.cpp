@@ -81,7 +81,32 @@ static T gcd_core(T u, T v) {
 }
 
 unsigned u_gcd(unsigned u, unsigned v) { return gcd_core(u, v); }
+
+#if defined(__GNUC__)
+// binary gcd that strips the trailing zeros at once, and keeps u <= v without branches
+uint64 u64_gcd(uint64 u, uint64 v) {
+    // one Euclidean step first, the arguments often have very different sizes
+    if (u > v)
+        std::swap(u, v);
+    if (u == 0)
+        return v;
+    v %= u;
+    if (v == 0)
+        return u;
+    unsigned k = __builtin_ctzll(u | v);
+    u >>= __builtin_ctzll(u);
+    do {
+        v >>= __builtin_ctzll(v);
+        uint64 lo = u < v ? u : v;
+        uint64 hi = u < v ? v : u;
+        u = lo;
+        v = hi - lo;
+    } while (v != 0);
+    return u << k;
+}
+#else
 uint64 u64_gcd(uint64 u, uint64 v) { return gcd_core(u, v); }
+#endif
 
 template<bool SYNCH>
 mpz_manager<SYNCH>::mpz_manager():
@@ -101,7 +126,6 @@ mpz_manager<SYNCH>::mpz_manager():
         m_arg[i] = allocate(m_init_cell_capacity);
         m_arg[i]->m_size = 1;
     }
-    set(m_int_min, -static_cast<int64>(INT_MIN));
 #else
     // GMP
     mpz_init(m_tmp);
@@ -142,7 +166,6 @@ template<bool SYNCH>
 mpz_manager<SYNCH>::~mpz_manager() {
     del(m_two64);
 #ifndef _MP_GMP
-    del(m_int_min);
     for (unsigned i = 0; i < 2; i++) {
         deallocate(m_tmp[i]);
         deallocate(m_arg[i]);
@@ -168,48 +191,50 @@ void mpz_manager<SYNCH>::set_big_i64(mpz & c, int64 v) {
         c.m_ptr = allocate(m_init_cell_capacity);
     }
     SASSERT(capacity(c) >= m_init_cell_capacity);
+    // -v overflows for INT64_MIN
     uint64 _v;
     if (v < 0) {
-        _v = -v;
+        _v = 0 - static_cast<uint64>(v);
         c.m_val = -1;
     }
     else {
         _v = v;
         c.m_val = 1;
     }
-    if (sizeof(digit_t) == sizeof(uint64)) {
-        // 64-bit machine
-        digits(c)[0] = static_cast<digit_t>(_v);
-        c.m_ptr->m_size = 1;
-    }
-    else {
-        // 32-bit machine
-        digits(c)[0] = static_cast<unsigned>(_v);
-        digits(c)[1] = static_cast<unsigned>(_v >> 32);
-        c.m_ptr->m_size = digits(c)[1] == 0 ? 1 : 2;
-    }
+    set_digits(c.m_ptr, _v);
 #else
     if (is_small(c)) {
         c.m_ptr = allocate();
     }
+    set_gmp_i64(*c.m_ptr, v);
+#endif
+}
+
+#ifdef _MP_GMP
+template<bool SYNCH>
+void mpz_manager<SYNCH>::set_gmp_i64(mpz_t & r, int64 v) {
+    if (sizeof(long) == sizeof(int64)) {
+        mpz_set_si(r, static_cast<long>(v));
+        return;
+    }
     uint64 _v;
     bool sign;
     if (v < 0) {
-        _v   = -v;
+        _v   = 0 - static_cast<uint64>(v);
         sign = true;
     }
     else {
         _v   = v;
         sign = false;
     }
-    mpz_set_ui(*c.m_ptr, static_cast<unsigned>(_v));
-    mpz_set_ui(m_tmp,    static_cast<unsigned>(_v >> 32));
+    mpz_set_ui(r,     static_cast<unsigned>(_v));
+    mpz_set_ui(m_tmp, static_cast<unsigned>(_v >> 32));
     mpz_mul(m_tmp, m_tmp, m_two32);
-    mpz_add(*c.m_ptr, *c.m_ptr, m_tmp);
+    mpz_add(r, r, m_tmp);
     if (sign)
-        mpz_neg(*c.m_ptr, *c.m_ptr);
-#endif
+        mpz_neg(r, r);
 }
+#endif
 
 template<bool SYNCH>
 void mpz_manager<SYNCH>::set_big_ui64(mpz & c, uint64 v) {
@@ -219,17 +244,7 @@ void mpz_manager<SYNCH>::set_big_ui64(mpz & c, uint64 v) {
     }
     SASSERT(capacity(c) >= m_init_cell_capacity);
     c.m_val = 1;
-    if (sizeof(digit_t) == sizeof(uint64)) {
-        // 64-bit machine
-        digits(c)[0] = static_cast<digit_t>(v);
-        c.m_ptr->m_size = 1;
-    }
-    else {
-        // 32-bit machine
-        digits(c)[0] = static_cast<unsigned>(v);
-        digits(c)[1] = static_cast<unsigned>(v >> 32);
-        c.m_ptr->m_size = digits(c)[1] == 0 ? 1 : 2;
-    }
+    set_digits(c.m_ptr, v);
 #else
     if (is_small(c)) {
         c.m_ptr = allocate();
@@ -264,10 +279,11 @@ void mpz_manager<SYNCH>::set(mpz & a, int sign, unsigned sz) {
         return;
     }
     
-    if (i == 1 && m_tmp[IDX]->m_digits[0] <= INT_MAX) {
+    uint64 v;
+    if (digits_fit_small(m_tmp[IDX]->m_digits, i, v)) {
         // m_tmp[IDX] fits is a fixnum
         del(a);
-        a.m_val = sign < 0 ? -static_cast<int>(m_tmp[IDX]->m_digits[0]) : static_cast<int>(m_tmp[IDX]->m_digits[0]);
+        a.m_val = sign < 0 ? -static_cast<int64>(v) : static_cast<int64>(v);
         return;
     }
 
@@ -307,10 +323,18 @@ void mpz_manager<SYNCH>::set(mpz & target, unsigned sz, digit_t const * digits)
     // remove zero digits
     while (sz > 0 && digits[sz - 1] == 0)
         sz--;
+#ifndef _MP_GMP
+    uint64 v;
+    if (sz == 0)
+        reset(target);
+    else if (digits_fit_small(digits, sz, v))
+        set(target, v);
+#else
     if (sz == 0)
         reset(target);
     else if (sz == 1)
         set(target, digits[0]);
+#endif
     else {
 #ifndef _MP_GMP
         target.m_val = 1; // number is positive.
@@ -559,14 +583,9 @@ void mpz_manager<SYNCH>::big_rem(mpz const & a, mpz const & b, mpz & c) {
 template<bool SYNCH>
 void mpz_manager<SYNCH>::gcd(mpz const & a, mpz const & b, mpz & c) {
     if (is_small(a) && is_small(b)) {
-        int _a = a.m_val;
-        int _b = b.m_val;
-        if (_a < 0) _a = -_a;
-        if (_b < 0) _b = -_b;
-        unsigned r = u_gcd(_a, _b);
-        // Remark: r is (INT_MAX + 1)
-        // If a == b == INT_MIN
-        set(c, r);
+        uint64 _a = a.m_val < 0 ? -a.m_val : a.m_val;
+        uint64 _b = b.m_val < 0 ? -b.m_val : b.m_val;
+        set(c, u64_gcd(_a, _b));
     }
     else {
 #ifdef _MP_GMP
@@ -739,8 +758,7 @@ void mpz_manager<SYNCH>::gcd(mpz const & a, mpz const & b, mpz & c) {
             SASSERT(ge(a1, b1));
             if (is_small(b1)) {
                 if (is_small(a1)) {
-                    unsigned r = u_gcd(a1.m_val, b1.m_val);
-                    set(c, r);
+                    set(c, u64_gcd(a1.m_val, b1.m_val));
                     break;
                 }
                 else {
@@ -1438,14 +1456,24 @@ std::string mpz_manager<SYNCH>::to_string(mpz const & a) const {
 
 template<bool SYNCH>
 unsigned mpz_manager<SYNCH>::hash(mpz const & a) {
-    if (is_small(a))
-        return a.m_val;
 #ifndef _MP_GMP
+    if (is_small(a)) {
+        if (INT_MIN <= a.m_val && a.m_val <= INT_MAX)
+            return static_cast<unsigned>(a.m_val);
+        // the other small numbers are hashed as the digits of their absolute value
+        uint64 v = a.m_val < 0 ? -a.m_val : a.m_val;
+        if (sizeof(digit_t) == sizeof(uint64) || v <= UINT_MAX)
+            return static_cast<unsigned>(v);
+        digit_t ds[2] = { static_cast<digit_t>(v), static_cast<digit_t>(v >> 32) };
+        return string_hash(reinterpret_cast<char*>(ds), sizeof(ds), 17);
+    }
     unsigned sz = size(a);
     if (sz == 1)
         return static_cast<unsigned>(digits(a)[0]);
     return string_hash(reinterpret_cast<char*>(digits(a)), sz * sizeof(digit_t), 17);
 #else
+    if (is_small(a))
+        return static_cast<unsigned>(a.m_val);
     return mpz_get_si(*a.m_ptr);
 #endif
 }
@@ -1462,9 +1490,9 @@ void mpz_manager<SYNCH>::power(mpz const & a, unsigned p, mpz & b) {
 #ifndef _MP_GMP
     if (is_small(a)) {
         if (a.m_val == 2) {
-            if (p < 8 * sizeof(int) - 1) {
+            if (p < 8 * sizeof(int64) - 1) {
                 del(b);
-                b.m_val = 1 << p;
+                b.m_val = static_cast<int64>(1) << p;
             }
             else {
                 unsigned sz    = p/(8 * sizeof(digit_t)) + 1;
@@ -1475,7 +1503,7 @@ void mpz_manager<SYNCH>::power(mpz const & a, unsigned p, mpz & b) {
                 b.m_ptr->m_size     = sz;
                 for (unsigned i = 0; i < sz - 1; i++)
                     b.m_ptr->m_digits[i] = 0;
-                b.m_ptr->m_digits[sz-1] = 1 << shift;
+                b.m_ptr->m_digits[sz-1] = static_cast<digit_t>(1) << shift;
                 b.m_val = 1;
             }
             return;
@@ -1516,8 +1544,9 @@ bool mpz_manager<SYNCH>::is_power_of_two(mpz const & a, unsigned & shift) {
     if (is_nonpos(a))
         return false;
     if (is_small(a)) {
-        if (::is_power_of_two(a.m_val)) {
-            shift = ::log2((unsigned)a.m_val);
+        uint64 v = a.m_val;
+        if (!(v & (v - 1))) {
+            shift = uint64_log2(v);
             return true;
         }
         else {
@@ -1562,22 +1591,13 @@ void mpz_manager<SYNCH>::ensure_capacity(mpz & a, unsigned capacity) {
     if (is_small(a)) {
         a.m_ptr = allocate(capacity);
         SASSERT(a.m_ptr->m_capacity == capacity);
-        if (a.m_val == INT_MIN) {
-            unsigned intmin_sz = m_int_min.m_ptr->m_size;
-            for (unsigned i = 0; i < intmin_sz; i++)
-                a.m_ptr->m_digits[i] = m_int_min.m_ptr->m_digits[i];
-            a.m_val = -1;
-            a.m_ptr->m_size = m_int_min.m_ptr->m_size;
-        }
-        else if (a.m_val < 0) {
-            a.m_ptr->m_digits[0] = -a.m_val;
+        if (a.m_val < 0) {
+            set_digits(a.m_ptr, -a.m_val);
             a.m_val = -1;
-            a.m_ptr->m_size = 1;
         }
         else {
-            a.m_ptr->m_digits[0] =  a.m_val;
+            set_digits(a.m_ptr, a.m_val);
             a.m_val = 1;
-            a.m_ptr->m_size = 1;
         }
     }
     else {
@@ -1610,9 +1630,10 @@ void mpz_manager<SYNCH>::normalize(mpz & a) {
         return;
     }
     
-    if (i == 1 && ds[0] <= INT_MAX) {
+    uint64 v;
+    if (digits_fit_small(ds, i, v)) {
         // a is small
-        int val = a.m_val < 0 ? -static_cast<int>(ds[0]) : static_cast<int>(ds[0]);
+        int64 val = a.m_val < 0 ? -static_cast<int64>(v) : static_cast<int64>(v);
         del(a);
         a.m_val = val;
         return;
@@ -1627,8 +1648,8 @@ void mpz_manager<SYNCH>::machine_div2k(mpz & a, unsigned k) {
     if (k == 0 || is_zero(a))
         return;
     if (is_small(a)) {
-        if (k < 32) {
-            int twok = 1 << k;
+        if (k < 63) {
+            int64 twok = static_cast<int64>(1) << k;
             a.m_val /= twok;
         }
         else {
@@ -1696,15 +1717,16 @@ template<bool SYNCH>
 void mpz_manager<SYNCH>::mul2k(mpz & a, unsigned k) {
     if (k == 0 || is_zero(a))
         return;
-    if (is_small(a) && k < 32) {
-        set_i64(a, i64(a) * (static_cast<int64>(1) << k));
+    if (is_small(a) && k < 63 && -(INT64_MAX >> k) <= a.m_val && a.m_val <= (INT64_MAX >> k)) {
+        a.m_val *= static_cast<int64>(1) << k;
         return;
     }
 #ifndef _MP_GMP
     TRACE("mpz_mul2k", tout << "mul2k\na: " << to_string(a) << "\nk: " << k << "\n";);
     unsigned word_shift  = k / (8 * sizeof(digit_t));
     unsigned bit_shift   = k % (8 * sizeof(digit_t));
-    unsigned old_sz      = is_small(a) ? 1 : a.m_ptr->m_size;
+    // a small number takes at most two digits
+    unsigned old_sz      = is_small(a) ? 2 : a.m_ptr->m_size;
     unsigned new_sz      = old_sz + word_shift + 1;
     ensure_capacity(a, new_sz);
     TRACE("mpz_mul2k", tout << "word_shift: " << word_shift << "\nbit_shift: " << bit_shift << "\nold_sz: " << old_sz << "\nnew_sz: " << new_sz 
@@ -1764,7 +1786,11 @@ unsigned mpz_manager<SYNCH>::power_of_two_multiple(mpz const & a) {
         return 0;
     if (is_small(a)) {
         unsigned r = 0;
-        int v      = a.m_val;
+        int64 v    = a.m_val;
+        if (v % (static_cast<int64>(1) << 32) == 0) {
+            r += 32;
+            v /= (static_cast<int64>(1) << 32);
+        }
 #define COUNT_DIGIT_RIGHT_ZEROS()               \
         if (v % (1 << 16) == 0) {               \
             r += 16;                            \
@@ -1820,7 +1846,7 @@ unsigned mpz_manager<SYNCH>::log2(mpz const & a) {
     if (is_nonpos(a))
         return 0;
     if (is_small(a))
-        return ::log2((unsigned)a.m_val);
+        return uint64_log2(static_cast<uint64>(a.m_val));
 #ifndef _MP_GMP
     COMPILE_TIME_ASSERT(sizeof(digit_t) == 8 || sizeof(digit_t) == 4);
     mpz_cell * c     = a.m_ptr;
@@ -1842,7 +1868,7 @@ unsigned mpz_manager<SYNCH>::mlog2(mpz const & a) {
     if (is_nonneg(a))
         return 0;
     if (is_small(a))
-        return ::log2((unsigned)-a.m_val);
+        return uint64_log2(static_cast<uint64>(-a.m_val));
 #ifndef _MP_GMP
     COMPILE_TIME_ASSERT(sizeof(digit_t) == 8 || sizeof(digit_t) == 4);
     mpz_cell * c     = a.m_ptr;
@@ -2019,14 +2045,11 @@ template<bool SYNCH>
 bool mpz_manager<SYNCH>::decompose(mpz const & a, svector<digit_t> & digits) {
     digits.reset();
     if (is_small(a)) {
-        if (a.m_val < 0) {
-            digits.push_back(-a.m_val);
-            return true;
-        }
-        else {
-            digits.push_back(a.m_val);
-            return false;
-        }
+        uint64 v = a.m_val < 0 ? -a.m_val : a.m_val;
+        digits.push_back(static_cast<digit_t>(v));
+        if (sizeof(digit_t) < sizeof(uint64) && (v >> 32) != 0)
+            digits.push_back(static_cast<digit_t>(v >> 32));
+        return a.m_val < 0;
     }
     else {
 #ifndef _MP_GMP
@@ -69,15 +69,22 @@ class mpz_cell {
 #include<gmp.h>
 #endif
 
+#if defined(__SIZEOF_INT128__)
+#define _MPZ_INT128
+#endif
+
 /**
    \brief Multi-precision integer.
    
    If m_ptr == 0, the it is a small number and the value is stored at m_val.
    Otherwise, m_val contains the sign (-1 negative, 1 positive), and m_ptr points to a mpz_cell that
    store the value. <<< This last statement is true only in Windows.
+
+   Small numbers range over [-INT64_MAX, INT64_MAX]. INT64_MIN is not small, so neg and abs
+   of a small number are small.
 */
 class mpz {
-    int        m_val; 
+    int64      m_val; 
 #ifndef _MP_GMP
     mpz_cell * m_ptr;
 #else
@@ -114,7 +121,6 @@ class mpz_manager {
     unsigned                m_init_cell_capacity;
     mpz_cell *              m_tmp[2];
     mpz_cell *              m_arg[2];
-    mpz                     m_int_min;
     
     static unsigned cell_size(unsigned capacity) { return sizeof(mpz_cell) + sizeof(digit_t) * capacity; }
 
@@ -189,14 +195,46 @@ class mpz_manager {
     template<int IDX>
     void set(mpz & a, int sign, unsigned sz);
 
-    static int64 i64(mpz const & a) { return static_cast<int64>(a.m_val); }
+    static int64 i64(mpz const & a) { return a.m_val; }
+
+    /**
+       \brief Store a + b (a * b) in r, and return true if the result is a small number.
+       The arguments are small numbers.
+    */
+    static bool small_add(int64 a, int64 b, int64 & r) {
+#ifdef _MPZ_INT128
+        __int128 s = static_cast<__int128>(a) + b;
+        r = static_cast<int64>(s);
+        return -INT64_MAX <= s && s <= INT64_MAX;
+#else
+        if (b > 0 ? a > INT64_MAX - b : a < -INT64_MAX - b)
+            return false;
+        r = a + b;
+        return true;
+#endif
+    }
+
+    static bool small_mul(int64 a, int64 b, int64 & r) {
+#ifdef _MPZ_INT128
+        __int128 p = static_cast<__int128>(a) * b;
+        r = static_cast<int64>(p);
+        return -INT64_MAX <= p && p <= INT64_MAX;
+#else
+        uint64 _a = a < 0 ? -a : a;
+        uint64 _b = b < 0 ? -b : b;
+        if ((_a | _b) > INT_MAX && _a != 0 && _b > static_cast<uint64>(INT64_MAX) / _a)
+            return false;
+        r = a * b;
+        return true;
+#endif
+    }
 
     void set_big_i64(mpz & c, int64 v);
 
     void set_i64(mpz & c, int64 v) { 
-        if (v >= INT_MIN && v <= INT_MAX) {
+        if (v != INT64_MIN) {
             del(c);
-            c.m_val = static_cast<int>(v); 
+            c.m_val = v; 
         }
         else {
             MPZ_BEGIN_CRITICAL();
@@ -214,6 +252,36 @@ class mpz_manager {
 
     static digit_t * digits(mpz const & c) { return c.m_ptr->m_digits; }
 
+    // Store the digits of v in cell. The capacity of cell is at least 2.
+    static void set_digits(mpz_cell * cell, uint64 v) {
+        if (sizeof(digit_t) == sizeof(uint64)) {
+            // 64-bit machine
+            cell->m_digits[0] = static_cast<digit_t>(v);
+            cell->m_size = 1;
+        }
+        else {
+            // 32-bit machine
+            cell->m_digits[0] = static_cast<digit_t>(v);
+            cell->m_digits[1] = static_cast<digit_t>(v >> 32);
+            cell->m_size = cell->m_digits[1] == 0 ? 1 : 2;
+        }
+    }
+
+    // Return true if the sz digits ds fit in a small number, and store their value in v.
+    static bool digits_fit_small(digit_t const * ds, unsigned sz, uint64 & v) {
+        if (sizeof(digit_t) == sizeof(uint64)) {
+            if (sz != 1)
+                return false;
+            v = ds[0];
+        }
+        else {
+            if (sz > 2)
+                return false;
+            v = sz == 1 ? ds[0] : (static_cast<uint64>(ds[1]) << 32) | ds[0];
+        }
+        return v <= static_cast<uint64>(INT64_MAX);
+    }
+
     // Return true if the absolute value fits in a UINT64
     static bool is_abs_uint64(mpz const & a) {
         if (is_small(a))
@@ -241,36 +309,31 @@ class mpz_manager {
     template<int IDX>
     void get_sign_cell(mpz const & a, int & sign, mpz_cell * & cell) {
         if (is_small(a)) {
-            if (a.m_val == INT_MIN) {
+            cell = m_arg[IDX];
+            if (a.m_val < 0) {
                 sign = -1;
-                cell = m_int_min.m_ptr;
+                set_digits(cell, -a.m_val);
             }
             else {
-                cell = m_arg[IDX];
-                SASSERT(cell->m_size == 1);
-                if (a.m_val < 0) {
-                    sign = -1;
-                    cell->m_digits[0] = -a.m_val;
-                }
-                else {
-                    sign = 1;
-                    cell->m_digits[0] = a.m_val;
-                }
+                sign = 1;
+                set_digits(cell, a.m_val);
             }
         }
         else {
-            sign = a.m_val;
+            sign = static_cast<int>(a.m_val);
             cell = a.m_ptr;
         }
     }
 #else
     // GMP code
 
+    void set_gmp_i64(mpz_t & r, int64 v);
+
     template<int IDX>
     void get_arg(mpz const & a, mpz_t * & result) {
         if (is_small(a)) {
             result = m_arg[IDX];
-            mpz_set_si(*result, a.m_val);
+            set_gmp_i64(*result, a.m_val);
         }
         else {
             result = a.m_ptr;
@@ -345,8 +408,10 @@ public:
     
     void add(mpz const & a, mpz const & b, mpz & c) {
         STRACE("mpz", tout << "[mpz] " << to_string(a) << " + " << to_string(b) << " == ";); 
-        if (is_small(a) && is_small(b)) {
-            set_i64(c, i64(a) + i64(b));
+        int64 r;
+        if (is_small(a) && is_small(b) && small_add(i64(a), i64(b), r)) {
+            del(c);
+            c.m_val = r;
         }
         else {
             MPZ_BEGIN_CRITICAL();
@@ -358,8 +423,10 @@ public:
 
     void sub(mpz const & a, mpz const & b, mpz & c) {
         STRACE("mpz", tout << "[mpz] " << to_string(a) << " - " << to_string(b) << " == ";); 
-        if (is_small(a) && is_small(b)) {
-            set_i64(c, i64(a) - i64(b));
+        int64 r;
+        if (is_small(a) && is_small(b) && small_add(i64(a), -i64(b), r)) {
+            del(c);
+            c.m_val = r;
         }
         else {
             MPZ_BEGIN_CRITICAL();
@@ -375,8 +442,10 @@ public:
 
     void mul(mpz const & a, mpz const & b, mpz & c) {
         STRACE("mpz", tout << "[mpz] " << to_string(a) << " * " << to_string(b) << " == ";); 
-        if (is_small(a) && is_small(b)) {
-            set_i64(c, i64(a) * i64(b));
+        int64 r;
+        if (is_small(a) && is_small(b) && small_mul(i64(a), i64(b), r)) {
+            del(c);
+            c.m_val = r;
         }
         else {
             MPZ_BEGIN_CRITICAL();
@@ -495,13 +564,6 @@ public:
 
     void neg(mpz & a) {
         STRACE("mpz", tout << "[mpz] 0 - " << to_string(a) << " == ";); 
-        if (is_small(a) && a.m_val == INT_MIN) {
-            // neg(INT_MIN) is not a small int
-            MPZ_BEGIN_CRITICAL();
-            set_big_i64(a, - static_cast<long long>(INT_MIN)); 
-            MPZ_END_CRITICAL();
-            return;
-        }
 #ifndef _MP_GMP
         a.m_val = -a.m_val;
 #else
@@ -517,16 +579,8 @@ public:
 
     void abs(mpz & a) {
         if (is_small(a)) {
-            if (a.m_val < 0) {
-                if (a.m_val == INT_MIN) {
-                    // abs(INT_MIN) is not a small int
-                    MPZ_BEGIN_CRITICAL();
-                    set_big_i64(a, - static_cast<long long>(INT_MIN)); 
-                    MPZ_END_CRITICAL();
-                }
-                else
-                    a.m_val = -a.m_val;
-            }
+            if (a.m_val < 0)
+                a.m_val = -a.m_val;
         }
         else {
 #ifndef _MP_GMP
@@ -572,10 +626,10 @@ public:
 
     static int sign(mpz const & a) {
 #ifndef _MP_GMP
-        return a.m_val;
+        return a.m_val > 0 ? 1 : (a.m_val < 0 ? -1 : 0);
 #else
         if (is_small(a))
-            return a.m_val;
+            return a.m_val > 0 ? 1 : (a.m_val < 0 ? -1 : 0);
         else
             return mpz_sgn(*a.m_ptr);
 #endif
@@ -674,10 +728,8 @@ public:
     }
 
     void set(mpz & a, unsigned val) {
-        if (val <= INT_MAX)
-            set(a, static_cast<int>(val));
-        else
-            set(a, static_cast<int64>(static_cast<uint64>(val)));
+        del(a);
+        a.m_val = val;
     }
 
     void set(mpz & a, char const * val);
@@ -687,9 +739,9 @@ public:
     }
 
     void set(mpz & a, uint64 val) {
-        if (val < INT_MAX) {
+        if (val <= static_cast<uint64>(INT64_MAX)) {
             del(a);
-            a.m_val = static_cast<int>(val);
+            a.m_val = static_cast<int64>(val);
         }
         else {
             MPZ_BEGIN_CRITICAL();
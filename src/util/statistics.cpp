@@ -227,6 +227,15 @@ double statistics::get_double_value(unsigned idx) const {
     return m_d_stats[idx - m_stats.size()].second;
 }
 
+unsigned statistics::get_uint(char const * key) const {
+    unsigned r = 0;
+    for (unsigned i = 0; i < m_stats.size(); ++i) {
+        if (strcmp(m_stats[i].first, key) == 0)
+            r += m_stats[i].second;
+    }
+    return r;
+}
+
 static void get_uint64_stats(statistics& st, char const* name, unsigned long long value) {
     if (value <= UINT_MAX) {
         st.update(name, static_cast<unsigned>(value));
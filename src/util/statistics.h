@@ -41,6 +41,8 @@ public:
     char const * get_key(unsigned idx) const;
     unsigned get_uint_value(unsigned idx) const;
     double get_double_value(unsigned idx) const;
+    // sum of the values recorded for key, 0 if there are none.
+    unsigned get_uint(char const * key) const;
 };
 
 void get_memory_statistics(statistics& st);